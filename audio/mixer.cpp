@@ -22,6 +22,8 @@
 
 #include "gui/EventRecorder.h"
 
+#include "common/atomic.h"
+#include "common/config-manager.h"
 #include "common/util.h"
 #include "common/system.h"
 #include "common/textconsole.h"
@@ -44,7 +46,7 @@ namespace Audio {
  */
 class Channel {
 public:
-	Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream, DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent);
+	Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream, DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent, RateConverterType converterType);
 	~Channel();
 
 	/**
@@ -80,8 +82,10 @@ public:
 	 *
 	 * @param paused true, when the channel should be paused.
 	 *               false when it should be unpaused.
+	 * @param time   the time of the request, as returned by
+	 *               OSystem::getMillis(true)
 	 */
-	void pause(bool paused);
+	void pause(bool paused, uint32 time);
 
 	/**
 	 * Queries whether the channel is currently paused.
@@ -123,9 +127,17 @@ public:
 	void notifyGlobalVolChange() { updateChannelVolumes(); }
 
 	/**
-	 * Queries how long the channel has been playing.
+	 * Queries the values needed to compute how long the channel has been
+	 * playing.
+	 *
+	 * @see computeElapsedTime
 	 */
-	Timestamp getElapsedTime();
+	void getTimingInfo(uint32 &samplesConsumed, uint32 &mixerTimeStamp, uint32 &pauseStartTime, uint32 &pauseTime) const {
+		samplesConsumed = _samplesConsumed;
+		mixerTimeStamp = _mixerTimeStamp;
+		pauseStartTime = _pauseStartTime;
+		pauseTime = _pauseTime;
+	}
 
 	/**
 	 * Queries the channel's sound type.
@@ -173,9 +185,42 @@ private:
 #pragma mark --- Mixer ---
 #pragma mark -
 
+/**
+ * Computes how long a channel has been playing from the timing information
+ * it published.
+ */
+static Timestamp computeElapsedTime(uint rate, bool paused, uint32 samplesConsumed, uint32 mixerTimeStamp, uint32 pauseStartTime, uint32 pauseTime) {
+	uint32 delta = 0;
+
+	Audio::Timestamp ts(0, rate);
+
+	if (mixerTimeStamp == 0)
+		return ts;
+
+	if (paused)
+		delta = pauseStartTime - mixerTimeStamp;
+	else
+		delta = g_system->getMillis(true) - mixerTimeStamp - pauseTime;
+
+	// Convert the number of samples into a time duration.
+
+	ts = ts.addFrames(samplesConsumed);
+	ts = ts.addMsecs(delta);
+
+	// In theory it would seem like a good idea to limit the approximation
+	// so that it never exceeds the theoretical upper bound set by
+	// _samplesDecoded. Meanwhile, back in the real world, doing so makes
+	// the Broken Sword cutscenes noticeably jerkier. I guess the mixer
+	// isn't invoked at the regular intervals that I first imagined.
+
+	return ts;
+}
+
 // TODO: parameter "system" is unused
 MixerImpl::MixerImpl(OSystem *system, uint sampleRate)
-	: _mutex(), _sampleRate(sampleRate), _mixerReady(false), _handleSeed(0), _soundTypeSettings() {
+	: _mutex(), _sampleRate(sampleRate), _mixerReady(false), _handleSeed(0), _soundTypeSettings(),
+	  _converterType(parseRateConverterType(ConfMan.get("resampler").c_str())),
+	  _commandWritePos(0), _commandReadPos(0), _channelsLocked(0) {
 
 	assert(sampleRate > 0);
 
@@ -184,6 +229,10 @@ MixerImpl::MixerImpl(OSystem *system, uint sampleRate)
 }
 
 MixerImpl::~MixerImpl() {
+	// The audio thread is gone by now, so there is nobody left to apply
+	// the queued commands. Do it here to release any pending channels.
+	processCommands();
+
 	for (int i = 0; i != NUM_CHANNELS; i++)
 		delete _channels[i];
 }
@@ -196,10 +245,184 @@ uint MixerImpl::getOutputRate() const {
 	return _sampleRate;
 }
 
-void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
+void MixerImpl::setRateConverterType(RateConverterType type) {
+	Common::StackLock lock(_mutex);
+	_converterType = type;
+}
+
+#pragma mark -
+#pragma mark --- Engine/audio thread communication ---
+#pragma mark -
+
+int MixerImpl::findSlot(SoundHandle handle) {
+	const int index = handle._val % NUM_CHANNELS;
+	if (_slots[index].handle != handle._val || !isSlotActive(index))
+		return -1;
+	return index;
+}
+
+bool MixerImpl::isSlotActive(int index) {
+	SlotInfo &slot = _slots[index];
+	if (slot.handle == 0xFFFFFFFF)
+		return false;
+
+	// Channels which reach the end of their stream are removed by the
+	// audio thread; we learn about that through the status snapshot.
+	ChannelStatus status;
+	readStatus(index, status);
+	if (status.handle == slot.handle && !status.active) {
+		slot.handle = 0xFFFFFFFF;
+		return false;
+	}
+
+	return true;
+}
+
+void MixerImpl::pushCommand(CommandType type, int index, int value, Channel *channel) {
+	if (_commandWritePos - Common::atomicLoad(_commandReadPos) == COMMAND_QUEUE_SIZE) {
+		// The audio thread is not draining the queue, e.g. because audio
+		// output has been suspended. Apply the queued commands ourselves.
+		lockChannels();
+		unlockChannels();
+	}
+
+	Command &cmd = _commands[_commandWritePos % COMMAND_QUEUE_SIZE];
+	cmd.type = type;
+	cmd.index = index;
+	cmd.handle = (index >= 0) ? _slots[index].handle : 0xFFFFFFFF;
+	cmd.channel = channel;
+	cmd.value = value;
+	cmd.time = g_system->getMillis(true);
+
+	Common::atomicStore(_commandWritePos, _commandWritePos + 1);
+}
+
+void MixerImpl::lockChannels() {
+	while (!Common::atomicCompareAndSwap(_channelsLocked, 0, 1))
+		g_system->delayMillis(1);
+
+	// Anything queued before must take effect first, e.g. the channel of
+	// a sound which is stopped right after being started.
+	processCommands();
+}
+
+void MixerImpl::unlockChannels() {
+	Common::atomicStore(_channelsLocked, 0);
+}
+
+Channel *MixerImpl::detachSlot(int index) {
+	Channel *chan = _channels[index];
+	if (chan && chan->getHandle()._val == _slots[index].handle) {
+		_channels[index] = 0;
+		publishStatus(index);
+	} else {
+		chan = 0;
+	}
+	_slots[index].handle = 0xFFFFFFFF;
+	return chan;
+}
+
+void MixerImpl::processCommands() {
+	const uint32 writePos = Common::atomicLoad(_commandWritePos);
+
+	while (_commandReadPos != writePos) {
+		applyCommand(_commands[_commandReadPos % COMMAND_QUEUE_SIZE]);
+		Common::atomicStore(_commandReadPos, _commandReadPos + 1);
+	}
+}
+
+void MixerImpl::applyCommand(const Command &cmd) {
+	if (cmd.type == kCommandAddChannel) {
+		delete _channels[cmd.index];
+		_channels[cmd.index] = cmd.channel;
+		publishStatus(cmd.index);
+		return;
+	}
+
+	if (cmd.type == kCommandUpdateVolumes) {
+		for (int i = 0; i != NUM_CHANNELS; ++i) {
+			if (_channels[i] && _channels[i]->getType() == (SoundType)cmd.value)
+				_channels[i]->notifyGlobalVolChange();
+		}
+		return;
+	}
+
+	// Simply ignore requests for sounds that already terminated
+	Channel *chan = _channels[cmd.index];
+	if (!chan || chan->getHandle()._val != cmd.handle)
+		return;
+
+	switch (cmd.type) {
+	case kCommandPauseChannel:
+		chan->pause(cmd.value != 0, cmd.time);
+		break;
+
+	case kCommandSetVolume:
+		chan->setVolume(cmd.value);
+		break;
+
+	case kCommandSetBalance:
+		chan->setBalance(cmd.value);
+		break;
+
+	default:
+		break;
+	}
+
+	publishStatus(cmd.index);
+}
+
+void MixerImpl::publishStatus(int index) {
+	ChannelStatus &status = _status[index];
+	Channel *chan = _channels[index];
+
+	Common::atomicStore(status.sequence, status.sequence + 1);
+	Common::memoryBarrier();
+
+	if (chan) {
+		uint32 samplesConsumed, mixerTimeStamp, pauseStartTime, pauseTime;
+		chan->getTimingInfo(samplesConsumed, mixerTimeStamp, pauseStartTime, pauseTime);
+
+		status.handle = chan->getHandle()._val;
+		status.active = 1;
+		status.paused = chan->isPaused();
+		status.samplesConsumed = samplesConsumed;
+		status.mixerTimeStamp = mixerTimeStamp;
+		status.pauseStartTime = pauseStartTime;
+		status.pauseTime = pauseTime;
+	} else {
+		// Keep the handle, so the engine side can tell which channel ended
+		status.active = 0;
+	}
+
+	Common::atomicStore(status.sequence, status.sequence + 1);
+}
+
+void MixerImpl::readStatus(int index, ChannelStatus &copy) const {
+	const ChannelStatus &status = _status[index];
+	uint32 sequence;
+
+	do {
+		sequence = Common::atomicLoad(status.sequence);
+		copy.handle = status.handle;
+		copy.active = status.active;
+		copy.paused = status.paused;
+		copy.samplesConsumed = status.samplesConsumed;
+		copy.mixerTimeStamp = status.mixerTimeStamp;
+		copy.pauseStartTime = status.pauseStartTime;
+		copy.pauseTime = status.pauseTime;
+		Common::memoryBarrier();
+	} while ((sequence & 1) || sequence != status.sequence);
+}
+
+#pragma mark -
+#pragma mark --- Mixer API ---
+#pragma mark -
+
+void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan, SoundType type, int id, bool permanent, byte volume, int8 balance) {
 	int index = -1;
 	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] == 0) {
+		if (!isSlotActive(i)) {
 			index = i;
 			break;
 		}
@@ -210,8 +433,6 @@ void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
 		return;
 	}
 
-	_channels[index] = chan;
-
 	SoundHandle chanHandle;
 	chanHandle._val = index + (_handleSeed * NUM_CHANNELS);
 
@@ -219,6 +440,16 @@ void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
 	_handleSeed++;
 	if (handle)
 		*handle = chanHandle;
+
+	SlotInfo &slot = _slots[index];
+	slot.handle = chanHandle._val;
+	slot.id = id;
+	slot.type = type;
+	slot.permanent = permanent;
+	slot.volume = volume;
+	slot.balance = balance;
+
+	pushCommand(kCommandAddChannel, index, 0, chan);
 }
 
 void MixerImpl::playStream(
@@ -242,7 +473,7 @@ void MixerImpl::playStream(
 	// Prevent duplicate sounds
 	if (id != -1) {
 		for (int i = 0; i != NUM_CHANNELS; i++)
-			if (_channels[i] != 0 && _channels[i]->getId() == id) {
+			if (isSlotActive(i) && _slots[i].id == id) {
 				// Delete the stream if were asked to auto-dispose it.
 				// Note: This could cause trouble if the client code does not
 				// yet expect the stream to be gone. The primary example to
@@ -259,18 +490,17 @@ void MixerImpl::playStream(
 	reverseStereo = !reverseStereo;
 #endif
 
-	// Create the channel
-	Channel *chan = new Channel(this, type, stream, autofreeStream, reverseStereo, id, permanent);
+	// Create the channel. It is handed over to the audio thread through the
+	// command queue, so it may be set up here without further locking.
+	Channel *chan = new Channel(this, type, stream, autofreeStream, reverseStereo, id, permanent, _converterType);
 	chan->setVolume(volume);
 	chan->setBalance(balance);
-	insertChannel(handle, chan);
+	insertChannel(handle, chan, type, id, permanent, volume, balance);
 }
 
 int MixerImpl::mixCallback(byte *samples, uint len) {
 	assert(samples);
 
-	Common::StackLock lock(_mutex);
-
 	int16 *buf = (int16 *)samples;
 	// we store stereo, 16-bit samples
 	assert(len % 4 == 0);
@@ -282,6 +512,14 @@ int MixerImpl::mixCallback(byte *samples, uint len) {
 	//  zero the buf
 	memset(buf, 0, 2 * len * sizeof(int16));
 
+	// The engine side only holds the channels to apply queued commands or
+	// to detach stopped channels, which is quick. Wait for it rather than
+	// dropping a buffer.
+	while (!Common::atomicCompareAndSwap(_channelsLocked, 0, 1))
+		;
+
+	processCommands();
+
 	// mix all channels
 	int res = 0, tmp;
 	for (int i = 0; i != NUM_CHANNELS; i++)
@@ -295,51 +533,71 @@ int MixerImpl::mixCallback(byte *samples, uint len) {
 				if (tmp > res)
 					res = tmp;
 			}
+			publishStatus(i);
 		}
 
+	Common::atomicStore(_channelsLocked, 0);
+
 	return res;
 }
 
+// Stopping is not queued like the other commands: callers may free the
+// stream right after stopping it, so the channel has to be gone by the
+// time these return. The channels are only detached while the audio thread
+// is locked out, and deleted afterwards, as deleting their streams may take
+// a while.
+
 void MixerImpl::stopAll() {
 	Common::StackLock lock(_mutex);
+	Channel *stopped[NUM_CHANNELS];
+	lockChannels();
 	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != 0 && !_channels[i]->isPermanent()) {
-			delete _channels[i];
-			_channels[i] = 0;
-		}
+		stopped[i] = 0;
+		if (isSlotActive(i) && !_slots[i].permanent)
+			stopped[i] = detachSlot(i);
 	}
+	unlockChannels();
+
+	for (int i = 0; i != NUM_CHANNELS; i++)
+		delete stopped[i];
 }
 
 void MixerImpl::stopID(int id) {
 	Common::StackLock lock(_mutex);
+	Channel *stopped[NUM_CHANNELS];
+	lockChannels();
 	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != 0 && _channels[i]->getId() == id) {
-			delete _channels[i];
-			_channels[i] = 0;
-		}
+		stopped[i] = 0;
+		if (isSlotActive(i) && _slots[i].id == id)
+			stopped[i] = detachSlot(i);
 	}
+	unlockChannels();
+
+	for (int i = 0; i != NUM_CHANNELS; i++)
+		delete stopped[i];
 }
 
 void MixerImpl::stopHandle(SoundHandle handle) {
 	Common::StackLock lock(_mutex);
 
 	// Simply ignore stop requests for handles of sounds that already terminated
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	const int index = findSlot(handle);
+	if (index == -1)
 		return;
 
-	delete _channels[index];
-	_channels[index] = 0;
+	lockChannels();
+	Channel *stopped = detachSlot(index);
+	unlockChannels();
+
+	delete stopped;
 }
 
 void MixerImpl::muteSoundType(SoundType type, bool mute) {
 	assert(0 <= (int)type && (int)type < ARRAYSIZE(_soundTypeSettings));
-	_soundTypeSettings[type].mute = mute;
 
-	for (int i = 0; i != NUM_CHANNELS; ++i) {
-		if (_channels[i] && _channels[i]->getType() == type)
-			_channels[i]->notifyGlobalVolChange();
-	}
+	Common::StackLock lock(_mutex);
+	_soundTypeSettings[type].mute = mute;
+	pushCommand(kCommandUpdateVolumes, -1, type);
 }
 
 bool MixerImpl::isSoundTypeMuted(SoundType type) const {
@@ -350,37 +608,43 @@ bool MixerImpl::isSoundTypeMuted(SoundType type) const {
 void MixerImpl::setChannelVolume(SoundHandle handle, byte volume) {
 	Common::StackLock lock(_mutex);
 
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	const int index = findSlot(handle);
+	if (index == -1)
 		return;
 
-	_channels[index]->setVolume(volume);
+	_slots[index].volume = volume;
+	pushCommand(kCommandSetVolume, index, volume);
 }
 
 byte MixerImpl::getChannelVolume(SoundHandle handle) {
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	Common::StackLock lock(_mutex);
+
+	const int index = findSlot(handle);
+	if (index == -1)
 		return 0;
 
-	return _channels[index]->getVolume();
+	return _slots[index].volume;
 }
 
 void MixerImpl::setChannelBalance(SoundHandle handle, int8 balance) {
 	Common::StackLock lock(_mutex);
 
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	const int index = findSlot(handle);
+	if (index == -1)
 		return;
 
-	_channels[index]->setBalance(balance);
+	_slots[index].balance = balance;
+	pushCommand(kCommandSetBalance, index, balance);
 }
 
 int8 MixerImpl::getChannelBalance(SoundHandle handle) {
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	Common::StackLock lock(_mutex);
+
+	const int index = findSlot(handle);
+	if (index == -1)
 		return 0;
 
-	return _channels[index]->getBalance();
+	return _slots[index].balance;
 }
 
 uint32 MixerImpl::getSoundElapsedTime(SoundHandle handle) {
@@ -388,20 +652,25 @@ uint32 MixerImpl::getSoundElapsedTime(SoundHandle handle) {
 }
 
 Timestamp MixerImpl::getElapsedTime(SoundHandle handle) {
-	Common::StackLock lock(_mutex);
-
+	// This only looks at the status snapshot, so it is safe to call without
+	// taking the mutex. A channel which has not been picked up by the audio
+	// thread yet has not played anything.
 	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	ChannelStatus status;
+	readStatus(index, status);
+
+	if (status.handle != handle._val || !status.active)
 		return Timestamp(0, _sampleRate);
 
-	return _channels[index]->getElapsedTime();
+	return computeElapsedTime(_sampleRate, status.paused != 0, status.samplesConsumed,
+	                          status.mixerTimeStamp, status.pauseStartTime, status.pauseTime);
 }
 
 void MixerImpl::pauseAll(bool paused) {
 	Common::StackLock lock(_mutex);
 	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != 0) {
-			_channels[i]->pause(paused);
+		if (isSlotActive(i)) {
+			pushCommand(kCommandPauseChannel, i, paused);
 		}
 	}
 }
@@ -409,8 +678,8 @@ void MixerImpl::pauseAll(bool paused) {
 void MixerImpl::pauseID(int id, bool paused) {
 	Common::StackLock lock(_mutex);
 	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != 0 && _channels[i]->getId() == id) {
-			_channels[i]->pause(paused);
+		if (isSlotActive(i) && _slots[i].id == id) {
+			pushCommand(kCommandPauseChannel, i, paused);
 			return;
 		}
 	}
@@ -420,11 +689,11 @@ void MixerImpl::pauseHandle(SoundHandle handle, bool paused) {
 	Common::StackLock lock(_mutex);
 
 	// Simply ignore (un)pause requests for sounds that already terminated
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	const int index = findSlot(handle);
+	if (index == -1)
 		return;
 
-	_channels[index]->pause(paused);
+	pushCommand(kCommandPauseChannel, index, paused);
 }
 
 bool MixerImpl::isSoundIDActive(int id) {
@@ -435,16 +704,16 @@ bool MixerImpl::isSoundIDActive(int id) {
 #endif
 
 	for (int i = 0; i != NUM_CHANNELS; i++)
-		if (_channels[i] && _channels[i]->getId() == id)
+		if (isSlotActive(i) && _slots[i].id == id)
 			return true;
 	return false;
 }
 
 int MixerImpl::getSoundID(SoundHandle handle) {
 	Common::StackLock lock(_mutex);
-	const int index = handle._val % NUM_CHANNELS;
-	if (_channels[index] && _channels[index]->getHandle()._val == handle._val)
-		return _channels[index]->getId();
+	const int index = findSlot(handle);
+	if (index != -1)
+		return _slots[index].id;
 	return 0;
 }
 
@@ -455,14 +724,13 @@ bool MixerImpl::isSoundHandleActive(SoundHandle handle) {
 	g_eventRec.updateSubsystems();
 #endif
 
-	const int index = handle._val % NUM_CHANNELS;
-	return _channels[index] && _channels[index]->getHandle()._val == handle._val;
+	return findSlot(handle) != -1;
 }
 
 bool MixerImpl::hasActiveChannelOfType(SoundType type) {
 	Common::StackLock lock(_mutex);
 	for (int i = 0; i != NUM_CHANNELS; i++)
-		if (_channels[i] && _channels[i]->getType() == type)
+		if (isSlotActive(i) && _slots[i].type == type)
 			return true;
 	return false;
 }
@@ -481,11 +749,7 @@ void MixerImpl::setVolumeForSoundType(SoundType type, int volume) {
 
 	Common::StackLock lock(_mutex);
 	_soundTypeSettings[type].volume = volume;
-
-	for (int i = 0; i != NUM_CHANNELS; ++i) {
-		if (_channels[i] && _channels[i]->getType() == type)
-			_channels[i]->notifyGlobalVolChange();
-	}
+	pushCommand(kCommandUpdateVolumes, -1, type);
 }
 
 int MixerImpl::getVolumeForSoundType(SoundType type) const {
@@ -500,7 +764,7 @@ int MixerImpl::getVolumeForSoundType(SoundType type) const {
 #pragma mark -
 
 Channel::Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream,
-                 DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent)
+                 DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent, RateConverterType converterType)
     : _type(type), _mixer(mixer), _id(id), _permanent(permanent), _volume(Mixer::kMaxChannelVolume),
       _balance(0), _pauseLevel(0), _samplesConsumed(0), _samplesDecoded(0), _mixerTimeStamp(0),
       _pauseStartTime(0), _pauseTime(0), _converter(0), _volL(0), _volR(0),
@@ -509,7 +773,7 @@ Channel::Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream,
 	assert(stream);
 
 	// Get a rate converter instance
-	_converter = makeRateConverter(_stream->getRate(), mixer->getOutputRate(), _stream->isStereo(), reverseStereo);
+	_converter = makeRateConverter(_stream->getRate(), mixer->getOutputRate(), _stream->isStereo(), reverseStereo, converterType);
 }
 
 Channel::~Channel() {
@@ -561,52 +825,24 @@ void Channel::updateChannelVolumes() {
 	}
 }
 
-void Channel::pause(bool paused) {
+void Channel::pause(bool paused, uint32 time) {
 	//assert((paused && _pauseLevel >= 0) || (!paused && _pauseLevel));
 
 	if (paused) {
 		_pauseLevel++;
 
 		if (_pauseLevel == 1)
-			_pauseStartTime = g_system->getMillis(true);
+			_pauseStartTime = time;
 	} else if (_pauseLevel > 0) {
 		_pauseLevel--;
 
 		if (!_pauseLevel) {
-			_pauseTime = (g_system->getMillis(true) - _pauseStartTime);
+			_pauseTime = (time - _pauseStartTime);
 			_pauseStartTime = 0;
 		}
 	}
 }
 
-Timestamp Channel::getElapsedTime() {
-	const uint32 rate = _mixer->getOutputRate();
-	uint32 delta = 0;
-
-	Audio::Timestamp ts(0, rate);
-
-	if (_mixerTimeStamp == 0)
-		return ts;
-
-	if (isPaused())
-		delta = _pauseStartTime - _mixerTimeStamp;
-	else
-		delta = g_system->getMillis(true) - _mixerTimeStamp - _pauseTime;
-
-	// Convert the number of samples into a time duration.
-
-	ts = ts.addFrames(_samplesConsumed);
-	ts = ts.addMsecs(delta);
-
-	// In theory it would seem like a good idea to limit the approximation
-	// so that it never exceeds the theoretical upper bound set by
-	// _samplesDecoded. Meanwhile, back in the real world, doing so makes
-	// the Broken Sword cutscenes noticeably jerkier. I guess the mixer
-	// isn't invoked at the regular intervals that I first imagined.
-
-	return ts;
-}
-
 int Channel::mix(int16 *data, uint len) {
 	assert(_stream);
 
@@ -26,6 +26,8 @@
 #include "common/types.h"
 #include "common/noncopyable.h"
 
+#include "audio/rate.h"
+
 namespace Audio {
 
 class AudioStream;
@@ -277,6 +279,15 @@ public:
 	 * @return the output sample rate in Hz
 	 */
 	virtual uint getOutputRate() const = 0;
+
+	/**
+	 * Set the sample rate converter used for the streams played from now
+	 * on. The mixer starts with the one selected by the "resampler" config
+	 * key, call this when the key changes.
+	 *
+	 * @param type the converter type
+	 */
+	virtual void setRateConverterType(RateConverterType type) = 0;
 };
 
 
@@ -51,9 +51,15 @@ namespace Audio {
 class MixerImpl : public Mixer {
 private:
 	enum {
-		NUM_CHANNELS = 16
+		NUM_CHANNELS = 16,
+		COMMAND_QUEUE_SIZE = 256
 	};
 
+	/**
+	 * Serializes the engine side of the mixer API. It is never taken by the
+	 * audio thread, which only communicates with the engine side through the
+	 * command queue and the channel status snapshots below.
+	 */
 	Common::Mutex _mutex;
 
 	const uint _sampleRate;
@@ -68,8 +74,86 @@ private:
 	};
 
 	SoundTypeSettings _soundTypeSettings[4];
-	Channel *_channels[NUM_CHANNELS];
 
+	/** Converter for new channels, only accessed with _mutex held */
+	RateConverterType _converterType;
+
+	/**
+	 * Engine side view of a channel slot. Only accessed with _mutex held.
+	 */
+	struct SlotInfo {
+		SlotInfo() : handle(0xFFFFFFFF), id(-1), type(kPlainSoundType), permanent(false), volume(kMaxChannelVolume), balance(0) {}
+
+		uint32 handle;
+		int id;
+		SoundType type;
+		bool permanent;
+		byte volume;
+		int8 balance;
+	};
+
+	SlotInfo _slots[NUM_CHANNELS];
+
+	/**
+	 * Snapshot of a channel's state, published by the audio thread. The
+	 * sequence counter is odd while the snapshot is being updated, so
+	 * readers can detect and retry torn reads without taking a lock.
+	 */
+	struct ChannelStatus {
+		ChannelStatus() : sequence(0), handle(0xFFFFFFFF), active(0), paused(0),
+			samplesConsumed(0), mixerTimeStamp(0), pauseStartTime(0), pauseTime(0) {}
+
+		volatile uint32 sequence;
+		volatile uint32 handle;
+		volatile uint32 active;
+		volatile uint32 paused;
+		volatile uint32 samplesConsumed;
+		volatile uint32 mixerTimeStamp;
+		volatile uint32 pauseStartTime;
+		volatile uint32 pauseTime;
+	};
+
+	ChannelStatus _status[NUM_CHANNELS];
+
+	enum CommandType {
+		kCommandAddChannel,
+		kCommandPauseChannel,
+		kCommandSetVolume,
+		kCommandSetBalance,
+		kCommandUpdateVolumes
+	};
+
+	/**
+	 * A control operation queued by the engine side, to be applied by the
+	 * audio thread before it mixes the next buffer.
+	 */
+	struct Command {
+		CommandType type;
+		int index;
+		uint32 handle;
+		Channel *channel;
+		int value;
+		uint32 time;
+	};
+
+	/**
+	 * Single producer, single consumer ring of pending commands. The engine
+	 * side (serialized by _mutex) is the producer, the audio thread is the
+	 * consumer.
+	 */
+	Command _commands[COMMAND_QUEUE_SIZE];
+	volatile uint32 _commandWritePos;
+	volatile uint32 _commandReadPos;
+
+	/**
+	 * Set while the channels are being mixed or modified. The engine side
+	 * only holds it briefly, to detach stopped channels and when the command
+	 * queue overflows, e.g. because audio output is suspended.
+	 */
+	volatile uint32 _channelsLocked;
+
+	/** The channels, owned by whoever holds _channelsLocked. */
+	Channel *_channels[NUM_CHANNELS];
 
 public:
 
@@ -118,8 +202,53 @@ public:
 
 	virtual uint getOutputRate() const;
 
+	virtual void setRateConverterType(RateConverterType type);
+
 protected:
-	void insertChannel(SoundHandle *handle, Channel *chan);
+	void insertChannel(SoundHandle *handle, Channel *chan, SoundType type, int id, bool permanent, byte volume, int8 balance);
+
+private:
+	/**
+	 * Returns the slot index of the given handle, or -1 if the handle does
+	 * not refer to an active channel. Must be called with _mutex held.
+	 */
+	int findSlot(SoundHandle handle);
+
+	/**
+	 * Checks whether the given slot holds an active channel, releasing the
+	 * slot if the audio thread reported that its channel has finished. Must
+	 * be called with _mutex held.
+	 */
+	bool isSlotActive(int index);
+
+	/** Queues a command for the audio thread. Must be called with _mutex held. */
+	void pushCommand(CommandType type, int index, int value = 0, Channel *channel = 0);
+
+	/**
+	 * Acquires _channelsLocked from the engine side, waiting for the audio
+	 * thread to finish mixing, and applies all queued commands. Must be
+	 * called with _mutex held.
+	 */
+	void lockChannels();
+	void unlockChannels();
+
+	/**
+	 * Removes the channel of a slot from the mix and releases the slot.
+	 * Returns the channel, which the caller must delete once it released
+	 * _channelsLocked, or 0 if the slot holds no channel. Must be called
+	 * with _mutex held and _channelsLocked set.
+	 */
+	Channel *detachSlot(int index);
+
+	/** Applies all queued commands. Must be called with _channelsLocked set. */
+	void processCommands();
+	void applyCommand(const Command &cmd);
+
+	/** Updates the status snapshot of a slot. Must be called with _channelsLocked set. */
+	void publishStatus(int index);
+
+	/** Reads a consistent copy of a slot's status snapshot. */
+	void readStatus(int index, ChannelStatus &status) const;
 
 public:
 	/**
@@ -16,6 +16,7 @@ MODULE_OBJS := \
 	mpu401.o \
 	musicplugin.o \
 	null.o \
+	rate_kernels.o \
 	timestamp.o \
 	decoders/3do.o \
 	decoders/aac.o \
@@ -30,11 +30,14 @@
 
 #include "audio/audiostream.h"
 #include "audio/rate.h"
+#include "audio/rate_kernels.h"
 #include "audio/mixer.h"
 #include "common/frac.h"
 #include "common/textconsole.h"
 #include "common/util.h"
 
+#include <math.h>
+
 namespace Audio {
 
 
@@ -46,6 +49,27 @@ namespace Audio {
  */
 #define INTERMEDIATE_BUFFER_SIZE 512
 
+/**
+ * Mix a block of converted (but not yet volume adjusted) samples into the
+ * output buffer, using the fastest available mixing kernel.
+ *
+ * For stereo input, the staged samples must already be in output order,
+ * i.e. swapped if reverseStereo is set.
+ */
+template<bool stereo, bool reverseStereo>
+class StagedMixer {
+	MixProc _mix;
+public:
+	StagedMixer() : _mix(stereo ? getStereoMixProc() : getMonoMixProc()) {}
+
+	void mix(st_sample_t *obuf, const st_sample_t *staged, st_size_t frames, st_volume_t vol_l, st_volume_t vol_r) const {
+		if (reverseStereo)
+			_mix(obuf, staged, frames, vol_r, vol_l);
+		else
+			_mix(obuf, staged, frames, vol_l, vol_r);
+	}
+};
+
 /**
  * The default fractional type in frac.h (with 16 fractional bits) limits
  * the rate conversion code to 65536Hz audio: we need to able to handle
@@ -70,6 +94,10 @@ protected:
 	const st_sample_t *inPtr;
 	int inLen;
 
+	/** converted samples waiting to be mixed into the output buffer */
+	st_sample_t stageBuf[INTERMEDIATE_BUFFER_SIZE];
+	StagedMixer<stereo, reverseStereo> stageMixer;
+
 	/** position of how far output is ahead of input */
 	/** Holds what would have been opos-ipos */
 	long opos;
@@ -119,37 +147,56 @@ int SimpleRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_samp
 	oend = obuf + osamp * 2;
 
 	while (obuf < oend) {
+		const st_size_t maxFrames = MIN<st_size_t>((oend - obuf) / 2, ARRAYSIZE(stageBuf) / 2);
+		st_sample_t *stagePtr = stageBuf;
+		st_size_t frames = 0;
+		bool endOfInput = false;
+
+		while (frames < maxFrames && !endOfInput) {
+			// read enough input samples so that opos >= 0
+			do {
+				// Check if we have to refill the buffer
+				if (inLen == 0) {
+					inPtr = inBuf;
+					inLen = input.readBuffer(inBuf, ARRAYSIZE(inBuf));
+					if (inLen <= 0) {
+						endOfInput = true;
+						break;
+					}
+				}
+				inLen -= (stereo ? 2 : 1);
+				opos--;
+				if (opos >= 0) {
+					inPtr += (stereo ? 2 : 1);
+				}
+			} while (opos >= 0);
+
+			if (endOfInput)
+				break;
 
-		// read enough input samples so that opos >= 0
-		do {
-			// Check if we have to refill the buffer
-			if (inLen == 0) {
-				inPtr = inBuf;
-				inLen = input.readBuffer(inBuf, ARRAYSIZE(inBuf));
-				if (inLen <= 0)
-					return (obuf - ostart) / 2;
-			}
-			inLen -= (stereo ? 2 : 1);
-			opos--;
-			if (opos >= 0) {
-				inPtr += (stereo ? 2 : 1);
-			}
-		} while (opos >= 0);
-
-		st_sample_t out0, out1;
-		out0 = *inPtr++;
-		out1 = (stereo ? *inPtr++ : out0);
+			st_sample_t out0, out1;
+			out0 = *inPtr++;
+			out1 = (stereo ? *inPtr++ : out0);
 
-		// Increment output position
-		opos += opos_inc;
+			// Increment output position
+			opos += opos_inc;
 
-		// output left channel
-		clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
+			// stage the converted frame for mixing
+			if (stereo) {
+				stagePtr[reverseStereo    ] = out0;
+				stagePtr[reverseStereo ^ 1] = out1;
+				stagePtr += 2;
+			} else {
+				*stagePtr++ = out0;
+			}
+			frames++;
+		}
 
-		// output right channel
-		clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
+		stageMixer.mix(obuf, stageBuf, frames, vol_l, vol_r);
+		obuf += frames * 2;
 
-		obuf += 2;
+		if (endOfInput)
+			break;
 	}
 	return (obuf - ostart) / 2;
 }
@@ -183,6 +230,10 @@ protected:
 	/** current sample(s) in the input stream (left/right channel) */
 	st_sample_t icur0, icur1;
 
+	/** converted samples waiting to be mixed into the output buffer */
+	st_sample_t stageBuf[INTERMEDIATE_BUFFER_SIZE];
+	StagedMixer<stereo, reverseStereo> stageMixer;
+
 public:
 	LinearRateConverter(st_rate_t inrate, st_rate_t outrate);
 	int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r);
@@ -228,47 +279,66 @@ int LinearRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_samp
 	oend = obuf + osamp * 2;
 
 	while (obuf < oend) {
-
-		// read enough input samples so that opos < 0
-		while ((frac_t)FRAC_ONE_LOW <= opos) {
-			// Check if we have to refill the buffer
-			if (inLen == 0) {
-				inPtr = inBuf;
-				inLen = input.readBuffer(inBuf, ARRAYSIZE(inBuf));
-				if (inLen <= 0)
-					return (obuf - ostart) / 2;
+		const st_size_t maxFrames = MIN<st_size_t>((oend - obuf) / 2, ARRAYSIZE(stageBuf) / 2);
+		st_sample_t *stagePtr = stageBuf;
+		st_size_t frames = 0;
+		bool endOfInput = false;
+
+		while (frames < maxFrames) {
+			// read enough input samples so that opos < 0
+			while ((frac_t)FRAC_ONE_LOW <= opos) {
+				// Check if we have to refill the buffer
+				if (inLen == 0) {
+					inPtr = inBuf;
+					inLen = input.readBuffer(inBuf, ARRAYSIZE(inBuf));
+					if (inLen <= 0) {
+						endOfInput = true;
+						break;
+					}
+				}
+				inLen -= (stereo ? 2 : 1);
+				ilast0 = icur0;
+				icur0 = *inPtr++;
+				if (stereo) {
+					ilast1 = icur1;
+					icur1 = *inPtr++;
+				}
+				opos -= FRAC_ONE_LOW;
 			}
-			inLen -= (stereo ? 2 : 1);
-			ilast0 = icur0;
-			icur0 = *inPtr++;
-			if (stereo) {
-				ilast1 = icur1;
-				icur1 = *inPtr++;
+
+			if (endOfInput)
+				break;
+
+			// Loop as long as the outpos trails behind, and as long as there is
+			// still space in the staging buffer.
+			while (opos < (frac_t)FRAC_ONE_LOW && frames < maxFrames) {
+				// interpolate
+				st_sample_t out0, out1;
+				out0 = (st_sample_t)(ilast0 + (((icur0 - ilast0) * opos + FRAC_HALF_LOW) >> FRAC_BITS_LOW));
+				out1 = (stereo ?
+							  (st_sample_t)(ilast1 + (((icur1 - ilast1) * opos + FRAC_HALF_LOW) >> FRAC_BITS_LOW)) :
+							  out0);
+
+				// stage the converted frame for mixing
+				if (stereo) {
+					stagePtr[reverseStereo    ] = out0;
+					stagePtr[reverseStereo ^ 1] = out1;
+					stagePtr += 2;
+				} else {
+					*stagePtr++ = out0;
+				}
+				frames++;
+
+				// Increment output position
+				opos += opos_inc;
 			}
-			opos -= FRAC_ONE_LOW;
 		}
 
-		// Loop as long as the outpos trails behind, and as long as there is
-		// still space in the output buffer.
-		while (opos < (frac_t)FRAC_ONE_LOW && obuf < oend) {
-			// interpolate
-			st_sample_t out0, out1;
-			out0 = (st_sample_t)(ilast0 + (((icur0 - ilast0) * opos + FRAC_HALF_LOW) >> FRAC_BITS_LOW));
-			out1 = (stereo ?
-						  (st_sample_t)(ilast1 + (((icur1 - ilast1) * opos + FRAC_HALF_LOW) >> FRAC_BITS_LOW)) :
-						  out0);
-
-			// output left channel
-			clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
-
-			// output right channel
-			clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
+		stageMixer.mix(obuf, stageBuf, frames, vol_l, vol_r);
+		obuf += frames * 2;
 
-			obuf += 2;
-
-			// Increment output position
-			opos += opos_inc;
-		}
+		if (endOfInput)
+			break;
 	}
 	return (obuf - ostart) / 2;
 }
@@ -284,6 +354,7 @@ template<bool stereo, bool reverseStereo>
 class CopyRateConverter : public RateConverter {
 	st_sample_t *_buffer;
 	st_size_t _bufferSize;
+	StagedMixer<stereo, reverseStereo> _stageMixer;
 public:
 	CopyRateConverter() : _buffer(0), _bufferSize(0) {}
 	~CopyRateConverter() {
@@ -315,20 +386,16 @@ public:
 		len = input.readBuffer(_buffer, osamp);
 
 		// Mix the data into the output buffer
-		ptr = _buffer;
-		for (; len > 0; len -= (stereo ? 2 : 1)) {
-			st_sample_t out0, out1;
-			out0 = *ptr++;
-			out1 = (stereo ? *ptr++ : out0);
-
-			// output left channel
-			clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
+		if (stereo && reverseStereo) {
+			ptr = _buffer;
+			for (st_size_t i = 0; i < len; i += 2, ptr += 2)
+				SWAP(ptr[0], ptr[1]);
+		}
 
-			// output right channel
-			clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
+		const st_size_t frames = (stereo ? len / 2 : len);
+		_stageMixer.mix(obuf, _buffer, frames, vol_l, vol_r);
+		obuf += frames * 2;
 
-			obuf += 2;
-		}
 		return (obuf - ostart) / 2;
 	}
 
@@ -338,12 +405,248 @@ public:
 };
 
 
+#pragma mark -
+
+
+enum {
+	/** number of filter phases, i.e. the resolution of the output position */
+	SINC_PHASE_BITS = 8,
+	SINC_PHASES = (1 << SINC_PHASE_BITS),
+	/** fixed point precision of the filter coefficients */
+	SINC_COEF_BITS = 14
+};
+
+/**
+ * Zeroth order modified Bessel function of the first kind, needed for the
+ * Kaiser window.
+ */
+static double besselI0(double x) {
+	double sum = 1.0, term = 1.0;
+	for (int k = 1; k < 32; ++k) {
+		term *= (x / (2.0 * k)) * (x / (2.0 * k));
+		sum += term;
+		if (term < sum * 1e-12)
+			break;
+	}
+	return sum;
+}
+
+/**
+ * Audio rate converter based on a polyphase windowed sinc filter.
+ *
+ * The filter coefficients for SINC_PHASES fractional positions are
+ * precomputed when the converter is created; each output sample is then a
+ * single SINC_TAPS wide dot product, done by the fastest available FIR
+ * kernel. When downsampling, the cutoff frequency is lowered to the output
+ * Nyquist frequency, so this also acts as anti-aliasing filter.
+ *
+ * Limited to sampling frequency <= 131071 Hz.
+ */
+template<bool stereo, bool reverseStereo>
+class SincRateConverter : public RateConverter {
+protected:
+	enum {
+		HISTORY_SIZE = SINC_TAPS + INTERMEDIATE_BUFFER_SIZE
+	};
+
+	st_sample_t inBuf[INTERMEDIATE_BUFFER_SIZE];
+
+	/** deinterleaved input samples, per channel */
+	st_sample_t history[stereo ? 2 : 1][HISTORY_SIZE];
+	/** number of valid frames in history */
+	int historyLen;
+	/** index of the first filter tap in history */
+	int ipos;
+
+	/** fractional part of the current input position */
+	frac_t opos;
+
+	/** fractional position increment in the output stream */
+	frac_t opos_inc;
+
+	/** filter coefficients, SINC_TAPS per phase */
+	int16 coefs[SINC_PHASES * SINC_TAPS];
+	FirProc fir;
+
+	/** converted samples waiting to be mixed into the output buffer */
+	st_sample_t stageBuf[INTERMEDIATE_BUFFER_SIZE];
+	StagedMixer<stereo, reverseStereo> stageMixer;
+
+	bool refill(AudioStream &input);
+
+	st_sample_t filter(const st_sample_t *samples, const int16 *phaseCoefs) const {
+		const int32 sum = (fir(samples, phaseCoefs) + (1 << (SINC_COEF_BITS - 1))) >> SINC_COEF_BITS;
+		return (st_sample_t)CLIP<int32>(sum, ST_SAMPLE_MIN, ST_SAMPLE_MAX);
+	}
+
+public:
+	SincRateConverter(st_rate_t inrate, st_rate_t outrate);
+	int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r);
+	int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) {
+		return ST_SUCCESS;
+	}
+};
+
+template<bool stereo, bool reverseStereo>
+SincRateConverter<stereo, reverseStereo>::SincRateConverter(st_rate_t inrate, st_rate_t outrate) {
+	if (inrate >= 131072 || outrate >= 131072) {
+		error("rate effect can only handle rates < 131072");
+	}
+
+	opos = 0;
+	opos_inc = (inrate << FRAC_BITS_LOW) / outrate;
+
+	// Start with silence, so that the first output sample is centered on
+	// the first input sample.
+	memset(history, 0, sizeof(history));
+	historyLen = SINC_TAPS / 2 - 1;
+	ipos = 0;
+
+	fir = getFirProc();
+
+	// Keep some headroom below the Nyquist frequency of the lower rate, as
+	// the short filter has a rather wide transition band.
+	const double cutoff = 0.9 * MIN<double>(1.0, (double)outrate / inrate);
+	const double beta = 6.0;
+	const double halfWidth = SINC_TAPS / 2;
+
+	for (int phase = 0; phase < SINC_PHASES; ++phase) {
+		double taps[SINC_TAPS];
+		double sum = 0.0;
+
+		for (int k = 0; k < SINC_TAPS; ++k) {
+			// Distance of the tap from the interpolated position
+			const double t = (k - (SINC_TAPS / 2 - 1)) - (double)phase / SINC_PHASES;
+			const double x = M_PI * cutoff * t;
+			const double sinc = (fabs(x) < 1e-9) ? 1.0 : sin(x) / x;
+			const double w = t / halfWidth;
+			const double window = (fabs(w) >= 1.0) ? 0.0 : besselI0(beta * sqrt(1.0 - w * w)) / besselI0(beta);
+
+			taps[k] = sinc * window;
+			sum += taps[k];
+		}
+
+		// Normalize to unity gain and quantize. Any rounding error is moved
+		// into the largest tap, so that DC passes through unchanged.
+		int16 *phaseCoefs = coefs + phase * SINC_TAPS;
+		int total = 0, largest = 0;
+		for (int k = 0; k < SINC_TAPS; ++k) {
+			phaseCoefs[k] = (int16)floor(taps[k] / sum * (1 << SINC_COEF_BITS) + 0.5);
+			total += phaseCoefs[k];
+			if (phaseCoefs[k] > phaseCoefs[largest])
+				largest = k;
+		}
+		phaseCoefs[largest] += (1 << SINC_COEF_BITS) - total;
+	}
+}
+
+/*
+ * Read the next block of input samples into the history buffer, keeping
+ * the samples still needed by the filter.
+ * Return false at the end of the input.
+ */
+template<bool stereo, bool reverseStereo>
+bool SincRateConverter<stereo, reverseStereo>::refill(AudioStream &input) {
+	const int keep = historyLen - ipos;
+	if (keep > 0) {
+		for (int c = 0; c < (stereo ? 2 : 1); ++c)
+			memmove(history[c], history[c] + ipos, keep * sizeof(st_sample_t));
+		historyLen = keep;
+		ipos = 0;
+	} else {
+		// When downsampling, the filter may have moved past the end of the
+		// history; the samples in between are skipped.
+		historyLen = 0;
+		ipos = -keep;
+	}
+
+	const int len = input.readBuffer(inBuf, ARRAYSIZE(inBuf));
+	if (len <= 0)
+		return false;
+
+	const st_sample_t *inPtr = inBuf;
+	if (stereo) {
+		for (int i = 0; i < len / 2; ++i) {
+			history[0][historyLen + i] = *inPtr++;
+			history[stereo ? 1 : 0][historyLen + i] = *inPtr++;
+		}
+		historyLen += len / 2;
+	} else {
+		memcpy(history[0] + historyLen, inBuf, len * sizeof(st_sample_t));
+		historyLen += len;
+	}
+
+	return true;
+}
+
+/*
+ * Processed signed long samples from ibuf to obuf.
+ * Return number of sample pairs processed.
+ */
+template<bool stereo, bool reverseStereo>
+int SincRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+	st_sample_t *ostart, *oend;
+
+	ostart = obuf;
+	oend = obuf + osamp * 2;
+
+	while (obuf < oend) {
+		const st_size_t maxFrames = MIN<st_size_t>((oend - obuf) / 2, ARRAYSIZE(stageBuf) / 2);
+		st_sample_t *stagePtr = stageBuf;
+		st_size_t frames = 0;
+		bool endOfInput = false;
+
+		while (frames < maxFrames) {
+			// make sure all filter taps are available
+			while (ipos + SINC_TAPS > historyLen) {
+				if (!refill(input)) {
+					endOfInput = true;
+					break;
+				}
+			}
+
+			if (endOfInput)
+				break;
+
+			const int16 *phaseCoefs = coefs + (opos >> (FRAC_BITS_LOW - SINC_PHASE_BITS)) * SINC_TAPS;
+			st_sample_t out0, out1;
+			out0 = filter(history[0] + ipos, phaseCoefs);
+			out1 = (stereo ? filter(history[stereo ? 1 : 0] + ipos, phaseCoefs) : out0);
+
+			// stage the converted frame for mixing
+			if (stereo) {
+				stagePtr[reverseStereo    ] = out0;
+				stagePtr[reverseStereo ^ 1] = out1;
+				stagePtr += 2;
+			} else {
+				*stagePtr++ = out0;
+			}
+			frames++;
+
+			// Increment output position
+			opos += opos_inc;
+			ipos += opos >> FRAC_BITS_LOW;
+			opos &= FRAC_ONE_LOW - 1;
+		}
+
+		stageMixer.mix(obuf, stageBuf, frames, vol_l, vol_r);
+		obuf += frames * 2;
+
+		if (endOfInput)
+			break;
+	}
+	return (obuf - ostart) / 2;
+}
+
+
 #pragma mark -
 
 template<bool stereo, bool reverseStereo>
-RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate) {
+RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, RateConverterType type) {
 	if (inrate != outrate) {
-		if ((inrate % outrate) == 0 && (inrate < 65536)) {
+		if (type == kRateConverterSinc) {
+			return new SincRateConverter<stereo, reverseStereo>(inrate, outrate);
+		} else if ((inrate % outrate) == 0 && (inrate < 65536)) {
 			return new SimpleRateConverter<stereo, reverseStereo>(inrate, outrate);
 		} else {
 			return new LinearRateConverter<stereo, reverseStereo>(inrate, outrate);
@@ -356,14 +659,14 @@ RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate) {
 /**
  * Create and return a RateConverter object for the specified input and output rates.
  */
-RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo) {
+RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo, RateConverterType type) {
 	if (stereo) {
 		if (reverseStereo)
-			return makeRateConverter<true, true>(inrate, outrate);
+			return makeRateConverter<true, true>(inrate, outrate, type);
 		else
-			return makeRateConverter<true, false>(inrate, outrate);
+			return makeRateConverter<true, false>(inrate, outrate, type);
 	} else
-		return makeRateConverter<false, false>(inrate, outrate);
+		return makeRateConverter<false, false>(inrate, outrate, type);
 }
 
 } // End of namespace Audio
@@ -24,6 +24,7 @@
 #define AUDIO_RATE_H
 
 #include "common/scummsys.h"
+#include "common/str.h"
 
 namespace Audio {
 
@@ -78,7 +79,28 @@ public:
 	virtual int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) = 0;
 };
 
-RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo = false);
+/**
+ * The algorithms available for converting between different sample rates.
+ */
+enum RateConverterType {
+	/** Nearest neighbour or linear interpolation, depending on the rates */
+	kRateConverterDefault,
+	/** Polyphase windowed sinc filter; higher quality, but more expensive */
+	kRateConverterSinc
+};
+
+/**
+ * Look up the converter type matching a name as used by the "resampler"
+ * config key ("default" or "sinc"). Unknown names map to
+ * kRateConverterDefault.
+ */
+inline RateConverterType parseRateConverterType(const char *name) {
+	if (!scumm_stricmp(name, "sinc"))
+		return kRateConverterSinc;
+	return kRateConverterDefault;
+}
+
+RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo = false, RateConverterType type = kRateConverterDefault);
 
 } // End of namespace Audio
 
@@ -0,0 +1,306 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "audio/rate_kernels.h"
+#include "audio/mixer.h"
+#include "common/cpudetect.h"
+
+#ifdef SCUMMVM_SIMD_X86
+#include <emmintrin.h>
+#include <immintrin.h>
+#endif
+
+#ifdef SCUMMVM_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+namespace Audio {
+
+void mixStereoC(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t frames, st_volume_t vol_l, st_volume_t vol_r) {
+	for (; frames > 0; --frames) {
+		clampedAdd(obuf[0], (ibuf[0] * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
+		clampedAdd(obuf[1], (ibuf[1] * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
+		ibuf += 2;
+		obuf += 2;
+	}
+}
+
+void mixMonoC(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t frames, st_volume_t vol_l, st_volume_t vol_r) {
+	for (; frames > 0; --frames) {
+		clampedAdd(obuf[0], (*ibuf * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
+		clampedAdd(obuf[1], (*ibuf * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
+		ibuf++;
+		obuf += 2;
+	}
+}
+
+// The vectorized kernels below depend on Mixer::kMaxMixerVolume being 256,
+// so that the volume scaling can be done with a multiply and a shift. The
+// shift is preceded by a bias of 255 for negative products, which makes it
+// round towards zero just like the integer division in the C kernels. The
+// scaled value always fits into 16 bits, so the remaining clamping is done
+// by a saturating add.
+//
+// With OUTPUT_UNSIGNED_AUDIO the output buffer is stored with a flipped sign
+// bit and only the C kernels are used.
+
+#if defined(SCUMMVM_SIMD_X86) && !defined(OUTPUT_UNSIGNED_AUDIO)
+
+__attribute__((target("sse2")))
+static inline __m128i scaleSSE2(__m128i in, __m128i vol) {
+	const __m128i lo = _mm_mullo_epi16(in, vol);
+	const __m128i hi = _mm_mulhi_epi16(in, vol);
+	const __m128i bias = _mm_set1_epi32(Audio::Mixer::kMaxMixerVolume - 1);
+
+	__m128i p0 = _mm_unpacklo_epi16(lo, hi);
+	__m128i p1 = _mm_unpackhi_epi16(lo, hi);
+	p0 = _mm_srai_epi32(_mm_add_epi32(p0, _mm_and_si128(_mm_srai_epi32(p0, 31), bias)), 8);
+	p1 = _mm_srai_epi32(_mm_add_epi32(p1, _mm_and_si128(_mm_srai_epi32(p1, 31), bias)), 8);
+	return _mm_packs_epi32(p0, p1);
+}
+
+__attribute__((target("sse2")))
+static void mixStereoSSE2(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t frames, st_volume_t vol_l, st_volume_t vol_r) {
+	const __m128i vol = _mm_set_epi16(vol_r, vol_l, vol_r, vol_l, vol_r, vol_l, vol_r, vol_l);
+
+	for (; frames >= 4; frames -= 4) {
+		const __m128i in = _mm_loadu_si128((const __m128i *)ibuf);
+		const __m128i out = _mm_loadu_si128((const __m128i *)obuf);
+		_mm_storeu_si128((__m128i *)obuf, _mm_adds_epi16(out, scaleSSE2(in, vol)));
+		ibuf += 8;
+		obuf += 8;
+	}
+
+	mixStereoC(obuf, ibuf, frames, vol_l, vol_r);
+}
+
+__attribute__((target("sse2")))
+static void mixMonoSSE2(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t frames, st_volume_t vol_l, st_volume_t vol_r) {
+	const __m128i vol = _mm_set_epi16(vol_r, vol_l, vol_r, vol_l, vol_r, vol_l, vol_r, vol_l);
+
+	for (; frames >= 4; frames -= 4) {
+		const __m128i mono = _mm_loadl_epi64((const __m128i *)ibuf);
+		const __m128i in = _mm_unpacklo_epi16(mono, mono);
+		const __m128i out = _mm_loadu_si128((const __m128i *)obuf);
+		_mm_storeu_si128((__m128i *)obuf, _mm_adds_epi16(out, scaleSSE2(in, vol)));
+		ibuf += 4;
+		obuf += 8;
+	}
+
+	mixMonoC(obuf, ibuf, frames, vol_l, vol_r);
+}
+
+__attribute__((target("avx2")))
+static inline __m256i scaleAVX2(__m256i in, __m256i vol) {
+	const __m256i lo = _mm256_mullo_epi16(in, vol);
+	const __m256i hi = _mm256_mulhi_epi16(in, vol);
+	const __m256i bias = _mm256_set1_epi32(Audio::Mixer::kMaxMixerVolume - 1);
+
+	// unpack and pack both operate on 128 bit lanes, so the sample order
+	// is preserved.
+	__m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+	__m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+	p0 = _mm256_srai_epi32(_mm256_add_epi32(p0, _mm256_and_si256(_mm256_srai_epi32(p0, 31), bias)), 8);
+	p1 = _mm256_srai_epi32(_mm256_add_epi32(p1, _mm256_and_si256(_mm256_srai_epi32(p1, 31), bias)), 8);
+	return _mm256_packs_epi32(p0, p1);
+}
+
+__attribute__((target("avx2")))
+static void mixStereoAVX2(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t frames, st_volume_t vol_l, st_volume_t vol_r) {
+	const __m256i vol = _mm256_set_epi16(vol_r, vol_l, vol_r, vol_l, vol_r, vol_l, vol_r, vol_l,
+	                                     vol_r, vol_l, vol_r, vol_l, vol_r, vol_l, vol_r, vol_l);
+
+	for (; frames >= 8; frames -= 8) {
+		const __m256i in = _mm256_loadu_si256((const __m256i *)ibuf);
+		const __m256i out = _mm256_loadu_si256((const __m256i *)obuf);
+		_mm256_storeu_si256((__m256i *)obuf, _mm256_adds_epi16(out, scaleAVX2(in, vol)));
+		ibuf += 16;
+		obuf += 16;
+	}
+
+	mixStereoSSE2(obuf, ibuf, frames, vol_l, vol_r);
+}
+
+__attribute__((target("avx2")))
+static void mixMonoAVX2(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t frames, st_volume_t vol_l, st_volume_t vol_r) {
+	const __m256i vol = _mm256_set_epi16(vol_r, vol_l, vol_r, vol_l, vol_r, vol_l, vol_r, vol_l,
+	                                     vol_r, vol_l, vol_r, vol_l, vol_r, vol_l, vol_r, vol_l);
+
+	for (; frames >= 8; frames -= 8) {
+		const __m128i mono = _mm_loadu_si128((const __m128i *)ibuf);
+		const __m256i in = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_unpacklo_epi16(mono, mono)),
+		                                           _mm_unpackhi_epi16(mono, mono), 1);
+		const __m256i out = _mm256_loadu_si256((const __m256i *)obuf);
+		_mm256_storeu_si256((__m256i *)obuf, _mm256_adds_epi16(out, scaleAVX2(in, vol)));
+		ibuf += 8;
+		obuf += 16;
+	}
+
+	mixMonoSSE2(obuf, ibuf, frames, vol_l, vol_r);
+}
+
+#endif // SCUMMVM_SIMD_X86
+
+#if defined(SCUMMVM_SIMD_NEON) && !defined(OUTPUT_UNSIGNED_AUDIO)
+
+static inline int16x4_t scaleNEON(int16x4_t in, int16x4_t vol) {
+	const int32x4_t bias = vdupq_n_s32(Audio::Mixer::kMaxMixerVolume - 1);
+	int32x4_t p = vmull_s16(in, vol);
+	p = vshrq_n_s32(vaddq_s32(p, vandq_s32(vshrq_n_s32(p, 31), bias)), 8);
+	return vmovn_s32(p);
+}
+
+static void mixStereoNEON(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t frames, st_volume_t vol_l, st_volume_t vol_r) {
+	const int16_t volArray[4] = { (int16_t)vol_l, (int16_t)vol_r, (int16_t)vol_l, (int16_t)vol_r };
+	const int16x4_t vol = vld1_s16(volArray);
+
+	for (; frames >= 4; frames -= 4) {
+		const int16x8_t in = vld1q_s16(ibuf);
+		const int16x8_t scaled = vcombine_s16(scaleNEON(vget_low_s16(in), vol), scaleNEON(vget_high_s16(in), vol));
+		vst1q_s16(obuf, vqaddq_s16(vld1q_s16(obuf), scaled));
+		ibuf += 8;
+		obuf += 8;
+	}
+
+	mixStereoC(obuf, ibuf, frames, vol_l, vol_r);
+}
+
+static void mixMonoNEON(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t frames, st_volume_t vol_l, st_volume_t vol_r) {
+	const int16_t volArray[4] = { (int16_t)vol_l, (int16_t)vol_r, (int16_t)vol_l, (int16_t)vol_r };
+	const int16x4_t vol = vld1_s16(volArray);
+
+	for (; frames >= 4; frames -= 4) {
+		const int16x4x2_t in = vzip_s16(vld1_s16(ibuf), vld1_s16(ibuf));
+		const int16x8_t scaled = vcombine_s16(scaleNEON(in.val[0], vol), scaleNEON(in.val[1], vol));
+		vst1q_s16(obuf, vqaddq_s16(vld1q_s16(obuf), scaled));
+		ibuf += 4;
+		obuf += 8;
+	}
+
+	mixMonoC(obuf, ibuf, frames, vol_l, vol_r);
+}
+
+#endif // SCUMMVM_SIMD_NEON
+
+int32 firC(const int16 *samples, const int16 *coefs) {
+	int32 sum = 0;
+	for (int i = 0; i < SINC_TAPS; ++i)
+		sum += samples[i] * coefs[i];
+	return sum;
+}
+
+#ifdef SCUMMVM_SIMD_X86
+
+__attribute__((target("sse2")))
+static int32 firSSE2(const int16 *samples, const int16 *coefs) {
+	__m128i sum = _mm_setzero_si128();
+
+	for (int i = 0; i < SINC_TAPS; i += 8) {
+		const __m128i s = _mm_loadu_si128((const __m128i *)(samples + i));
+		const __m128i c = _mm_loadu_si128((const __m128i *)(coefs + i));
+		sum = _mm_add_epi32(sum, _mm_madd_epi16(s, c));
+	}
+
+	sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+	sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_cvtsi128_si32(sum);
+}
+
+__attribute__((target("avx2")))
+static int32 firAVX2(const int16 *samples, const int16 *coefs) {
+	__m256i sum = _mm256_setzero_si256();
+
+	for (int i = 0; i < SINC_TAPS; i += 16) {
+		const __m256i s = _mm256_loadu_si256((const __m256i *)(samples + i));
+		const __m256i c = _mm256_loadu_si256((const __m256i *)(coefs + i));
+		sum = _mm256_add_epi32(sum, _mm256_madd_epi16(s, c));
+	}
+
+	__m128i sum128 = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+	sum128 = _mm_add_epi32(sum128, _mm_shuffle_epi32(sum128, _MM_SHUFFLE(1, 0, 3, 2)));
+	sum128 = _mm_add_epi32(sum128, _mm_shuffle_epi32(sum128, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_cvtsi128_si32(sum128);
+}
+
+#endif // SCUMMVM_SIMD_X86
+
+#ifdef SCUMMVM_SIMD_NEON
+
+static int32 firNEON(const int16 *samples, const int16 *coefs) {
+	int32x4_t sum = vdupq_n_s32(0);
+
+	for (int i = 0; i < SINC_TAPS; i += 8) {
+		const int16x8_t s = vld1q_s16(samples + i);
+		const int16x8_t c = vld1q_s16(coefs + i);
+		sum = vmlal_s16(sum, vget_low_s16(s), vget_low_s16(c));
+		sum = vmlal_s16(sum, vget_high_s16(s), vget_high_s16(c));
+	}
+
+	const int32x2_t sum2 = vadd_s32(vget_low_s32(sum), vget_high_s32(sum));
+	return vget_lane_s32(vpadd_s32(sum2, sum2), 0);
+}
+
+#endif // SCUMMVM_SIMD_NEON
+
+FirProc getFirProc() {
+#ifdef SCUMMVM_SIMD_X86
+	if (Common::hasCPUFeature(Common::kCPUFeatureAVX2))
+		return firAVX2;
+	if (Common::hasCPUFeature(Common::kCPUFeatureSSE2))
+		return firSSE2;
+#endif
+#ifdef SCUMMVM_SIMD_NEON
+	if (Common::hasCPUFeature(Common::kCPUFeatureNEON))
+		return firNEON;
+#endif
+	return firC;
+}
+
+MixProc getStereoMixProc() {
+#if defined(SCUMMVM_SIMD_X86) && !defined(OUTPUT_UNSIGNED_AUDIO)
+	if (Common::hasCPUFeature(Common::kCPUFeatureAVX2))
+		return mixStereoAVX2;
+	if (Common::hasCPUFeature(Common::kCPUFeatureSSE2))
+		return mixStereoSSE2;
+#endif
+#if defined(SCUMMVM_SIMD_NEON) && !defined(OUTPUT_UNSIGNED_AUDIO)
+	if (Common::hasCPUFeature(Common::kCPUFeatureNEON))
+		return mixStereoNEON;
+#endif
+	return mixStereoC;
+}
+
+MixProc getMonoMixProc() {
+#if defined(SCUMMVM_SIMD_X86) && !defined(OUTPUT_UNSIGNED_AUDIO)
+	if (Common::hasCPUFeature(Common::kCPUFeatureAVX2))
+		return mixMonoAVX2;
+	if (Common::hasCPUFeature(Common::kCPUFeatureSSE2))
+		return mixMonoSSE2;
+#endif
+#if defined(SCUMMVM_SIMD_NEON) && !defined(OUTPUT_UNSIGNED_AUDIO)
+	if (Common::hasCPUFeature(Common::kCPUFeatureNEON))
+		return mixMonoNEON;
+#endif
+	return mixMonoC;
+}
+
+} // End of namespace Audio
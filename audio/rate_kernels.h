@@ -0,0 +1,91 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef AUDIO_RATE_KERNELS_H
+#define AUDIO_RATE_KERNELS_H
+
+#include "audio/rate.h"
+
+namespace Audio {
+
+/**
+ * A mixing kernel scales the samples in ibuf by the given channel volumes
+ * (0 - Mixer::kMaxMixerVolume) and adds them to the interleaved stereo
+ * samples in obuf, clamping the result to the valid sample range.
+ *
+ * For stereo kernels, ibuf holds 'frames' interleaved left/right pairs. For
+ * mono kernels, ibuf holds 'frames' samples which are mixed into both the
+ * left and the right output channel.
+ *
+ * All kernels produce results which are bit identical to the plain C++
+ * implementations mixStereoC and mixMonoC.
+ */
+typedef void (*MixProc)(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t frames, st_volume_t vol_l, st_volume_t vol_r);
+
+/** Reference implementation of the stereo mixing kernel. */
+void mixStereoC(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t frames, st_volume_t vol_l, st_volume_t vol_r);
+
+/** Reference implementation of the mono mixing kernel. */
+void mixMonoC(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t frames, st_volume_t vol_l, st_volume_t vol_r);
+
+/**
+ * Return the fastest stereo mixing kernel supported by the host CPU.
+ * The choice is based on Common::getCPUFeatures().
+ */
+MixProc getStereoMixProc();
+
+/**
+ * Return the fastest mono mixing kernel supported by the host CPU.
+ * The choice is based on Common::getCPUFeatures().
+ */
+MixProc getMonoMixProc();
+
+/**
+ * Number of filter taps used per output sample by the windowed sinc
+ * resampler. Must be a multiple of 16 for the vectorized kernels.
+ */
+enum {
+	SINC_TAPS = 16
+};
+
+/**
+ * A FIR kernel computes the dot product of SINC_TAPS samples and filter
+ * coefficients. Neither pointer needs to be aligned.
+ *
+ * All kernels produce results which are bit identical to the plain C++
+ * implementation firC, as long as the sum of the absolute coefficient
+ * values stays within 1 << 16.
+ */
+typedef int32 (*FirProc)(const int16 *samples, const int16 *coefs);
+
+/** Reference implementation of the FIR kernel. */
+int32 firC(const int16 *samples, const int16 *coefs);
+
+/**
+ * Return the fastest FIR kernel supported by the host CPU.
+ * The choice is based on Common::getCPUFeatures().
+ */
+FirProc getFirProc();
+
+} // End of namespace Audio
+
+#endif
@@ -173,6 +173,17 @@ public:
 	 */
 	virtual bool isWritable() const = 0;
 
+	/**
+	 * Queries the size and the time of the last modification of the file
+	 * referred by this path, without opening it.
+	 *
+	 * The default implementation reports that the information is not
+	 * available; backends which can provide it cheaply should override it.
+	 *
+	 * @return bool true if size and lastModified were set, false otherwise.
+	 */
+	virtual bool getFileStats(uint32 &size, uint32 &lastModified) const { return false; }
+
 
 	/**
 	 * Creates a SeekableReadStream instance corresponding to the file
@@ -183,6 +194,17 @@ public:
 	 */
 	virtual Common::SeekableReadStream *createReadStream() = 0;
 
+	/**
+	 * Creates a SeekableReadStream instance corresponding to the file
+	 * referred by this node, like createReadStream(), but the file may be
+	 * mapped into memory. Only use this for files ScummVM does not write
+	 * to while it runs, such as game data: reading a mapping past the end
+	 * of a file truncated meanwhile crashes.
+	 *
+	 * @return pointer to the stream object, 0 in case of a failure
+	 */
+	virtual Common::SeekableReadStream *createMappedReadStream() { return createReadStream(); }
+
 	/**
 	 * Creates a WriteStream instance corresponding to the file
 	 * referred by this node. This assumes that the node actually refers
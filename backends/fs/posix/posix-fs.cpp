@@ -31,6 +31,7 @@
 #define FORBIDDEN_SYMBOL_EXCEPTION_exit		//Needed for IRIX's unistd.h
 
 #include "backends/fs/posix/posix-fs.h"
+#include "backends/fs/posix/posix-mmap-stream.h"
 #include "backends/fs/stdiostream.h"
 #include "common/algorithm.h"
 
@@ -105,6 +106,16 @@ POSIXFilesystemNode::POSIXFilesystemNode(const Common::String &p) {
 	setFlags();
 }
 
+bool POSIXFilesystemNode::getFileStats(uint32 &size, uint32 &lastModified) const {
+	struct stat st;
+	if (stat(_path.c_str(), &st) != 0 || S_ISDIR(st.st_mode))
+		return false;
+
+	size = (uint32)st.st_size;
+	lastModified = (uint32)st.st_mtime;
+	return true;
+}
+
 AbstractFSNode *POSIXFilesystemNode::getChild(const Common::String &n) const {
 	assert(!_path.empty());
 	assert(_isDirectory);
@@ -254,6 +265,22 @@ Common::SeekableReadStream *POSIXFilesystemNode::createReadStream() {
 	return StdioStream::makeFromPath(getPath(), false);
 }
 
+Common::SeekableReadStream *POSIXFilesystemNode::createMappedReadStream() {
+#if defined(POSIX) && defined(HAVE_MMAP)
+	// Map large files into memory. Random access into them then costs
+	// neither a system call nor a copy through the stdio buffer. Small
+	// files are cheaper to read with stdio than to map.
+	uint32 size, lastModified;
+	if (getFileStats(size, lastModified) && size >= kMinMappedFileSize) {
+		Common::SeekableReadStream *stream = PosixMmapStream::makeFromPath(getPath());
+		if (stream)
+			return stream;
+	}
+#endif
+
+	return createReadStream();
+}
+
 Common::WriteStream *POSIXFilesystemNode::createWriteStream() {
 	return StdioStream::makeFromPath(getPath(), true);
 }
@@ -37,6 +37,11 @@
  */
 class POSIXFilesystemNode : public AbstractFSNode {
 protected:
+	enum {
+		/** Files at least this large are memory mapped for reading. */
+		kMinMappedFileSize = 64 * 1024
+	};
+
 	Common::String _displayName;
 	Common::String _path;
 	bool _isDirectory;
@@ -66,12 +71,14 @@ public:
 	virtual bool isDirectory() const { return _isDirectory; }
 	virtual bool isReadable() const { return access(_path.c_str(), R_OK) == 0; }
 	virtual bool isWritable() const { return access(_path.c_str(), W_OK) == 0; }
+	virtual bool getFileStats(uint32 &size, uint32 &lastModified) const;
 
 	virtual AbstractFSNode *getChild(const Common::String &n) const;
 	virtual bool getChildren(AbstractFSList &list, ListMode mode, bool hidden) const;
 	virtual AbstractFSNode *getParent() const;
 
 	virtual Common::SeekableReadStream *createReadStream();
+	virtual Common::SeekableReadStream *createMappedReadStream();
 	virtual Common::WriteStream *createWriteStream();
 	virtual bool create(bool isDirectoryFlag);
 
@@ -0,0 +1,93 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+// Disable symbol overrides so that we can use open, close etc.
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include "backends/fs/posix/posix-mmap-stream.h"
+
+#if defined(POSIX) && defined(HAVE_MMAP)
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+PosixMmapStream *PosixMmapStream::makeFromPath(const Common::String &path) {
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+		return 0;
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size <= 0 || st.st_size > 0x7FFFFFFF) {
+		close(fd);
+		return 0;
+	}
+
+	void *data = mmap(0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+	// The mapping stays valid after the descriptor is closed
+	close(fd);
+
+	if (data == MAP_FAILED)
+		return 0;
+
+	return new PosixMmapStream(data, (uint32)st.st_size);
+}
+
+PosixMmapStream::PosixMmapStream(void *data, uint32 size)
+	: Common::MemoryReadStream((const byte *)data, size), _data(data), _mappedSize(size), _posPastEnd(-1) {
+}
+
+PosixMmapStream::~PosixMmapStream() {
+	munmap(_data, _mappedSize);
+}
+
+bool PosixMmapStream::seek(int32 offs, int whence) {
+	int64 target = offs;
+	if (whence == SEEK_CUR)
+		target += pos();
+	else if (whence == SEEK_END)
+		target += size();
+
+	if (target < 0 || target > 0x7FFFFFFF)
+		return false;
+
+	// Past the end, the underlying stream stays at the end of the file,
+	// where reads return no data and set the end of stream flag
+	if (target > size()) {
+		_posPastEnd = (int32)target;
+		return Common::MemoryReadStream::seek(0, SEEK_END);
+	}
+
+	_posPastEnd = -1;
+	return Common::MemoryReadStream::seek((int32)target, SEEK_SET);
+}
+
+int32 PosixMmapStream::pos() const {
+	if (_posPastEnd >= 0)
+		return _posPastEnd;
+
+	return Common::MemoryReadStream::pos();
+}
+
+#endif
@@ -0,0 +1,73 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef BACKENDS_FS_POSIX_MMAP_STREAM_H
+#define BACKENDS_FS_POSIX_MMAP_STREAM_H
+
+#include "common/scummsys.h"
+
+#if defined(POSIX) && defined(HAVE_MMAP)
+
+#include "common/memstream.h"
+#include "common/str.h"
+
+/**
+ * Read stream for a file mapped into memory with mmap().
+ *
+ * Reads are plain memory copies without any system call, and
+ * getMemory() gives direct access to the contents of the file.
+ *
+ * Note that the file must not be truncated while it is mapped, so only
+ * use this for game data and not for files ScummVM itself writes.
+ */
+class PosixMmapStream : public Common::MemoryReadStream {
+public:
+	/**
+	 * Given a path, maps the whole file into memory and wraps it in a
+	 * PosixMmapStream instance. Returns 0 if the file could not be mapped,
+	 * in which case the caller should fall back to regular file access.
+	 */
+	static PosixMmapStream *makeFromPath(const Common::String &path);
+
+	virtual ~PosixMmapStream();
+
+	/**
+	 * Seeks like StdioStream: positions past the end of the file may be
+	 * set, and reading from them returns no data and sets eos(). Only
+	 * negative positions fail.
+	 */
+	virtual bool seek(int32 offs, int whence = SEEK_SET);
+	virtual int32 pos() const;
+
+private:
+	PosixMmapStream(void *data, uint32 size);
+
+	void *_data;
+	uint32 _mappedSize;
+
+	/** The position set by seeking past the end of the file, or -1 */
+	int32 _posPastEnd;
+};
+
+#endif
+
+#endif
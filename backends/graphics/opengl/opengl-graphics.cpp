@@ -29,6 +29,7 @@
 #include "backends/graphics/opengl/shader.h"
 
 #include "common/array.h"
+#include "common/debug.h"
 #include "common/textconsole.h"
 #include "common/translation.h"
 #include "common/algorithm.h"
@@ -412,6 +413,11 @@ void OpenGLGraphicsManager::updateScreen() {
 	}
 	_overlay->updateGLTexture();
 
+	// Report how much texture data this frame had to transfer.
+	const GLTexture::UploadStats &uploadStats = GLTexture::getUploadStats();
+	debug(6, "OpenGL: Uploaded %u bytes in %u uploads", uploadStats.bytes, uploadStats.uploads);
+	GLTexture::resetUploadStats();
+
 	// Clear the screen buffer.
 	if (_scissorOverride && !_overlayVisible) {
 		// In certain cases we need to assure that the whole screen area is
@@ -26,6 +26,7 @@
 #include "backends/graphics/opengl/pipelines/clut8.h"
 #include "backends/graphics/opengl/framebuffer.h"
 
+#include "common/algorithm.h"
 #include "common/rect.h"
 #include "common/textconsole.h"
 
@@ -43,17 +44,44 @@ static GLuint nextHigher2(GLuint v) {
 	return ++v;
 }
 
+static uint rectArea(const Common::Rect &rect) {
+	return rect.width() * rect.height();
+}
+
+static bool compareRectTop(const Common::Rect &a, const Common::Rect &b) {
+	return a.top < b.top;
+}
+
+enum {
+	/**
+	 * Minimum number of bytes of a batch of uploads to stream it through a
+	 * pixel buffer object. Mapping a buffer is not worth it for less.
+	 */
+	kMinPixelBufferUpload = 64 * 1024
+};
+
+GLTexture::UploadStats GLTexture::_uploadStats = { 0, 0 };
+
+void GLTexture::resetUploadStats() {
+	_uploadStats.bytes = 0;
+	_uploadStats.uploads = 0;
+}
 
 GLTexture::GLTexture(GLenum glIntFormat, GLenum glFormat, GLenum glType)
     : _glIntFormat(glIntFormat), _glFormat(glFormat), _glType(glType),
       _width(0), _height(0), _logicalWidth(0), _logicalHeight(0),
       _texCoords(), _glFilter(GL_NEAREST),
-      _glTexture(0) {
+      _glTexture(0), _glPixelBuffer(0) {
 	create();
 }
 
 GLTexture::~GLTexture() {
 	GL_CALL_SAFE(glDeleteTextures, (1, &_glTexture));
+#if !USE_FORCED_GLES
+	if (_glPixelBuffer) {
+		GL_CALL_SAFE(glDeleteBuffers, (1, &_glPixelBuffer));
+	}
+#endif
 }
 
 void GLTexture::enableLinearFiltering(bool enable) {
@@ -72,6 +100,13 @@ void GLTexture::enableLinearFiltering(bool enable) {
 void GLTexture::destroy() {
 	GL_CALL(glDeleteTextures(1, &_glTexture));
 	_glTexture = 0;
+
+#if !USE_FORCED_GLES
+	if (_glPixelBuffer) {
+		GL_CALL(glDeleteBuffers(1, &_glPixelBuffer));
+		_glPixelBuffer = 0;
+	}
+#endif
 }
 
 void GLTexture::create() {
@@ -143,29 +178,130 @@ void GLTexture::setSize(uint width, uint height) {
 }
 
 void GLTexture::updateArea(const Common::Rect &area, const Graphics::Surface &src) {
+	DirtyRectList areas;
+	areas.push_back(area);
+	updateAreas(areas, src);
+}
+
+void GLTexture::updateAreas(const DirtyRectList &areas, const Graphics::Surface &src) {
+	if (areas.empty()) {
+		return;
+	}
+
 	// Set the texture on the active texture unit.
 	bind();
 
-	// Update the actual texture.
-	// Although we have the area of the texture buffer we want to update we
-	// cannot take advantage of the left/right boundries here because it is
-	// not possible to specify a pitch to glTexSubImage2D. To be precise, with
-	// plain OpenGL we could set GL_UNPACK_ROW_LENGTH to achieve this. However,
-	// OpenGL ES 1.0 does not support GL_UNPACK_ROW_LENGTH. Thus, we are left
-	// with the following options:
-	//
-	// 1) (As we do right now) Simply always update the whole texture lines of
-	//    rect changed. This is simplest to implement. In case performance is
-	//    really an issue we can think of switching to another method.
-	//
-	// 2) Copy the dirty rect to a temporary buffer and upload that by using
-	//    glTexSubImage2D. This is what the Android backend does. It is more
-	//    complicated though.
-	//
-	// 3) Use glTexSubImage2D per line changed. This is what the old OpenGL
-	//    graphics manager did but it is much slower! Thus, we do not use it.
-	GL_CALL(glTexSubImage2D(GL_TEXTURE_2D, 0, 0, area.top, src.w, area.height(),
-	                       _glFormat, _glType, src.getBasePtr(0, area.top)));
+	// Without GL_UNPACK_ROW_LENGTH it is not possible to specify a pitch to
+	// glTexSubImage2D. Thus, on contexts without it (OpenGL ES 1.0 and 2.0
+	// without GL_EXT_unpack_subimage) we upload the whole texture lines of
+	// every area changed. Overlapping line ranges are merged so that no line
+	// is uploaded twice. The alternatives, copying every area to a temporary
+	// buffer or uploading line by line, are much slower.
+	DirtyRectList lineAreas;
+	const DirtyRectList *uploadAreas = &areas;
+	if (!g_context.unpackSubImageSupported) {
+		for (DirtyRectList::const_iterator i = areas.begin(); i != areas.end(); ++i) {
+			lineAreas.push_back(Common::Rect(0, i->top, src.w, i->bottom));
+		}
+		Common::sort(lineAreas.begin(), lineAreas.end(), compareRectTop);
+
+		uint last = 0;
+		for (uint i = 1; i < lineAreas.size(); ++i) {
+			if (lineAreas[i].top <= lineAreas[last].bottom) {
+				lineAreas[last].bottom = MAX(lineAreas[last].bottom, lineAreas[i].bottom);
+			} else {
+				lineAreas[++last] = lineAreas[i];
+			}
+		}
+		lineAreas.resize(last + 1);
+
+		uploadAreas = &lineAreas;
+	}
+
+#if !USE_FORCED_GLES
+	if (g_context.pixelBufferObjectSupported && updateAreasPBO(*uploadAreas, src)) {
+		return;
+	}
+#endif
+
+	if (g_context.unpackSubImageSupported) {
+		GL_CALL(glPixelStorei(GL_UNPACK_ROW_LENGTH, src.pitch / src.format.bytesPerPixel));
+	}
+
+	for (DirtyRectList::const_iterator i = uploadAreas->begin(); i != uploadAreas->end(); ++i) {
+		GL_CALL(glTexSubImage2D(GL_TEXTURE_2D, 0, i->left, i->top, i->width(), i->height(),
+		                        _glFormat, _glType, src.getBasePtr(i->left, i->top)));
+
+		_uploadStats.bytes += rectArea(*i) * src.format.bytesPerPixel;
+		++_uploadStats.uploads;
+	}
+
+	if (g_context.unpackSubImageSupported) {
+		GL_CALL(glPixelStorei(GL_UNPACK_ROW_LENGTH, 0));
+	}
+}
+
+bool GLTexture::updateAreasPBO(const DirtyRectList &areas, const Graphics::Surface &src) {
+#if !USE_FORCED_GLES
+	const uint bytesPerPixel = src.format.bytesPerPixel;
+
+	uint size = 0;
+	for (DirtyRectList::const_iterator i = areas.begin(); i != areas.end(); ++i) {
+		size += rectArea(*i) * bytesPerPixel;
+	}
+
+	if (size < kMinPixelBufferUpload) {
+		return false;
+	}
+
+	if (!_glPixelBuffer) {
+		GL_CALL(glGenBuffers(1, &_glPixelBuffer));
+	}
+
+	GL_CALL(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _glPixelBuffer));
+
+	// Orphan the old storage so that mapping does not have to wait for the
+	// uploads of the previous frame to finish.
+	GL_CALL(glBufferData(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW));
+
+	GLvoid *buffer;
+	GL_ASSIGN(buffer, glMapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY));
+	if (!buffer) {
+		GL_CALL(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0));
+		return false;
+	}
+
+	// Pack the areas tightly into the buffer.
+	byte *dst = (byte *)buffer;
+	for (DirtyRectList::const_iterator i = areas.begin(); i != areas.end(); ++i) {
+		const uint lineSize = i->width() * bytesPerPixel;
+		const byte *srcLine = (const byte *)src.getBasePtr(i->left, i->top);
+
+		for (int y = i->top; y < i->bottom; ++y) {
+			memcpy(dst, srcLine, lineSize);
+			dst += lineSize;
+			srcLine += src.pitch;
+		}
+	}
+
+	GL_CALL(glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER));
+
+	// With a bound pixel buffer the data pointer is an offset into it.
+	size_t offset = 0;
+	for (DirtyRectList::const_iterator i = areas.begin(); i != areas.end(); ++i) {
+		GL_CALL(glTexSubImage2D(GL_TEXTURE_2D, 0, i->left, i->top, i->width(), i->height(),
+		                        _glFormat, _glType, (const GLvoid *)offset));
+
+		offset += rectArea(*i) * bytesPerPixel;
+		++_uploadStats.uploads;
+	}
+	_uploadStats.bytes += size;
+
+	GL_CALL(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0));
+	return true;
+#else
+	return false;
+#endif
 }
 
 //
@@ -173,7 +309,7 @@ void GLTexture::updateArea(const Common::Rect &area, const Graphics::Surface &sr
 //
 
 Surface::Surface()
-    : _allDirty(false), _dirtyArea() {
+    : _allDirty(false), _dirtyRects() {
 }
 
 void Surface::copyRectToTexture(uint x, uint y, uint w, uint h, const void *srcPtr, uint srcPitch) {
@@ -181,15 +317,7 @@ void Surface::copyRectToTexture(uint x, uint y, uint w, uint h, const void *srcP
 	assert(x + w <= dstSurf->w);
 	assert(y + h <= dstSurf->h);
 
-	// *sigh* Common::Rect::extend behaves unexpected whenever one of the two
-	// parameters is an empty rect. Thus, we check whether the current dirty
-	// area is valid. In case it is not we simply use the parameters as new
-	// dirty area. Otherwise, we simply call extend.
-	if (_dirtyArea.isEmpty()) {
-		_dirtyArea = Common::Rect(x, y, x + w, y + h);
-	} else {
-		_dirtyArea.extend(Common::Rect(x, y, x + w, y + h));
-	}
+	addDirtyArea(Common::Rect(x, y, x + w, y + h));
 
 	const byte *src = (const byte *)srcPtr;
 	byte *dst = (byte *)dstSurf->getBasePtr(x, y);
@@ -214,11 +342,60 @@ void Surface::fill(uint32 color) {
 	flagDirty();
 }
 
-Common::Rect Surface::getDirtyArea() const {
+void Surface::addDirtyArea(const Common::Rect &area) {
+	// *sigh* Common::Rect::extend behaves unexpected whenever one of the two
+	// parameters is an empty rect. Thus, we ignore empty areas altogether.
+	if (_allDirty || area.isEmpty()) {
+		return;
+	}
+
+	// Merge the area with every dirty area it overlaps or which is close
+	// enough that uploading their bounding box wastes little. The merged
+	// area might reach further areas, thus start over after each merge.
+	Common::Rect newArea = area;
+	for (uint i = 0; i < _dirtyRects.size(); ) {
+		Common::Rect merged = newArea;
+		merged.extend(_dirtyRects[i]);
+
+		if (newArea.intersects(_dirtyRects[i])
+		    || rectArea(merged) <= rectArea(newArea) + rectArea(_dirtyRects[i]) + kDirtyRectMergeSlack) {
+			newArea = merged;
+			_dirtyRects.remove_at(i);
+			i = 0;
+		} else {
+			++i;
+		}
+	}
+
+	if (_dirtyRects.size() < kMaxDirtyRects) {
+		_dirtyRects.push_back(newArea);
+		return;
+	}
+
+	// There are too many separate areas. Merge the area into the one which
+	// grows the least.
+	uint best = 0;
+	uint bestGrowth = 0xFFFFFFFF;
+	for (uint i = 0; i < _dirtyRects.size(); ++i) {
+		Common::Rect merged = _dirtyRects[i];
+		merged.extend(newArea);
+
+		const uint growth = rectArea(merged) - rectArea(_dirtyRects[i]);
+		if (growth < bestGrowth) {
+			best = i;
+			bestGrowth = growth;
+		}
+	}
+	_dirtyRects[best].extend(newArea);
+}
+
+DirtyRectList Surface::getDirtyRects() const {
 	if (_allDirty) {
-		return Common::Rect(getWidth(), getHeight());
+		DirtyRectList allRects;
+		allRects.push_back(Common::Rect(getWidth(), getHeight()));
+		return allRects;
 	} else {
-		return _dirtyArea;
+		return _dirtyRects;
 	}
 }
 
@@ -279,38 +456,42 @@ void Texture::updateGLTexture() {
 		return;
 	}
 
-	Common::Rect dirtyArea = getDirtyArea();
+	DirtyRectList dirtyRects = getDirtyRects();
 
 	// In case we use linear filtering we might need to duplicate the last
 	// pixel row/column to avoid glitches with filtering.
 	if (_glTexture.isLinearFilteringEnabled()) {
-		if (dirtyArea.right == _userPixelData.w && _userPixelData.w != _textureData.w) {
-			uint height = dirtyArea.height();
+		for (DirtyRectList::iterator i = dirtyRects.begin(); i != dirtyRects.end(); ++i) {
+			Common::Rect &dirtyArea = *i;
 
-			const byte *src = (const byte *)_textureData.getBasePtr(_userPixelData.w - 1, dirtyArea.top);
-			byte *dst = (byte *)_textureData.getBasePtr(_userPixelData.w, dirtyArea.top);
+			if (dirtyArea.right == _userPixelData.w && _userPixelData.w != _textureData.w) {
+				uint height = dirtyArea.height();
 
-			while (height-- > 0) {
-				memcpy(dst, src, _textureData.format.bytesPerPixel);
-				dst += _textureData.pitch;
-				src += _textureData.pitch;
-			}
+				const byte *src = (const byte *)_textureData.getBasePtr(_userPixelData.w - 1, dirtyArea.top);
+				byte *dst = (byte *)_textureData.getBasePtr(_userPixelData.w, dirtyArea.top);
 
-			// Extend the dirty area.
-			++dirtyArea.right;
-		}
+				while (height-- > 0) {
+					memcpy(dst, src, _textureData.format.bytesPerPixel);
+					dst += _textureData.pitch;
+					src += _textureData.pitch;
+				}
+
+				// Extend the dirty area.
+				++dirtyArea.right;
+			}
 
-		if (dirtyArea.bottom == _userPixelData.h && _userPixelData.h != _textureData.h) {
-			const byte *src = (const byte *)_textureData.getBasePtr(dirtyArea.left, _userPixelData.h - 1);
-			byte *dst = (byte *)_textureData.getBasePtr(dirtyArea.left, _userPixelData.h);
-			memcpy(dst, src, dirtyArea.width() * _textureData.format.bytesPerPixel);
+			if (dirtyArea.bottom == _userPixelData.h && _userPixelData.h != _textureData.h) {
+				const byte *src = (const byte *)_textureData.getBasePtr(dirtyArea.left, _userPixelData.h - 1);
+				byte *dst = (byte *)_textureData.getBasePtr(dirtyArea.left, _userPixelData.h);
+				memcpy(dst, src, dirtyArea.width() * _textureData.format.bytesPerPixel);
 
-			// Extend the dirty area.
-			++dirtyArea.bottom;
+				// Extend the dirty area.
+				++dirtyArea.bottom;
+			}
 		}
 	}
 
-	_glTexture.updateArea(dirtyArea, _textureData);
+	_glTexture.updateAreas(dirtyRects, _textureData);
 
 	// We should have handled everything, thus not dirty anymore.
 	clearDirty();
@@ -410,20 +591,25 @@ void TextureCLUT8::updateGLTexture() {
 	// Do the palette look up
 	Graphics::Surface *outSurf = Texture::getSurface();
 
-	Common::Rect dirtyArea = getDirtyArea();
-
-	if (outSurf->format.bytesPerPixel == 2) {
-		doPaletteLookUp<uint16>((uint16 *)outSurf->getBasePtr(dirtyArea.left, dirtyArea.top),
-		                        (const byte *)_clut8Data.getBasePtr(dirtyArea.left, dirtyArea.top),
-		                        dirtyArea.width(), dirtyArea.height(),
-		                        outSurf->pitch, _clut8Data.pitch, (const uint16 *)_palette);
-	} else if (outSurf->format.bytesPerPixel == 4) {
-		doPaletteLookUp<uint32>((uint32 *)outSurf->getBasePtr(dirtyArea.left, dirtyArea.top),
-		                        (const byte *)_clut8Data.getBasePtr(dirtyArea.left, dirtyArea.top),
-		                        dirtyArea.width(), dirtyArea.height(),
-		                        outSurf->pitch, _clut8Data.pitch, (const uint32 *)_palette);
-	} else {
-		warning("TextureCLUT8::updateTexture: Unsupported pixel depth: %d", outSurf->format.bytesPerPixel);
+	const DirtyRectList dirtyRects = getDirtyRects();
+
+	for (DirtyRectList::const_iterator i = dirtyRects.begin(); i != dirtyRects.end(); ++i) {
+		const Common::Rect &dirtyArea = *i;
+
+		if (outSurf->format.bytesPerPixel == 2) {
+			doPaletteLookUp<uint16>((uint16 *)outSurf->getBasePtr(dirtyArea.left, dirtyArea.top),
+			                        (const byte *)_clut8Data.getBasePtr(dirtyArea.left, dirtyArea.top),
+			                        dirtyArea.width(), dirtyArea.height(),
+			                        outSurf->pitch, _clut8Data.pitch, (const uint16 *)_palette);
+		} else if (outSurf->format.bytesPerPixel == 4) {
+			doPaletteLookUp<uint32>((uint32 *)outSurf->getBasePtr(dirtyArea.left, dirtyArea.top),
+			                        (const byte *)_clut8Data.getBasePtr(dirtyArea.left, dirtyArea.top),
+			                        dirtyArea.width(), dirtyArea.height(),
+			                        outSurf->pitch, _clut8Data.pitch, (const uint32 *)_palette);
+		} else {
+			warning("TextureCLUT8::updateTexture: Unsupported pixel depth: %d", outSurf->format.bytesPerPixel);
+			break;
+		}
 	}
 
 	// Do generic handling of updating the texture.
@@ -464,25 +650,29 @@ void TextureRGB555::updateTexture() {
 	// Convert color space.
 	Graphics::Surface *outSurf = Texture::getSurface();
 
-	const Common::Rect dirtyArea = getDirtyArea();
+	const DirtyRectList dirtyRects = getDirtyRects();
 
-	uint16 *dst = (uint16 *)outSurf->getBasePtr(dirtyArea.left, dirtyArea.top);
-	const uint dstAdd = outSurf->pitch - 2 * dirtyArea.width();
+	for (DirtyRectList::const_iterator i = dirtyRects.begin(); i != dirtyRects.end(); ++i) {
+		const Common::Rect &dirtyArea = *i;
 
-	const uint16 *src = (const uint16 *)_rgb555Data.getBasePtr(dirtyArea.left, dirtyArea.top);
-	const uint srcAdd = _rgb555Data.pitch - 2 * dirtyArea.width();
+		uint16 *dst = (uint16 *)outSurf->getBasePtr(dirtyArea.left, dirtyArea.top);
+		const uint dstAdd = outSurf->pitch - 2 * dirtyArea.width();
 
-	for (int height = dirtyArea.height(); height > 0; --height) {
-		for (int width = dirtyArea.width(); width > 0; --width) {
-			const uint16 color = *src++;
+		const uint16 *src = (const uint16 *)_rgb555Data.getBasePtr(dirtyArea.left, dirtyArea.top);
+		const uint srcAdd = _rgb555Data.pitch - 2 * dirtyArea.width();
 
-			*dst++ =   ((color & 0x7C00) << 1)                             // R
-			         | (((color & 0x03E0) << 1) | ((color & 0x0200) >> 4)) // G
-			         | (color & 0x001F);                                   // B
-		}
+		for (int height = dirtyArea.height(); height > 0; --height) {
+			for (int width = dirtyArea.width(); width > 0; --width) {
+				const uint16 color = *src++;
 
-		src = (const uint16 *)((const byte *)src + srcAdd);
-		dst = (uint16 *)((byte *)dst + dstAdd);
+				*dst++ =   ((color & 0x7C00) << 1)                             // R
+				         | (((color & 0x03E0) << 1) | ((color & 0x0200) >> 4)) // G
+				         | (color & 0x001F);                                   // B
+			}
+
+			src = (const uint16 *)((const byte *)src + srcAdd);
+			dst = (uint16 *)((byte *)dst + dstAdd);
+		}
 	}
 
 	// Do generic handling of updating the texture.
@@ -609,7 +799,7 @@ void TextureCLUT8GPU::updateGLTexture() {
 
 	// Update CLUT8 texture if necessary.
 	if (Surface::isDirty()) {
-		_clut8Texture.updateArea(getDirtyArea(), _clut8Data);
+		_clut8Texture.updateAreas(getDirtyRects(), _clut8Data);
 		clearDirty();
 	}
 
@@ -28,12 +28,18 @@
 #include "graphics/pixelformat.h"
 #include "graphics/surface.h"
 
+#include "common/array.h"
 #include "common/rect.h"
 
 namespace OpenGL {
 
 class Shader;
 
+/**
+ * A list of rectangular areas of a texture.
+ */
+typedef Common::Array<Common::Rect> DirtyRectList;
+
 /**
  * A simple GL texture object abstraction.
  *
@@ -99,6 +105,19 @@ public:
 	 */
 	void updateArea(const Common::Rect &area, const Graphics::Surface &src);
 
+	/**
+	 * Copy image data of multiple areas to the texture.
+	 *
+	 * The areas are uploaded in one batch. When the context supports pixel
+	 * buffer objects, big batches are streamed through one.
+	 *
+	 * @param areas    The areas to update.
+	 * @param src      Surface for the whole texture containing the pixel data
+	 *                 to upload. Only the areas described by areas will be
+	 *                 uploaded.
+	 */
+	void updateAreas(const DirtyRectList &areas, const Graphics::Surface &src);
+
 	/**
 	 * Query the GL texture's width.
 	 */
@@ -131,7 +150,34 @@ public:
 	 * destroy will invalidate the texture name.
 	 */
 	GLuint getGLTexture() const { return _glTexture; }
+
+	/**
+	 * Statistics about the texture data transferred to OpenGL.
+	 */
+	struct UploadStats {
+		uint32 bytes;   ///< Number of bytes uploaded.
+		uint32 uploads; ///< Number of glTexSubImage2D calls.
+	};
+
+	/**
+	 * Query the statistics of all uploads since the last reset.
+	 */
+	static const UploadStats &getUploadStats() { return _uploadStats; }
+
+	/**
+	 * Reset the upload statistics.
+	 */
+	static void resetUploadStats();
 private:
+	/**
+	 * Upload the areas through the pixel buffer object.
+	 *
+	 * @return false when the buffer could not be mapped.
+	 */
+	bool updateAreasPBO(const DirtyRectList &areas, const Graphics::Surface &src);
+
+	static UploadStats _uploadStats;
+
 	const GLenum _glIntFormat;
 	const GLenum _glFormat;
 	const GLenum _glType;
@@ -143,6 +189,7 @@ private:
 	GLint _glFilter;
 
 	GLuint _glTexture;
+	GLuint _glPixelBuffer;
 };
 
 /**
@@ -201,7 +248,7 @@ public:
 	void fill(uint32 color);
 
 	void flagDirty() { _allDirty = true; }
-	virtual bool isDirty() const { return _allDirty || !_dirtyArea.isEmpty(); }
+	virtual bool isDirty() const { return _allDirty || !_dirtyRects.empty(); }
 
 	virtual uint getWidth() const = 0;
 	virtual uint getHeight() const = 0;
@@ -239,12 +286,34 @@ public:
 	 */
 	virtual const GLTexture &getGLTexture() const = 0;
 protected:
-	void clearDirty() { _allDirty = false; _dirtyArea = Common::Rect(); }
+	void clearDirty() { _allDirty = false; _dirtyRects.clear(); }
 
-	Common::Rect getDirtyArea() const;
+	/**
+	 * Mark an area as dirty.
+	 *
+	 * The area is merged with dirty areas it overlaps or lies close to, so
+	 * that only a few separate areas need to be uploaded.
+	 */
+	void addDirtyArea(const Common::Rect &area);
+
+	/**
+	 * Obtain the dirty areas. The areas might overlap.
+	 */
+	DirtyRectList getDirtyRects() const;
 private:
+	enum {
+		/**
+		 * Number of pixels two areas may waste when merged into their
+		 * bounding box before they are kept apart.
+		 */
+		kDirtyRectMergeSlack = 32 * 32,
+
+		/** Maximum number of separate dirty areas. */
+		kMaxDirtyRects = 16
+	};
+
 	bool _allDirty;
-	Common::Rect _dirtyArea;
+	DirtyRectList _dirtyRects;
 };
 
 /**
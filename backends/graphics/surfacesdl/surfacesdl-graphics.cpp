@@ -33,6 +33,7 @@
 #include "common/translation.h"
 #include "common/util.h"
 #include "common/frac.h"
+#include "common/workerpool.h"
 #ifdef USE_RGB_COLOR
 #include "common/list.h"
 #endif
@@ -1091,6 +1092,41 @@ void SurfaceSdlGraphicsManager::updateShader() {
 // hardware-based up-scaling (sharp-bilinear-simple, etc.)
 }
 
+namespace {
+
+/** Minimum number of source pixels per band handed to a worker thread */
+const int kScalerMinBandPixels = 32 * 1024;
+
+/**
+ * Runs a scaler over bands of a dirty rect. The bands consist of pairs of
+ * rows, so that every band starts at an even row like the whole rect does.
+ * DotMatrix depends on this, and AdvMame2x/3x need at least two rows.
+ */
+class ScalerBandJob : public Common::BandedJob {
+public:
+	ScalerBandJob(ScalerProc *scalerProc, const byte *src, uint32 srcPitch, byte *dst, uint32 dstPitch, int width, int height, int scaleFactor) :
+		_scalerProc(scalerProc), _src(src), _srcPitch(srcPitch), _dst(dst), _dstPitch(dstPitch),
+		_width(width), _height(height), _scaleFactor(scaleFactor) {}
+
+	virtual void runBand(int begin, int end) {
+		const int top = begin * 2;
+		const int bottom = MIN(end * 2, _height);
+
+		_scalerProc(_src + top * _srcPitch, _srcPitch, _dst + top * _scaleFactor * _dstPitch, _dstPitch, _width, bottom - top);
+	}
+
+private:
+	ScalerProc *_scalerProc;
+	const byte *_src;
+	uint32 _srcPitch;
+	byte *_dst;
+	uint32 _dstPitch;
+	int _width, _height;
+	int _scaleFactor;
+};
+
+} // End of anonymous namespace
+
 void SurfaceSdlGraphicsManager::internUpdateScreen() {
 	SDL_Surface *srcSurf, *origSurf;
 	int height, width;
@@ -1209,8 +1245,15 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 					dst_y = real2Aspect(dst_y);
 
 				assert(scalerProc != NULL);
-				scalerProc((byte *)srcSurf->pixels + (r->x * 2 + 2) + (r->y + 1) * srcPitch, srcPitch,
-					(byte *)_hwscreen->pixels + rx1 * 2 + dst_y * dstPitch, dstPitch, r->w, dst_h);
+
+				// Large areas are scaled in bands on the worker threads,
+				// unless the scaler cannot run on several threads at once
+				ScalerBandJob job(scalerProc, (byte *)srcSurf->pixels + (r->x * 2 + 2) + (r->y + 1) * srcPitch, srcPitch,
+					(byte *)_hwscreen->pixels + rx1 * 2 + dst_y * dstPitch, dstPitch, r->w, dst_h, scale1);
+				if (isScalerReentrant(scalerProc))
+					Common::runBanded(job, (dst_h + 1) / 2, MAX(kScalerMinBandPixels / MAX(r->w * 2, 1), 2));
+				else
+					job.runBand(0, (dst_h + 1) / 2);
 			}
 
 			r->x = rx1;
@@ -27,6 +27,7 @@
 
 #include <limits.h>
 
+#include "engines/detectioncache.h"
 #include "engines/metaengine.h"
 #include "base/commandLine.h"
 #include "base/plugins.h"
@@ -215,6 +216,8 @@ void registerDefaults() {
 	ConfMan.registerDefault("enable_gs", false);
 	ConfMan.registerDefault("midi_gain", 100);
 
+	ConfMan.registerDefault("resampler", "default");
+
 	ConfMan.registerDefault("music_driver", "auto");
 	ConfMan.registerDefault("mt32_device", "null");
 	ConfMan.registerDefault("gm_device", "null");
@@ -1194,17 +1197,21 @@ bool processSettings(Common::String &command, Common::StringMap &settings, Commo
 		// If we get a non-empty ID, we store it in command so that it gets processed together with the
 		// other command line options below.
 		command = detectGames(settings["path"]);
+		DetectionCacheMan.flush();
 		if (command.empty())
 			return true;
 	} else if (command == "detect") {
 		// Ignore the return value of detectGame.
 		detectGames(settings["path"]);
+		DetectionCacheMan.flush();
 		return true;
 	} else if (command == "add") {
 		addGame(settings["path"]);
+		DetectionCacheMan.flush();
 		return true;
 	} else if (command == "massadd") {
 		massAddGame(settings["path"]);
+		DetectionCacheMan.flush();
 		return true;
 	}
 #ifdef DETECTOR_TESTING_HACK
@@ -92,6 +92,61 @@ void SearchSet::insert(const Node &node) {
 			break;
 	}
 	_list.insert(it, node);
+	invalidateIndex();
+}
+
+void SearchSet::buildIndex() const {
+	_index.clear();
+
+	// Walk the archives in descending priority, so that the first archive
+	// listing a name is the one a plain search would find.
+	ArchiveNodeList::const_iterator it = _list.begin();
+	for (; it != _list.end(); ++it) {
+		ArchiveMemberList members;
+		it->_listed = it->_arc->listMembers(members) > 0;
+
+		for (ArchiveMemberList::const_iterator m = members.begin(); m != members.end(); ++m) {
+			const String name = (*m)->getName();
+			if (!_index.contains(name))
+				_index[name] = it->_arc;
+		}
+	}
+
+	_indexValid = true;
+}
+
+Archive *SearchSet::lookupIndex(const String &name) const {
+	if (!_indexEnabled)
+		return 0;
+
+	if (!_indexValid)
+		buildIndex();
+
+	NameIndex::const_iterator i = _index.find(name);
+	if (i != _index.end()) {
+		// Archives with a higher priority than the indexed one may still
+		// hold the name without listing it, so ask those first.
+		ArchiveNodeList::const_iterator it = _list.begin();
+		for (; it != _list.end() && it->_arc != i->_value; ++it) {
+			if (!it->_listed && it->_arc->hasFile(name)) {
+				_indexHits++;
+				return it->_arc;
+			}
+		}
+
+		if (i->_value->hasFile(name)) {
+			_indexHits++;
+			return i->_value;
+		}
+	}
+
+	_indexMisses++;
+	return 0;
+}
+
+void SearchSet::enableIndex(bool enable) {
+	_indexEnabled = enable;
+	invalidateIndex();
 }
 
 void SearchSet::add(const String &name, Archive *archive, int priority, bool autoFree) {
@@ -173,6 +228,7 @@ void SearchSet::remove(const String &name) {
 		if (it->_autoFree)
 			delete it->_arc;
 		_list.erase(it);
+		invalidateIndex();
 	}
 }
 
@@ -187,6 +243,7 @@ void SearchSet::clear() {
 	}
 
 	_list.clear();
+	invalidateIndex();
 }
 
 void SearchSet::setPriority(const String &name, int priority) {
@@ -209,6 +266,9 @@ bool SearchSet::hasFile(const String &name) const {
 	if (name.empty())
 		return false;
 
+	if (lookupIndex(name))
+		return true;
+
 	ArchiveNodeList::const_iterator it = _list.begin();
 	for (; it != _list.end(); ++it) {
 		if (it->_arc->hasFile(name))
@@ -242,6 +302,10 @@ const ArchiveMemberPtr SearchSet::getMember(const String &name) const {
 	if (name.empty())
 		return ArchiveMemberPtr();
 
+	Archive *arc = lookupIndex(name);
+	if (arc)
+		return arc->getMember(name);
+
 	ArchiveNodeList::const_iterator it = _list.begin();
 	for (; it != _list.end(); ++it) {
 		if (it->_arc->hasFile(name))
@@ -255,6 +319,13 @@ SeekableReadStream *SearchSet::createReadStreamForMember(const String &name) con
 	if (name.empty())
 		return 0;
 
+	Archive *arc = lookupIndex(name);
+	if (arc) {
+		SeekableReadStream *stream = arc->createReadStreamForMember(name);
+		if (stream)
+			return stream;
+	}
+
 	ArchiveNodeList::const_iterator it = _list.begin();
 	for (; it != _list.end(); ++it) {
 		SeekableReadStream *stream = it->_arc->createReadStreamForMember(name);
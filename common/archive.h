@@ -24,6 +24,8 @@
 #define COMMON_ARCHIVE_H
 
 #include "common/str.h"
+#include "common/hash-str.h"
+#include "common/hashmap.h"
 #include "common/list.h"
 #include "common/ptr.h"
 #include "common/singleton.h"
@@ -114,6 +116,12 @@ public:
 	/**
 	 * Create a stream bound to a member with the specified name in the
 	 * archive. If no member with this name exists, 0 is returned.
+	 *
+	 * The stream must stay valid after the archive is deleted, as callers
+	 * commonly keep member streams around longer than the archive. Archives
+	 * reading members through a stream of their own have to share it with
+	 * the member streams instead of owning it alone.
+	 *
 	 * @return the newly created input stream
 	 */
 	virtual SeekableReadStream *createReadStreamForMember(const String &name) const = 0;
@@ -133,20 +141,35 @@ class SearchSet : public Archive {
 		String	_name;
 		Archive	*_arc;
 		bool	_autoFree;
+		mutable bool	_listed;	// listed members when the index was built
 		Node(int priority, const String &name, Archive *arc, bool autoFree)
-			: _priority(priority), _name(name), _arc(arc), _autoFree(autoFree) {
+			: _priority(priority), _name(name), _arc(arc), _autoFree(autoFree), _listed(false) {
 		}
 	};
 	typedef List<Node> ArchiveNodeList;
 	ArchiveNodeList _list;
 
+	typedef HashMap<String, Archive *, IgnoreCase_Hash, IgnoreCase_EqualTo> NameIndex;
+	mutable NameIndex _index;
+	mutable bool _indexValid;
+	bool _indexEnabled;
+	mutable uint32 _indexHits;
+	mutable uint32 _indexMisses;
+
 	ArchiveNodeList::iterator find(const String &name);
 	ArchiveNodeList::const_iterator find(const String &name) const;
 
 	// Add an archive keeping the list sorted by descending priority.
 	void insert(const Node& node);
 
+	// Build the name index from the members of all archives.
+	void buildIndex() const;
+
+	// Find the archive holding a member through the name index.
+	Archive *lookupIndex(const String &name) const;
+
 public:
+	SearchSet() : _indexValid(false), _indexEnabled(false), _indexHits(0), _indexMisses(0) {}
 	virtual ~SearchSet() { clear(); }
 
 	/**
@@ -230,6 +253,40 @@ public:
 	 */
 	void setPriority(const String& name, int priority);
 
+	/**
+	 * Enable or disable the name index.
+	 *
+	 * With the index enabled, the first lookup builds a case-insensitive map
+	 * from the names of the members listed by all archives to the archive
+	 * with the highest priority listing them. Lookups of indexed names then
+	 * skip every archive which lists its members but not the name. Archives
+	 * which do not list their members are still asked in priority order, so
+	 * the result is always the same as without the index. Names which are
+	 * not indexed, such as paths into sub directories, and names the indexed
+	 * archive does not have anymore are still searched in all archives.
+	 *
+	 * The index is off by default. Building it lists the members of every
+	 * archive, and it is rebuilt on the first lookup after archives are
+	 * added, removed or reordered, so only enable it for sets which are
+	 * searched often and rarely change. If the contents of an archive
+	 * change, call invalidateIndex().
+	 */
+	void enableIndex(bool enable);
+
+	/**
+	 * Discard the name index, so that it gets rebuilt on the next lookup.
+	 */
+	void invalidateIndex() { _indexValid = false; _index.clear(); }
+
+	/** Number of lookups answered through the name index. */
+	uint32 getIndexHits() const { return _indexHits; }
+
+	/** Number of lookups which had to search all archives. */
+	uint32 getIndexMisses() const { return _indexMisses; }
+
+	/** Reset the index hit and miss counters. */
+	void resetIndexStats() { _indexHits = _indexMisses = 0; }
+
 	virtual bool hasFile(const String &name) const;
 	virtual int listMatchingMembers(ArchiveMemberList &list, const String &pattern) const;
 	virtual int listMembers(ArchiveMemberList &list) const;
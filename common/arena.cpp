@@ -0,0 +1,183 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "common/arena.h"
+#include "common/memorypool.h"
+#include "common/mutex.h"
+
+namespace Common {
+
+Arena *Arena::_current = 0;
+
+Arena::Arena(bool threadSafe)
+	: _mutex(0), _liveBytes(0), _peakBytes(0), _liveObjects(0),
+	  _frameAllocations(0), _totalAllocations(0) {
+
+	for (int i = 0; i < kNumSizeClasses; ++i)
+		_pools[i] = new MemoryPool(kMinChunkSize << i);
+
+	_largeBlocks._prev = &_largeBlocks;
+	_largeBlocks._next = &_largeBlocks;
+	_largeBlocks._size = 0;
+
+	if (threadSafe)
+		_mutex = new Mutex();
+}
+
+Arena::~Arena() {
+	reset();
+
+	for (int i = 0; i < kNumSizeClasses; ++i)
+		delete _pools[i];
+	delete _mutex;
+}
+
+int Arena::sizeClass(size_t size) {
+	int sizeClass = 0;
+	while (((size_t)kMinChunkSize << sizeClass) < size)
+		++sizeClass;
+	return sizeClass;
+}
+
+void *Arena::allocate(size_t size) {
+	if (!_mutex)
+		return allocateUnlocked(size);
+
+	StackLock lock(*_mutex);
+	return allocateUnlocked(size);
+}
+
+void Arena::deallocate(void *ptr, size_t size) {
+	if (!_mutex) {
+		deallocateUnlocked(ptr, size);
+		return;
+	}
+
+	StackLock lock(*_mutex);
+	deallocateUnlocked(ptr, size);
+}
+
+void *Arena::allocateUnlocked(size_t size) {
+	void *result;
+
+	if (size <= kMaxChunkSize) {
+		result = _pools[sizeClass(size)]->allocChunk();
+	} else {
+		LargeBlock *block = (LargeBlock *)malloc(sizeof(LargeBlock) + size);
+		assert(block);
+		block->_size = size;
+		block->_prev = &_largeBlocks;
+		block->_next = _largeBlocks._next;
+		block->_next->_prev = block;
+		_largeBlocks._next = block;
+		result = block + 1;
+	}
+
+	_liveBytes += size;
+	if (_liveBytes > _peakBytes)
+		_peakBytes = _liveBytes;
+	++_liveObjects;
+	++_frameAllocations;
+	++_totalAllocations;
+
+	return result;
+}
+
+void Arena::deallocateUnlocked(void *ptr, size_t size) {
+	if (!ptr)
+		return;
+
+	if (size <= kMaxChunkSize) {
+		_pools[sizeClass(size)]->freeChunk(ptr);
+	} else {
+		LargeBlock *block = (LargeBlock *)ptr - 1;
+		assert(block->_size == size);
+		block->_prev->_next = block->_next;
+		block->_next->_prev = block->_prev;
+		free(block);
+	}
+
+	assert(_liveObjects > 0 && _liveBytes >= size);
+	_liveBytes -= size;
+	--_liveObjects;
+}
+
+void Arena::reset() {
+	if (_mutex)
+		_mutex->lock();
+
+	for (int i = 0; i < kNumSizeClasses; ++i)
+		_pools[i]->freeAllChunks();
+
+	LargeBlock *block = _largeBlocks._next;
+	while (block != &_largeBlocks) {
+		LargeBlock *next = block->_next;
+		free(block);
+		block = next;
+	}
+	_largeBlocks._prev = &_largeBlocks;
+	_largeBlocks._next = &_largeBlocks;
+
+	_liveBytes = 0;
+	_liveObjects = 0;
+
+	if (_mutex)
+		_mutex->unlock();
+}
+
+void Arena::beginFrame() {
+	_frameAllocations = 0;
+}
+
+namespace {
+
+// Prepended to blocks handed out by arenaAlloc(), the union keeps the
+// payload aligned for any type a String or List may hold.
+union BlockHeader {
+	Arena *_arena;
+	double _align;
+};
+
+} // end of anonymous namespace
+
+void *arenaAlloc(size_t size) {
+	Arena *arena = Arena::getCurrent();
+	size_t totalSize = size + sizeof(BlockHeader);
+
+	BlockHeader *header = (BlockHeader *)(arena ? arena->allocate(totalSize) : malloc(totalSize));
+	assert(header);
+	header->_arena = arena;
+	return header + 1;
+}
+
+void arenaFree(void *ptr, size_t size) {
+	if (!ptr)
+		return;
+
+	BlockHeader *header = (BlockHeader *)ptr - 1;
+	if (header->_arena)
+		header->_arena->deallocate(header, size + sizeof(BlockHeader));
+	else
+		free(header);
+}
+
+} // End of namespace Common
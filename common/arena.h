@@ -0,0 +1,170 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef COMMON_ARENA_H
+#define COMMON_ARENA_H
+
+#include "common/scummsys.h"
+
+/**
+ * @def USE_ARENA_ALLOCATOR
+ * Defined by configure --enable-arena-allocator. Common::String and
+ * Common::List then obtain their heap storage from the current Arena (see
+ * ArenaScope), falling back to the global heap when no arena is active.
+ * Every block carries a small header naming its owner, so this costs a few
+ * bytes per allocation.
+ */
+
+namespace Common {
+
+class MemoryPool;
+class Mutex;
+
+/**
+ * A size class allocator meant to be scoped to a scene or a frame.
+ *
+ * Requests of up to kMaxChunkSize bytes are rounded up to a power of two
+ * and served by one MemoryPool per size class; bigger requests go to
+ * malloc() but are still tracked, so reset() can return all memory handed
+ * out by the arena at once. The pages of the pools are kept by reset(),
+ * so an arena reused every frame stops calling malloc() after warming up.
+ *
+ * An arena is not thread-safe unless it was created with threadSafe set,
+ * in which case every call is serialized through a Common::Mutex. Code
+ * running on several threads should rather give each thread its own arena.
+ */
+class Arena {
+public:
+	enum {
+		kMinChunkSize = 16,
+		kMaxChunkSize = 2048,
+		kNumSizeClasses = 8
+	};
+
+	explicit Arena(bool threadSafe = false);
+	~Arena();
+
+	/**
+	 * Allocate a block of at least size bytes.
+	 */
+	void *allocate(size_t size);
+
+	/**
+	 * Return a block to the arena. size must be the value which was passed
+	 * to the allocate() call that returned ptr.
+	 */
+	void deallocate(void *ptr, size_t size);
+
+	/**
+	 * Release every block allocated from this arena at once. Objects still
+	 * living in the arena must not be used, nor deallocated, afterwards.
+	 */
+	void reset();
+
+	/**
+	 * Mark the beginning of a new frame, resetting the per frame allocation
+	 * counter.
+	 */
+	void beginFrame();
+
+	/** Return the number of bytes currently allocated from the arena. */
+	size_t getLiveBytes() const { return _liveBytes; }
+	/** Return the highest value getLiveBytes() ever had. */
+	size_t getPeakBytes() const { return _peakBytes; }
+	/** Return the number of blocks currently allocated from the arena. */
+	uint32 getLiveObjects() const { return _liveObjects; }
+	/** Return the number of allocations since the last beginFrame() call. */
+	uint32 getFrameAllocations() const { return _frameAllocations; }
+	/** Return the number of allocations since the arena was created. */
+	uint32 getTotalAllocations() const { return _totalAllocations; }
+
+	/**
+	 * Return the arena String and List allocate from, or 0 if they use the
+	 * global heap. Only used when USE_ARENA_ALLOCATOR is defined.
+	 */
+	static Arena *getCurrent() { return _current; }
+
+private:
+	Arena(const Arena &);
+	Arena &operator=(const Arena &);
+
+	struct LargeBlock {
+		LargeBlock *_prev;
+		LargeBlock *_next;
+		size_t _size;
+	};
+
+	static int sizeClass(size_t size);
+
+	void *allocateUnlocked(size_t size);
+	void deallocateUnlocked(void *ptr, size_t size);
+
+	MemoryPool *_pools[kNumSizeClasses];
+	LargeBlock _largeBlocks;
+	Mutex *_mutex;
+
+	size_t _liveBytes;
+	size_t _peakBytes;
+	uint32 _liveObjects;
+	uint32 _frameAllocations;
+	uint32 _totalAllocations;
+
+	friend class ArenaScope;
+	static Arena *_current;
+};
+
+/**
+ * Make an arena the current one for the lifetime of this object, restoring
+ * the previous one when it goes out of scope. Scopes may be nested.
+ *
+ * The current arena is global, not per thread: scopes should only be opened
+ * on the thread running the engine, and the arena be created thread-safe if
+ * other threads may create strings or lists meanwhile.
+ */
+class ArenaScope {
+public:
+	explicit ArenaScope(Arena *arena) : _previous(Arena::_current) { Arena::_current = arena; }
+	~ArenaScope() { Arena::_current = _previous; }
+
+private:
+	ArenaScope(const ArenaScope &);
+	ArenaScope &operator=(const ArenaScope &);
+
+	Arena *_previous;
+};
+
+/**
+ * Allocate size bytes from the current arena, or from the heap when there
+ * is none. The block remembers where it came from, so it may be released
+ * with arenaFree() after the scope which allocated it has ended.
+ */
+void *arenaAlloc(size_t size);
+
+/**
+ * Release a block obtained by arenaAlloc(). size must be the value passed
+ * to arenaAlloc().
+ */
+void arenaFree(void *ptr, size_t size);
+
+} // End of namespace Common
+
+#endif
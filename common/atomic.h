@@ -0,0 +1,103 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef COMMON_ATOMIC_H
+#define COMMON_ATOMIC_H
+
+#include "common/scummsys.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace Common {
+
+/*
+ * Minimal set of atomic operations on 32 bit values, for the few places
+ * which exchange data between threads without taking a Common::Mutex
+ * (e.g. between the audio callback and the engine thread).
+ *
+ * Loads have acquire semantics, stores have release semantics and the
+ * read-modify-write operations act as full memory barriers.
+ */
+
+/**
+ * Issue a full memory barrier.
+ */
+inline void memoryBarrier() {
+#if defined(__GNUC__)
+	__sync_synchronize();
+#elif defined(_MSC_VER)
+	long barrier = 0;
+	_InterlockedExchange(&barrier, 0);
+#else
+#error "Atomic operations are not implemented for this compiler"
+#endif
+}
+
+/**
+ * Read a value written by another thread.
+ */
+inline uint32 atomicLoad(const volatile uint32 &value) {
+	const uint32 result = value;
+	memoryBarrier();
+	return result;
+}
+
+/**
+ * Publish a value to other threads. All memory writes issued before this
+ * call are visible to a thread which observes the new value.
+ */
+inline void atomicStore(volatile uint32 &value, uint32 newValue) {
+	memoryBarrier();
+	value = newValue;
+}
+
+/**
+ * Replace the value with newValue if it currently equals oldValue.
+ *
+ * @return true if the value was replaced
+ */
+inline bool atomicCompareAndSwap(volatile uint32 &value, uint32 oldValue, uint32 newValue) {
+#if defined(__GNUC__)
+	return __sync_bool_compare_and_swap(&value, oldValue, newValue);
+#elif defined(_MSC_VER)
+	return (uint32)_InterlockedCompareExchange((volatile long *)&value, (long)newValue, (long)oldValue) == oldValue;
+#endif
+}
+
+/**
+ * Add delta to the value.
+ *
+ * @return the new value
+ */
+inline uint32 atomicAdd(volatile uint32 &value, uint32 delta) {
+#if defined(__GNUC__)
+	return __sync_add_and_fetch(&value, delta);
+#elif defined(_MSC_VER)
+	return (uint32)_InterlockedExchangeAdd((volatile long *)&value, (long)delta) + delta;
+#endif
+}
+
+} // End of namespace Common
+
+#endif
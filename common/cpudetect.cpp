@@ -0,0 +1,65 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "common/cpudetect.h"
+
+namespace Common {
+
+static uint32 s_cpuFeatureMask = 0xFFFFFFFF;
+
+static uint32 detectCPUFeatures() {
+	uint32 features = 0;
+
+#ifdef SCUMMVM_SIMD_X86
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("sse2"))
+		features |= kCPUFeatureSSE2;
+	if (__builtin_cpu_supports("avx2"))
+		features |= kCPUFeatureAVX2;
+#endif
+
+#ifdef SCUMMVM_SIMD_NEON
+	features |= kCPUFeatureNEON;
+#endif
+
+	return features;
+}
+
+uint32 getCPUFeatures() {
+	// The detection itself is idempotent, so it does not matter if two
+	// threads race for the first call.
+	static bool detected = false;
+	static uint32 features = 0;
+
+	if (!detected) {
+		features = detectCPUFeatures();
+		detected = true;
+	}
+
+	return features & s_cpuFeatureMask;
+}
+
+void setCPUFeatureMask(uint32 mask) {
+	s_cpuFeatureMask = mask;
+}
+
+} // End of namespace Common
@@ -0,0 +1,83 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef COMMON_CPUDETECT_H
+#define COMMON_CPUDETECT_H
+
+#include "common/scummsys.h"
+
+/**
+ * SCUMMVM_SIMD_X86 is defined when the compiler lets us build SSE2 and AVX2
+ * code paths through per-function target attributes, independently of the
+ * flags the rest of the tree is compiled with. Such code must only be called
+ * after checking the matching feature with Common::hasCPUFeature().
+ *
+ * SCUMMVM_SIMD_NEON is defined when NEON intrinsics are available. NEON
+ * support is a compile time decision, so no runtime check is required.
+ */
+#if !defined(DISABLE_SIMD) && defined(__GNUC__) && ((__GNUC__ > 4) || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9) || defined(__clang__)) && (defined(__i386__) || defined(__x86_64__))
+#define SCUMMVM_SIMD_X86
+#endif
+
+#if !defined(DISABLE_SIMD) && (defined(__ARM_NEON__) || defined(__ARM_NEON))
+#define SCUMMVM_SIMD_NEON
+#endif
+
+namespace Common {
+
+/**
+ * Instruction set extensions which optimized code paths may depend on.
+ */
+enum CPUFeature {
+	kCPUFeatureSSE2 = 1 << 0,
+	kCPUFeatureAVX2 = 1 << 1,
+	kCPUFeatureNEON = 1 << 2
+};
+
+/**
+ * Query the instruction set extensions of the host CPU. The result is
+ * computed once and cached afterwards.
+ *
+ * @return a bitmask of CPUFeature values
+ */
+uint32 getCPUFeatures();
+
+/**
+ * Check whether the host CPU supports the given instruction set extension.
+ */
+inline bool hasCPUFeature(CPUFeature feature) {
+	return (getCPUFeatures() & feature) != 0;
+}
+
+/**
+ * Restrict the features reported by getCPUFeatures() to the given mask.
+ * This is meant for tests and benchmarks that need to compare optimized
+ * code paths against their plain C++ reference implementations.
+ *
+ * @param mask	features which may still be reported; pass 0xFFFFFFFF
+ *				to restore the detected feature set
+ */
+void setCPUFeatureMask(uint32 mask);
+
+} // End of namespace Common
+
+#endif
@@ -30,6 +30,8 @@ namespace Common {
 
 class DecompressorDCL {
 public:
+	DecompressorDCL(bool quiet = false) : _quiet(quiet) {}
+
 	bool unpack(SeekableReadStream *sourceStream, WriteStream *targetStream, uint32 targetSize, bool targetFixedSize);
 
 protected:
@@ -73,6 +75,7 @@ protected:
 	uint32 _bytesWritten;	///< number of bytes written to _targetStream
 	SeekableReadStream *_sourceStream;
 	WriteStream *_targetStream;
+	bool _quiet;			///< neither warnings nor debug output are printed
 };
 
 void DecompressorDCL::init(SeekableReadStream *sourceStream, WriteStream *targetStream, uint32 targetSize, bool targetFixedSize) {
@@ -321,11 +324,13 @@ int DecompressorDCL::huffman_lookup(const int *tree) {
 
 	while (!(tree[pos] & HUFFMAN_LEAF)) {
 		int bit = getBitsLSB(1);
-		debug(8, "[%d]:%d->", pos, bit);
+		if (!_quiet)
+			debug(8, "[%d]:%d->", pos, bit);
 		pos = bit ? tree[pos] & 0xFFF : tree[pos] >> 12;
 	}
 
-	debug(8, "=%02x\n", tree[pos] & 0xffff);
+	if (!_quiet)
+		debug(8, "=%02x\n", tree[pos] & 0xffff);
 	return tree[pos] & 0xFFFF;
 }
 
@@ -349,7 +354,8 @@ bool DecompressorDCL::unpack(SeekableReadStream *sourceStream, WriteStream *targ
 	byte dictionaryType = getByteLSB();
 
 	if (mode != DCL_BINARY_MODE && mode != DCL_ASCII_MODE) {
-		warning("DCL-INFLATE: Error: Encountered mode %02x, expected 00 or 01", mode);
+		if (!_quiet)
+			warning("DCL-INFLATE: Error: Encountered mode %02x, expected 00 or 01", mode);
 		return false;
 	}
 
@@ -367,7 +373,8 @@ bool DecompressorDCL::unpack(SeekableReadStream *sourceStream, WriteStream *targ
 		dictionarySize = 4096;
 		break;
 	default:
-		warning("DCL-INFLATE: Error: unsupported dictionary type %02x", dictionaryType);
+		if (!_quiet)
+			warning("DCL-INFLATE: Error: unsupported dictionary type %02x", dictionaryType);
 		return false;
 	}
 	dictionaryMask = dictionarySize - 1;
@@ -384,7 +391,8 @@ bool DecompressorDCL::unpack(SeekableReadStream *sourceStream, WriteStream *targ
 			if (tokenLength == 519)
 				break; // End of stream signal
 
-			debug(8, " | ");
+			if (!_quiet)
+				debug(8, " | ");
 
 			value = huffman_lookup(distance_tree);
 
@@ -394,19 +402,22 @@ bool DecompressorDCL::unpack(SeekableReadStream *sourceStream, WriteStream *targ
 				tokenOffset = (value << dictionaryType) | getBitsLSB(dictionaryType);
 			tokenOffset++;
 
-			debug(8, "\nCOPY(%d from %d)\n", tokenLength, tokenOffset);
+			if (!_quiet)
+				debug(8, "\nCOPY(%d from %d)\n", tokenLength, tokenOffset);
 
 			if (_targetFixedSize) {
 				if (tokenLength + _bytesWritten > _targetSize) {
-					warning("DCL-INFLATE Error: Write out of bounds while copying %d bytes (declared unpacked size is %d bytes, current is %d + %d bytes)",
-							tokenLength, _targetSize, _bytesWritten, tokenLength);
+					if (!_quiet)
+						warning("DCL-INFLATE Error: Write out of bounds while copying %d bytes (declared unpacked size is %d bytes, current is %d + %d bytes)",
+								tokenLength, _targetSize, _bytesWritten, tokenLength);
 					return false;
 				}
 			}
 
 			if (_bytesWritten < tokenOffset) {
-				warning("DCL-INFLATE Error: Attempt to copy from before beginning of input stream (declared unpacked size is %d bytes, current is %d bytes)",
-						_targetSize, _bytesWritten);
+				if (!_quiet)
+					warning("DCL-INFLATE Error: Attempt to copy from before beginning of input stream (declared unpacked size is %d bytes, current is %d bytes)",
+							_targetSize, _bytesWritten);
 				return false;
 			}
 
@@ -417,7 +428,8 @@ bool DecompressorDCL::unpack(SeekableReadStream *sourceStream, WriteStream *targ
 			while (tokenLength) {
 				// Write byte from dictionary
 				putByte(dictionary[dictionaryIndex]);
-				debug(9, "\33[32;31m%02x\33[37;37m ", dictionary[dictionaryIndex]);
+				if (!_quiet)
+					debug(9, "\33[32;31m%02x\33[37;37m ", dictionary[dictionaryIndex]);
 
 				dictionary[dictionaryNextIndex] = dictionary[dictionaryIndex];
 
@@ -432,7 +444,8 @@ bool DecompressorDCL::unpack(SeekableReadStream *sourceStream, WriteStream *targ
 				tokenLength--;
 			}
 			dictionaryPos = dictionaryNextIndex;
-			debug(9, "\n");
+			if (!_quiet)
+				debug(9, "\n");
 
 		} else { // Copy byte verbatim
 			value = (mode == DCL_ASCII_MODE) ? huffman_lookup(ascii_tree) : getByteLSB();
@@ -444,21 +457,22 @@ bool DecompressorDCL::unpack(SeekableReadStream *sourceStream, WriteStream *targ
 			if (dictionaryPos >= dictionarySize)
 				dictionaryPos = 0;
 
-			debug(9, "\33[32;31m%02x \33[37;37m", value);
+			if (!_quiet)
+				debug(9, "\33[32;31m%02x \33[37;37m", value);
 		}
 	}
 
 	if (_targetFixedSize) {
-		if (_bytesWritten != _targetSize)
+		if (_bytesWritten != _targetSize && !_quiet)
 			warning("DCL-INFLATE Error: Inconsistent bytes written (%d) and target buffer size (%d)", _bytesWritten, _targetSize);
 		return _bytesWritten == _targetSize;
 	}
 	return true; // For targets featuring dynamic size we always succeed
 }
 
-bool decompressDCL(ReadStream *src, byte *dest, uint32 packedSize, uint32 unpackedSize) {
+bool decompressDCL(ReadStream *src, byte *dest, uint32 packedSize, uint32 unpackedSize, bool quiet) {
 	bool success = false;
-	DecompressorDCL dcl;
+	DecompressorDCL dcl(quiet);
 
 	if (!src || !dest)
 		return false;
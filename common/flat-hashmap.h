@@ -0,0 +1,553 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef COMMON_FLAT_HASHMAP_H
+#define COMMON_FLAT_HASHMAP_H
+
+#include "common/func.h"
+
+#ifdef DEBUG_HASH_COLLISIONS
+#include "common/debug.h"
+#endif
+
+namespace Common {
+
+/**
+ * FlatHashMap<Key,Val> is an alternative to HashMap<Key,Val> with the same
+ * interface, but a different memory layout.
+ *
+ * HashMap keeps an array of pointers to nodes allocated separately, so each
+ * probe of a lookup has to follow a pointer. FlatHashMap stores the nodes
+ * themselves in one array, next to an array holding one metadata byte per
+ * slot: either an empty or deleted marker, or 7 bits of the hash of the key
+ * in the slot. Lookups probe linearly through the metadata bytes and only
+ * compare keys whose hash bits match, so most probes touch a single cache
+ * line and never call the equality functor.
+ *
+ * Unlike HashMap, the nodes move when the map grows. Pointers, references
+ * and iterators to elements are therefore invalidated by any insertion.
+ * Prefer FlatHashMap for maps with small keys and values which are mostly
+ * read, and keep HashMap where references to values are held.
+ */
+template<class Key, class Val, class HashFunc = Hash<Key>, class EqualFunc = EqualTo<Key> >
+class FlatHashMap {
+public:
+	typedef uint size_type;
+
+private:
+
+	typedef FlatHashMap<Key, Val, HashFunc, EqualFunc> HM_t;
+
+	struct Node {
+		const Key _key;
+		Val _value;
+		explicit Node(const Key &key) : _key(key), _value() {}
+	};
+
+	enum {
+		FLATHASHMAP_EMPTY = 0x80,
+		FLATHASHMAP_DELETED = 0xFE,
+		FLATHASHMAP_MIN_CAPACITY = 16,
+
+		// The quotient of the next two constants controls how much the
+		// internal storage of the hashmap may fill up before being
+		// increased automatically. Deleted slots are counted as well.
+		FLATHASHMAP_LOADFACTOR_NUMERATOR = 3,
+		FLATHASHMAP_LOADFACTOR_DENOMINATOR = 4
+	};
+
+	static const size_type NOT_FOUND = (size_type)-1;
+
+	byte *_ctrl;		///< metadata byte for each slot
+	Node *_nodes;		///< storage for the nodes, constructed in full slots only
+	size_type _mask;	///< Capacity of the HashMap minus one; must be a power of two of minus one
+	size_type _size;
+	size_type _deleted;	///< Number of slots marked as deleted
+
+	HashFunc _hash;
+	EqualFunc _equal;
+
+	/** Default value, returned by the const getVal. */
+	const Val _defaultVal;
+
+#ifdef DEBUG_HASH_COLLISIONS
+	mutable int _collisions, _lookups, _dummyHits;
+#endif
+
+	/**
+	 * Spread the bits of the hash, since the probe position comes from its
+	 * low bits and the metadata from its high bits, and a number of our
+	 * hash functions (for integers, for instance) are the identity.
+	 */
+	static size_type mixHash(size_type hash) {
+		hash ^= hash >> 16;
+		hash *= 0x85EBCA6B;
+		hash ^= hash >> 13;
+		hash *= 0xC2B2AE35;
+		hash ^= hash >> 16;
+		return hash;
+	}
+
+	static byte hashTag(size_type hash) {
+		return (byte)((hash >> 25) & 0x7F);
+	}
+
+	bool isFull(size_type idx) const {
+		return !(_ctrl[idx] & 0x80);
+	}
+
+	void allocStorage(size_type capacity);
+	void freeStorage();
+	void assign(const HM_t &map);
+	size_type lookup(const Key &key) const;
+	size_type lookupAndCreateIfMissing(const Key &key);
+	void expandStorage(size_type newCapacity);
+	void eraseAt(size_type idx);
+
+	/**
+	 * Simple FlatHashMap iterator implementation.
+	 */
+	template<class NodeType>
+	class IteratorImpl {
+		friend class FlatHashMap;
+		template<class T> friend class IteratorImpl;
+	protected:
+		typedef const FlatHashMap hashmap_t;
+
+		size_type _idx;
+		hashmap_t *_hashmap;
+
+	protected:
+		IteratorImpl(size_type idx, hashmap_t *hashmap) : _idx(idx), _hashmap(hashmap) {}
+
+		NodeType *deref() const {
+			assert(_hashmap != 0);
+			assert(_idx <= _hashmap->_mask);
+			assert(_hashmap->isFull(_idx));
+			return &_hashmap->_nodes[_idx];
+		}
+
+	public:
+		IteratorImpl() : _idx(0), _hashmap(0) {}
+		template<class T>
+		IteratorImpl(const IteratorImpl<T> &c) : _idx(c._idx), _hashmap(c._hashmap) {}
+
+		NodeType &operator*() const { return *deref(); }
+		NodeType *operator->() const { return deref(); }
+
+		bool operator==(const IteratorImpl &iter) const { return _idx == iter._idx && _hashmap == iter._hashmap; }
+		bool operator!=(const IteratorImpl &iter) const { return !(*this == iter); }
+
+		IteratorImpl &operator++() {
+			assert(_hashmap);
+			do {
+				_idx++;
+			} while (_idx <= _hashmap->_mask && !_hashmap->isFull(_idx));
+			if (_idx > _hashmap->_mask)
+				_idx = NOT_FOUND;
+
+			return *this;
+		}
+
+		IteratorImpl operator++(int) {
+			IteratorImpl old = *this;
+			operator ++();
+			return old;
+		}
+	};
+
+public:
+	typedef IteratorImpl<Node> iterator;
+	typedef IteratorImpl<const Node> const_iterator;
+
+	FlatHashMap();
+	FlatHashMap(const HM_t &map);
+	~FlatHashMap();
+
+	HM_t &operator=(const HM_t &map) {
+		if (this == &map)
+			return *this;
+
+		// Remove the previous content and ...
+		freeStorage();
+		// ... copy the new stuff.
+		assign(map);
+		return *this;
+	}
+
+	bool contains(const Key &key) const;
+
+	Val &operator[](const Key &key);
+	const Val &operator[](const Key &key) const;
+
+	Val &getVal(const Key &key);
+	const Val &getVal(const Key &key) const;
+	const Val &getVal(const Key &key, const Val &defaultVal) const;
+	void setVal(const Key &key, const Val &val);
+
+	void clear(bool shrinkArray = 0);
+
+	void erase(iterator entry);
+	void erase(const Key &key);
+
+	size_type size() const { return _size; }
+
+	iterator	begin() {
+		// Find and return the first non-empty entry
+		for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+			if (isFull(ctr))
+				return iterator(ctr, this);
+		}
+		return end();
+	}
+	iterator	end() {
+		return iterator(NOT_FOUND, this);
+	}
+
+	const_iterator	begin() const {
+		// Find and return the first non-empty entry
+		for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+			if (isFull(ctr))
+				return const_iterator(ctr, this);
+		}
+		return end();
+	}
+	const_iterator	end() const {
+		return const_iterator(NOT_FOUND, this);
+	}
+
+	iterator	find(const Key &key) {
+		return iterator(lookup(key), this);
+	}
+
+	const_iterator	find(const Key &key) const {
+		return const_iterator(lookup(key), this);
+	}
+
+	bool empty() const {
+		return (_size == 0);
+	}
+};
+
+//-------------------------------------------------------
+// FlatHashMap functions
+
+/**
+ * Base constructor, creates an empty hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::FlatHashMap() : _defaultVal() {
+	allocStorage(FLATHASHMAP_MIN_CAPACITY);
+
+#ifdef DEBUG_HASH_COLLISIONS
+	_collisions = 0;
+	_lookups = 0;
+	_dummyHits = 0;
+#endif
+}
+
+/**
+ * Copy constructor, creates a full copy of the given hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::FlatHashMap(const HM_t &map) : _defaultVal() {
+#ifdef DEBUG_HASH_COLLISIONS
+	_collisions = 0;
+	_lookups = 0;
+	_dummyHits = 0;
+#endif
+	assign(map);
+}
+
+/**
+ * Destructor, frees all used memory.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::~FlatHashMap() {
+	freeStorage();
+#ifdef DEBUG_HASH_COLLISIONS
+	extern void updateHashCollisionStats(int, int, int, int, int);
+	updateHashCollisionStats(_collisions, _dummyHits, _lookups, _mask+1, _size);
+#endif
+}
+
+/**
+ * Internal method for allocating empty storage of the given capacity,
+ * which must be a power of two.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::allocStorage(size_type capacity) {
+	_mask = capacity - 1;
+	_size = 0;
+	_deleted = 0;
+
+	_ctrl = new byte[capacity];
+	assert(_ctrl != NULL);
+	memset(_ctrl, FLATHASHMAP_EMPTY, capacity);
+
+	_nodes = (Node *)malloc(capacity * sizeof(Node));
+	assert(_nodes != NULL);
+}
+
+/**
+ * Internal method for destroying all nodes and freeing the storage.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::freeStorage() {
+	for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+		if (isFull(ctr))
+			_nodes[ctr].~Node();
+	}
+
+	delete[] _ctrl;
+	free(_nodes);
+}
+
+/**
+ * Internal method for assigning the content of another FlatHashMap
+ * to this one.
+ *
+ * @note We do *not* deallocate the previous storage here -- the caller is
+ *       responsible for doing that!
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::assign(const HM_t &map) {
+	allocStorage(map._mask + 1);
+
+	// Keep the slots of all elements, so that no rehashing is needed
+	memcpy(_ctrl, map._ctrl, _mask + 1);
+	for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+		if (isFull(ctr))
+			new ((void *)&_nodes[ctr]) Node(map._nodes[ctr]);
+	}
+
+	_size = map._size;
+	_deleted = map._deleted;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::clear(bool shrinkArray) {
+	if (shrinkArray && _mask >= FLATHASHMAP_MIN_CAPACITY) {
+		freeStorage();
+		allocStorage(FLATHASHMAP_MIN_CAPACITY);
+		return;
+	}
+
+	for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+		if (isFull(ctr))
+			_nodes[ctr].~Node();
+	}
+	memset(_ctrl, FLATHASHMAP_EMPTY, _mask + 1);
+
+	_size = 0;
+	_deleted = 0;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::expandStorage(size_type newCapacity) {
+	assert(newCapacity >= _mask+1);
+
+	const size_type old_size = _size;
+	const size_type old_mask = _mask;
+	byte *old_ctrl = _ctrl;
+	Node *old_nodes = _nodes;
+
+	allocStorage(newCapacity);
+
+	// Move all the old elements. Since we know that no key exists twice in
+	// the old table, we only need to look for a free slot.
+	for (size_type ctr = 0; ctr <= old_mask; ++ctr) {
+		if (old_ctrl[ctr] & 0x80)
+			continue;
+
+		const size_type hash = mixHash(_hash(old_nodes[ctr]._key));
+		size_type idx = hash & _mask;
+		while (isFull(idx))
+			idx = (idx + 1) & _mask;
+
+		_ctrl[idx] = old_ctrl[ctr];
+		new ((void *)&_nodes[idx]) Node(old_nodes[ctr]);
+		old_nodes[ctr].~Node();
+	}
+	_size = old_size;
+
+	delete[] old_ctrl;
+	free(old_nodes);
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+typename FlatHashMap<Key, Val, HashFunc, EqualFunc>::size_type FlatHashMap<Key, Val, HashFunc, EqualFunc>::lookup(const Key &key) const {
+	const size_type hash = mixHash(_hash(key));
+	const byte tag = hashTag(hash);
+
+#ifdef DEBUG_HASH_COLLISIONS
+	_lookups++;
+#endif
+
+	// The load factor guarantees that there is an empty slot to stop at
+	for (size_type ctr = hash & _mask; ; ctr = (ctr + 1) & _mask) {
+		const byte ctrl = _ctrl[ctr];
+		if (ctrl == FLATHASHMAP_EMPTY)
+			return NOT_FOUND;
+		if (ctrl == tag && _equal(_nodes[ctr]._key, key))
+			return ctr;
+
+#ifdef DEBUG_HASH_COLLISIONS
+		if (ctrl == FLATHASHMAP_DELETED)
+			_dummyHits++;
+		_collisions++;
+#endif
+	}
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+typename FlatHashMap<Key, Val, HashFunc, EqualFunc>::size_type FlatHashMap<Key, Val, HashFunc, EqualFunc>::lookupAndCreateIfMissing(const Key &key) {
+	const size_type hash = mixHash(_hash(key));
+	const byte tag = hashTag(hash);
+	size_type firstFree = NOT_FOUND;
+	size_type ctr;
+
+#ifdef DEBUG_HASH_COLLISIONS
+	_lookups++;
+#endif
+
+	for (ctr = hash & _mask; ; ctr = (ctr + 1) & _mask) {
+		const byte ctrl = _ctrl[ctr];
+		if (ctrl == FLATHASHMAP_EMPTY)
+			break;
+		if (ctrl == FLATHASHMAP_DELETED) {
+#ifdef DEBUG_HASH_COLLISIONS
+			_dummyHits++;
+#endif
+			if (firstFree == NOT_FOUND)
+				firstFree = ctr;
+		} else if (ctrl == tag && _equal(_nodes[ctr]._key, key)) {
+			return ctr;
+		}
+
+#ifdef DEBUG_HASH_COLLISIONS
+		_collisions++;
+#endif
+	}
+
+	// Reuse the first deleted slot on the probe sequence, if any
+	if (firstFree != NOT_FOUND) {
+		ctr = firstFree;
+		_deleted--;
+	}
+
+	_ctrl[ctr] = tag;
+	new ((void *)&_nodes[ctr]) Node(key);
+	_size++;
+
+	// Keep the load factor below a certain threshold.
+	// Deleted slots are also counted
+	size_type capacity = _mask + 1;
+	if ((_size + _deleted) * FLATHASHMAP_LOADFACTOR_DENOMINATOR >
+	        capacity * FLATHASHMAP_LOADFACTOR_NUMERATOR) {
+		// Only grow if the map is really full, not just of deleted slots
+		if (_size * FLATHASHMAP_LOADFACTOR_DENOMINATOR * 2 > capacity * FLATHASHMAP_LOADFACTOR_NUMERATOR)
+			capacity = capacity < 500 ? (capacity * 4) : (capacity * 2);
+		expandStorage(capacity);
+		ctr = lookup(key);
+		assert(ctr != NOT_FOUND);
+	}
+
+	return ctr;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::eraseAt(size_type idx) {
+	_nodes[idx].~Node();
+	_size--;
+
+	// A slot followed by an empty one ends every probe sequence passing
+	// through it, so it can be marked empty instead of deleted.
+	if (_ctrl[(idx + 1) & _mask] == FLATHASHMAP_EMPTY) {
+		_ctrl[idx] = FLATHASHMAP_EMPTY;
+	} else {
+		_ctrl[idx] = FLATHASHMAP_DELETED;
+		_deleted++;
+	}
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+bool FlatHashMap<Key, Val, HashFunc, EqualFunc>::contains(const Key &key) const {
+	return lookup(key) != NOT_FOUND;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::operator[](const Key &key) {
+	return getVal(key);
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::operator[](const Key &key) const {
+	return getVal(key);
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getVal(const Key &key) {
+	size_type ctr = lookupAndCreateIfMissing(key);
+	return _nodes[ctr]._value;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getVal(const Key &key) const {
+	return getVal(key, _defaultVal);
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getVal(const Key &key, const Val &defaultVal) const {
+	size_type ctr = lookup(key);
+	if (ctr != NOT_FOUND)
+		return _nodes[ctr]._value;
+	else
+		return defaultVal;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::setVal(const Key &key, const Val &val) {
+	size_type ctr = lookupAndCreateIfMissing(key);
+	_nodes[ctr]._value = val;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::erase(iterator entry) {
+	// Check whether we have a valid iterator
+	assert(entry._hashmap == this);
+	assert(entry._idx <= _mask);
+	assert(isFull(entry._idx));
+
+	eraseAt(entry._idx);
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::erase(const Key &key) {
+	size_type ctr = lookup(key);
+	if (ctr != NOT_FOUND)
+		eraseAt(ctr);
+}
+
+} // End of namespace Common
+
+#endif
@@ -213,6 +213,19 @@ public:
 	 */
 	bool isWritable() const;
 
+	/**
+	 * Queries the size and the time of the last modification of the file
+	 * referred by this node, without opening it. This is meant for
+	 * validating cached information about a file; not all backends support
+	 * it.
+	 *
+	 * @param size			set to the size of the file, in bytes
+	 * @param lastModified	set to the modification time of the file, in a
+	 *						backend specific unit
+	 * @return true if the information is available, false otherwise.
+	 */
+	bool getFileStats(uint32 &size, uint32 &lastModified) const;
+
 	/**
 	 * Creates a SeekableReadStream instance corresponding to the file
 	 * referred by this node. This assumes that the node actually refers
@@ -222,6 +235,16 @@ public:
 	 */
 	virtual SeekableReadStream *createReadStream() const;
 
+	/**
+	 * Creates a SeekableReadStream instance like createReadStream(), but
+	 * the backend may map the file into memory. Only use this for files
+	 * which are not written to while ScummVM runs, such as game data.
+	 * FSDirectory uses it for its members.
+	 *
+	 * @return pointer to the stream object, 0 in case of a failure
+	 */
+	SeekableReadStream *createMappedReadStream() const;
+
 	/**
 	 * Creates a WriteStream instance corresponding to the file
 	 * referred by this node. This assumes that the node actually refers
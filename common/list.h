@@ -25,6 +25,10 @@
 
 #include "common/list_intern.h"
 
+#ifdef USE_ARENA_ALLOCATOR
+#include "common/arena.h"
+#endif
+
 namespace Common {
 
 /**
@@ -195,7 +199,7 @@ public:
 		while (pos != &_anchor) {
 			Node *node = static_cast<Node *>(pos);
 			pos = pos->_next;
-			delete node;
+			freeNode(node);
 		}
 
 		_anchor._prev = &_anchor;
@@ -232,12 +236,31 @@ public:
 	}
 
 protected:
+#ifdef USE_ARENA_ALLOCATOR
+	static Node *allocNode(const t_T &element) {
+		return new (arenaAlloc(sizeof(Node))) Node(element);
+	}
+
+	static void freeNode(Node *node) {
+		node->~Node();
+		arenaFree(node, sizeof(Node));
+	}
+#else
+	static Node *allocNode(const t_T &element) {
+		return new Node(element);
+	}
+
+	static void freeNode(Node *node) {
+		delete node;
+	}
+#endif
+
 	NodeBase erase(NodeBase *pos) {
 		NodeBase n = *pos;
 		Node *node = static_cast<Node *>(pos);
 		n._prev->_next = n._next;
 		n._next->_prev = n._prev;
-		delete node;
+		freeNode(node);
 		return n;
 	}
 
@@ -245,7 +268,7 @@ protected:
 	 * Inserts element before pos.
 	 */
 	void insert(NodeBase *pos, const t_T &element) {
-		ListInternal::NodeBase *newNode = new Node(element);
+		ListInternal::NodeBase *newNode = allocNode(element);
 		assert(newNode);
 
 		newNode->_next = pos;
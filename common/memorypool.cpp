@@ -44,6 +44,8 @@ MemoryPool::MemoryPool(size_t chunkSize)
 	: _chunkSize(adjustChunkSize(chunkSize)) {
 
 	_next = NULL;
+	_internalPage.start = NULL;
+	_internalPage.numChunks = 0;
 
 	_chunksPerPage = INITIAL_CHUNKS_PER_PAGE;
 }
@@ -112,6 +114,15 @@ void MemoryPool::freeChunk(void *ptr) {
 	_next = ptr;
 }
 
+void MemoryPool::freeAllChunks() {
+	_next = NULL;
+
+	if (_internalPage.start)
+		addPageToPool(_internalPage);
+	for (size_t i = 0; i < _pages.size(); ++i)
+		addPageToPool(_pages[i]);
+}
+
 // Technically not compliant C++ to compare unrelated pointers. In practice...
 bool MemoryPool::isPointerInPage(void *ptr, const Page &page) {
 	return (ptr >= page.start) && (ptr < (char *)page.start + page.numChunks * _chunkSize);
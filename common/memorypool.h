@@ -51,6 +51,7 @@ protected:
 
 	const size_t	_chunkSize;
 	Array<Page>		_pages;
+	Page			_internalPage;
 	void			*_next;
 	size_t			_chunksPerPage;
 
@@ -90,6 +91,13 @@ public:
 	 */
 	void	freeUnusedPages();
 
+	/**
+	 * Return every chunk to the pool at once, as if freeChunk() had been
+	 * called for each chunk still in use. The pages are kept, so the pool
+	 * can serve as many chunks again without allocating memory.
+	 */
+	void	freeAllChunks();
+
 	/**
 	 * Return the chunk size used by this memory pool.
 	 */
@@ -114,6 +122,7 @@ public:
 		assert(REAL_CHUNK_SIZE == _chunkSize);
 		// Insert some static storage
 		Page internalPage = { _storage, NUM_INTERNAL_CHUNKS };
+		_internalPage = internalPage;
 		addPageToPool(internalPage);
 	}
 };
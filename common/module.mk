@@ -1,9 +1,11 @@
 MODULE := common
 
 MODULE_OBJS := \
+	arena.o \
 	archive.o \
 	config-manager.o \
 	coroutines.o \
+	cpudetect.o \
 	dcl.o \
 	debug.o \
 	error.o \
@@ -42,6 +44,7 @@ MODULE_OBJS := \
 	winexe.o \
 	winexe_ne.o \
 	winexe_pe.o \
+	workerpool.o \
 	xmlparser.o \
 	zlib.o
 
@@ -20,6 +20,7 @@
  *
  */
 
+#include "common/arena.h"
 #include "common/hash-str.h"
 #include "common/list.h"
 #include "common/memorypool.h"
@@ -35,6 +36,22 @@ static uint32 computeCapacity(uint32 len) {
 	return ((len + 32 - 1) & ~0x1F);
 }
 
+static inline char *allocStorage(uint32 capacity) {
+#ifdef USE_ARENA_ALLOCATOR
+	return (char *)arenaAlloc(capacity);
+#else
+	return new char[capacity];
+#endif
+}
+
+static inline void freeStorage(char *storage, uint32 capacity) {
+#ifdef USE_ARENA_ALLOCATOR
+	arenaFree(storage, capacity);
+#else
+	delete[] storage;
+#endif
+}
+
 String::String(const char *str) : _size(0), _str(_storage) {
 	if (str == 0) {
 		_storage[0] = 0;
@@ -65,7 +82,7 @@ void String::initWithCStr(const char *str, uint32 len) {
 		// Not enough internal storage, so allocate more
 		_extern._capacity = computeCapacity(len+1);
 		_extern._refCount = 0;
-		_str = new char[_extern._capacity];
+		_str = allocStorage(_extern._capacity);
 		assert(_str != 0);
 	}
 
@@ -142,7 +159,7 @@ void String::ensureCapacity(uint32 new_size, bool keep_old) {
 		newCapacity = MAX(curCapacity * 2, computeCapacity(new_size+1));
 
 	// Allocate new storage
-	newStorage = new char[newCapacity];
+	newStorage = allocStorage(newCapacity);
 	assert(newStorage);
 
 
@@ -199,7 +216,7 @@ void String::decRefCount(int *oldRefCount) {
 			assert(g_refCountPool);
 			g_refCountPool->freeChunk(oldRefCount);
 		}
-		delete[] _str;
+		freeStorage(_str, _extern._capacity);
 
 		// Even though _str points to a freed memory block now,
 		// we do not change its value, because any code that calls
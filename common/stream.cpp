@@ -261,6 +261,14 @@ bool SeekableSubReadStream::seek(int32 offset, int whence) {
 	return ret;
 }
 
+const byte *SeekableSubReadStream::getMemory() const {
+	const byte *parentMemory = _parentStream->getMemory();
+	if (!parentMemory || _end > (uint32)_parentStream->size())
+		return 0;
+
+	return parentMemory + _begin;
+}
+
 uint32 SafeSeekableSubReadStream::read(void *dataPtr, uint32 dataSize) {
 	// Make sure the parent stream is at the right position
 	seek(0, SEEK_CUR);
@@ -485,6 +485,17 @@ public:
 	 */
 	virtual bool skip(uint32 offset) { return seek(offset, SEEK_CUR); }
 
+	/**
+	 * Returns a pointer to the whole contents of the stream, for streams
+	 * backed by memory which stays valid as long as the stream exists,
+	 * like memory buffers and memory mapped files. This allows callers
+	 * to access the data without copying it.
+	 *
+	 * @return a pointer to size() bytes, or 0 if the stream reads its data
+	 *         on demand
+	 */
+	virtual const byte *getMemory() const { return 0; }
+
 	/**
 	 * Reads at most one less than the number of characters specified
 	 * by bufSize from the and stores them in the string buf. Reading
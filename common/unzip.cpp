@@ -105,7 +105,10 @@ typedef struct {
 
 #include "common/fs.h"
 #include "common/unzip.h"
+#include "common/list.h"
 #include "common/memstream.h"
+#include "common/ptr.h"
+#include "common/substream.h"
 
 #include "common/hashmap.h"
 #include "common/hash-str.h"
@@ -382,6 +385,7 @@ typedef Common::HashMap<Common::String, cached_file_in_zip, Common::IgnoreCase_H
 */
 typedef struct {
 	Common::SeekableReadStream *_stream;				/* io structore of the zipfile */
+	Common::SharedPtr<Common::SeekableReadStream> _streamRef;	/* shared with streamed members */
 	unz_global_info gi;				/* public global information */
 	uLong byte_before_the_zipfile;	/* byte before the zipfile, (>0 for sfx)*/
 	uLong num_file;					/* number of the current file in the zipfile*/
@@ -544,6 +548,7 @@ unzFile unzOpen(Common::SeekableReadStream *stream) {
 	int err=UNZ_OK;
 
 	us->_stream = stream;
+	us->_streamRef = Common::SharedPtr<Common::SeekableReadStream>(stream);
 
 	central_pos = unzlocal_SearchCentralDir(*us->_stream);
 	if (central_pos==0)
@@ -595,7 +600,6 @@ unzFile unzOpen(Common::SeekableReadStream *stream) {
 		err=UNZ_BADZIPFILE;
 
 	if (err != UNZ_OK) {
-		delete us->_stream;
 		delete us;
 		return NULL;
 	}
@@ -644,7 +648,7 @@ int unzClose(unzFile file) {
 	if (s->pfile_in_zip_read != NULL)
 		unzCloseCurrentFile(file);
 
-	delete s->_stream;
+	// The stream is deleted once no streamed member uses it anymore
 	delete s;
 	return UNZ_OK;
 }
@@ -1421,8 +1425,50 @@ namespace Common {
 
 
 class ZipArchive : public Archive {
+	enum {
+		/**
+		 * Stored members at least this large are read straight from the
+		 * archive, instead of being read into memory when opened.
+		 */
+		kStreamedMemberSize = 1024 * 1024,
+
+		/** Members up to this size are kept in the member cache. */
+		kMaxCachedMemberSize = 256 * 1024,
+
+		/** Total size of the members kept in the member cache. */
+		kMemberCacheSize = 1024 * 1024
+	};
+
+	struct FreeDeleter {
+		void operator()(byte *ptr) { free(ptr); }
+	};
+
+	typedef SharedPtr<byte> MemberData;
+	typedef List<String> MemberLRU;
+
+	struct CachedMember {
+		MemberData data;
+		uint32 size;
+		MemberLRU::iterator lru;
+	};
+
+	typedef HashMap<String, CachedMember, IgnoreCase_Hash, IgnoreCase_EqualTo> MemberCache;
+
 	unzFile _zipFile;
 
+	/**
+	 * Recently opened small members, so that opening them again does not
+	 * require reading and decompressing them again. The least recently
+	 * opened members are evicted when the cache exceeds its size.
+	 */
+	mutable MemberCache _cache;
+	mutable MemberLRU _cacheLRU;
+	mutable uint32 _cacheSize;
+
+	SeekableReadStream *createStreamedMember(const unz_file_info &fileInfo) const;
+	SeekableReadStream *createCachedMember(const String &name) const;
+	void addToCache(const String &name, const MemberData &data, uint32 size) const;
+
 public:
 	ZipArchive(unzFile zipFile);
 
@@ -1435,6 +1481,32 @@ public:
 	virtual SeekableReadStream *createReadStreamForMember(const String &name) const;
 };
 
+/**
+ * Stream over a member held in the member cache of a ZipArchive. It keeps
+ * the data alive when the member is evicted from the cache.
+ */
+class ZipCachedMemberStream : public MemoryReadStream {
+	SharedPtr<byte> _data;
+
+public:
+	ZipCachedMemberStream(const SharedPtr<byte> &data, uint32 size)
+		: MemoryReadStream(data.get(), size), _data(data) {
+	}
+};
+
+/**
+ * Stream over a stored member of a ZipArchive. It shares the stream of the
+ * archive, so it stays valid after the archive is deleted.
+ */
+class ZipStreamedMemberStream : public SafeSeekableSubReadStream {
+	SharedPtr<SeekableReadStream> _archiveStream;
+
+public:
+	ZipStreamedMemberStream(const SharedPtr<SeekableReadStream> &archiveStream, uint32 begin, uint32 end)
+		: SafeSeekableSubReadStream(archiveStream.get(), begin, end), _archiveStream(archiveStream) {
+	}
+};
+
 /*
 class ZipArchiveMember : public ArchiveMember {
 	unzFile _zipFile;
@@ -1453,7 +1525,7 @@ public:
 };
 */
 
-ZipArchive::ZipArchive(unzFile zipFile) : _zipFile(zipFile) {
+ZipArchive::ZipArchive(unzFile zipFile) : _zipFile(zipFile), _cacheSize(0) {
 	assert(_zipFile);
 }
 
@@ -1486,9 +1558,51 @@ const ArchiveMemberPtr ZipArchive::getMember(const String &name) const {
 }
 
 SeekableReadStream *ZipArchive::createReadStreamForMember(const String &name) const {
+	MemberCache::iterator cached = _cache.find(name);
+	if (cached != _cache.end()) {
+		// Mark the member as the most recently used one
+		_cacheLRU.erase(cached->_value.lru);
+		_cacheLRU.push_front(cached->_key);
+		cached->_value.lru = _cacheLRU.begin();
+
+		return new ZipCachedMemberStream(cached->_value.data, cached->_value.size);
+	}
+
 	if (unzLocateFile(_zipFile, name.c_str(), 2) != UNZ_OK)
 		return 0;
 
+	unz_file_info fileInfo;
+	if (unzGetCurrentFileInfo(_zipFile, &fileInfo, NULL, 0, NULL, 0, NULL, 0) != UNZ_OK)
+		return 0;
+
+	// Deflated members are always inflated into memory, as seeking back
+	// in a stream inflating on the fly has to start over from the beginning.
+	if (fileInfo.compression_method == 0 && fileInfo.uncompressed_size >= kStreamedMemberSize) {
+		SeekableReadStream *stream = createStreamedMember(fileInfo);
+		if (stream)
+			return stream;
+	}
+
+	return createCachedMember(name);
+}
+
+SeekableReadStream *ZipArchive::createStreamedMember(const unz_file_info &fileInfo) const {
+	// Open the member to find where its data starts
+	if (unzOpenCurrentFile(_zipFile) != UNZ_OK)
+		return 0;
+
+	unz_s *const archive = (unz_s *)_zipFile;
+	const file_in_zip_read_info_s *const info = archive->pfile_in_zip_read;
+	const uint32 begin = info->pos_in_zipfile + info->byte_before_the_zipfile;
+	const uint32 end = begin + fileInfo.compressed_size;
+	unzCloseCurrentFile(_zipFile);
+
+	// The member streams share the archive stream, so they must seek it
+	// before each read.
+	return new ZipStreamedMemberStream(archive->_streamRef, begin, end);
+}
+
+SeekableReadStream *ZipArchive::createCachedMember(const String &name) const {
 	unz_file_info fileInfo;
 	if (unzOpenCurrentFile(_zipFile) != UNZ_OK)
 		return 0;
@@ -1509,12 +1623,29 @@ SeekableReadStream *ZipArchive::createReadStreamForMember(const String &name) co
 		return 0;
 	}
 
-	return new MemoryReadStream(buffer, fileInfo.uncompressed_size, DisposeAfterUse::YES);
+	if (fileInfo.uncompressed_size == 0 || fileInfo.uncompressed_size > kMaxCachedMemberSize)
+		return new MemoryReadStream(buffer, fileInfo.uncompressed_size, DisposeAfterUse::YES);
+
+	MemberData data(buffer, FreeDeleter());
+	addToCache(name, data, fileInfo.uncompressed_size);
+	return new ZipCachedMemberStream(data, fileInfo.uncompressed_size);
+}
+
+void ZipArchive::addToCache(const String &name, const MemberData &data, uint32 size) const {
+	while (!_cacheLRU.empty() && _cacheSize + size > kMemberCacheSize) {
+		MemberCache::iterator oldest = _cache.find(_cacheLRU.back());
+		_cacheSize -= oldest->_value.size;
+		_cache.erase(oldest);
+		_cacheLRU.pop_back();
+	}
+
+	_cacheLRU.push_front(name);
 
-	// FIXME: instead of reading all into a memory stream, we could
-	// instead create a new ZipStream class. But then we have to be
-	// careful to handle the case where the client code opens multiple
-	// files in the archive and tries to use them independently.
+	CachedMember &member = _cache[name];
+	member.data = data;
+	member.size = size;
+	member.lru = _cacheLRU.begin();
+	_cacheSize += size;
 }
 
 Archive *makeZipArchive(const String &name) {
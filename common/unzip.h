@@ -31,6 +31,13 @@ class Archive;
 class FSNode;
 class SeekableReadStream;
 
+/*
+ * Note that large stored members of ZIP archives are read straight from the
+ * archive file. Their streams share the file with the archive, and keep it
+ * open after the archive is deleted, but must not be used on other threads
+ * than the archive.
+ */
+
 /**
  * This factory method creates an Archive instance corresponding to the content
  * of the ZIP compressed file with the given name.
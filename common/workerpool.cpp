@@ -0,0 +1,299 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+// The worker threads use the host's thread API directly
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include "common/workerpool.h"
+#include "common/util.h"
+
+#ifdef HAVE_PTHREADS
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+namespace Common {
+
+#ifdef HAVE_PTHREADS
+
+struct WorkerPool::Threads {
+	pthread_t *threads;
+	pthread_mutex_t mutex;
+	pthread_cond_t workAvailable;
+	pthread_cond_t jobDone;
+
+	WorkerJob *queueHead;
+	WorkerJob *queueTail;
+	uint pending;
+	bool quit;
+
+	WorkerJob *takeJob() {
+		WorkerJob *job = queueHead;
+		queueHead = job->_next;
+		if (!queueHead)
+			queueTail = nullptr;
+		job->_next = nullptr;
+		return job;
+	}
+
+	bool unqueue(WorkerJob *job) {
+		WorkerJob **link = &queueHead;
+		WorkerJob *prev = nullptr;
+		while (*link && *link != job) {
+			prev = *link;
+			link = &prev->_next;
+		}
+		if (!*link)
+			return false;
+
+		*link = job->_next;
+		if (queueTail == job)
+			queueTail = prev;
+		job->_next = nullptr;
+		return true;
+	}
+
+	void runJob(WorkerJob *job) {
+		job->_state = WorkerJob::kStateRunning;
+		pthread_mutex_unlock(&mutex);
+		job->run();
+		pthread_mutex_lock(&mutex);
+		job->_state = WorkerJob::kStateDone;
+		--pending;
+		pthread_cond_broadcast(&jobDone);
+	}
+
+	static void *workerMain(void *arg) {
+		Threads *t = (Threads *)arg;
+
+		pthread_mutex_lock(&t->mutex);
+		for (;;) {
+			while (!t->queueHead && !t->quit)
+				pthread_cond_wait(&t->workAvailable, &t->mutex);
+			if (!t->queueHead)
+				break;
+			t->runJob(t->takeJob());
+		}
+		pthread_mutex_unlock(&t->mutex);
+
+		return nullptr;
+	}
+};
+
+WorkerPool::WorkerPool(uint numThreads, bool sequential) : _threads(nullptr), _numThreads(0), _sequential(sequential) {
+	assert(!sequential || numThreads <= 1);
+
+	if (!numThreads)
+		return;
+
+	_threads = new Threads();
+	_threads->threads = new pthread_t[numThreads];
+	pthread_mutex_init(&_threads->mutex, nullptr);
+	pthread_cond_init(&_threads->workAvailable, nullptr);
+	pthread_cond_init(&_threads->jobDone, nullptr);
+	_threads->queueHead = _threads->queueTail = nullptr;
+	_threads->pending = 0;
+	_threads->quit = false;
+
+	// Without threads the pool still works, so failing to start some of
+	// them is not fatal.
+	while (_numThreads < numThreads && pthread_create(&_threads->threads[_numThreads], nullptr, Threads::workerMain, _threads) == 0)
+		++_numThreads;
+}
+
+WorkerPool::~WorkerPool() {
+	if (!_threads)
+		return;
+
+	pthread_mutex_lock(&_threads->mutex);
+	_threads->quit = true;
+	pthread_cond_broadcast(&_threads->workAvailable);
+	pthread_mutex_unlock(&_threads->mutex);
+
+	for (uint i = 0; i < _numThreads; ++i)
+		pthread_join(_threads->threads[i], nullptr);
+
+	// Jobs left over if no thread could be started
+	while (_threads->queueHead) {
+		WorkerJob *job = _threads->takeJob();
+		job->run();
+		job->_state = WorkerJob::kStateDone;
+	}
+
+	pthread_cond_destroy(&_threads->jobDone);
+	pthread_cond_destroy(&_threads->workAvailable);
+	pthread_mutex_destroy(&_threads->mutex);
+	delete[] _threads->threads;
+	delete _threads;
+}
+
+void WorkerPool::submit(WorkerJob *job) {
+	if (!_numThreads) {
+		job->_state = WorkerJob::kStateRunning;
+		job->run();
+		job->_state = WorkerJob::kStateDone;
+		return;
+	}
+
+	pthread_mutex_lock(&_threads->mutex);
+	assert(job->_state == WorkerJob::kStateIdle || job->_state == WorkerJob::kStateDone);
+	job->_state = WorkerJob::kStateQueued;
+	if (_threads->queueTail)
+		_threads->queueTail->_next = job;
+	else
+		_threads->queueHead = job;
+	_threads->queueTail = job;
+	++_threads->pending;
+	pthread_cond_signal(&_threads->workAvailable);
+	pthread_mutex_unlock(&_threads->mutex);
+}
+
+bool WorkerPool::isDone(WorkerJob *job) {
+	if (!_numThreads)
+		return job->_state != WorkerJob::kStateRunning;
+
+	pthread_mutex_lock(&_threads->mutex);
+	const bool done = (job->_state == WorkerJob::kStateDone || job->_state == WorkerJob::kStateIdle);
+	pthread_mutex_unlock(&_threads->mutex);
+	return done;
+}
+
+void WorkerPool::wait(WorkerJob *job) {
+	if (!_numThreads)
+		return;
+
+	pthread_mutex_lock(&_threads->mutex);
+	if (!_sequential && job->_state == WorkerJob::kStateQueued && _threads->unqueue(job))
+		_threads->runJob(job);
+	while (job->_state == WorkerJob::kStateQueued || job->_state == WorkerJob::kStateRunning)
+		pthread_cond_wait(&_threads->jobDone, &_threads->mutex);
+	pthread_mutex_unlock(&_threads->mutex);
+}
+
+void WorkerPool::waitAll() {
+	if (!_numThreads)
+		return;
+
+	pthread_mutex_lock(&_threads->mutex);
+	while (_threads->pending)
+		pthread_cond_wait(&_threads->jobDone, &_threads->mutex);
+	pthread_mutex_unlock(&_threads->mutex);
+}
+
+uint WorkerPool::getProcessorCount() {
+	const long count = sysconf(_SC_NPROCESSORS_ONLN);
+	return count > 0 ? (uint)count : 1;
+}
+
+#else
+
+struct WorkerPool::Threads {
+};
+
+WorkerPool::WorkerPool(uint numThreads, bool sequential) : _threads(nullptr), _numThreads(0), _sequential(sequential) {
+}
+
+WorkerPool::~WorkerPool() {
+}
+
+void WorkerPool::submit(WorkerJob *job) {
+	job->_state = WorkerJob::kStateRunning;
+	job->run();
+	job->_state = WorkerJob::kStateDone;
+}
+
+bool WorkerPool::isDone(WorkerJob *job) {
+	return job->_state != WorkerJob::kStateRunning;
+}
+
+void WorkerPool::wait(WorkerJob *job) {
+}
+
+void WorkerPool::waitAll() {
+}
+
+uint WorkerPool::getProcessorCount() {
+	return 1;
+}
+
+#endif
+
+WorkerPool &WorkerPool::getShared() {
+	// The calling thread takes a share of the work as well. More threads
+	// than this hardly pay off for the small jobs we split.
+	static WorkerPool pool(MIN<uint>(getProcessorCount(), 8) - 1);
+	return pool;
+}
+
+namespace {
+
+class BandJob : public WorkerJob {
+public:
+	BandJob() : _job(nullptr), _begin(0), _end(0) {}
+
+	void set(BandedJob *job, int begin, int end) {
+		_job = job;
+		_begin = begin;
+		_end = end;
+	}
+
+	void run() {
+		_job->runBand(_begin, _end);
+	}
+
+private:
+	BandedJob *_job;
+	int _begin;
+	int _end;
+};
+
+} // End of anonymous namespace
+
+void runBanded(BandedJob &job, int count, int minBandSize, WorkerPool *pool) {
+	if (!pool)
+		pool = &WorkerPool::getShared();
+
+	int numBands = MIN<int>(pool->getThreadCount() + 1, count / MAX(minBandSize, 1));
+	if (numBands <= 1) {
+		if (count > 0)
+			job.runBand(0, count);
+		return;
+	}
+
+	// The calling thread processes the first band itself
+	BandJob *bands = new BandJob[numBands - 1];
+	int begin = count / numBands;
+	for (int i = 1; i < numBands; ++i) {
+		const int end = (int)((int64)count * (i + 1) / numBands);
+		bands[i - 1].set(&job, begin, end);
+		pool->submit(&bands[i - 1]);
+		begin = end;
+	}
+
+	job.runBand(0, count / numBands);
+
+	for (int i = 0; i < numBands - 1; ++i)
+		pool->wait(&bands[i]);
+	delete[] bands;
+}
+
+} // End of namespace Common
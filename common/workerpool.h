@@ -0,0 +1,167 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef COMMON_WORKERPOOL_H
+#define COMMON_WORKERPOOL_H
+
+#include "common/scummsys.h"
+#include "common/noncopyable.h"
+
+namespace Common {
+
+class WorkerPool;
+
+/**
+ * A unit of work which can be run by a WorkerPool.
+ *
+ * A job is not owned by the pool: the submitter must keep it alive until
+ * the pool reports it as done.
+ */
+class WorkerJob {
+	friend class WorkerPool;
+public:
+	WorkerJob() : _next(nullptr), _state(kStateIdle) {}
+	virtual ~WorkerJob() {}
+
+	/**
+	 * Do the work. This may be called on any thread, so it must not use
+	 * g_system or any other state which is not safe to share.
+	 */
+	virtual void run() = 0;
+
+private:
+	enum State {
+		kStateIdle,
+		kStateQueued,
+		kStateRunning,
+		kStateDone
+	};
+
+	WorkerJob *_next;
+	State _state;
+};
+
+/**
+ * A set of worker threads, which run the jobs submitted to them in order of
+ * submission.
+ *
+ * On hosts without thread support, or if the pool has no threads, jobs are
+ * run synchronously by submit(). Code using a pool must thus work correctly
+ * either way.
+ */
+class WorkerPool : NonCopyable {
+public:
+	/**
+	 * Create a pool with the given number of threads.
+	 *
+	 * @param numThreads	the number of worker threads
+	 * @param sequential	whether the jobs must run one after another, in
+	 *						order of submission. wait() then never runs a job
+	 *						on the calling thread. This needs at most one
+	 *						thread.
+	 */
+	explicit WorkerPool(uint numThreads, bool sequential = false);
+
+	/**
+	 * Run all pending jobs and stop the threads.
+	 */
+	~WorkerPool();
+
+	/**
+	 * Return the number of threads of the pool. This is 0 if jobs are run
+	 * on the calling thread.
+	 */
+	uint getThreadCount() const { return _numThreads; }
+
+	/**
+	 * Queue a job to be run on one of the worker threads. A job can be
+	 * submitted again once it is done.
+	 */
+	void submit(WorkerJob *job);
+
+	/**
+	 * Return whether the job has finished running.
+	 */
+	bool isDone(WorkerJob *job);
+
+	/**
+	 * Wait until the job has finished running. Unless the pool is
+	 * sequential, a job which has not been picked up by a worker yet is run
+	 * on the calling thread instead.
+	 */
+	void wait(WorkerJob *job);
+
+	/**
+	 * Wait until all submitted jobs have finished running.
+	 */
+	void waitAll();
+
+	/**
+	 * Return the pool shared by all users which split work across the
+	 * processors of the host. It is created on first use, which must happen
+	 * on the main thread.
+	 */
+	static WorkerPool &getShared();
+
+	/**
+	 * Return the number of processors available to the process.
+	 */
+	static uint getProcessorCount();
+
+private:
+	struct Threads;
+
+	Threads *_threads;
+	uint _numThreads;
+	bool _sequential;
+};
+
+/**
+ * A piece of work which can be split into independent bands, e.g. the rows
+ * of an image.
+ */
+class BandedJob {
+public:
+	virtual ~BandedJob() {}
+
+	/**
+	 * Process the items [begin, end). Bands do not overlap and may be run
+	 * concurrently.
+	 */
+	virtual void runBand(int begin, int end) = 0;
+};
+
+/**
+ * Split the items [0, count) into bands of at least minBandSize items and
+ * process them on the worker threads of the pool and the calling thread.
+ * Returns once all bands have been processed.
+ *
+ * @param job			the work to do
+ * @param count			the number of items
+ * @param minBandSize	the smallest number of items worth a band of its own
+ * @param pool			the pool to use, or nullptr for the shared pool
+ */
+void runBanded(BandedJob &job, int count, int minBandSize, WorkerPool *pool = nullptr);
+
+} // End of namespace Common
+
+#endif
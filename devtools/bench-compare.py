@@ -0,0 +1,58 @@
+#!/usr/bin/env python
+# encoding: utf-8
+#
+# Compare two result files written by 'test/bench/runner --csv' and
+# report the benchmarks which got slower. Exits with status 1 if any did.
+
+import argparse
+import csv
+import sys
+
+def loadResults(fileName):
+	results = {}
+	with open(fileName) as f:
+		for row in csv.DictReader(f):
+			results[(row['suite'], row['name'])] = (float(row['value']), row['unit'])
+	return results
+
+def main():
+	parser = argparse.ArgumentParser(description='Compare two benchmark result files.')
+	parser.add_argument('baseline', help='results of the reference build')
+	parser.add_argument('current', help='results of the build to check')
+	parser.add_argument('--threshold', type=float, default=10.0, help='change in percent below which results are considered equal (default: 10)')
+	args = parser.parse_args()
+
+	baseline = loadResults(args.baseline)
+	current = loadResults(args.current)
+
+	regressions = 0
+	for key in sorted(current.keys()):
+		if key not in baseline:
+			continue
+
+		oldValue, unit = baseline[key]
+		newValue = current[key][0]
+		if oldValue == 0:
+			continue
+
+		# Throughputs are better when higher, times when lower
+		change = (newValue - oldValue) / oldValue * 100.0
+		if unit.endswith('/s'):
+			change = -change
+
+		if abs(change) < args.threshold:
+			continue
+
+		status = 'SLOWER' if change > 0 else 'faster'
+		if change > 0:
+			regressions += 1
+		print ("%-6s %-24s %-40s %12.3f -> %12.3f %s (%+.1f%%)" % (status, key[0], key[1], oldValue, newValue, unit, change))
+
+	missing = [key for key in baseline.keys() if key not in current]
+	for key in sorted(missing):
+		print ("gone   %-24s %s" % key)
+
+	sys.exit(1 if regressions else 0)
+
+if __name__ == '__main__':
+	main()
@@ -0,0 +1,46 @@
+#!/bin/bash
+#
+# Measures the time taken by a headless mass add over a directory tree,
+# first with an empty detection checksum cache and then with the cache
+# filled by the first run.
+#
+# Usage: detection-benchmark.sh <scummvm binary> [<game tree>]
+#
+# Without a game tree, a synthetic one is created, made of directories
+# containing files with names commonly looked for by the detectors.
+
+if test -z "$1" ; then
+	echo "Usage: $0 <scummvm binary> [<game tree>]"
+	exit 1
+fi
+
+SCUMMVM="$1"
+WORKDIR=`mktemp -d /tmp/detection-benchmark.XXXXXX`
+trap 'rm -rf "$WORKDIR"' EXIT
+
+if test -n "$2" ; then
+	TREE="$2"
+else
+	TREE="$WORKDIR/tree"
+	for i in `seq 1 200` ; do
+		mkdir -p "$TREE/game$i"
+		for f in resource.map resource.000 000.lfl data.001 data.prg intro.stk; do
+			head -c 65536 /dev/urandom > "$TREE/game$i/$f"
+		done
+	done
+fi
+
+mkdir -p "$WORKDIR/saves"
+
+run() {
+	# The save path must come from the config file, since the command line
+	# settings are only applied after the detection commands have run.
+	printf "[scummvm]\nsavepath=%s\n" "$WORKDIR/saves" > "$WORKDIR/scummvm.ini"
+	start=`date +%s%N`
+	"$SCUMMVM" -c "$WORKDIR/scummvm.ini" --path="$TREE" --massadd > /dev/null 2>&1
+	end=`date +%s%N`
+	echo "$1: $(( (end - start) / 1000000 )) ms"
+}
+
+run cold
+run warm
@@ -29,10 +29,53 @@
 #include "common/system.h"
 #include "common/textconsole.h"
 #include "common/translation.h"
+#include "common/workerpool.h"
 #include "gui/EventRecorder.h"
 #include "engines/advancedDetector.h"
+#include "engines/detectioncache.h"
 #include "engines/obsolete.h"
 
+/**
+ * Computes the size and the checksum of a file on a worker thread.
+ *
+ * File system nodes must not be shared between threads, so the file is
+ * opened on the main thread; only reading and hashing it happen on the
+ * worker thread.
+ */
+class ADFileHashJob : public Common::WorkerJob {
+public:
+	ADFileHashJob(const Common::FSNode &node, Common::SeekableReadStream *stream, uint32 md5Bytes) :
+		_node(node), _stream(stream), _md5Bytes(md5Bytes), _size(0) {}
+
+	~ADFileHashJob() {
+		delete _stream;
+	}
+
+	void run() {
+		_size = (int32)_stream->size();
+		_md5 = Common::computeStreamMD5AsString(*_stream, _md5Bytes);
+	}
+
+	const Common::FSNode &getNode() const { return _node; }
+	int32 getSize() const { return _size; }
+	const Common::String &getMD5() const { return _md5; }
+
+private:
+	const Common::FSNode _node;
+	Common::SeekableReadStream *_stream;
+	const uint32 _md5Bytes;
+	int32 _size;
+	Common::String _md5;
+};
+
+enum {
+	/**
+	 * The number of files which may be handed to worker threads at once
+	 * during detection. Each of them is kept open until collected.
+	 */
+	kMaxPendingFileHashes = 32
+};
+
 static GameDescriptor toGameDescriptor(const ADGameDescription &g, const PlainGameDescriptor *sg) {
 	const char *title = 0;
 	const char *extra;
@@ -385,7 +428,7 @@ void AdvancedMetaEngine::composeFileHashMap(FileMap &allFiles, const Common::FSL
 	}
 }
 
-bool AdvancedMetaEngine::getFileProperties(const Common::FSNode &parent, const FileMap &allFiles, const ADGameDescription &game, const Common::String fname, ADFileProperties &fileProps) const {
+bool AdvancedMetaEngine::getFileProperties(const Common::FSNode &parent, const FileMap &allFiles, const ADGameDescription &game, const Common::String fname, ADFileProperties &fileProps, ADFileHashJobMap *hashJobs) const {
 	// FIXME/TODO: We don't handle the case that a file is listed as a regular
 	// file and as one with resource fork.
 
@@ -405,16 +448,48 @@ bool AdvancedMetaEngine::getFileProperties(const Common::FSNode &parent, const F
 	if (!allFiles.contains(fname))
 		return false;
 
-	Common::File testFile;
+	const Common::FSNode &node = allFiles[fname];
+
+	// Files are usually checked by several detectors, and again on every
+	// scan of the same directory, so try the shared checksum cache first.
+	if (DetectionCacheMan.lookup(node, _md5Bytes, fileProps.md5, fileProps.size))
+		return true;
+
+	Common::SeekableReadStream *testFile = node.createReadStream();
 
-	if (!testFile.open(allFiles[fname]))
+	if (!testFile)
 		return false;
 
-	fileProps.size = (int32)testFile.size();
-	fileProps.md5 = Common::computeStreamMD5AsString(testFile, _md5Bytes);
+	if (hashJobs) {
+		ADFileHashJob *job = new ADFileHashJob(node, testFile, _md5Bytes);
+		(*hashJobs)[fname] = job;
+		Common::WorkerPool::getShared().submit(job);
+		return false;
+	}
+
+	fileProps.size = (int32)testFile->size();
+	fileProps.md5 = Common::computeStreamMD5AsString(*testFile, _md5Bytes);
+	delete testFile;
+	DetectionCacheMan.store(node, _md5Bytes, fileProps.md5);
 	return true;
 }
 
+void AdvancedMetaEngine::collectFileHashes(ADFileHashJobMap &hashJobs, ADFilePropertiesMap &filesProps) const {
+	for (ADFileHashJobMap::iterator i = hashJobs.begin(); i != hashJobs.end(); ++i) {
+		ADFileHashJob *job = i->_value;
+		Common::WorkerPool::getShared().wait(job);
+
+		ADFileProperties &fileProps = filesProps[i->_key];
+		fileProps.size = job->getSize();
+		fileProps.md5 = job->getMD5();
+		DetectionCacheMan.store(job->getNode(), _md5Bytes, fileProps.md5);
+		debug(3, "> '%s': '%s'", i->_key.c_str(), fileProps.md5.c_str());
+
+		delete job;
+	}
+	hashJobs.clear();
+}
+
 ADGameDescList AdvancedMetaEngine::detectGame(const Common::FSNode &parent, const FileMap &allFiles, Common::Language language, Common::Platform platform, const Common::String &extra) const {
 	ADFilePropertiesMap filesProps;
 
@@ -425,7 +500,10 @@ ADGameDescList AdvancedMetaEngine::detectGame(const Common::FSNode &parent, cons
 	debug(3, "Starting detection in dir '%s'", parent.getPath().c_str());
 
 	// Check which files are included in some ADGameDescription *and* are present.
-	// Compute MD5s and file sizes for these files.
+	// Compute MD5s and file sizes for these files. Files which are not in the
+	// checksum cache are hashed on the worker threads.
+	ADFileHashJobMap hashJobs;
+
 	for (descPtr = _gameDescriptors; ((const ADGameDescription *)descPtr)->gameId != 0; descPtr += _descItemSize) {
 		g = (const ADGameDescription *)descPtr;
 
@@ -433,16 +511,21 @@ ADGameDescList AdvancedMetaEngine::detectGame(const Common::FSNode &parent, cons
 			Common::String fname = fileDesc->fileName;
 			ADFileProperties tmp;
 
-			if (filesProps.contains(fname))
+			if (filesProps.contains(fname) || hashJobs.contains(fname))
 				continue;
 
-			if (getFileProperties(parent, allFiles, *g, fname, tmp)) {
+			if (getFileProperties(parent, allFiles, *g, fname, tmp, &hashJobs)) {
 				debug(3, "> '%s': '%s'", fname.c_str(), tmp.md5.c_str());
 				filesProps[fname] = tmp;
 			}
+
+			if (hashJobs.size() >= kMaxPendingFileHashes)
+				collectFileHashes(hashJobs, filesProps);
 		}
 	}
 
+	collectFileHashes(hashJobs, filesProps);
+
 	ADGameDescList matched;
 	int maxFilesMatched = 0;
 	bool gotAnyMatchesWithAllFiles = false;
@@ -61,6 +61,14 @@ struct ADFileProperties {
  */
 typedef Common::HashMap<Common::String, ADFileProperties, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> ADFilePropertiesMap;
 
+class ADFileHashJob;
+
+/**
+ * A map of the files of a game directory which are being hashed on worker
+ * threads while detecting.
+ */
+typedef Common::HashMap<Common::String, ADFileHashJob *, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> ADFileHashJobMap;
+
 /**
  * A shortcut to produce an empty ADGameFileDescription record. Used to mark
  * the end of a list of these.
@@ -339,8 +347,17 @@ protected:
 	 */
 	void composeFileHashMap(FileMap &allFiles, const Common::FSList &fslist, int depth, const Common::String &parentName = Common::String()) const;
 
-	/** Get the properties (size and MD5) of this file. */
-	bool getFileProperties(const Common::FSNode &parent, const FileMap &allFiles, const ADGameDescription &game, const Common::String fname, ADFileProperties &fileProps) const;
+	/**
+	 * Get the properties (size and MD5) of this file.
+	 *
+	 * If hashJobs is given, a file which has to be hashed is handed to a
+	 * worker thread and added to hashJobs instead, and false is returned.
+	 * Its properties are then added to the map by collectFileHashes().
+	 */
+	bool getFileProperties(const Common::FSNode &parent, const FileMap &allFiles, const ADGameDescription &game, const Common::String fname, ADFileProperties &fileProps, ADFileHashJobMap *hashJobs = 0) const;
+
+	/** Wait for the files handed to worker threads and add their properties. */
+	void collectFileHashes(ADFileHashJobMap &hashJobs, ADFilePropertiesMap &filesProps) const;
 };
 
 #endif
@@ -0,0 +1,235 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "engines/detectioncache.h"
+
+#include "common/config-manager.h"
+#include "common/debug.h"
+#include "common/endian.h"
+#include "common/fs.h"
+#include "common/savefile.h"
+#include "common/system.h"
+
+namespace Common {
+DECLARE_SINGLETON(DetectionCache);
+}
+
+static const char *const kDetectionCacheFile = "detection.cache";
+
+enum {
+	kDetectionCacheVersion = 1,
+
+	/**
+	 * Upper limit for the number of entries written to disk. When there are
+	 * more, only the entries used in the current session are kept, so that
+	 * files which have vanished eventually drop out of the cache.
+	 */
+	kDetectionCacheMaxEntries = 100000
+};
+
+/**
+ * The cache lives in the save file directory. The command line detection
+ * commands run before the backend is initialized, in which case there is no
+ * save file manager yet and the configured save path is used directly.
+ */
+static Common::SeekableReadStream *openCacheForLoading() {
+	Common::SaveFileManager *saveFileMan = g_system->getSavefileManager();
+	if (saveFileMan)
+		return saveFileMan->openForLoading(kDetectionCacheFile);
+
+	const Common::String savePath = ConfMan.get("savepath");
+	if (savePath.empty())
+		return 0;
+	Common::FSNode file = Common::FSNode(savePath).getChild(kDetectionCacheFile);
+	if (!file.exists())
+		return 0;
+	return file.createReadStream();
+}
+
+static Common::WriteStream *openCacheForSaving() {
+	Common::SaveFileManager *saveFileMan = g_system->getSavefileManager();
+	if (saveFileMan)
+		return saveFileMan->openForSaving(kDetectionCacheFile, false);
+
+	const Common::String savePath = ConfMan.get("savepath");
+	if (savePath.empty())
+		return 0;
+	return Common::FSNode(savePath).getChild(kDetectionCacheFile).createWriteStream();
+}
+
+static Common::String makeKey(const Common::String &path, uint32 md5Bytes) {
+	return Common::String::format("%u:", md5Bytes) + path;
+}
+
+DetectionCache::DetectionCache() : _loaded(false), _dirty(false), _hits(0), _misses(0) {
+}
+
+bool DetectionCache::lookup(const Common::FSNode &node, uint32 md5Bytes, Common::String &md5, int32 &size) {
+	load();
+
+	uint32 fileSize, lastModified;
+	if (!node.getFileStats(fileSize, lastModified)) {
+		_misses++;
+		return false;
+	}
+
+	if (!lookup(node.getPath(), md5Bytes, fileSize, lastModified, md5))
+		return false;
+
+	size = (int32)fileSize;
+	return true;
+}
+
+void DetectionCache::store(const Common::FSNode &node, uint32 md5Bytes, const Common::String &md5) {
+	uint32 fileSize, lastModified;
+	if (!node.getFileStats(fileSize, lastModified))
+		return;
+
+	store(node.getPath(), md5Bytes, fileSize, lastModified, md5);
+}
+
+bool DetectionCache::lookup(const Common::String &path, uint32 md5Bytes, uint32 size, uint32 lastModified, Common::String &md5) {
+	EntryMap::iterator i = _entries.find(makeKey(path, md5Bytes));
+	if (i == _entries.end() || i->_value.size != size || i->_value.lastModified != lastModified) {
+		_misses++;
+		return false;
+	}
+
+	i->_value.used = true;
+	md5 = i->_value.md5;
+	_hits++;
+	return true;
+}
+
+void DetectionCache::store(const Common::String &path, uint32 md5Bytes, uint32 size, uint32 lastModified, const Common::String &md5) {
+	Entry &entry = _entries[makeKey(path, md5Bytes)];
+	entry.size = size;
+	entry.lastModified = lastModified;
+	entry.md5 = md5;
+	entry.used = true;
+	_dirty = true;
+}
+
+void DetectionCache::clear() {
+	_entries.clear();
+	_hits = 0;
+	_misses = 0;
+	_dirty = false;
+}
+
+void DetectionCache::load() {
+	if (_loaded)
+		return;
+	_loaded = true;
+
+	Common::SeekableReadStream *in = openCacheForLoading();
+	if (!in)
+		return;
+
+	if (!loadFromStream(*in))
+		warning("DetectionCache: Ignoring invalid cache file");
+	else
+		debug(2, "DetectionCache: Loaded %d entries", _entries.size());
+	delete in;
+}
+
+bool DetectionCache::loadFromStream(Common::SeekableReadStream &in) {
+	if (in.readUint32BE() != MKTAG('D', 'C', 'C', 'H') || in.readUint32LE() != kDetectionCacheVersion)
+		return false;
+
+	const uint32 count = in.readUint32LE();
+	for (uint32 i = 0; i < count && !in.eos() && !in.err(); ++i) {
+		Entry entry;
+		entry.size = in.readUint32LE();
+		entry.lastModified = in.readUint32LE();
+		entry.used = false;
+
+		char md5[33];
+		in.read(md5, 32);
+		md5[32] = 0;
+		entry.md5 = md5;
+
+		Common::String key;
+		const uint16 keyLength = in.readUint16LE();
+		for (uint16 j = 0; j < keyLength; ++j)
+			key += (char)in.readByte();
+
+		if (!in.eos() && !in.err())
+			_entries[key] = entry;
+	}
+
+	return true;
+}
+
+void DetectionCache::flush() {
+	if (!_dirty)
+		return;
+
+	Common::WriteStream *out = openCacheForSaving();
+	if (!out) {
+		debug(2, "DetectionCache: No location to write the cache file to");
+		return;
+	}
+
+	const uint32 count = saveToStream(*out);
+
+	out->finalize();
+	if (out->err())
+		warning("DetectionCache: Could not write the cache file");
+	delete out;
+
+	debug(2, "DetectionCache: Saved %d entries (%d hits, %d misses)", count, _hits, _misses);
+	_dirty = false;
+}
+
+uint32 DetectionCache::saveToStream(Common::WriteStream &out) const {
+	const bool onlyUsed = (_entries.size() > kDetectionCacheMaxEntries);
+
+	uint32 count = 0;
+	for (EntryMap::const_iterator i = _entries.begin(); i != _entries.end(); ++i) {
+		if (!onlyUsed || i->_value.used)
+			count++;
+	}
+
+	out.writeUint32BE(MKTAG('D', 'C', 'C', 'H'));
+	out.writeUint32LE(kDetectionCacheVersion);
+	out.writeUint32LE(count);
+
+	for (EntryMap::const_iterator i = _entries.begin(); i != _entries.end(); ++i) {
+		if (onlyUsed && !i->_value.used)
+			continue;
+
+		out.writeUint32LE(i->_value.size);
+		out.writeUint32LE(i->_value.lastModified);
+
+		// MD5 checksums are always 32 hex digits
+		Common::String md5 = i->_value.md5;
+		while (md5.size() < 32)
+			md5 += '0';
+		out.write(md5.c_str(), 32);
+
+		out.writeUint16LE(i->_key.size());
+		out.writeString(i->_key);
+	}
+
+	return count;
+}
@@ -0,0 +1,134 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef ENGINES_DETECTIONCACHE_H
+#define ENGINES_DETECTIONCACHE_H
+
+#include "common/hashmap.h"
+#include "common/hash-str.h"
+#include "common/singleton.h"
+#include "common/str.h"
+
+namespace Common {
+class FSNode;
+class SeekableReadStream;
+class WriteStream;
+}
+
+/**
+ * Cache for the MD5 checksums computed during game detection.
+ *
+ * Every detector hashes the beginning of the files it knows about. When
+ * scanning a directory, the same file is often checked by several engines,
+ * and mass adding or re-scanning a game library hashes the same files again
+ * on every run. This cache, shared by all detectors, remembers the checksums
+ * keyed by path and number of hashed bytes. An entry is only used as long as
+ * the size and the modification time of the file are unchanged, so it is
+ * only effective on backends which implement FSNode::getFileStats().
+ *
+ * The cache is kept in the save file directory across runs. It is loaded on
+ * first use; call flush() after a detection run to write back new entries.
+ */
+class DetectionCache : public Common::Singleton<DetectionCache> {
+public:
+	/**
+	 * Look up the checksum of the first md5Bytes bytes of a file.
+	 *
+	 * @param node		the file
+	 * @param md5Bytes	the number of bytes hashed (0 for the whole file)
+	 * @param md5		set to the cached checksum
+	 * @param size		set to the size of the file
+	 * @return true if a valid entry was found
+	 */
+	bool lookup(const Common::FSNode &node, uint32 md5Bytes, Common::String &md5, int32 &size);
+
+	/**
+	 * Remember the checksum of the first md5Bytes bytes of a file.
+	 */
+	void store(const Common::FSNode &node, uint32 md5Bytes, const Common::String &md5);
+
+	/**
+	 * Look up a checksum by path, given the current size and modification
+	 * time of the file. This does not load the cache from disk.
+	 */
+	bool lookup(const Common::String &path, uint32 md5Bytes, uint32 size, uint32 lastModified, Common::String &md5);
+
+	/**
+	 * Remember a checksum by path, along with the size and modification
+	 * time of the file it was computed from.
+	 */
+	void store(const Common::String &path, uint32 md5Bytes, uint32 size, uint32 lastModified, const Common::String &md5);
+
+	/**
+	 * Write the cache to disk, if it changed since it was loaded.
+	 */
+	void flush();
+
+	/**
+	 * Add the entries of a cache file to the cache.
+	 *
+	 * @return false if the stream is not a valid cache file
+	 */
+	bool loadFromStream(Common::SeekableReadStream &in);
+
+	/**
+	 * Write the cache in the cache file format.
+	 *
+	 * @return the number of entries written
+	 */
+	uint32 saveToStream(Common::WriteStream &out) const;
+
+	/** Remove all entries, without touching the cache file. */
+	void clear();
+
+	/** Number of lookups answered from the cache. */
+	uint32 getHits() const { return _hits; }
+
+	/** Number of lookups which required hashing the file. */
+	uint32 getMisses() const { return _misses; }
+
+private:
+	friend class Common::Singleton<SingletonBaseType>;
+	DetectionCache();
+
+	void load();
+
+	struct Entry {
+		uint32 size;
+		uint32 lastModified;
+		Common::String md5;
+		bool used;
+	};
+
+	typedef Common::HashMap<Common::String, Entry> EntryMap;
+
+	EntryMap _entries;
+	bool _loaded;
+	bool _dirty;
+	uint32 _hits;
+	uint32 _misses;
+};
+
+/** Shortcut for accessing the detection cache. */
+#define DetectionCacheMan DetectionCache::instance()
+
+#endif
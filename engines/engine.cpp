@@ -619,6 +619,8 @@ void Engine::syncSoundSettings() {
 	_mixer->setVolumeForSoundType(Audio::Mixer::kMusicSoundType, soundVolumeMusic);
 	_mixer->setVolumeForSoundType(Audio::Mixer::kSFXSoundType, soundVolumeSFX);
 	_mixer->setVolumeForSoundType(Audio::Mixer::kSpeechSoundType, soundVolumeSpeech);
+
+	_mixer->setRateConverterType(Audio::parseRateConverterType(ConfMan.get("resampler").c_str()));
 }
 
 void Engine::deinitKeymap() {
@@ -117,6 +117,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("alloc_list",				WRAP_METHOD(Console, cmdAllocList));
 	registerCmd("hexgrep",			WRAP_METHOD(Console, cmdHexgrep));
 	registerCmd("verify_scripts",		WRAP_METHOD(Console, cmdVerifyScripts));
+	registerCmd("resource_stats",		WRAP_METHOD(Console, cmdResourceStats));
 	// Game
 	registerCmd("save_game",			WRAP_METHOD(Console, cmdSaveGame));
 	registerCmd("restore_game",		WRAP_METHOD(Console, cmdRestoreGame));
@@ -160,6 +161,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("gc_reachable",		WRAP_METHOD(Console, cmdGCShowReachable));
 	registerCmd("gc_freeable",		WRAP_METHOD(Console, cmdGCShowFreeable));
 	registerCmd("gc_normalize",		WRAP_METHOD(Console, cmdGCNormalize));
+	registerCmd("gc_stats",			WRAP_METHOD(Console, cmdGCStats));
 	// Music/SFX
 	registerCmd("songlib",			WRAP_METHOD(Console, cmdSongLib));
 	registerCmd("songinfo",			WRAP_METHOD(Console, cmdSongInfo));
@@ -221,6 +223,8 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("bpe",				WRAP_METHOD(Console, cmdBreakpointFunction));		// alias
 	// VM
 	registerCmd("script_steps",		WRAP_METHOD(Console, cmdScriptSteps));
+	registerCmd("decode_bench",		WRAP_METHOD(Console, cmdDecodeBench));
+	registerCmd("selector_cache",	WRAP_METHOD(Console, cmdSelectorCache));
 	registerCmd("script_objects",   WRAP_METHOD(Console, cmdScriptObjects));
 	registerCmd("scro",             WRAP_METHOD(Console, cmdScriptObjects));
 	registerCmd("script_strings",   WRAP_METHOD(Console, cmdScriptStrings));
@@ -373,6 +377,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf(" alloc_list - Lists all allocated resources\n");
 	debugPrintf(" hexgrep - Searches some resources for a particular sequence of bytes, represented as hexadecimal numbers\n");
 	debugPrintf(" verify_scripts - Performs sanity checks on SCI1.1-SCI2.1 game scripts (e.g. if they're up to 64KB in total)\n");
+	debugPrintf(" resource_stats - Shows the load times of the resources, per resource type\n");
 	debugPrintf("\n");
 	debugPrintf("Game:\n");
 	debugPrintf(" save_game - Saves the current game state to the hard disk\n");
@@ -411,6 +416,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf(" gc_reachable - Lists all addresses directly reachable from a given memory object\n");
 	debugPrintf(" gc_freeable - Lists all addresses freeable in a given segment\n");
 	debugPrintf(" gc_normalize - Prints the \"normal\" address of a given address\n");
+	debugPrintf(" gc_stats - Shows the pause times of the garbage collector\n");
 	debugPrintf("\n");
 	debugPrintf("Music/SFX:\n");
 	debugPrintf(" songlib - Shows the song library\n");
@@ -455,6 +461,8 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf("\n");
 	debugPrintf("VM:\n");
 	debugPrintf(" script_steps - Shows the number of executed SCI operations\n");
+	debugPrintf(" decode_bench - Times decoding the methods of all loaded scripts, with and without the instruction cache\n");
+	debugPrintf(" selector_cache - Shows the hit rate of the selector lookup cache\n");
 	debugPrintf(" vm_varlist / vmvarlist / vl - Shows the addresses of variables in the VM\n");
 	debugPrintf(" vm_vars / vmvars / vv - Displays or changes variables in the VM\n");
 	debugPrintf(" stack - Lists the specified number of stack elements\n");
@@ -1085,6 +1093,33 @@ bool Console::cmdHexgrep(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdResourceStats(int argc, const char **argv) {
+	if (argc > 2 || (argc == 2 && strcmp(argv[1], "reset"))) {
+		debugPrintf("Shows the number of loaded resources and the time spent loading\n");
+		debugPrintf("them, per resource type.\n");
+		debugPrintf("Usage: %s [reset]\n", argv[0]);
+		return true;
+	}
+
+	ResourceManager *resMan = _engine->getResMan();
+
+	if (argc == 2) {
+		resMan->resetLoadStats();
+		return true;
+	}
+
+	for (int i = 0; i < kResourceTypeInvalid; i++) {
+		const ResourceManager::LoadStats &stats = resMan->getLoadStats((ResourceType)i);
+		if (!stats.loads)
+			continue;
+
+		debugPrintf("%-14s loads: %u, prefetched: %u, average %u ms, max %u ms, total %u ms\n",
+			getResourceTypeName((ResourceType)i), stats.loads, stats.prefetched,
+			stats.totalTime / stats.loads, stats.maxTime, stats.totalTime);
+	}
+	return true;
+}
+
 bool Console::cmdVerifyScripts(int argc, const char **argv) {
 	if (getSciVersion() < SCI_VERSION_1_1) {
 		debugPrintf("This script check is only meant for SCI1.1-SCI3 games\n");
@@ -2498,6 +2533,27 @@ bool Console::cmdGCInvoke(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdGCStats(int argc, const char **argv) {
+	if (argc > 2 || (argc == 2 && strcmp(argv[1], "reset"))) {
+		debugPrintf("Shows the pause times of the garbage collector.\n");
+		debugPrintf("Usage: %s [reset]\n", argv[0]);
+		return true;
+	}
+
+	SegManager *segMan = _engine->_gamestate->_segMan;
+	GCStats &stats = segMan->getGCStats();
+
+	if (argc == 2) {
+		stats.reset();
+		return true;
+	}
+
+	debugPrintf("Collections: %u, freed objects: %u\n", stats.collections, stats.freedObjects);
+	debugPrintf("Pause times: last %u ms, max %u ms, average %u ms, total %u ms\n",
+		stats.lastPause, stats.maxPause, stats.collections ? stats.totalPause / stats.collections : 0, stats.totalPause);
+	return true;
+}
+
 bool Console::cmdGCObjects(int argc, const char **argv) {
 	AddrSet *use_map = findAllActiveReferences(_engine->_gamestate);
 
@@ -3083,6 +3139,122 @@ bool Console::cmdScriptSteps(int argc, const char **argv) {
 	return true;
 }
 
+// Longest PMachine instruction: the opcode followed by three words
+static const uint kMaxInstructionSize = 7;
+
+static bool isValidOpcode(byte opcode) {
+	for (int i = 0; i < 4 && g_sci->_opcode_formats[opcode][i] != Script_None; ++i) {
+		if (g_sci->_opcode_formats[opcode][i] == Script_Invalid)
+			return false;
+	}
+	return true;
+}
+
+bool Console::cmdDecodeBench(int argc, const char **argv) {
+	if (argc > 2) {
+		debugPrintf("Times decoding the instructions of all methods of the loaded scripts,\n");
+		debugPrintf("once with readPMachineInstruction() and once through the instruction cache\n");
+		debugPrintf("the VM uses. The methods are only decoded, not executed.\n");
+		debugPrintf("Usage: %s [<iterations>]\n", argv[0]);
+		return true;
+	}
+
+	const int iterations = (argc == 2) ? atoi(argv[1]) : 100;
+	if (iterations <= 0) {
+		debugPrintf("Invalid number of iterations\n");
+		return true;
+	}
+
+	// Collect the workload: every method up to its first ret, as laid out
+	// in the script
+	SegManager *segMan = _engine->_gamestate->_segMan;
+	Common::Array<Script *> scripts;
+	Common::Array<uint32> offsets;
+	int methodCount = 0;
+
+	for (uint i = 0; i < segMan->_heap.size(); i++) {
+		SegmentObj *segmentObj = segMan->_heap[i];
+		if (!segmentObj || segmentObj->getType() != SEG_TYPE_SCRIPT)
+			continue;
+
+		Script *scr = (Script *)segmentObj;
+		const ObjMap &objects = scr->getObjectMap();
+		for (ObjMap::const_iterator it = objects.begin(); it != objects.end(); ++it) {
+			for (uint m = 0; m < it->_value.getMethodCount(); m++) {
+				uint32 offset = it->_value.getFunction(m).getOffset();
+				methodCount++;
+
+				// Stop at invalid opcodes and before instructions which
+				// may run past the end of the script, as decoding them
+				// would error out
+				while (offset + kMaxInstructionSize <= scr->getBufSize() && isValidOpcode(*scr->getBuf(offset) >> 1)) {
+					byte extOpcode;
+					int16 opparams[4];
+					scripts.push_back(scr);
+					offsets.push_back(offset);
+					offset += readPMachineInstruction(scr->getBuf(offset), extOpcode, opparams);
+					if ((extOpcode >> 1) == op_ret)
+						break;
+				}
+			}
+		}
+	}
+
+	uint32 checksum = 0;
+
+	uint32 start = g_system->getMillis();
+	for (int n = 0; n < iterations; n++) {
+		for (uint i = 0; i < offsets.size(); i++) {
+			byte extOpcode;
+			int16 opparams[4];
+			checksum += readPMachineInstruction(scripts[i]->getBuf(offsets[i]), extOpcode, opparams);
+			checksum += opparams[0];
+		}
+	}
+	const uint32 decodeTime = g_system->getMillis() - start;
+
+	start = g_system->getMillis();
+	for (int n = 0; n < iterations; n++) {
+		for (uint i = 0; i < offsets.size(); i++) {
+			const PMachineInstruction &instruction = scripts[i]->getInstruction(offsets[i]);
+			checksum -= instruction.size;
+			checksum -= instruction.opparams[0];
+		}
+	}
+	const uint32 cacheTime = g_system->getMillis() - start;
+
+	debugPrintf("%d instructions in %d methods, %d iterations\n", offsets.size(), methodCount, iterations);
+	debugPrintf("Decoding: %d ms, instruction cache: %d ms\n", decodeTime, cacheTime);
+	if (checksum != 0)
+		debugPrintf("Decoded instructions differ from the instruction cache\n");
+	return true;
+}
+
+bool Console::cmdSelectorCache(int argc, const char **argv) {
+	if (argc > 2 || (argc == 2 && strcmp(argv[1], "reset") && strcmp(argv[1], "clear"))) {
+		debugPrintf("Shows the statistics of the selector lookup cache.\n");
+		debugPrintf("Usage: %s [reset|clear]\n", argv[0]);
+		debugPrintf("'reset' resets the counters, 'clear' drops all cached lookups\n");
+		return true;
+	}
+
+	SelectorLookupCache &cache = _engine->_gamestate->_segMan->getSelectorLookupCache();
+
+	if (argc == 2) {
+		if (!strcmp(argv[1], "reset"))
+			cache.resetStats();
+		else
+			cache.clear();
+		return true;
+	}
+
+	const uint32 lookups = cache.getHits() + cache.getMisses();
+	debugPrintf("Selector lookups: %u, hits: %u (%u%%), misses: %u\n", lookups,
+		cache.getHits(), lookups ? (uint)((uint64)cache.getHits() * 100 / lookups) : 0, cache.getMisses());
+	debugPrintf("Cached lookups: %u, invalidations: %u\n", cache.getSize(), cache.getInvalidations());
+	return true;
+}
+
 bool Console::cmdScriptObjects(int argc, const char **argv) {
 	int curScriptNr = -1;
 
@@ -25,6 +25,7 @@
 #include "common/dcl.h"
 #include "common/util.h"
 #include "common/endian.h"
+#include "common/str.h"
 #include "common/stream.h"
 #include "common/textconsole.h"
 
@@ -53,6 +54,7 @@ void Decompressor::init(Common::ReadStream *src, byte *dest, uint32 nPacked,
 	_nBits = 0;
 	_dwRead = _dwWrote = 0;
 	_dwBits = 0;
+	_failed = false;
 }
 
 void Decompressor::fetchBitsMSB() {
@@ -102,6 +104,19 @@ byte Decompressor::getByteLSB() {
 void Decompressor::putByte(byte b) {
 	_dest[_dwWrote++] = b;
 }
+
+void Decompressor::report(const char *s, ...) {
+	_failed = true;
+	if (_quiet)
+		return;
+
+	va_list va;
+	va_start(va, s);
+	Common::String message = Common::String::vformat(s, va);
+	va_end(va);
+
+	warning("%s", message.c_str());
+}
 //-------------------------------
 //  Huffman decompressor
 //-------------------------------
@@ -163,17 +178,25 @@ int DecompressorLZW::unpack(Common::ReadStream *src, byte *dest, uint32 nPacked,
 		break;
 	case kCompLZW1View:
 		buffer = new byte[nUnpacked];
-		unpackLZW1(src, buffer, nPacked, nUnpacked);
+		// Quiet callers unpack again to get the warnings, no need to reorder
+		if (unpackLZW1(src, buffer, nPacked, nUnpacked) && _quiet) {
+			_failed = true;
+			break;
+		}
 		reorderView(buffer, dest);
 		break;
 	case kCompLZW1Pic:
 		buffer = new byte[nUnpacked];
-		unpackLZW1(src, buffer, nPacked, nUnpacked);
+		// Quiet callers unpack again to get the warnings, no need to reorder
+		if (unpackLZW1(src, buffer, nPacked, nUnpacked) && _quiet) {
+			_failed = true;
+			break;
+		}
 		reorderPic(buffer, dest, nUnpacked);
 		break;
 	}
 	delete[] buffer;
-	return 0;
+	return _failed && _quiet ? SCI_ERROR_DECOMPRESSION_ERROR : 0;
 }
 
 int DecompressorLZW::unpackLZW(Common::ReadStream *src, byte *dest, uint32 nPacked,
@@ -189,6 +212,10 @@ int DecompressorLZW::unpackLZW(Common::ReadStream *src, byte *dest, uint32 nPack
 		free(tokenlist);
 		free(tokenlengthlist);
 
+		if (_quiet) {
+			_failed = true;
+			return SCI_ERROR_DECOMPRESSION_ERROR;
+		}
 		error("[DecompressorLZW::unpackLZW] Cannot allocate token memory buffers");
 	}
 
@@ -209,7 +236,7 @@ int DecompressorLZW::unpackLZW(Common::ReadStream *src, byte *dest, uint32 nPack
 		} else {
 			if (token > 0xff) {
 				if (token >= _curtoken) {
-					warning("unpackLZW: Bad token %x", token);
+					report("unpackLZW: Bad token %x", token);
 
 					free(tokenlist);
 					free(tokenlengthlist);
@@ -219,8 +246,8 @@ int DecompressorLZW::unpackLZW(Common::ReadStream *src, byte *dest, uint32 nPack
 				tokenlastlength = tokenlengthlist[token] + 1;
 				if (_dwWrote + tokenlastlength > _szUnpacked) {
 					// For me this seems a normal situation, It's necessary to handle it
-					warning("unpackLZW: Trying to write beyond the end of array(len=%d, destctr=%d, tok_len=%d)",
-					        _szUnpacked, _dwWrote, tokenlastlength);
+					report("unpackLZW: Trying to write beyond the end of array(len=%d, destctr=%d, tok_len=%d)",
+					       _szUnpacked, _dwWrote, tokenlastlength);
 					for (int i = 0; _dwWrote < _szUnpacked; i++)
 						putByte(dest[tokenlist[token] + i]);
 				} else
@@ -229,7 +256,7 @@ int DecompressorLZW::unpackLZW(Common::ReadStream *src, byte *dest, uint32 nPack
 			} else {
 				tokenlastlength = 1;
 				if (_dwWrote >= _szUnpacked)
-					warning("unpackLZW: Try to write single byte beyond end of array");
+					report("unpackLZW: Try to write single byte beyond end of array");
 				else
 					putByte(token);
 			}
@@ -263,6 +290,10 @@ int DecompressorLZW::unpackLZW1(Common::ReadStream *src, byte *dest, uint32 nPac
 		free(stak);
 		free(tokens);
 
+		if (_quiet) {
+			_failed = true;
+			return SCI_ERROR_DECOMPRESSION_ERROR;
+		}
 		error("[DecompressorLZW::unpackLZW1] Cannot allocate decompression buffers");
 	}
 
@@ -555,7 +586,7 @@ void DecompressorLZW::reorderView(byte *src, byte *dest) {
 	for (l = 0; l < loopheaders; l++) {
 		if (lh_mask & lb) { /* The loop is _not_ present */
 			if (lh_last == -1) {
-				warning("Error: While reordering view: Loop not present, but can't re-use last loop");
+				report("Error: While reordering view: Loop not present, but can't re-use last loop");
 				lh_last = 0;
 			}
 			WRITE_LE_UINT16(lh_ptr, lh_last);
@@ -589,7 +620,7 @@ void DecompressorLZW::reorderView(byte *src, byte *dest) {
 	}
 
 	if (celindex < cel_total) {
-		warning("View decompression generated too few (%d / %d) headers", celindex, cel_total);
+		report("View decompression generated too few (%d / %d) headers", celindex, cel_total);
 		free(cc_pos);
 		free(cc_lengths);
 		return;
@@ -625,7 +656,12 @@ void DecompressorLZW::reorderView(byte *src, byte *dest) {
 
 int DecompressorDCL::unpack(Common::ReadStream *src, byte *dest, uint32 nPacked,
                             uint32 nUnpacked) {
-	return Common::decompressDCL(src, dest, nPacked, nUnpacked) ? 0 : SCI_ERROR_DECOMPRESSION_ERROR;
+	init(src, dest, nPacked, nUnpacked);
+	if (Common::decompressDCL(src, dest, nPacked, nUnpacked, _quiet))
+		return 0;
+
+	_failed = true;
+	return SCI_ERROR_DECOMPRESSION_ERROR;
 }
 
 #ifdef ENABLE_SCI32
@@ -650,14 +686,14 @@ int DecompressorLZS::unpackLZS() {
 				if (!offs) // This is the end marker - a 7 bit offset of zero
 					break;
 				if (!(clen = getCompLen())) {
-					warning("lzsDecomp: length mismatch");
+					report("lzsDecomp: length mismatch");
 					return SCI_ERROR_DECOMPRESSION_ERROR;
 				}
 				copyComp(offs, clen);
 			} else { // Eleven bit offset follows
 				offs = getBitsMSB(11);
 				if (!(clen = getCompLen())) {
-					warning("lzsDecomp: length mismatch");
+					report("lzsDecomp: length mismatch");
 					return SCI_ERROR_DECOMPRESSION_ERROR;
 				}
 				copyComp(offs, clen);
@@ -51,12 +51,22 @@ enum ResourceCompression {
  */
 class Decompressor {
 public:
-	Decompressor() {}
+	Decompressor() : _quiet(false), _failed(false) {}
 	virtual ~Decompressor() {}
 
 
 	virtual int unpack(Common::ReadStream *src, byte *dest, uint32 nPacked, uint32 nUnpacked);
 
+	/**
+	 * Sets whether problems with the packed data are only recorded instead
+	 * of being reported through warning() and error(), which may not be
+	 * called from worker threads.
+	 */
+	void setQuiet(bool quiet) { _quiet = quiet; }
+
+	/** Returns true if the last unpack ran into a problem with the data. */
+	bool hasFailed() const { return _failed; }
+
 protected:
 	/**
 	 * Initialize decompressor.
@@ -101,6 +111,12 @@ protected:
 
 	virtual void putByte(byte b);
 
+	/**
+	 * Records a problem with the packed data, and reports it as a warning
+	 * unless the decompressor is quiet.
+	 */
+	void report(const char *s, ...) GCC_PRINTF(2, 3);
+
 	/**
 	 * Returns true if all expected data has been unpacked to _dest
 	 * and there is no more data in _src.
@@ -117,6 +133,8 @@ protected:
 	uint32 _dwWrote;	///< number of bytes written to _dest
 	Common::ReadStream *_src;
 	byte *_dest;
+	bool _quiet;		///< only record problems, see setQuiet()
+	bool _failed;		///< a problem was found during the last unpack
 };
 
 /**
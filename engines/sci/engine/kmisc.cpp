@@ -193,6 +193,8 @@ reg_t kMemorySegment(EngineState *s, int argc, reg_t *argv) {
 }
 
 reg_t kFlushResources(EngineState *s, int argc, reg_t *argv) {
+	// Read the resources of the new room while the garbage is collected
+	g_sci->getResMan()->prefetchRoom(argv[0].toUint16());
 	run_gc(s);
 	debugC(kDebugLevelRoom, "Entering room number %d", argv[0].toUint16());
 	return s->r_acc;
@@ -358,6 +360,11 @@ reg_t kMemory(EngineState *s, int argc, reg_t *argv) {
 				return s->r_acc;
 			}
 			WRITE_SCIENDIAN_UINT16(ref.raw, argv[2].getOffset());		// Amiga versions are BE
+
+			// The write may have changed code the VM already decoded
+			Script *scr = s->_segMan->getScriptIfLoaded(argv[1].getSegment());
+			if (scr)
+				scr->invalidateInstructionCache();
 		} else {
 			if (ref.skipByte)
 				error("Attempt to poke memory at odd offset %04X:%04X", PRINT_REG(argv[1]));
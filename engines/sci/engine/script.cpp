@@ -73,6 +73,8 @@ void Script::freeScript(const bool keepLocalsSegment) {
 	_offsetLookupObjectCount = 0;
 	_offsetLookupStringCount = 0;
 	_offsetLookupSaidCount = 0;
+
+	invalidateInstructionCache();
 }
 
 enum {
@@ -149,6 +151,7 @@ void Script::load(int script_nr, ResourceManager *resMan, ScriptPatcher *scriptP
 
 	// Check scripts (+ possibly SCI 1.1 heap) for matching signatures and patch those, if found
 	scriptPatcher->processScript(_nr, outBuffer);
+	invalidateInstructionCache();
 
 	if (getSciVersion() <= SCI_VERSION_1_LATE) {
 		// Some buggy game scripts contain two export tables (e.g. script 912
@@ -895,6 +898,32 @@ uint32 Script::validateExportFunc(int pubfunct, bool relocSci3) {
 	return offset;
 }
 
+void Script::invalidateInstructionCache() {
+	_instructionIndex.clear();
+	_instructions.clear();
+}
+
+const PMachineInstruction &Script::decodeInstruction(uint32 offset) {
+	assert(offset < _buf->size());
+
+	PMachineInstruction instruction;
+	instruction.size = readPMachineInstruction(getBuf(offset), instruction.extOpcode, instruction.opparams);
+
+	// The index only refers to 65535 instructions, which is far more than
+	// any script has
+	if (_instructions.size() >= 0xFFFF) {
+		_uncachedInstruction = instruction;
+		return _uncachedInstruction;
+	}
+
+	if (_instructionIndex.empty())
+		_instructionIndex.resize(_buf->size());
+
+	_instructions.push_back(instruction);
+	_instructionIndex[offset] = _instructions.size();
+	return _instructions.back();
+}
+
 SciSpan<const byte> Script::findBlockSCI0(ScriptObjectTypes type, bool findLastBlock) const {
 	SciSpan<const byte> foundBlock;
 
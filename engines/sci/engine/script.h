@@ -69,6 +69,15 @@ struct offsetLookupArrayEntry {
 
 typedef Common::Array<offsetLookupArrayEntry> offsetLookupArrayType;
 
+/**
+ * A PMachine instruction, as decoded by readPMachineInstruction().
+ */
+struct PMachineInstruction {
+	int16 opparams[4];
+	byte extOpcode;
+	uint16 size; /**< Length of the instruction in bytes */
+};
+
 class Script : public SegmentObj {
 private:
 	int _nr; /**< Script number */
@@ -94,6 +103,15 @@ private:
 
 	ObjMap _objects;	/**< Table for objects, contains property variables */
 
+	/**
+	 * For each offset into the buffer, the index + 1 of the decoded
+	 * instruction starting there, or 0 if it wasn't decoded yet
+	 */
+	Common::Array<uint16> _instructionIndex;
+	Common::Array<PMachineInstruction> _instructions;
+	/** Returned once the index can't refer to more instructions */
+	PMachineInstruction _uncachedInstruction;
+
 protected:
 	offsetLookupArrayType _offsetLookupArray; // Table of all elements of currently loaded script, that may get pointed to
 
@@ -236,6 +254,27 @@ public:
 	 */
 	uint32 validateExportFunc(int pubfunct, bool relocSci3);
 
+	/**
+	 * Returns the instruction at the given offset into the script buffer.
+	 * Instructions are decoded on first use and kept until the script is
+	 * unloaded. The result is only valid until the next call, as running
+	 * other code of the script may decode more instructions.
+	 */
+	const PMachineInstruction &getInstruction(uint32 offset) {
+		if (offset < _instructionIndex.size() && _instructionIndex[offset])
+			return _instructions[_instructionIndex[offset] - 1];
+		return decodeInstruction(offset);
+	}
+
+	/**
+	 * Drops all decoded instructions. Must be called when the code of the
+	 * script gets modified after it was loaded.
+	 */
+	void invalidateInstructionCache();
+
+	/** Returns the number of instructions decoded so far. */
+	uint getDecodedInstructionCount() const { return _instructions.size(); }
+
 	/**
 	 * Marks the script as deleted.
 	 * This will not actually delete the script.  If references remain present on the
@@ -352,6 +391,8 @@ private:
 
 	LocalVariables *allocLocalsSegment(SegManager *segMan);
 
+	const PMachineInstruction &decodeInstruction(uint32 offset);
+
 	/**
 	 * Identifies certain offsets within script data and set up lookup-table
 	 */
@@ -80,6 +80,8 @@ void SegManager::resetSegMan() {
 	// Reinitialize class table
 	_classTable.clear();
 	createClassTable();
+
+	_selectorLookupCache.clear();
 }
 
 void SegManager::initSysStrings() {
@@ -166,6 +168,7 @@ void SegManager::deallocate(SegmentId seg) {
 
 	if (mobj->getType() == SEG_TYPE_SCRIPT) {
 		Script *scr = (Script *)mobj;
+		_selectorLookupCache.clear();
 		_scriptSegMap.erase(scr->getScriptNumber());
 		if (scr->getLocalsSegment()) {
 			// Check if the locals segment has already been deallocated.
@@ -1031,6 +1034,9 @@ int SegManager::instantiateScript(int scriptNum) {
 	g_sci->_guestAdditions->instantiateScriptHook(*scr);
 #endif
 
+	// The new objects may reuse the positions of freed ones
+	_selectorLookupCache.clear();
+
 	return segmentId;
 }
 
@@ -1061,6 +1067,7 @@ void SegManager::uninstantiateScript(int script_nr) {
 	if (!scr->getLockers()) {
 		// The actual script deletion seems to be done by SCI scripts themselves
 		scr->markDeleted();
+		_selectorLookupCache.clear();
 		debugC(kDebugLevelScripts, "Unloaded script 0x%x.", script_nr);
 	}
 }
@@ -26,6 +26,7 @@
 #include "common/scummsys.h"
 #include "common/serializer.h"
 #include "sci/engine/script.h"
+#include "sci/engine/selector.h"
 #include "sci/engine/vm.h"
 #include "sci/engine/vm_types.h"
 #include "sci/engine/segment.h"
@@ -46,6 +47,34 @@ enum ScriptLoadType {
 
 class Script;
 
+/**
+ * Statistics of the garbage collector, as shown by the gc_stats console
+ * command. Times are in milliseconds.
+ */
+struct GCStats {
+	uint32 collections;		///< number of collections
+	uint32 freedObjects;	///< number of objects freed
+	uint32 lastPause;		///< duration of the last collection
+	uint32 maxPause;		///< longest collection
+	uint32 totalPause;		///< time spent in the collector
+
+	GCStats() { reset(); }
+
+	void reset() {
+		collections = 0;
+		freedObjects = 0;
+		lastPause = 0;
+		maxPause = 0;
+		totalPause = 0;
+	}
+
+	void addPause(uint32 pause) {
+		lastPause = pause;
+		maxPause = MAX(maxPause, pause);
+		totalPause += pause;
+	}
+};
+
 class SegManager : public Common::Serializable {
 	friend class Console;
 public:
@@ -263,6 +292,11 @@ public:
 	bool freeDynmem(reg_t addr);
 
 
+	// 10. Garbage Collection
+
+	GCStats &getGCStats() { return _gcStats; }
+
+
 	// Generic Operations on Segments and Addresses
 
 	/**
@@ -451,11 +485,20 @@ public:
 
 	const Common::Array<SegmentObj *> &getSegments() const { return _heap; }
 
+	/**
+	 * Returns the cache of lookupSelector() results. It is cleared whenever
+	 * scripts are loaded, unloaded or freed.
+	 */
+	SelectorLookupCache &getSelectorLookupCache() { return _selectorLookupCache; }
+
 private:
 	Common::Array<SegmentObj *> _heap;
 	Common::Array<Class> _classTable; /**< Table of all classes */
 	/** Map script ids to segment ids. */
 	Common::HashMap<int, SegmentId> _scriptSegMap;
+	SelectorLookupCache _selectorLookupCache;
+
+	GCStats _gcStats;
 
 	ResourceManager *_resMan;
 	ScriptPatcher *_scriptPatcher;
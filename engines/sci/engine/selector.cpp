@@ -291,6 +291,23 @@ void invokeSelector(EngineState *s, reg_t object, int selectorId,
 	run_vm(s); // Start a new vm
 }
 
+SelectorLookupCache::SelectorLookupCache() : _hits(0), _misses(0), _invalidations(0) {
+}
+
+void SelectorLookupCache::clear() {
+	if (_entries.empty())
+		return;
+
+	_entries.clear(true);
+	_invalidations++;
+}
+
+void SelectorLookupCache::resetStats() {
+	_hits = 0;
+	_misses = 0;
+	_invalidations = 0;
+}
+
 SelectorType lookupSelector(SegManager *segMan, reg_t obj_location, Selector selectorId, ObjVarRef *varp, reg_t *fptr) {
 	const Object *obj = segMan->getObject(obj_location);
 	int index;
@@ -306,34 +323,46 @@ SelectorType lookupSelector(SegManager *segMan, reg_t obj_location, Selector sel
 		error("lookupSelector: Attempt to send to non-object or invalid script. Address %04x:%04x, %s", PRINT_REG(obj_location), origin.toString().c_str());
 	}
 
-	index = obj->locateVarSelector(segMan, selectorId);
+	SelectorLookupCache &cache = segMan->getSelectorLookupCache();
+	const reg_t pos = obj->getPos();
+	const SelectorLookupCache::Entry *cached = cache.find(pos, selectorId);
+	SelectorLookupCache::Entry entry;
 
-	if (index >= 0) {
-		// Found it as a variable
-		if (varp) {
-			varp->obj = obj_location;
-			varp->varindex = index;
-		}
-		return kSelectorVariable;
+	if (cached) {
+		entry = *cached;
 	} else {
-		// Check if it's a method, with recursive lookup in superclasses
-		while (obj) {
-			index = obj->funcSelectorPosition(selectorId);
-			if (index >= 0) {
-				if (fptr)
-					*fptr = obj->getFunction(index);
-
-				return kSelectorMethod;
-			} else {
-				obj = segMan->getObject(obj->getSuperClassSelector());
+		entry.type = kSelectorNone;
+		entry.varIndex = obj->locateVarSelector(segMan, selectorId);
+		entry.function = NULL_REG;
+
+		if (entry.varIndex >= 0) {
+			// Found it as a variable
+			entry.type = kSelectorVariable;
+		} else {
+			// Check if it's a method, with recursive lookup in superclasses
+			while (obj) {
+				index = obj->funcSelectorPosition(selectorId);
+				if (index >= 0) {
+					entry.type = kSelectorMethod;
+					entry.function = obj->getFunction(index);
+					break;
+				} else {
+					obj = segMan->getObject(obj->getSuperClassSelector());
+				}
 			}
 		}
 
-		return kSelectorNone;
+		cache.store(pos, selectorId, entry);
 	}
 
+	if (entry.type == kSelectorVariable && varp) {
+		varp->obj = obj_location;
+		varp->varindex = entry.varIndex;
+	} else if (entry.type == kSelectorMethod && fptr) {
+		*fptr = entry.function;
+	}
 
-//	return _lookupSelector_function(segMan, obj, selectorId, fptr);
+	return entry.type;
 }
 
 } // End of namespace Sci
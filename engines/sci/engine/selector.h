@@ -24,6 +24,7 @@
 #define SCI_ENGINE_SELECTOR_H
 
 #include "common/scummsys.h"
+#include "common/hashmap.h"
 
 #include "sci/engine/vm_types.h"	// for reg_t
 #include "sci/engine/vm.h"
@@ -177,6 +178,72 @@ struct SelectorCache {
 #endif
 };
 
+/**
+ * Caches the results of lookupSelector(). Entries are keyed by the position
+ * at which an object is defined in its script and the selector ID. Clones
+ * keep the position of the object they were cloned from and resolve all
+ * selectors the same way, so they share its entries.
+ *
+ * The cache must be cleared whenever objects or their superclass chains may
+ * change, i.e. when scripts are loaded, unloaded or freed.
+ */
+class SelectorLookupCache {
+public:
+	struct Entry {
+		SelectorType type;
+		int varIndex;		///< for kSelectorVariable
+		reg_t function;		///< for kSelectorMethod
+	};
+
+	SelectorLookupCache();
+
+	/**
+	 * Looks up the cached result for the object defined at pos.
+	 * @return	the entry, or NULL if the lookup is not cached
+	 */
+	const Entry *find(reg_t pos, Selector selectorId) {
+		EntryMap::const_iterator it = _entries.find(makeKey(pos, selectorId));
+		if (it == _entries.end()) {
+			_misses++;
+			return nullptr;
+		}
+		_hits++;
+		return &it->_value;
+	}
+
+	void store(reg_t pos, Selector selectorId, const Entry &entry) {
+		_entries[makeKey(pos, selectorId)] = entry;
+	}
+
+	/** Drops all entries. */
+	void clear();
+
+	void resetStats();
+
+	uint32 getHits() const { return _hits; }
+	uint32 getMisses() const { return _misses; }
+	uint32 getInvalidations() const { return _invalidations; }
+	uint getSize() const { return _entries.size(); }
+
+private:
+	struct KeyHash {
+		uint operator()(uint64 key) const {
+			return (uint)(key ^ (key >> 32));
+		}
+	};
+
+	typedef Common::HashMap<uint64, Entry, KeyHash> EntryMap;
+
+	static uint64 makeKey(reg_t pos, Selector selectorId) {
+		return ((uint64)pos.getSegment() << 48) | ((uint64)pos.getOffset() << 16) | (uint16)selectorId;
+	}
+
+	EntryMap _entries;
+	uint32 _hits;
+	uint32 _misses;
+	uint32 _invalidations;
+};
+
 /**
  * Map a selector name to a selector id. Shortcut for accessing the selector cache.
  */
@@ -85,34 +85,39 @@ static StackPtr validate_stack_addr(EngineState *s, StackPtr sp) {
 		(int)(sp - s->stack_base), 0, (int)(s->stack_top - s->stack_base - 1));
 }
 
-static bool validate_variable(reg_t *r, reg_t *stack_base, int type, int max, int index) {
+static bool validate_invalid_variable(reg_t *r, reg_t *stack_base, int type, int max, int index) {
 	const char *names[4] = {"global", "local", "temp", "param"};
 
-	if (index < 0 || index >= max) {
-		Common::String txt = Common::String::format(
-							"[VM] Attempt to use invalid %s variable %04x ",
-							names[type], index);
-		if (max == 0)
-			txt += "(variable type invalid)";
-		else
-			txt += Common::String::format("(out of range [%d..%d])", 0, max - 1);
-
-		if (type == VAR_PARAM || type == VAR_TEMP) {
-			int total_offset = r - stack_base;
-			if (total_offset < 0 || total_offset >= VM_STACK_SIZE) {
-				// Fatal, as the game is trying to do an OOB access
-				error("%s. [VM] Access would be outside even of the stack (%d); access denied", txt.c_str(), total_offset);
-				return false;
-			} else {
-				debugC(kDebugLevelVM, "%s", txt.c_str());
-				debugC(kDebugLevelVM, "[VM] Access within stack boundaries; access granted.");
-				return true;
-			}
+	Common::String txt = Common::String::format(
+						"[VM] Attempt to use invalid %s variable %04x ",
+						names[type], index);
+	if (max == 0)
+		txt += "(variable type invalid)";
+	else
+		txt += Common::String::format("(out of range [%d..%d])", 0, max - 1);
+
+	if (type == VAR_PARAM || type == VAR_TEMP) {
+		int total_offset = r - stack_base;
+		if (total_offset < 0 || total_offset >= VM_STACK_SIZE) {
+			// Fatal, as the game is trying to do an OOB access
+			error("%s. [VM] Access would be outside even of the stack (%d); access denied", txt.c_str(), total_offset);
+			return false;
+		} else {
+			debugC(kDebugLevelVM, "%s", txt.c_str());
+			debugC(kDebugLevelVM, "[VM] Access within stack boundaries; access granted.");
+			return true;
 		}
-		return false;
 	}
+	return false;
+}
+
+static inline bool validate_variable(reg_t *r, reg_t *stack_base, int type, int max, int index) {
+	// Keep the check for valid accesses small enough to be inlined, the
+	// error handling is rarely needed
+	if (index >= 0 && index < max)
+		return true;
 
-	return true;
+	return validate_invalid_variable(r, stack_base, type, max, index);
 }
 
 static reg_t read_var(EngineState *s, int type, int index) {
@@ -651,9 +656,12 @@ void run_vm(EngineState *s) {
 			error("run_vm(): program counter gone astray, addr: %d, code buffer size: %d",
 			s->xs->addr.pc.getOffset(), scr->getBufSize());
 
-		// Get opcode
-		byte extOpcode;
-		s->xs->addr.pc.incOffset(readPMachineInstruction(scr->getBuf(s->xs->addr.pc.getOffset()), extOpcode, opparams));
+		// Get opcode. Instructions are only decoded the first time they are
+		// executed, and copied since running other code may decode more.
+		const PMachineInstruction &instruction = scr->getInstruction(s->xs->addr.pc.getOffset());
+		const byte extOpcode = instruction.extOpcode;
+		memcpy(opparams, instruction.opparams, sizeof(opparams));
+		s->xs->addr.pc.incOffset(instruction.size);
 		const byte opcode = extOpcode >> 1;
 		//debug("%s: %d, %d, %d, %d, acc = %04x:%04x, script %d, local script %d", opcodeNames[opcode], opparams[0], opparams[1], opparams[2], opparams[3], PRINT_REG(s->r_acc), scr->getScriptNumber(), local_script->getScriptNumber());
 
@@ -20,6 +20,8 @@
  *
  */
 
+#include "common/workerpool.h"
+#include "graphics/skip_copy_kernels.h"
 #include "sci/resource.h"
 #include "sci/engine/features.h"
 #include "sci/engine/seg_manager.h"
@@ -79,6 +81,15 @@ const CelScalerTable *CelScaler::getScalerTable(const Ratio &scaleX, const Ratio
 	return &_scaleTables[_activeIndex];
 }
 
+#pragma mark -
+#pragma mark Row kernels
+
+static Graphics::SkipCopyProc skipCopy = Graphics::skipCopyRow;
+
+static void initRowProcs() {
+	skipCopy = Graphics::getSkipCopyProc();
+}
+
 #pragma mark -
 #pragma mark CelObj
 bool CelObj::_drawBlackLines = false;
@@ -90,6 +101,8 @@ void CelObj::init() {
 	_scaler = new CelScaler();
 	_cache = new CelCache;
 	_cache->resize(100);
+	_cacheIndex = new CelCacheIndex;
+	initRowProcs();
 }
 
 void CelObj::deinit() {
@@ -102,6 +115,8 @@ void CelObj::deinit() {
 	}
 	delete _cache;
 	_cache = nullptr;
+	delete _cacheIndex;
+	_cacheIndex = nullptr;
 }
 
 #pragma mark -
@@ -152,6 +167,15 @@ struct SCALER_NoScale {
 			return *_row++;
 		}
 	}
+
+	inline const byte *readRow(const int16 count) {
+		assert(!FLIP);
+		assert(_row + count <= _rowEdge);
+
+		const byte *row = _row;
+		_row += count;
+		return row;
+	}
 };
 
 template<bool FLIP, typename READER>
@@ -613,9 +637,19 @@ void CelObj::submitPalette() const {
 
 int CelObj::_nextCacheId = 1;
 CelCache *CelObj::_cache = nullptr;
+CelCacheIndex *CelObj::_cacheIndex = nullptr;
 
 int CelObj::searchCache(const CelInfo32 &celInfo, int *const nextInsertIndex) const {
 	*nextInsertIndex = -1;
+
+	CelCacheIndex::const_iterator cached = _cacheIndex->find(celInfo);
+	if (cached != _cacheIndex->end()) {
+		(*_cache)[cached->_value].id = ++_nextCacheId;
+		return cached->_value;
+	}
+
+	// Only a miss needs to look at every entry, to find the
+	// slot to reuse
 	int oldestId = _nextCacheId + 1;
 	int oldestIndex = 0;
 
@@ -626,9 +660,6 @@ int CelObj::searchCache(const CelInfo32 &celInfo, int *const nextInsertIndex) co
 			if (*nextInsertIndex == -1) {
 				*nextInsertIndex = i;
 			}
-		} else if (entry.celObj->_info == celInfo) {
-			entry.id = ++_nextCacheId;
-			return i;
 		} else if (oldestId > entry.id) {
 			oldestId = entry.id;
 			oldestIndex = i;
@@ -650,16 +681,56 @@ void CelObj::putCopyInCache(const int cacheIndex) const {
 	CelCacheEntry &entry = (*_cache)[cacheIndex];
 
 	if (entry.celObj != nullptr) {
+		// CelObjView clamps the loop and cel numbers after searching the
+		// cache, so another slot may hold the same key; only drop the key
+		// if it still refers to this slot
+		CelCacheIndex::iterator it = _cacheIndex->find(entry.celObj->_info);
+		if (it != _cacheIndex->end() && it->_value == cacheIndex) {
+			_cacheIndex->erase(it);
+		}
 		delete entry.celObj;
 	}
 
 	entry.celObj = duplicate();
 	entry.id = ++_nextCacheId;
+	(*_cacheIndex)[entry.celObj->_info] = cacheIndex;
 }
 
 #pragma mark -
 #pragma mark CelObj - Drawing
 
+/**
+ * Draws a single row of a cel through the given mapper
+ * and scaler, one pixel at a time.
+ */
+template<typename MAPPER, typename SCALER>
+struct ROW_RENDERER {
+	static inline void draw(byte *targetPixel, MAPPER &mapper, SCALER &scaler, const int16 width, const uint8 skipColor) {
+		for (int16 x = 0; x < width; ++x) {
+			mapper.draw(targetPixel++, scaler.read(), skipColor);
+		}
+	}
+};
+
+/**
+ * Unscaled, unmirrored rows without remapping read their
+ * source pixels in order, so whole rows can be copied at
+ * once.
+ */
+template<typename READER>
+struct ROW_RENDERER<MAPPER_NoMD, SCALER_NoScale<false, READER> > {
+	static inline void draw(byte *targetPixel, MAPPER_NoMD &, SCALER_NoScale<false, READER> &scaler, const int16 width, const uint8 skipColor) {
+		skipCopy(targetPixel, scaler.readRow(width), width, skipColor);
+	}
+};
+
+template<typename READER>
+struct ROW_RENDERER<MAPPER_NoMDNoSkip, SCALER_NoScale<false, READER> > {
+	static inline void draw(byte *targetPixel, MAPPER_NoMDNoSkip &, SCALER_NoScale<false, READER> &scaler, const int16 width, const uint8) {
+		memcpy(targetPixel, scaler.readRow(width), width);
+	}
+};
+
 template<typename MAPPER, typename SCALER, bool DRAW_BLACK_LINES>
 struct RENDERER {
 	MAPPER &_mapper;
@@ -671,13 +742,16 @@ struct RENDERER {
 	_scaler(scaler),
 	_skipColor(skipColor) {}
 
-	inline void draw(Buffer &target, const Common::Rect &targetRect, const Common::Point &scaledPosition) const {
-		byte *targetPixel = (byte *)target.getPixels() + target.screenWidth * targetRect.top + targetRect.left;
+	/**
+	 * Draws the rows [firstRow, lastRow) of the target
+	 * rectangle, counted from its top.
+	 */
+	inline void draw(Buffer &target, const Common::Rect &targetRect, const int16 firstRow, const int16 lastRow) const {
+		byte *targetPixel = (byte *)target.getPixels() + target.screenWidth * (targetRect.top + firstRow) + targetRect.left;
 
 		const int16 skipStride = target.screenWidth - targetRect.width();
 		const int16 targetWidth = targetRect.width();
-		const int16 targetHeight = targetRect.height();
-		for (int16 y = 0; y < targetHeight; ++y) {
+		for (int16 y = firstRow; y < lastRow; ++y) {
 			if (DRAW_BLACK_LINES && (y % 2) == 0) {
 				memset(targetPixel, 0, targetWidth);
 				targetPixel += targetWidth + skipStride;
@@ -686,22 +760,86 @@ struct RENDERER {
 
 			_scaler.setTarget(targetRect.left, targetRect.top + y);
 
-			for (int16 x = 0; x < targetWidth; ++x) {
-				_mapper.draw(targetPixel++, _scaler.read(), _skipColor);
-			}
+			ROW_RENDERER<MAPPER, SCALER>::draw(targetPixel, _mapper, _scaler, targetWidth, _skipColor);
 
-			targetPixel += skipStride;
+			targetPixel += targetWidth + skipStride;
 		}
 	}
 };
 
+enum {
+	/**
+	 * The smallest number of target pixels worth a band of
+	 * its own when a cel is drawn on multiple threads.
+	 */
+	kCelMinBandPixels = 16384
+};
+
+/**
+ * Draws the rows of a single cel in horizontal bands on
+ * the shared worker pool. Screen items are still drawn one
+ * after the other, so priority order is unaffected.
+ */
+template<typename MAPPER, typename SCALER, bool DRAW_BLACK_LINES>
+class RenderBandJob : public Common::BandedJob {
+public:
+	RenderBandJob(Buffer &target, const Common::Rect &targetRect, SCALER &scaler, const uint8 skipColor, const int numBands) :
+	_target(target),
+	_targetRect(targetRect),
+	_skipColor(skipColor) {
+		// Scalers keep the current source row and may decompress
+		// into it, so every band needs a copy of its own. The
+		// copies are made here since copying a resource span is
+		// not safe on the worker threads.
+		_scalers.push_back(&scaler);
+		for (int i = 1; i < numBands; ++i) {
+			_scalers.push_back(new SCALER(scaler));
+		}
+	}
+
+	~RenderBandJob() {
+		for (uint i = 1; i < _scalers.size(); ++i) {
+			delete _scalers[i];
+		}
+	}
+
+	void runBand(int begin, int end) {
+		MAPPER mapper;
+		const int height = _targetRect.height();
+		const int numBands = _scalers.size();
+		for (int band = begin; band < end; ++band) {
+			RENDERER<MAPPER, SCALER, DRAW_BLACK_LINES> renderer(mapper, *_scalers[band], _skipColor);
+			renderer.draw(_target, _targetRect, height * band / numBands, height * (band + 1) / numBands);
+		}
+	}
+
+private:
+	Buffer &_target;
+	const Common::Rect &_targetRect;
+	Common::Array<SCALER *> _scalers;
+	const uint8 _skipColor;
+};
+
+template<typename MAPPER, typename SCALER, bool DRAW_BLACK_LINES>
+static void renderBanded(Buffer &target, const Common::Rect &targetRect, MAPPER &mapper, SCALER &scaler, const uint8 skipColor) {
+	const int numBands = MIN<int>(Common::WorkerPool::getShared().getThreadCount() + 1, targetRect.width() * targetRect.height() / kCelMinBandPixels);
+
+	if (numBands <= 1) {
+		RENDERER<MAPPER, SCALER, DRAW_BLACK_LINES> renderer(mapper, scaler, skipColor);
+		renderer.draw(target, targetRect, 0, targetRect.height());
+		return;
+	}
+
+	RenderBandJob<MAPPER, SCALER, DRAW_BLACK_LINES> job(target, targetRect, scaler, skipColor, numBands);
+	Common::runBanded(job, numBands, 1);
+}
+
 template<typename MAPPER, typename SCALER>
 void CelObj::render(Buffer &target, const Common::Rect &targetRect, const Common::Point &scaledPosition) const {
 
 	MAPPER mapper;
 	SCALER scaler(*this, targetRect.left - scaledPosition.x + targetRect.width(), scaledPosition);
-	RENDERER<MAPPER, SCALER, false> renderer(mapper, scaler, _skipColor);
-	renderer.draw(target, targetRect, scaledPosition);
+	renderBanded<MAPPER, SCALER, false>(target, targetRect, mapper, scaler, _skipColor);
 }
 
 template<typename MAPPER, typename SCALER>
@@ -710,11 +848,9 @@ void CelObj::render(Buffer &target, const Common::Rect &targetRect, const Common
 	MAPPER mapper;
 	SCALER scaler(*this, targetRect, scaledPosition, scaleX, scaleY);
 	if (_drawBlackLines) {
-		RENDERER<MAPPER, SCALER, true> renderer(mapper, scaler, _skipColor);
-		renderer.draw(target, targetRect, scaledPosition);
+		renderBanded<MAPPER, SCALER, true>(target, targetRect, mapper, scaler, _skipColor);
 	} else {
-		RENDERER<MAPPER, SCALER, false> renderer(mapper, scaler, _skipColor);
-		renderer.draw(target, targetRect, scaledPosition);
+		renderBanded<MAPPER, SCALER, false>(target, targetRect, mapper, scaler, _skipColor);
 	}
 }
 
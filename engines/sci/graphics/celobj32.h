@@ -23,6 +23,7 @@
 #ifndef SCI_GRAPHICS_CELOBJ32_H
 #define SCI_GRAPHICS_CELOBJ32_H
 
+#include "common/hashmap.h"
 #include "common/rational.h"
 #include "common/rect.h"
 #include "sci/resource.h"
@@ -110,7 +111,7 @@ struct CelInfo32 {
 	// NOTE: This is the equivalence criteria used by
 	// CelObj::searchCache in at least SCI2.1/SQ6. Notably,
 	// it does not check the color field.
-	inline bool operator==(const CelInfo32 &other) {
+	inline bool operator==(const CelInfo32 &other) const {
 		return (
 			type == other.type &&
 			resourceId == other.resourceId &&
@@ -120,7 +121,7 @@ struct CelInfo32 {
 		);
 	}
 
-	inline bool operator!=(const CelInfo32 &other) {
+	inline bool operator!=(const CelInfo32 &other) const {
 		return !(*this == other);
 	}
 
@@ -154,6 +155,22 @@ struct CelCacheEntry {
 
 typedef Common::Array<CelCacheEntry> CelCache;
 
+/**
+ * Hashes the fields of a CelInfo32 which are used to
+ * find it in the cel cache.
+ */
+struct CelInfo32Hash {
+	uint operator()(const CelInfo32 &info) const {
+		return (info.type << 28) ^ (info.resourceId << 12) ^ (info.loopNo << 8) ^ info.celNo ^ reg_t_Hash()(info.bitmap);
+	}
+};
+
+/**
+ * Maps the CelInfo32 of every cached cel object to its
+ * slot in the cel cache.
+ */
+typedef Common::HashMap<CelInfo32, int, CelInfo32Hash> CelCacheIndex;
+
 #pragma mark -
 #pragma mark CelScaler
 
@@ -483,6 +500,12 @@ protected:
 	// NOTE: At least SQ6 uses a fixed cache size of 100.
 	static CelCache *_cache;
 
+	/**
+	 * An index of the cel cache, used to find cached cel
+	 * objects without scanning the whole cache.
+	 */
+	static CelCacheIndex *_cacheIndex;
+
 	/**
 	 * Searches the cel cache for a CelObj matching the
 	 * provided CelInfo32. If not found, -1 is returned.
@@ -25,11 +25,11 @@
 #include "common/file.h"
 #include "common/fs.h"
 #include "common/macresman.h"
+#include "common/memstream.h"
+#include "common/system.h"
 #include "common/textconsole.h"
 #include "common/translation.h"
-#ifdef ENABLE_SCI32
-#include "common/memstream.h"
-#endif
+#include "common/workerpool.h"
 
 #include "sci/parser/vocabulary.h"
 #include "sci/resource.h"
@@ -387,6 +387,18 @@ Common::SeekableReadStream *ResourceManager::getVolumeFile(ResourceSource *sourc
 	return NULL;
 }
 
+Common::SeekableReadStream *ResourceManager::openVolumeFile(ResourceSource *source) {
+	if (source->_resourceFile)
+		return source->_resourceFile->createReadStream();
+
+	Common::File *file = new Common::File;
+	if (!file->open(source->getLocationName())) {
+		delete file;
+		return nullptr;
+	}
+	return file;
+}
+
 void ResourceManager::disposeVolumeFileStream(Common::SeekableReadStream *fileStream, Sci::ResourceSource *source) {
 #ifdef ENABLE_SCI32
 	ChunkResourceSource *chunkSource = dynamic_cast<ChunkResourceSource *>(source);
@@ -405,8 +417,122 @@ void ResourceManager::disposeVolumeFileStream(Common::SeekableReadStream *fileSt
 	// deleted from _volumeFiles
 }
 
+/**
+ * Creates the decompressor for a compression method.
+ * @return the decompressor, or nullptr if the method is not supported
+ */
+static Decompressor *createDecompressor(ResourceCompression compression) {
+	switch (compression) {
+	case kCompNone:
+		return new Decompressor;
+	case kCompHuffman:
+		return new DecompressorHuffman;
+	case kCompLZW:
+	case kCompLZW1:
+	case kCompLZW1View:
+	case kCompLZW1Pic:
+		return new DecompressorLZW(compression);
+	case kCompDCL:
+		return new DecompressorDCL;
+#ifdef ENABLE_SCI32
+	case kCompSTACpack:
+		return new DecompressorLZS;
+#endif
+	default:
+		return nullptr;
+	}
+}
+
+/**
+ * Reads and decompresses a prefetched resource on a worker thread. The job
+ * reads from a stream of the volume file of its own, which the main thread
+ * opens, as looking up files through the search manager is not thread-safe.
+ * The main thread hands the result over to the resource once it is
+ * requested. Problems with the data are only recorded, as warning() and
+ * error() may not be called here; the main thread then loads the resource
+ * again, which reports them.
+ */
+class ResourcePrefetchJob : public Common::WorkerJob {
+public:
+	ResourcePrefetchJob(ResourceSource *source, int32 fileOffset, Common::SeekableReadStream *file, int32 dataOffset, ResourceCompression compression, uint32 packedSize, uint32 size) :
+		_source(source), _fileOffset(fileOffset), _file(file), _dataOffset(dataOffset), _compression(compression), _packedSize(packedSize), _size(size), _data(nullptr), _error(SCI_ERROR_NONE) {}
+
+	~ResourcePrefetchJob() {
+		delete _file;
+		delete[] _data;
+	}
+
+	void run() {
+		// The decompressors may read a few bytes ahead, which are zeroed
+		byte *packed = new byte[_packedSize + kReadAhead];
+		memset(packed + _packedSize, 0, kReadAhead);
+
+		_file->seek(_dataOffset, SEEK_SET);
+		if (_file->read(packed, _packedSize) == _packedSize) {
+			Common::MemoryReadStream stream(packed, _packedSize + kReadAhead);
+			Decompressor *dec = createDecompressor(_compression);
+			dec->setQuiet(true);
+
+			_data = new byte[_size];
+			_error = dec->unpack(&stream, _data, _packedSize, _size);
+			if (!_error && dec->hasFailed())
+				_error = SCI_ERROR_DECOMPRESSION_ERROR;
+			if (_error) {
+				delete[] _data;
+				_data = nullptr;
+			}
+
+			delete dec;
+		} else {
+			_error = SCI_ERROR_IO_ERROR;
+		}
+
+		// The stream is deleted on the main thread, Common::File shares its
+		// name with the resource source
+		delete[] packed;
+	}
+
+	/** Returns the unpacked data, which the caller then owns. */
+	byte *takeData() {
+		byte *data = _data;
+		_data = nullptr;
+		return data;
+	}
+
+	/** Returns the amount of memory held by the job. */
+	uint32 getMemorySize() const { return _packedSize + _size; }
+
+	enum {
+		kReadAhead = 4
+	};
+
+	ResourceSource *const _source;
+	const int32 _fileOffset;
+
+private:
+	Common::SeekableReadStream *_file;
+	const int32 _dataOffset;
+	const ResourceCompression _compression;
+	const uint32 _packedSize;
+	const uint32 _size;
+	byte *_data;
+	int _error;
+};
+
 void ResourceManager::loadResource(Resource *res) {
-	res->_source->loadResource(this, res);
+	const uint32 startTime = g_system->getMillis();
+
+	const bool prefetched = loadPrefetchedResource(res);
+	if (!prefetched)
+		res->_source->loadResource(this, res);
+
+	const uint32 time = g_system->getMillis() - startTime;
+	LoadStats &stats = _loadStats[res->getType()];
+	stats.loads++;
+	if (prefetched)
+		stats.prefetched++;
+	stats.totalTime += time;
+	stats.maxTime = MAX(stats.maxTime, time);
 }
 
 
@@ -951,7 +1077,7 @@ void ResourceManager::freeResourceSources() {
 }
 
 ResourceManager::ResourceManager(const bool detectionMode) :
-	_detectionMode(detectionMode) {}
+	_detectionMode(detectionMode), _prefetchPool(nullptr), _prefetchMemory(0) {}
 
 void ResourceManager::init() {
 	_maxMemoryLRU = 256 * 1024; // 256KiB
@@ -960,6 +1086,7 @@ void ResourceManager::init() {
 	_LRU.clear();
 	_resMap.clear();
 	_audioMapSCI1 = NULL;
+	resetLoadStats();
 #ifdef ENABLE_SCI32
 	_currentDiscNo = 1;
 #endif
@@ -1038,6 +1165,11 @@ void ResourceManager::init() {
 }
 
 ResourceManager::~ResourceManager() {
+	// Wait for the running prefetches, they use the resource sources
+	delete _prefetchPool;
+	for (Common::List<ResourcePrefetchJob *>::iterator it = _prefetchJobs.begin(); it != _prefetchJobs.end(); ++it)
+		delete *it;
+
 	// freeing resources
 	ResourceMap::iterator itr = _resMap.begin();
 	while (itr != _resMap.end()) {
@@ -1353,7 +1485,7 @@ ResVersion ResourceManager::detectVolVersion() {
 	while (!fileStream->eos() && fileStream->pos() < 0x100000) {
 		if (curVersion > kResVersionSci0Sci1Early)
 			fileStream->readByte();
-		fileStream->skip(2);	// resId
+		fileStream->readUint16LE();	// resId
 		dwPacked = (curVersion < kResVersionSci2) ? fileStream->readUint16LE() : fileStream->readUint32LE();
 		dwUnpacked = (curVersion < kResVersionSci2) ? fileStream->readUint16LE() : fileStream->readUint32LE();
 
@@ -1406,12 +1538,23 @@ ResVersion ResourceManager::detectVolVersion() {
 			continue;
 		}
 
+		int32 skip;
 		if (curVersion < kResVersionSci11)
-			fileStream->seek(dwPacked - 4, SEEK_CUR);
+			skip = dwPacked - 4;
 		else if (curVersion == kResVersionSci11)
-			fileStream->seek(sci11Align && ((9 + dwPacked) % 2) ? dwPacked + 1 : dwPacked, SEEK_CUR);
-		else if (curVersion >= kResVersionSci2)
-			fileStream->seek(dwPacked, SEEK_CUR);
+			skip = sci11Align && ((9 + dwPacked) % 2) ? dwPacked + 1 : dwPacked;
+		else
+			skip = dwPacked;
+
+		// Sizes read from a damaged or bogus volume may point outside of
+		// it. Not every stream can seek there, so treat this like running
+		// into the end of the volume while reading a header.
+		const int32 next = fileStream->pos() + skip;
+		if (next < 0 || next > fileStream->size()) {
+			delete fileStream;
+			return curVersion;
+		}
+		fileStream->seek(next);
 	}
 
 	delete fileStream;
@@ -2193,60 +2336,149 @@ int Resource::decompress(ResVersion volVersion, Common::SeekableReadStream *file
 		return errorNum;
 
 	// getting a decompressor
-	Decompressor *dec = NULL;
-	switch (compression) {
-	case kCompNone:
-		dec = new Decompressor;
-		break;
-	case kCompHuffman:
-		dec = new DecompressorHuffman;
-		break;
-	case kCompLZW:
-	case kCompLZW1:
-	case kCompLZW1View:
-	case kCompLZW1Pic:
-		dec = new DecompressorLZW(compression);
-		break;
-	case kCompDCL:
-		dec = new DecompressorDCL;
-		break;
-#ifdef ENABLE_SCI32
-	case kCompSTACpack:
-		dec = new DecompressorLZS;
-		break;
-#endif
-	default:
+	Decompressor *dec = createDecompressor(compression);
+	if (!dec) {
 		error("Resource %s: Compression method %d not supported", _id.toString().c_str(), compression);
 		return SCI_ERROR_UNKNOWN_COMPRESSION;
 	}
 
 	byte *ptr = new byte[_size];
-	_data = ptr;
-	_status = kResStatusAllocated;
-	errorNum = ptr ? dec->unpack(file, ptr, szPacked, _size) : SCI_ERROR_RESOURCE_TOO_BIG;
+	errorNum = dec->unpack(file, ptr, szPacked, _size);
 	if (errorNum) {
+		delete[] ptr;
 		unalloc();
 	} else {
-		// At least Lighthouse puts sound effects in RESSCI.00n/RESSCI.PAT
-		// instead of using a RESOURCE.SFX
-		if (getType() == kResourceTypeAudio) {
-			const uint8 headerSize = ptr[1];
-			if (headerSize < 11) {
-				error("Unexpected audio header size for %s: should be >= 11, but got %d", _id.toString().c_str(), headerSize);
-			}
-			const uint32 audioSize = READ_LE_UINT32(ptr + 9);
-			const uint32 calculatedTotalSize = audioSize + headerSize + kResourceHeaderSize;
-			if (calculatedTotalSize != _size) {
-				error("Unexpected audio file size: the size of %s in %s is %d, but the volume says it should be %d", _id.toString().c_str(), _source->getLocationName().c_str(), calculatedTotalSize, _size);
-			}
-			_size = headerSize + audioSize;
-		}
+		setUnpackedData(ptr);
 	}
 
 	delete dec;
 	return errorNum;
 }
 
+void Resource::setUnpackedData(byte *data) {
+	_data = data;
+	_status = kResStatusAllocated;
+
+	// At least Lighthouse puts sound effects in RESSCI.00n/RESSCI.PAT
+	// instead of using a RESOURCE.SFX
+	if (getType() == kResourceTypeAudio) {
+		const uint8 headerSize = data[1];
+		if (headerSize < 11) {
+			error("Unexpected audio header size for %s: should be >= 11, but got %d", _id.toString().c_str(), headerSize);
+		}
+		const uint32 audioSize = READ_LE_UINT32(data + 9);
+		const uint32 calculatedTotalSize = audioSize + headerSize + kResourceHeaderSize;
+		if (calculatedTotalSize != _size) {
+			error("Unexpected audio file size: the size of %s in %s is %d, but the volume says it should be %d", _id.toString().c_str(), _source->getLocationName().c_str(), calculatedTotalSize, _size);
+		}
+		_size = headerSize + audioSize;
+	}
+}
+
+bool ResourceManager::prefetchResource(ResourceId id) {
+	Resource *res = testResource(id);
+	if (_detectionMode || !res || res->_status != kResStatusNoMalloc || res->_source->getSourceType() != kSourceVolume)
+		return false;
+
+	for (Common::List<ResourcePrefetchJob *>::const_iterator it = _prefetchJobs.begin(); it != _prefetchJobs.end(); ++it) {
+		if ((*it)->_source == res->_source && (*it)->_fileOffset == res->_fileOffset)
+			return true;
+	}
+
+	Common::SeekableReadStream *fileStream = getVolumeFile(res->_source);
+	if (!fileStream)
+		return false;
+
+	fileStream->seek(res->_fileOffset, SEEK_SET);
+
+	// Only the header is read here, the job reads the packed data
+	uint32 packedSize;
+	ResourceCompression compression;
+	Decompressor *dec = nullptr;
+	bool fits = false;
+	if (!res->readResourceInfo(_volVersion, fileStream, packedSize, compression) &&
+		packedSize <= SCI_MAX_RESOURCE_SIZE && res->_size <= SCI_MAX_RESOURCE_SIZE &&
+		(dec = createDecompressor(compression)) != nullptr) {
+
+		// Drop prefetches which were never used, oldest first, to stay
+		// within the memory budget. It is separate from the budget of the
+		// LRU, prefetched data is moved there once it is requested.
+		const uint32 memorySize = packedSize + res->_size;
+		while (!_prefetchJobs.empty() && _prefetchMemory + memorySize > MAX_PREFETCH_MEMORY &&
+			   _prefetchPool->isDone(_prefetchJobs.front())) {
+			ResourcePrefetchJob *job = _prefetchJobs.front();
+			removePrefetchJob(job);
+			delete job;
+		}
+
+		fits = _prefetchJobs.empty() || _prefetchMemory + memorySize <= MAX_PREFETCH_MEMORY;
+	}
+
+	delete dec;
+	const int32 packedOffset = fileStream->pos();
+	disposeVolumeFileStream(fileStream, res->_source);
+
+	if (!fits)
+		return false;
+
+	Common::SeekableReadStream *file = openVolumeFile(res->_source);
+	if (!file)
+		return false;
+
+	if (!_prefetchPool)
+		_prefetchPool = new Common::WorkerPool(1);
+
+	ResourcePrefetchJob *job = new ResourcePrefetchJob(res->_source, res->_fileOffset, file, packedOffset, compression, packedSize, res->_size);
+	_prefetchJobs.push_back(job);
+	_prefetchMemory += job->getMemorySize();
+	_prefetchPool->submit(job);
+
+	debugC(kDebugLevelResMan, 2, "[resMan] Prefetching %s", id.toString().c_str());
+	return true;
+}
+
+void ResourceManager::prefetchRoom(uint16 roomNumber) {
+	prefetchResource(ResourceId(kResourceTypeScript, roomNumber));
+	prefetchResource(ResourceId(kResourceTypeHeap, roomNumber));
+	prefetchResource(ResourceId(kResourceTypePic, roomNumber));
+	prefetchResource(ResourceId(kResourceTypeMessage, roomNumber));
+}
+
+bool ResourceManager::loadPrefetchedResource(Resource *res) {
+	ResourcePrefetchJob *job = nullptr;
+	for (Common::List<ResourcePrefetchJob *>::const_iterator it = _prefetchJobs.begin(); it != _prefetchJobs.end(); ++it) {
+		if ((*it)->_source == res->_source && (*it)->_fileOffset == res->_fileOffset) {
+			job = *it;
+			break;
+		}
+	}
+
+	if (!job)
+		return false;
+
+	_prefetchPool->wait(job);
+	removePrefetchJob(job);
+
+	byte *data = job->takeData();
+	delete job;
+
+	// Failed prefetches are loaded again, to report the error
+	if (!data)
+		return false;
+
+	res->setUnpackedData(data);
+	return true;
+}
+
+void ResourceManager::removePrefetchJob(ResourcePrefetchJob *job) {
+	_prefetchJobs.remove(job);
+	_prefetchMemory -= job->getMemorySize();
+}
+
+void ResourceManager::resetLoadStats() {
+	memset(_loadStats, 0, sizeof(_loadStats));
+}
+
 ResourceCompression ResourceManager::getViewCompression() {
 	int viewsTested = 0;
 
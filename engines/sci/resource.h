@@ -38,6 +38,7 @@ class FSList;
 class FSNode;
 class WriteStream;
 class SeekableReadStream;
+class WorkerPool;
 }
 
 namespace Sci {
@@ -71,7 +72,8 @@ enum ResourceErrorCodes {
 };
 
 enum {
-	MAX_OPENED_VOLUMES = 5 ///< Max number of simultaneously opened volumes
+	MAX_OPENED_VOLUMES = 5, ///< Max number of simultaneously opened volumes
+	MAX_PREFETCH_MEMORY = 1024 * 1024 ///< Max amount of memory held by prefetched resources not requested yet
 };
 
 enum ResourceType {
@@ -295,12 +297,14 @@ protected:
 	bool loadFromAudioVolumeSCI1(Common::SeekableReadStream *file);
 	bool loadFromAudioVolumeSCI11(Common::SeekableReadStream *file);
 	int decompress(ResVersion volVersion, Common::SeekableReadStream *file);
+	void setUnpackedData(byte *data);
 	int readResourceInfo(ResVersion volVersion, Common::SeekableReadStream *file, uint32 &szPacked, ResourceCompression &compression);
 };
 
 typedef Common::HashMap<ResourceId, Resource *, ResourceIdHash> ResourceMap;
 
 class IntMapResourceSource;
+class ResourcePrefetchJob;
 class ResourceManager {
 	// FIXME: These 'friend' declarations are meant to be a temporary hack to
 	// ease transition to the ResourceSource class system.
@@ -356,6 +360,34 @@ public:
 	 */
 	void unlockResource(Resource *res);
 
+	/**
+	 * Starts decompressing a resource in the background, so that a later
+	 * findResource() does not have to wait for it. This is only a hint: it
+	 * does nothing if the resource is already loaded, is not stored in a
+	 * resource volume, or too much prefetched data is still unused.
+	 * @param id	The resource to prefetch
+	 * @return true if the resource is being prefetched
+	 */
+	bool prefetchResource(ResourceId id);
+
+	/**
+	 * Prefetches the resources of a room which are named after its number,
+	 * i.e. its script, heap, picture and messages.
+	 * @param roomNumber	The number of the room
+	 */
+	void prefetchRoom(uint16 roomNumber);
+
+	/** Statistics of the loads of the resources of one type. */
+	struct LoadStats {
+		uint32 loads;		///< number of resources loaded
+		uint32 prefetched;	///< number of loads satisfied by a prefetch
+		uint32 totalTime;	///< time spent loading, in milliseconds
+		uint32 maxTime;		///< longest load, in milliseconds
+	};
+
+	const LoadStats &getLoadStats(ResourceType type) const { return _loadStats[type]; }
+	void resetLoadStats();
+
 	/**
 	 * Tests whether a resource exists.
 	 *
@@ -471,6 +503,10 @@ protected:
 	Common::List<Resource *> _LRU; ///< Last Resource Used list
 	ResourceMap _resMap;
 	Common::List<Common::File *> _volumeFiles; ///< list of opened volume files
+	Common::WorkerPool *_prefetchPool; ///< decompresses prefetched resources, created on first use
+	Common::List<ResourcePrefetchJob *> _prefetchJobs; ///< prefetches not claimed yet, oldest first
+	uint32 _prefetchMemory; ///< Amount of bytes held by _prefetchJobs
+	LoadStats _loadStats[kResourceTypeInvalid + 1];
 	ResourceSource *_audioMapSCI1; ///< Currently loaded audio map for SCI1
 	ResVersion _volVersion; ///< resource.0xx version
 	ResVersion _mapVersion; ///< resource.map version
@@ -527,7 +563,15 @@ protected:
 	 */
 	Common::SeekableReadStream *getVolumeFile(ResourceSource *source);
 	void disposeVolumeFileStream(Common::SeekableReadStream *fileStream, ResourceSource *source);
+
+	/**
+	 * Opens a new stream for the volume file of a source, which is not
+	 * shared with any other user. The caller deletes it.
+	 */
+	Common::SeekableReadStream *openVolumeFile(ResourceSource *source);
 	void loadResource(Resource *res);
+	bool loadPrefetchedResource(Resource *res);
+	void removePrefetchJob(ResourcePrefetchJob *job);
 	void freeOldResources();
 	bool validateResource(const ResourceId &resourceId, const Common::String &sourceMapLocation, const Common::String &sourceName, const uint32 offset, const uint32 size, const uint32 sourceSize) const;
 	Resource *addResource(ResourceId resId, ResourceSource *src, uint32 offset, uint32 size = 0, const Common::String &sourceMapLocation = Common::String("(no map location)"));
@@ -34,26 +34,7 @@ namespace Graphics {
  ********************************************************************/
 void VectorRenderer::drawStep(const Common::Rect &area, const DrawStep &step, uint32 extra) {
 
-	if (step.bgColor.set)
-		setBgColor(step.bgColor.r, step.bgColor.g, step.bgColor.b);
-
-	if (step.fgColor.set)
-		setFgColor(step.fgColor.r, step.fgColor.g, step.fgColor.b);
-
-	if (step.bevelColor.set)
-		setBevelColor(step.bevelColor.r, step.bevelColor.g, step.bevelColor.b);
-
-	if (step.gradColor1.set && step.gradColor2.set)
-		setGradientColors(step.gradColor1.r, step.gradColor1.g, step.gradColor1.b,
-						  step.gradColor2.r, step.gradColor2.g, step.gradColor2.b);
-
-	setShadowOffset(_disableShadows ? 0 : step.shadow);
-	setBevel(step.bevel);
-	setGradientFactor(step.factor);
-	setStrokeWidth(step.stroke);
-	setFillMode((FillMode)step.fillMode);
-
-	_dynamicData = extra;
+	applyStepState(step, extra);
 
 	Common::Rect noClip = Common::Rect(0, 0, 0, 0);
 	(this->*(step.drawingCall))(area, step, noClip);
@@ -61,6 +42,12 @@ void VectorRenderer::drawStep(const Common::Rect &area, const DrawStep &step, ui
 
 void VectorRenderer::drawStepClip(const Common::Rect &area, const Common::Rect &clip, const DrawStep &step, uint32 extra) {
 
+	applyStepState(step, extra);
+
+	(this->*(step.drawingCall))(area, step, clip);
+}
+
+void VectorRenderer::applyStepState(const DrawStep &step, uint32 extra) {
 	if (step.bgColor.set)
 		setBgColor(step.bgColor.r, step.bgColor.g, step.bgColor.b);
 
@@ -72,7 +59,7 @@ void VectorRenderer::drawStepClip(const Common::Rect &area, const Common::Rect &
 
 	if (step.gradColor1.set && step.gradColor2.set)
 		setGradientColors(step.gradColor1.r, step.gradColor1.g, step.gradColor1.b,
-			step.gradColor2.r, step.gradColor2.g, step.gradColor2.b);
+						  step.gradColor2.r, step.gradColor2.g, step.gradColor2.b);
 
 	setShadowOffset(_disableShadows ? 0 : step.shadow);
 	setBevel(step.bevel);
@@ -81,8 +68,6 @@ void VectorRenderer::drawStepClip(const Common::Rect &area, const Common::Rect &
 	setFillMode((FillMode)step.fillMode);
 
 	_dynamicData = extra;
-
-	(this->*(step.drawingCall))(area, step, clip);
 }
 
 int VectorRenderer::stepGetRadius(const DrawStep &step, const Common::Rect &area) {
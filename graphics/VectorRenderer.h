@@ -29,6 +29,7 @@
 
 #include "graphics/surface.h"
 #include "graphics/transparent_surface.h"
+#include "graphics/VectorRendererState.h"
 
 #include "gui/ThemeEngine.h"
 
@@ -289,6 +290,17 @@ public:
 		_activeSurface = surface;
 	}
 
+	/**
+	 * Returns the active drawing surface.
+	 */
+	TransparentSurface *getSurface() const { return _activeSurface; }
+
+	/**
+	 * Returns the drawing state which isn't set by every DrawStep, see
+	 * VectorRendererState.
+	 */
+	virtual VectorRendererState getState() const = 0;
+
 	/**
 	 * Fills the active surface with the specified fg/bg color or the active gradient.
 	 * Defaults to using the active Foreground color for filling.
@@ -451,6 +463,14 @@ public:
 	virtual void drawStep(const Common::Rect &area, const DrawStep &step, uint32 extra = 0);
 	virtual void drawStepClip(const Common::Rect &area, const Common::Rect &clip, const DrawStep &step, uint32 extra = 0);
 
+	/**
+	 * Sets up the colors and settings of the specified draw step without
+	 * drawing it, leaving the renderer in the same state as drawStep().
+	 *
+	 * @param step Pointer to a DrawStep struct.
+	 */
+	void applyStepState(const DrawStep &step, uint32 extra = 0);
+
 	/**
 	 * Copies the part of the current frame to the system overlay.
 	 *
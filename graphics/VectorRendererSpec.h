@@ -83,6 +83,18 @@ public:
 	void setFgColor(uint8 r, uint8 g, uint8 b) { _fgColor = _format.RGBToColor(r, g, b); }
 	void setBgColor(uint8 r, uint8 g, uint8 b) { _bgColor = _format.RGBToColor(r, g, b); }
 	void setBevelColor(uint8 r, uint8 g, uint8 b) { _bevelColor = _format.RGBToColor(r, g, b); }
+
+	VectorRendererState getState() const {
+		VectorRendererState state;
+		state.fgColor = _fgColor;
+		state.bgColor = _bgColor;
+		state.bevelColor = _bevelColor;
+		state.gradientStart = _gradientStart;
+		state.gradientEnd = _gradientEnd;
+		state.disableShadows = Base::_disableShadows;
+		return state;
+	}
+
 	void setGradientColors(uint8 r1, uint8 g1, uint8 b1, uint8 r2, uint8 g2, uint8 b2);
 
 	void copyFrame(OSystem *sys, const Common::Rect &r);
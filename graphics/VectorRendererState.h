@@ -0,0 +1,71 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef VECTOR_RENDERER_STATE_H
+#define VECTOR_RENDERER_STATE_H
+
+#include "common/scummsys.h"
+
+namespace Graphics {
+
+/**
+ * The drawing state of a VectorRenderer which isn't set by every DrawStep,
+ * i.e. the colors a step inherits from the steps drawn before it, and
+ * whether shadows are disabled. Drawing the same steps with the same state
+ * on the same background gives the same pixels.
+ */
+struct VectorRendererState {
+	uint32 fgColor;
+	uint32 bgColor;
+	uint32 bevelColor;
+	uint32 gradientStart;
+	uint32 gradientEnd;
+	bool disableShadows;
+
+	VectorRendererState() : fgColor(0), bgColor(0), bevelColor(0), gradientStart(0), gradientEnd(0), disableShadows(false) {}
+
+	bool operator==(const VectorRendererState &other) const {
+		return fgColor == other.fgColor &&
+			bgColor == other.bgColor &&
+			bevelColor == other.bevelColor &&
+			gradientStart == other.gradientStart &&
+			gradientEnd == other.gradientEnd &&
+			disableShadows == other.disableShadows;
+	}
+
+	bool operator!=(const VectorRendererState &other) const { return !(*this == other); }
+
+	/** Returns a hash of the state, equal states have equal hashes. */
+	uint32 hash() const {
+		uint32 hash = fgColor;
+		hash = hash * 31 + bgColor;
+		hash = hash * 31 + bevelColor;
+		hash = hash * 31 + gradientStart;
+		hash = hash * 31 + gradientEnd;
+		hash = hash * 31 + disableShadows;
+		return hash;
+	}
+};
+
+} // End of namespace Graphics
+
+#endif
@@ -27,15 +27,19 @@ MODULE_OBJS := \
 	scaler/thumbnail_intern.o \
 	screen.o \
 	sjis.o \
+	skip_copy_kernels.o \
 	surface.o \
+	transform_cache.o \
 	transform_struct.o \
 	transform_tools.o \
 	transparent_surface.o \
+	transparent_surface_kernels.o \
 	thumbnail.o \
 	VectorRenderer.o \
 	VectorRendererSpec.o \
 	wincursor.o \
-	yuv_to_rgb.o
+	yuv_to_rgb.o \
+	yuv_to_rgb_kernels.o
 
 ifdef USE_SCALERS
 MODULE_OBJS += \
@@ -62,6 +66,9 @@ ifdef USE_NASM
 MODULE_OBJS += \
 	scaler/hq2x_i386.o \
 	scaler/hq3x_i386.o
+else
+MODULE_OBJS += \
+	scaler/hq_patterns.o
 endif
 
 endif
@@ -20,6 +20,7 @@
  *
  */
 
+#include "graphics/scaler.h"
 #include "graphics/scaler/intern.h"
 #include "graphics/scaler/scalebit.h"
 #include "common/util.h"
@@ -159,6 +160,14 @@ void DestroyScalers() {
 #endif
 }
 
+bool isScalerReentrant(ScalerProc *scaler) {
+#if defined(USE_SCALERS) && defined(USE_HQ_SCALERS) && defined(USE_NASM)
+	if (scaler == HQ2x || scaler == HQ3x)
+		return false;
+#endif
+	return true;
+}
+
 
 /**
  * Trivial 'scaler' - in fact it doesn't do any scaling but just copies the
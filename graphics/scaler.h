@@ -62,6 +62,13 @@ DECLARE_SCALER(HQ3x);
 
 #endif // #ifdef USE_SCALERS
 
+/**
+ * Returns whether the scaler may run on several threads at once, each on
+ * its own band of the same image. This is not the case for the assembly
+ * versions of HQ2x and HQ3x, which keep their state in global variables.
+ */
+extern bool isScalerReentrant(ScalerProc *scaler);
+
 // creates a 160x100 thumbnail for 320x200 games
 // and 160x120 thumbnail for 320x240 and 640x480 games
 // only 565 mode
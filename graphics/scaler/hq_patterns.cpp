@@ -0,0 +1,192 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "graphics/scaler/hq_patterns.h"
+#include "graphics/scaler/intern.h"
+#include "common/cpudetect.h"
+
+#ifdef SCUMMVM_SIMD_X86
+#include <emmintrin.h>
+#include <immintrin.h>
+#endif
+
+extern "C" uint32 *RGBtoYUV;
+
+void computeHQPatternRow(byte *patterns, const uint32 *yuv0, const uint32 *yuv1, const uint32 *yuv2, int width) {
+	for (int x = 0; x < width; ++x) {
+		const int yuv5 = yuv1[x];
+
+		int pattern = 0;
+		if (diffYUV(yuv5, yuv0[x - 1])) pattern |= 0x0001;
+		if (diffYUV(yuv5, yuv0[x    ])) pattern |= 0x0002;
+		if (diffYUV(yuv5, yuv0[x + 1])) pattern |= 0x0004;
+		if (diffYUV(yuv5, yuv1[x - 1])) pattern |= 0x0008;
+		if (diffYUV(yuv5, yuv1[x + 1])) pattern |= 0x0010;
+		if (diffYUV(yuv5, yuv2[x - 1])) pattern |= 0x0020;
+		if (diffYUV(yuv5, yuv2[x    ])) pattern |= 0x0040;
+		if (diffYUV(yuv5, yuv2[x + 1])) pattern |= 0x0080;
+
+		patterns[x] = pattern;
+	}
+}
+
+// The YUV values hold Y, U and V in bytes 2, 1 and 0, so the vectorized
+// kernels compute the absolute differences of all three with saturating
+// byte arithmetic. The differences above the thresholds of diffYUV() stay
+// non zero after subtracting the thresholds.
+#define HQ_THRESHOLDS 0x00300706
+
+#ifdef SCUMMVM_SIMD_X86
+
+/**
+ * Return the bit where the 4 pixels of center and neighbour differ.
+ */
+__attribute__((target("sse2")))
+static inline __m128i diffBitSSE2(__m128i center, const uint32 *neighbour, __m128i thresholds, int bit) {
+	const __m128i n = _mm_loadu_si128((const __m128i *)neighbour);
+	const __m128i absDiff = _mm_or_si128(_mm_subs_epu8(center, n), _mm_subs_epu8(n, center));
+	const __m128i same = _mm_cmpeq_epi32(_mm_subs_epu8(absDiff, thresholds), _mm_setzero_si128());
+	return _mm_andnot_si128(same, _mm_set1_epi32(bit));
+}
+
+__attribute__((target("sse2")))
+static void computeHQPatternRowSSE2(byte *patterns, const uint32 *yuv0, const uint32 *yuv1, const uint32 *yuv2, int width) {
+	const __m128i thresholds = _mm_set1_epi32(HQ_THRESHOLDS);
+
+	int x = 0;
+	for (; x + 4 <= width; x += 4) {
+		const __m128i center = _mm_loadu_si128((const __m128i *)(yuv1 + x));
+
+		__m128i pattern = diffBitSSE2(center, yuv0 + x - 1, thresholds, 0x0001);
+		pattern = _mm_or_si128(pattern, diffBitSSE2(center, yuv0 + x    , thresholds, 0x0002));
+		pattern = _mm_or_si128(pattern, diffBitSSE2(center, yuv0 + x + 1, thresholds, 0x0004));
+		pattern = _mm_or_si128(pattern, diffBitSSE2(center, yuv1 + x - 1, thresholds, 0x0008));
+		pattern = _mm_or_si128(pattern, diffBitSSE2(center, yuv1 + x + 1, thresholds, 0x0010));
+		pattern = _mm_or_si128(pattern, diffBitSSE2(center, yuv2 + x - 1, thresholds, 0x0020));
+		pattern = _mm_or_si128(pattern, diffBitSSE2(center, yuv2 + x    , thresholds, 0x0040));
+		pattern = _mm_or_si128(pattern, diffBitSSE2(center, yuv2 + x + 1, thresholds, 0x0080));
+
+		pattern = _mm_packs_epi32(pattern, pattern);
+		pattern = _mm_packus_epi16(pattern, pattern);
+		*(uint32 *)(patterns + x) = _mm_cvtsi128_si32(pattern);
+	}
+
+	computeHQPatternRow(patterns + x, yuv0 + x, yuv1 + x, yuv2 + x, width - x);
+}
+
+/**
+ * Return the bit where the 8 pixels of center and neighbour differ.
+ */
+__attribute__((target("avx2")))
+static inline __m256i diffBitAVX2(__m256i center, const uint32 *neighbour, __m256i thresholds, int bit) {
+	const __m256i n = _mm256_loadu_si256((const __m256i *)neighbour);
+	const __m256i absDiff = _mm256_or_si256(_mm256_subs_epu8(center, n), _mm256_subs_epu8(n, center));
+	const __m256i same = _mm256_cmpeq_epi32(_mm256_subs_epu8(absDiff, thresholds), _mm256_setzero_si256());
+	return _mm256_andnot_si256(same, _mm256_set1_epi32(bit));
+}
+
+__attribute__((target("avx2")))
+static void computeHQPatternRowAVX2(byte *patterns, const uint32 *yuv0, const uint32 *yuv1, const uint32 *yuv2, int width) {
+	const __m256i thresholds = _mm256_set1_epi32(HQ_THRESHOLDS);
+
+	int x = 0;
+	for (; x + 8 <= width; x += 8) {
+		const __m256i center = _mm256_loadu_si256((const __m256i *)(yuv1 + x));
+
+		__m256i pattern = diffBitAVX2(center, yuv0 + x - 1, thresholds, 0x0001);
+		pattern = _mm256_or_si256(pattern, diffBitAVX2(center, yuv0 + x    , thresholds, 0x0002));
+		pattern = _mm256_or_si256(pattern, diffBitAVX2(center, yuv0 + x + 1, thresholds, 0x0004));
+		pattern = _mm256_or_si256(pattern, diffBitAVX2(center, yuv1 + x - 1, thresholds, 0x0008));
+		pattern = _mm256_or_si256(pattern, diffBitAVX2(center, yuv1 + x + 1, thresholds, 0x0010));
+		pattern = _mm256_or_si256(pattern, diffBitAVX2(center, yuv2 + x - 1, thresholds, 0x0020));
+		pattern = _mm256_or_si256(pattern, diffBitAVX2(center, yuv2 + x    , thresholds, 0x0040));
+		pattern = _mm256_or_si256(pattern, diffBitAVX2(center, yuv2 + x + 1, thresholds, 0x0080));
+
+		// The pack instructions work within 128 bit lanes
+		pattern = _mm256_packs_epi32(pattern, pattern);
+		pattern = _mm256_packus_epi16(pattern, pattern);
+		*(uint32 *)(patterns + x) = _mm_cvtsi128_si32(_mm256_castsi256_si128(pattern));
+		*(uint32 *)(patterns + x + 4) = _mm_cvtsi128_si32(_mm256_extracti128_si256(pattern, 1));
+	}
+
+	computeHQPatternRowSSE2(patterns + x, yuv0 + x, yuv1 + x, yuv2 + x, width - x);
+}
+
+#endif // SCUMMVM_SIMD_X86
+
+#undef HQ_THRESHOLDS
+
+HQPatternRowProc getHQPatternRowProc() {
+#ifdef SCUMMVM_SIMD_X86
+	if (Common::hasCPUFeature(Common::kCPUFeatureAVX2))
+		return computeHQPatternRowAVX2;
+	if (Common::hasCPUFeature(Common::kCPUFeatureSSE2))
+		return computeHQPatternRowSSE2;
+#endif
+	return nullptr;
+}
+
+HQPatternRows::HQPatternRows(int width) : _proc(getHQPatternRowProc()), _width(width),
+		_yuvBuffer(nullptr), _patterns(nullptr), _first(true) {
+	_yuv[0] = _yuv[1] = _yuv[2] = nullptr;
+
+	if (!_proc)
+		return;
+
+	// Every row holds the pixels left of the first and right of the last
+	// pixel as well
+	_yuvBuffer = new uint32[3 * (width + 2)];
+	for (int i = 0; i < 3; ++i)
+		_yuv[i] = _yuvBuffer + i * (width + 2) + 1;
+	_patterns = new byte[width];
+}
+
+HQPatternRows::~HQPatternRows() {
+	delete[] _yuvBuffer;
+	delete[] _patterns;
+}
+
+void HQPatternRows::lookUpRow(uint32 *yuv, const uint16 *src) const {
+	for (int x = -1; x <= _width; ++x)
+		yuv[x] = RGBtoYUV[src[x]];
+}
+
+const byte *HQPatternRows::computeRow(const uint16 *src, uint32 nextlineSrc) {
+	if (!_proc)
+		return nullptr;
+
+	if (_first) {
+		lookUpRow(_yuv[1], src - nextlineSrc);
+		lookUpRow(_yuv[2], src);
+		_first = false;
+	}
+
+	// Rotate the rows, the row below becomes the current one
+	uint32 *above = _yuv[0];
+	_yuv[0] = _yuv[1];
+	_yuv[1] = _yuv[2];
+	_yuv[2] = above;
+	lookUpRow(_yuv[2], src + nextlineSrc);
+
+	_proc(_patterns, _yuv[0], _yuv[1], _yuv[2], _width);
+	return _patterns;
+}
@@ -0,0 +1,92 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef GRAPHICS_SCALER_HQ_PATTERNS_H
+#define GRAPHICS_SCALER_HQ_PATTERNS_H
+
+#include "common/scummsys.h"
+
+/**
+ * A pattern row kernel computes the patterns the hq scalers select their
+ * interpolation with, for one row of pixels. Bits 0 to 7 of the pattern of
+ * a pixel w5 are set when its neighbours w1, w2, w3, w4, w6, w7, w8 resp.
+ * w9 differ from it according to diffYUV().
+ *
+ *	 w1 w2 w3
+ *	 w4 w5 w6
+ *	 w7 w8 w9
+ *
+ * @param patterns	the patterns of the pixels
+ * @param yuv0		the YUV values of the row above, see RGBtoYUV
+ * @param yuv1		the YUV values of the row
+ * @param yuv2		the YUV values of the row below
+ * @param width		the number of pixels
+ *
+ * The YUV values of the pixels left of the first and right of the last
+ * pixel must be present as well.
+ */
+typedef void (*HQPatternRowProc)(byte *patterns, const uint32 *yuv0, const uint32 *yuv1, const uint32 *yuv2, int width);
+
+/** Reference implementation of a pattern row kernel. */
+void computeHQPatternRow(byte *patterns, const uint32 *yuv0, const uint32 *yuv1, const uint32 *yuv2, int width);
+
+/**
+ * Return the fastest vectorized pattern row kernel supported by the host
+ * CPU, or nullptr if there is none. The hq scalers compute the patterns
+ * inline faster than the reference kernel, so it is not returned. The
+ * choice is based on Common::getCPUFeatures().
+ */
+HQPatternRowProc getHQPatternRowProc();
+
+/**
+ * Computes the patterns of consecutive rows of a source image with the
+ * vectorized kernel, looking up the YUV value of every pixel only once.
+ */
+class HQPatternRows {
+public:
+	explicit HQPatternRows(int width);
+	~HQPatternRows();
+
+	/**
+	 * Compute the patterns of the next row. The first call computes the
+	 * patterns of the first row of the image, every further call those of
+	 * the row below the previous one.
+	 *
+	 * @param src			the first pixel of the row
+	 * @param nextlineSrc	the pitch of the image, in pixels
+	 * @return the patterns, or nullptr if there is no vectorized kernel and
+	 *         the patterns have to be computed inline
+	 */
+	const byte *computeRow(const uint16 *src, uint32 nextlineSrc);
+
+private:
+	void lookUpRow(uint32 *yuv, const uint16 *src) const;
+
+	const HQPatternRowProc _proc;
+	const int _width;
+	uint32 *_yuvBuffer;
+	uint32 *_yuv[3];
+	byte *_patterns;
+	bool _first;
+};
+
+#endif
@@ -19,7 +19,8 @@
  */
 
 /*
- * This file contains a C and MMX implementation of the Scale2x effect.
+ * This file contains a C, MMX, SSE2 and AVX2 implementation of the Scale2x
+ * effect.
  *
  * You can find an high level description of the effect at :
  *
@@ -36,6 +37,11 @@
 
 #include "graphics/scaler/scale2x.h"
 
+#if defined(SCUMMVM_SIMD_X86)
+#include <emmintrin.h>
+#include <immintrin.h>
+#endif
+
 /***************************************************************************/
 /* Scale2x C implementation */
 
@@ -500,3 +506,102 @@ void scale2x_32_mmx(scale2x_uint32* dst0, scale2x_uint32* dst1, const scale2x_ui
 }
 
 #endif
+
+/***************************************************************************/
+/* Scale2x SSE2 and AVX2 implementation */
+
+#if defined(SCUMMVM_SIMD_X86)
+
+/*
+ * The vectorized versions select the pixels with masks instead of branches.
+ * Considering the pixel map :
+ *
+ *      ABC (src0)
+ *      DEF (src1)
+ *      GHI (src2)
+ *
+ * the left pixel is B if D == B, B != H and D != F, otherwise E, and the
+ * right pixel is B if F == B, B != H and D != F, otherwise E. Like the C
+ * implementation they access the pixels left of the first and right of the
+ * last pixel of src1. The remaining pixels of a row are handled by the C
+ * implementation.
+ */
+
+__attribute__((target("sse2")))
+static inline void scale2x_16_sse2_single(scale2x_uint16* __restrict__ dst, const scale2x_uint16* __restrict__ src0, const scale2x_uint16* __restrict__ src1, const scale2x_uint16* __restrict__ src2, unsigned count) {
+	unsigned x = 0;
+
+	for (; x + 8 <= count; x += 8) {
+		const __m128i b = _mm_loadu_si128((const __m128i *)(src0 + x));
+		const __m128i h = _mm_loadu_si128((const __m128i *)(src2 + x));
+		const __m128i d = _mm_loadu_si128((const __m128i *)(src1 + x - 1));
+		const __m128i e = _mm_loadu_si128((const __m128i *)(src1 + x));
+		const __m128i f = _mm_loadu_si128((const __m128i *)(src1 + x + 1));
+
+		const __m128i inactive = _mm_or_si128(_mm_cmpeq_epi16(b, h), _mm_cmpeq_epi16(d, f));
+		const __m128i useLeft = _mm_andnot_si128(inactive, _mm_cmpeq_epi16(d, b));
+		const __m128i useRight = _mm_andnot_si128(inactive, _mm_cmpeq_epi16(f, b));
+
+		const __m128i left = _mm_or_si128(_mm_and_si128(useLeft, b), _mm_andnot_si128(useLeft, e));
+		const __m128i right = _mm_or_si128(_mm_and_si128(useRight, b), _mm_andnot_si128(useRight, e));
+
+		_mm_storeu_si128((__m128i *)(dst + 2 * x), _mm_unpacklo_epi16(left, right));
+		_mm_storeu_si128((__m128i *)(dst + 2 * x + 8), _mm_unpackhi_epi16(left, right));
+	}
+
+	if (x < count)
+		scale2x_16_def_single(dst + 2 * x, src0 + x, src1 + x, src2 + x, count - x);
+}
+
+__attribute__((target("avx2")))
+static inline void scale2x_16_avx2_single(scale2x_uint16* __restrict__ dst, const scale2x_uint16* __restrict__ src0, const scale2x_uint16* __restrict__ src1, const scale2x_uint16* __restrict__ src2, unsigned count) {
+	unsigned x = 0;
+
+	for (; x + 16 <= count; x += 16) {
+		const __m256i b = _mm256_loadu_si256((const __m256i *)(src0 + x));
+		const __m256i h = _mm256_loadu_si256((const __m256i *)(src2 + x));
+		const __m256i d = _mm256_loadu_si256((const __m256i *)(src1 + x - 1));
+		const __m256i e = _mm256_loadu_si256((const __m256i *)(src1 + x));
+		const __m256i f = _mm256_loadu_si256((const __m256i *)(src1 + x + 1));
+
+		const __m256i inactive = _mm256_or_si256(_mm256_cmpeq_epi16(b, h), _mm256_cmpeq_epi16(d, f));
+		const __m256i useLeft = _mm256_andnot_si256(inactive, _mm256_cmpeq_epi16(d, b));
+		const __m256i useRight = _mm256_andnot_si256(inactive, _mm256_cmpeq_epi16(f, b));
+
+		const __m256i left = _mm256_blendv_epi8(e, b, useLeft);
+		const __m256i right = _mm256_blendv_epi8(e, b, useRight);
+
+		// The unpack instructions work within 128 bit lanes
+		const __m256i lo = _mm256_unpacklo_epi16(left, right);
+		const __m256i hi = _mm256_unpackhi_epi16(left, right);
+		_mm256_storeu_si256((__m256i *)(dst + 2 * x), _mm256_permute2x128_si256(lo, hi, 0x20));
+		_mm256_storeu_si256((__m256i *)(dst + 2 * x + 16), _mm256_permute2x128_si256(lo, hi, 0x31));
+	}
+
+	if (x < count)
+		scale2x_16_sse2_single(dst + 2 * x, src0 + x, src1 + x, src2 + x, count - x);
+}
+
+/**
+ * Scale by a factor of 2 a row of pixels of 16 bits.
+ * This function operates like scale2x_16_def() but uses SSE2 instructions.
+ * It must only be called if the CPU supports SSE2.
+ */
+__attribute__((target("sse2")))
+void scale2x_16_sse2(scale2x_uint16* dst0, scale2x_uint16* dst1, const scale2x_uint16* src0, const scale2x_uint16* src1, const scale2x_uint16* src2, unsigned count) {
+	scale2x_16_sse2_single(dst0, src0, src1, src2, count);
+	scale2x_16_sse2_single(dst1, src2, src1, src0, count);
+}
+
+/**
+ * Scale by a factor of 2 a row of pixels of 16 bits.
+ * This function operates like scale2x_16_def() but uses AVX2 instructions.
+ * It must only be called if the CPU supports AVX2.
+ */
+__attribute__((target("avx2")))
+void scale2x_16_avx2(scale2x_uint16* dst0, scale2x_uint16* dst1, const scale2x_uint16* src0, const scale2x_uint16* src1, const scale2x_uint16* src2, unsigned count) {
+	scale2x_16_avx2_single(dst0, src0, src1, src2, count);
+	scale2x_16_avx2_single(dst1, src2, src1, src0, count);
+}
+
+#endif
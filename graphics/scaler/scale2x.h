@@ -21,6 +21,8 @@
 #ifndef SCALER_SCALE2X_H
 #define SCALER_SCALE2X_H
 
+#include "common/cpudetect.h"
+
 #if defined(_MSC_VER)
 #define __restrict__
 #endif
@@ -57,6 +59,13 @@ static inline void scale2x_mmx_emms(void)
 
 #endif
 
+#if defined(SCUMMVM_SIMD_X86)
+
+void scale2x_16_sse2(scale2x_uint16* dst0, scale2x_uint16* dst1, const scale2x_uint16* src0, const scale2x_uint16* src1, const scale2x_uint16* src2, unsigned count);
+void scale2x_16_avx2(scale2x_uint16* dst0, scale2x_uint16* dst1, const scale2x_uint16* src0, const scale2x_uint16* src1, const scale2x_uint16* src2, unsigned count);
+
+#endif
+
 #if defined(USE_ARM_SCALER_ASM)
 
 extern "C" void scale2x_8_arm(scale2x_uint8* dst0, scale2x_uint8* dst1, const scale2x_uint8* src0, const scale2x_uint8* src1, const scale2x_uint8* src2, unsigned count);
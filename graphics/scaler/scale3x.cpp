@@ -19,7 +19,8 @@
  */
 
 /*
- * This file contains a C and MMX implementation of the Scale2x effect.
+ * This file contains a C, SSE2 and AVX2 implementation of the Scale3x
+ * effect.
  *
  * You can find an high level description of the effect at :
  *
@@ -36,6 +37,11 @@
 
 #include "graphics/scaler/scale3x.h"
 
+#if defined(SCUMMVM_SIMD_X86)
+#include <emmintrin.h>
+#include <immintrin.h>
+#endif
+
 /***************************************************************************/
 /* Scale3x C implementation */
 
@@ -220,3 +226,148 @@ void scale3x_32_def(scale3x_uint32* dst0, scale3x_uint32* dst1, scale3x_uint32*
 	scale3x_32_def_center(dst1, src0, src1, src2, count);
 	scale3x_32_def_border(dst2, src2, src1, src0, count);
 }
+
+/***************************************************************************/
+/* Scale3x SSE2 and AVX2 implementation */
+
+#if defined(SCUMMVM_SIMD_X86)
+
+/*
+ * The vectorized versions compute the three destination rows of a group of
+ * pixels at once and select the pixels with masks instead of branches. The
+ * results are interleaved through a small buffer, as there is no cheap way
+ * to interleave three vectors with SSE2. Like the C implementation they
+ * access the pixels left of the first and right of the last pixel of the
+ * source rows. The remaining pixels of a row are handled by the C
+ * implementation.
+ */
+
+/**
+ * Return the pixels of b where mask is set and those of a elsewhere.
+ */
+__attribute__((target("sse2")))
+static inline __m128i selectSSE2(__m128i a, __m128i b, __m128i mask) {
+	return _mm_or_si128(_mm_and_si128(mask, b), _mm_andnot_si128(mask, a));
+}
+
+__attribute__((target("sse2")))
+static inline void scale3x_16_sse2_rows(scale3x_uint16* __restrict__ dst0, scale3x_uint16* __restrict__ dst1, scale3x_uint16* __restrict__ dst2, const scale3x_uint16* __restrict__ src0, const scale3x_uint16* __restrict__ src1, const scale3x_uint16* __restrict__ src2, unsigned count) {
+	scale3x_uint16 row[9][8];
+	unsigned x = 0;
+
+	for (; x + 8 <= count; x += 8) {
+		const __m128i a = _mm_loadu_si128((const __m128i *)(src0 + x - 1));
+		const __m128i b = _mm_loadu_si128((const __m128i *)(src0 + x));
+		const __m128i c = _mm_loadu_si128((const __m128i *)(src0 + x + 1));
+		const __m128i d = _mm_loadu_si128((const __m128i *)(src1 + x - 1));
+		const __m128i e = _mm_loadu_si128((const __m128i *)(src1 + x));
+		const __m128i f = _mm_loadu_si128((const __m128i *)(src1 + x + 1));
+		const __m128i g = _mm_loadu_si128((const __m128i *)(src2 + x - 1));
+		const __m128i h = _mm_loadu_si128((const __m128i *)(src2 + x));
+		const __m128i i = _mm_loadu_si128((const __m128i *)(src2 + x + 1));
+
+		const __m128i inactive = _mm_or_si128(_mm_cmpeq_epi16(b, h), _mm_cmpeq_epi16(d, f));
+		const __m128i db = _mm_andnot_si128(inactive, _mm_cmpeq_epi16(d, b));
+		const __m128i fb = _mm_andnot_si128(inactive, _mm_cmpeq_epi16(f, b));
+		const __m128i dh = _mm_andnot_si128(inactive, _mm_cmpeq_epi16(d, h));
+		const __m128i fh = _mm_andnot_si128(inactive, _mm_cmpeq_epi16(f, h));
+		const __m128i ea = _mm_cmpeq_epi16(e, a);
+		const __m128i ec = _mm_cmpeq_epi16(e, c);
+		const __m128i eg = _mm_cmpeq_epi16(e, g);
+		const __m128i ei = _mm_cmpeq_epi16(e, i);
+
+		_mm_storeu_si128((__m128i *)row[0], selectSSE2(e, d, db));
+		_mm_storeu_si128((__m128i *)row[1], selectSSE2(e, b, _mm_or_si128(_mm_andnot_si128(ec, db), _mm_andnot_si128(ea, fb))));
+		_mm_storeu_si128((__m128i *)row[2], selectSSE2(e, f, fb));
+		_mm_storeu_si128((__m128i *)row[3], selectSSE2(e, d, _mm_or_si128(_mm_andnot_si128(eg, db), _mm_andnot_si128(ea, dh))));
+		_mm_storeu_si128((__m128i *)row[4], e);
+		_mm_storeu_si128((__m128i *)row[5], selectSSE2(e, f, _mm_or_si128(_mm_andnot_si128(ei, fb), _mm_andnot_si128(ec, fh))));
+		_mm_storeu_si128((__m128i *)row[6], selectSSE2(e, d, dh));
+		_mm_storeu_si128((__m128i *)row[7], selectSSE2(e, h, _mm_or_si128(_mm_andnot_si128(ei, dh), _mm_andnot_si128(eg, fh))));
+		_mm_storeu_si128((__m128i *)row[8], selectSSE2(e, f, fh));
+
+		for (unsigned j = 0; j < 8; ++j) {
+			scale3x_uint16 *out0 = dst0 + 3 * (x + j);
+			scale3x_uint16 *out1 = dst1 + 3 * (x + j);
+			scale3x_uint16 *out2 = dst2 + 3 * (x + j);
+			out0[0] = row[0][j]; out0[1] = row[1][j]; out0[2] = row[2][j];
+			out1[0] = row[3][j]; out1[1] = row[4][j]; out1[2] = row[5][j];
+			out2[0] = row[6][j]; out2[1] = row[7][j]; out2[2] = row[8][j];
+		}
+	}
+
+	if (x < count)
+		scale3x_16_def(dst0 + 3 * x, dst1 + 3 * x, dst2 + 3 * x, src0 + x, src1 + x, src2 + x, count - x);
+}
+
+__attribute__((target("avx2")))
+static inline void scale3x_16_avx2_rows(scale3x_uint16* __restrict__ dst0, scale3x_uint16* __restrict__ dst1, scale3x_uint16* __restrict__ dst2, const scale3x_uint16* __restrict__ src0, const scale3x_uint16* __restrict__ src1, const scale3x_uint16* __restrict__ src2, unsigned count) {
+	scale3x_uint16 row[9][16];
+	unsigned x = 0;
+
+	for (; x + 16 <= count; x += 16) {
+		const __m256i a = _mm256_loadu_si256((const __m256i *)(src0 + x - 1));
+		const __m256i b = _mm256_loadu_si256((const __m256i *)(src0 + x));
+		const __m256i c = _mm256_loadu_si256((const __m256i *)(src0 + x + 1));
+		const __m256i d = _mm256_loadu_si256((const __m256i *)(src1 + x - 1));
+		const __m256i e = _mm256_loadu_si256((const __m256i *)(src1 + x));
+		const __m256i f = _mm256_loadu_si256((const __m256i *)(src1 + x + 1));
+		const __m256i g = _mm256_loadu_si256((const __m256i *)(src2 + x - 1));
+		const __m256i h = _mm256_loadu_si256((const __m256i *)(src2 + x));
+		const __m256i i = _mm256_loadu_si256((const __m256i *)(src2 + x + 1));
+
+		const __m256i inactive = _mm256_or_si256(_mm256_cmpeq_epi16(b, h), _mm256_cmpeq_epi16(d, f));
+		const __m256i db = _mm256_andnot_si256(inactive, _mm256_cmpeq_epi16(d, b));
+		const __m256i fb = _mm256_andnot_si256(inactive, _mm256_cmpeq_epi16(f, b));
+		const __m256i dh = _mm256_andnot_si256(inactive, _mm256_cmpeq_epi16(d, h));
+		const __m256i fh = _mm256_andnot_si256(inactive, _mm256_cmpeq_epi16(f, h));
+		const __m256i ea = _mm256_cmpeq_epi16(e, a);
+		const __m256i ec = _mm256_cmpeq_epi16(e, c);
+		const __m256i eg = _mm256_cmpeq_epi16(e, g);
+		const __m256i ei = _mm256_cmpeq_epi16(e, i);
+
+		_mm256_storeu_si256((__m256i *)row[0], _mm256_blendv_epi8(e, d, db));
+		_mm256_storeu_si256((__m256i *)row[1], _mm256_blendv_epi8(e, b, _mm256_or_si256(_mm256_andnot_si256(ec, db), _mm256_andnot_si256(ea, fb))));
+		_mm256_storeu_si256((__m256i *)row[2], _mm256_blendv_epi8(e, f, fb));
+		_mm256_storeu_si256((__m256i *)row[3], _mm256_blendv_epi8(e, d, _mm256_or_si256(_mm256_andnot_si256(eg, db), _mm256_andnot_si256(ea, dh))));
+		_mm256_storeu_si256((__m256i *)row[4], e);
+		_mm256_storeu_si256((__m256i *)row[5], _mm256_blendv_epi8(e, f, _mm256_or_si256(_mm256_andnot_si256(ei, fb), _mm256_andnot_si256(ec, fh))));
+		_mm256_storeu_si256((__m256i *)row[6], _mm256_blendv_epi8(e, d, dh));
+		_mm256_storeu_si256((__m256i *)row[7], _mm256_blendv_epi8(e, h, _mm256_or_si256(_mm256_andnot_si256(ei, dh), _mm256_andnot_si256(eg, fh))));
+		_mm256_storeu_si256((__m256i *)row[8], _mm256_blendv_epi8(e, f, fh));
+
+		for (unsigned j = 0; j < 16; ++j) {
+			scale3x_uint16 *out0 = dst0 + 3 * (x + j);
+			scale3x_uint16 *out1 = dst1 + 3 * (x + j);
+			scale3x_uint16 *out2 = dst2 + 3 * (x + j);
+			out0[0] = row[0][j]; out0[1] = row[1][j]; out0[2] = row[2][j];
+			out1[0] = row[3][j]; out1[1] = row[4][j]; out1[2] = row[5][j];
+			out2[0] = row[6][j]; out2[1] = row[7][j]; out2[2] = row[8][j];
+		}
+	}
+
+	if (x < count)
+		scale3x_16_sse2_rows(dst0 + 3 * x, dst1 + 3 * x, dst2 + 3 * x, src0 + x, src1 + x, src2 + x, count - x);
+}
+
+/**
+ * Scale by a factor of 3 a row of pixels of 16 bits.
+ * This function operates like scale3x_16_def() but uses SSE2 instructions.
+ * It must only be called if the CPU supports SSE2.
+ */
+__attribute__((target("sse2")))
+void scale3x_16_sse2(scale3x_uint16* dst0, scale3x_uint16* dst1, scale3x_uint16* dst2, const scale3x_uint16* src0, const scale3x_uint16* src1, const scale3x_uint16* src2, unsigned count) {
+	scale3x_16_sse2_rows(dst0, dst1, dst2, src0, src1, src2, count);
+}
+
+/**
+ * Scale by a factor of 3 a row of pixels of 16 bits.
+ * This function operates like scale3x_16_def() but uses AVX2 instructions.
+ * It must only be called if the CPU supports AVX2.
+ */
+__attribute__((target("avx2")))
+void scale3x_16_avx2(scale3x_uint16* dst0, scale3x_uint16* dst1, scale3x_uint16* dst2, const scale3x_uint16* src0, const scale3x_uint16* src1, const scale3x_uint16* src2, unsigned count) {
+	scale3x_16_avx2_rows(dst0, dst1, dst2, src0, src1, src2, count);
+}
+
+#endif
@@ -45,6 +45,16 @@
  * Apply the Scale2x effect on a group of rows. Used internally.
  */
 static inline void stage_scale2x(void* dst0, void* dst1, const void* src0, const void* src1, const void* src2, unsigned pixel, unsigned pixel_per_row) {
+#if defined(SCUMMVM_SIMD_X86)
+	if (pixel == 2 && Common::hasCPUFeature(Common::kCPUFeatureAVX2)) {
+		scale2x_16_avx2(DST(16,0), DST(16,1), SRC(16,0), SRC(16,1), SRC(16,2), pixel_per_row);
+		return;
+	} else if (pixel == 2 && Common::hasCPUFeature(Common::kCPUFeatureSSE2)) {
+		scale2x_16_sse2(DST(16,0), DST(16,1), SRC(16,0), SRC(16,1), SRC(16,2), pixel_per_row);
+		return;
+	}
+#endif
+
 	switch (pixel) {
 #if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
 	case 1 : scale2x_8_mmx(DST(8,0), DST(8,1), SRC(8,0), SRC(8,1), SRC(8,2), pixel_per_row); break;
@@ -66,6 +76,16 @@ static inline void stage_scale2x(void* dst0, void* dst1, const void* src0, const
  * Apply the Scale3x effect on a group of rows. Used internally.
  */
 static inline void stage_scale3x(void* dst0, void* dst1, void* dst2, const void* src0, const void* src1, const void* src2, unsigned pixel, unsigned pixel_per_row) {
+#if defined(SCUMMVM_SIMD_X86)
+	if (pixel == 2 && Common::hasCPUFeature(Common::kCPUFeatureAVX2)) {
+		scale3x_16_avx2(DST(16,0), DST(16,1), DST(16,2), SRC(16,0), SRC(16,1), SRC(16,2), pixel_per_row);
+		return;
+	} else if (pixel == 2 && Common::hasCPUFeature(Common::kCPUFeatureSSE2)) {
+		scale3x_16_sse2(DST(16,0), DST(16,1), DST(16,2), SRC(16,0), SRC(16,1), SRC(16,2), pixel_per_row);
+		return;
+	}
+#endif
+
 	switch (pixel) {
 	case 1 : scale3x_8_def(DST(8,0), DST(8,1), DST(8,2), SRC(8,0), SRC(8,1), SRC(8,2), pixel_per_row); break;
 	case 2 : scale3x_16_def(DST(16,0), DST(16,1), DST(16,2), SRC(16,0), SRC(16,1), SRC(16,2), pixel_per_row); break;
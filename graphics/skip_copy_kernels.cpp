@@ -0,0 +1,115 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "graphics/skip_copy_kernels.h"
+#include "common/cpudetect.h"
+
+#ifdef SCUMMVM_SIMD_X86
+#include <emmintrin.h>
+#include <immintrin.h>
+#endif
+
+#ifdef SCUMMVM_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+namespace Graphics {
+
+void skipCopyRow(byte *target, const byte *source, int width, const byte skipColor) {
+	for (; width > 0; --width) {
+		const byte pixel = *source++;
+		if (pixel != skipColor) {
+			*target = pixel;
+		}
+		++target;
+	}
+}
+
+#ifdef SCUMMVM_SIMD_X86
+
+__attribute__((target("sse2")))
+static void skipCopySSE2(byte *target, const byte *source, int width, const byte skipColor) {
+	const __m128i skip = _mm_set1_epi8((char)skipColor);
+
+	for (; width >= 16; width -= 16) {
+		const __m128i pixels = _mm_loadu_si128((const __m128i *)source);
+		const __m128i mask = _mm_cmpeq_epi8(pixels, skip);
+		const __m128i old = _mm_loadu_si128((const __m128i *)target);
+		_mm_storeu_si128((__m128i *)target, _mm_or_si128(_mm_and_si128(mask, old), _mm_andnot_si128(mask, pixels)));
+		source += 16;
+		target += 16;
+	}
+
+	skipCopyRow(target, source, width, skipColor);
+}
+
+__attribute__((target("avx2")))
+static void skipCopyAVX2(byte *target, const byte *source, int width, const byte skipColor) {
+	const __m256i skip = _mm256_set1_epi8((char)skipColor);
+
+	for (; width >= 32; width -= 32) {
+		const __m256i pixels = _mm256_loadu_si256((const __m256i *)source);
+		const __m256i mask = _mm256_cmpeq_epi8(pixels, skip);
+		const __m256i old = _mm256_loadu_si256((const __m256i *)target);
+		_mm256_storeu_si256((__m256i *)target, _mm256_blendv_epi8(pixels, old, mask));
+		source += 32;
+		target += 32;
+	}
+
+	skipCopySSE2(target, source, width, skipColor);
+}
+
+#endif // SCUMMVM_SIMD_X86
+
+#ifdef SCUMMVM_SIMD_NEON
+
+static void skipCopyNEON(byte *target, const byte *source, int width, const byte skipColor) {
+	const uint8x16_t skip = vdupq_n_u8(skipColor);
+
+	for (; width >= 16; width -= 16) {
+		const uint8x16_t pixels = vld1q_u8(source);
+		const uint8x16_t mask = vceqq_u8(pixels, skip);
+		vst1q_u8(target, vbslq_u8(mask, vld1q_u8(target), pixels));
+		source += 16;
+		target += 16;
+	}
+
+	skipCopyRow(target, source, width, skipColor);
+}
+
+#endif // SCUMMVM_SIMD_NEON
+
+SkipCopyProc getSkipCopyProc() {
+#ifdef SCUMMVM_SIMD_X86
+	if (Common::hasCPUFeature(Common::kCPUFeatureAVX2))
+		return skipCopyAVX2;
+	if (Common::hasCPUFeature(Common::kCPUFeatureSSE2))
+		return skipCopySSE2;
+#endif
+#ifdef SCUMMVM_SIMD_NEON
+	if (Common::hasCPUFeature(Common::kCPUFeatureNEON))
+		return skipCopyNEON;
+#endif
+	return skipCopyRow;
+}
+
+} // End of namespace Graphics
@@ -0,0 +1,53 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef GRAPHICS_SKIP_COPY_KERNELS_H
+#define GRAPHICS_SKIP_COPY_KERNELS_H
+
+#include "common/scummsys.h"
+
+namespace Graphics {
+
+/**
+ * A skip copy kernel copies a row of 8 bit pixels, leaving the target
+ * untouched where the source pixel is the skip color.
+ *
+ * @param target	the first target pixel
+ * @param source	the first source pixel
+ * @param width		the number of pixels
+ * @param skipColor	the transparent color of the source
+ */
+typedef void (*SkipCopyProc)(byte *target, const byte *source, int width, byte skipColor);
+
+/** Reference implementation of a skip copy kernel. */
+void skipCopyRow(byte *target, const byte *source, int width, byte skipColor);
+
+/**
+ * Return the fastest skip copy kernel supported by the host CPU. This is
+ * the reference kernel if there is no vectorized one. The choice is based
+ * on Common::getCPUFeatures().
+ */
+SkipCopyProc getSkipCopyProc();
+
+} // End of namespace Graphics
+
+#endif
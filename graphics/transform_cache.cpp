@@ -0,0 +1,182 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "graphics/transform_cache.h"
+
+namespace Graphics {
+
+bool TransformCache::Key::operator==(const Key &other) const {
+	// TransformStruct::operator== ignores the hotspot, which matters for
+	// rotoscaling.
+	return pixels == other.pixels &&
+		generation == other.generation &&
+		transform == other.transform &&
+		transform._hotspot == other.transform._hotspot &&
+		width == other.width &&
+		height == other.height &&
+		filteringMode == other.filteringMode;
+}
+
+uint TransformCache::KeyHash::operator()(const Key &key) const {
+	uint hash = (uint)(size_t)key.pixels;
+	hash = hash * 31 + key.generation;
+	hash = hash * 31 + key.transform._angle;
+	hash = hash * 31 + ((key.transform._zoom.x << 16) ^ key.transform._zoom.y);
+	hash = hash * 31 + ((key.transform._hotspot.x << 16) ^ key.transform._hotspot.y);
+	hash = hash * 31 + key.transform._rgbaMod;
+	hash = hash * 31 + ((key.width << 16) | key.height);
+	hash = hash * 31 + key.filteringMode;
+	return hash;
+}
+
+TransformCache::TransformCache(uint32 maxBytes) : _maxBytes(maxBytes), _bytes(0), _hits(0), _misses(0), _evictions(0) {
+}
+
+TransformCache::~TransformCache() {
+	clear();
+}
+
+const TransparentSurface *TransformCache::rotoscale(const TransparentSurface &src, uint32 generation, const TransformStruct &transform, TFilteringMode filteringMode) {
+	// There is no area filter for rotoscaling, so the other modes give the
+	// same result and share one entry
+	if (filteringMode != FILTER_NEAREST)
+		filteringMode = FILTER_BILINEAR;
+
+	Key key;
+	key.pixels = src.getPixels();
+	key.generation = generation;
+	key.transform = transform;
+	key.width = 0;
+	key.height = 0;
+	key.filteringMode = filteringMode;
+
+	const TransparentSurface *result = lookup(key);
+	if (result)
+		return result;
+
+	if (filteringMode == FILTER_NEAREST)
+		return insert(key, src.rotoscaleT<FILTER_NEAREST>(transform));
+	return insert(key, src.rotoscaleT<FILTER_BILINEAR>(transform));
+}
+
+const TransparentSurface *TransformCache::scale(const TransparentSurface &src, uint32 generation, uint16 newWidth, uint16 newHeight, TFilteringMode filteringMode) {
+	Key key;
+	key.pixels = src.getPixels();
+	key.generation = generation;
+	key.width = newWidth;
+	key.height = newHeight;
+	key.filteringMode = filteringMode;
+
+	const TransparentSurface *result = lookup(key);
+	if (result)
+		return result;
+
+	switch (filteringMode) {
+	case FILTER_BILINEAR:
+		return insert(key, src.scaleT<FILTER_BILINEAR>(newWidth, newHeight));
+	case FILTER_AREA:
+		return insert(key, src.scaleT<FILTER_AREA>(newWidth, newHeight));
+	default:
+		return insert(key, src.scaleT<FILTER_NEAREST>(newWidth, newHeight));
+	}
+}
+
+void TransformCache::invalidate(const Surface &src) {
+	const void *pixels = src.getPixels();
+
+	LRUList::iterator i = _lru.begin();
+	while (i != _lru.end()) {
+		Entry *entry = *i;
+		++i;
+		if (entry->key.pixels == pixels)
+			removeEntry(entry);
+	}
+}
+
+void TransformCache::clear() {
+	while (!_lru.empty())
+		removeEntry(_lru.front());
+}
+
+void TransformCache::setMaxBytes(uint32 maxBytes) {
+	_maxBytes = maxBytes;
+	shrink(maxBytes);
+}
+
+void TransformCache::resetStats() {
+	_hits = 0;
+	_misses = 0;
+	_evictions = 0;
+}
+
+const TransparentSurface *TransformCache::lookup(const Key &key) {
+	EntryMap::iterator i = _entries.find(key);
+	if (i == _entries.end()) {
+		++_misses;
+		return nullptr;
+	}
+
+	++_hits;
+	Entry *entry = i->_value;
+	if (entry->lruPosition != _lru.begin()) {
+		_lru.erase(entry->lruPosition);
+		_lru.push_front(entry);
+		entry->lruPosition = _lru.begin();
+	}
+	return entry->surface;
+}
+
+const TransparentSurface *TransformCache::insert(const Key &key, TransparentSurface *surface) {
+	const uint32 size = surface->pitch * surface->h;
+
+	// Make room for the new result. It is kept even if it exceeds the
+	// ceiling on its own, since the caller needs it.
+	shrink(_maxBytes > size ? _maxBytes - size : 0);
+
+	Entry *entry = new Entry();
+	entry->key = key;
+	entry->surface = surface;
+	_lru.push_front(entry);
+	entry->lruPosition = _lru.begin();
+	_entries[key] = entry;
+	_bytes += size;
+
+	return surface;
+}
+
+void TransformCache::removeEntry(Entry *entry) {
+	_bytes -= entry->surface->pitch * entry->surface->h;
+	_entries.erase(entry->key);
+	_lru.erase(entry->lruPosition);
+	entry->surface->free();
+	delete entry->surface;
+	delete entry;
+}
+
+void TransformCache::shrink(uint32 maxBytes) {
+	while (_bytes > maxBytes && !_lru.empty()) {
+		removeEntry(_lru.back());
+		++_evictions;
+	}
+}
+
+} // End of namespace Graphics
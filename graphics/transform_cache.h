@@ -0,0 +1,150 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef GRAPHICS_TRANSFORM_CACHE_H
+#define GRAPHICS_TRANSFORM_CACHE_H
+
+#include "common/hashmap.h"
+#include "common/list.h"
+#include "common/noncopyable.h"
+
+#include "graphics/transform_struct.h"
+#include "graphics/transparent_surface.h"
+
+namespace Graphics {
+
+/**
+ * A bounded cache of scaled and rotoscaled surfaces, for engines which
+ * render the same transformed sprite in consecutive frames.
+ *
+ * Results are keyed by the identity of the source surface, a generation
+ * number supplied by the caller, the transform and the filtering mode. The
+ * source is identified by its pixel buffer, so whenever the pixels of a
+ * source change, or its buffer may be reused for another image, the caller
+ * must bump the generation or call invalidate().
+ *
+ * The least recently used results are dropped once the cached pixels
+ * exceed the memory ceiling. Using the cache is opt-in: engines which want
+ * it create their own instance.
+ */
+class TransformCache : Common::NonCopyable {
+public:
+	/**
+	 * Create a cache holding at most maxBytes bytes of pixels.
+	 */
+	explicit TransformCache(uint32 maxBytes = 8 * 1024 * 1024);
+	~TransformCache();
+
+	/**
+	 * Return the source rotated and scaled according to the transform, as
+	 * TransparentSurface::rotoscaleT() would. As with rotoscaleT(), the
+	 * angle of the transform must not be 0. FILTER_AREA rotoscales with
+	 * the bilinear filter, and is cached as FILTER_BILINEAR.
+	 *
+	 * The result is owned by the cache. It stays valid until the next call
+	 * to scale(), rotoscale(), invalidate(), clear() or setMaxBytes().
+	 */
+	const TransparentSurface *rotoscale(const TransparentSurface &src, uint32 generation, const TransformStruct &transform, TFilteringMode filteringMode = FILTER_BILINEAR);
+
+	/**
+	 * Return the source scaled to the given size, as
+	 * TransparentSurface::scaleT() would.
+	 *
+	 * The result is owned by the cache, see rotoscale().
+	 */
+	const TransparentSurface *scale(const TransparentSurface &src, uint32 generation, uint16 newWidth, uint16 newHeight, TFilteringMode filteringMode = FILTER_NEAREST);
+
+	/**
+	 * Drop all results computed from the given source.
+	 */
+	void invalidate(const Surface &src);
+
+	/**
+	 * Drop all results.
+	 */
+	void clear();
+
+	/**
+	 * Change the memory ceiling, dropping results if needed.
+	 */
+	void setMaxBytes(uint32 maxBytes);
+	uint32 getMaxBytes() const { return _maxBytes; }
+
+	/** Return the number of bytes of pixels currently cached. */
+	uint32 getBytes() const { return _bytes; }
+	/** Return the number of results currently cached. */
+	uint getEntryCount() const { return _entries.size(); }
+
+	/** Return the number of requests served from the cache. */
+	uint32 getHits() const { return _hits; }
+	/** Return the number of requests which had to compute the result. */
+	uint32 getMisses() const { return _misses; }
+	/** Return the number of results dropped to honour the memory ceiling. */
+	uint32 getEvictions() const { return _evictions; }
+	void resetStats();
+
+private:
+	struct Key {
+		const void *pixels;
+		uint32 generation;
+		TransformStruct transform;
+		uint16 width;
+		uint16 height;
+		TFilteringMode filteringMode;
+
+		bool operator==(const Key &other) const;
+	};
+
+	struct KeyHash {
+		uint operator()(const Key &key) const;
+	};
+
+	struct Entry;
+	typedef Common::List<Entry *> LRUList;
+	typedef Common::HashMap<Key, Entry *, KeyHash> EntryMap;
+
+	struct Entry {
+		Key key;
+		TransparentSurface *surface;
+		LRUList::iterator lruPosition;
+	};
+
+	const TransparentSurface *lookup(const Key &key);
+	const TransparentSurface *insert(const Key &key, TransparentSurface *surface);
+	void removeEntry(Entry *entry);
+	void shrink(uint32 maxBytes);
+
+	EntryMap _entries;
+	/** Most recently used entries first */
+	LRUList _lru;
+
+	uint32 _maxBytes;
+	uint32 _bytes;
+
+	uint32 _hits;
+	uint32 _misses;
+	uint32 _evictions;
+};
+
+} // End of namespace Graphics
+
+#endif
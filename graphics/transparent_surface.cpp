@@ -33,8 +33,10 @@
 #include "common/rect.h"
 #include "common/math.h"
 #include "common/textconsole.h"
+#include "common/workerpool.h"
 #include "graphics/primitives.h"
 #include "graphics/transparent_surface.h"
+#include "graphics/transparent_surface_kernels.h"
 #include "graphics/transform_tools.h"
 
 namespace Graphics {
@@ -59,9 +61,6 @@ static const int kRIndex = 0;
 
 void doBlitOpaqueFast(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep);
 void doBlitBinaryFast(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep);
-void doBlitAlphaBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color);
-void doBlitAdditiveBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color);
-void doBlitSubtractiveBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color);
 
 TransparentSurface::TransparentSurface() : Surface(), _alphaMode(ALPHA_FULL) {}
 
@@ -300,19 +299,19 @@ void doBlitSubtractiveBlend(byte *ino, byte *outo, uint32 width, uint32 height,
 
 				out[kAIndex] = 255;
 				if (cb != 255) {
-					out[kBIndex] = MAX(out[kBIndex] - ((in[kBIndex] * cb  * (out[kBIndex]) * in[kAIndex]) >> 24), 0);
+					out[kBIndex] = MAX<int>(out[kBIndex] - (int)(((uint32)in[kBIndex] * cb * out[kBIndex] * in[kAIndex]) >> 24), 0);
 				} else {
 					out[kBIndex] = MAX(out[kBIndex] - (in[kBIndex] * (out[kBIndex]) * in[kAIndex] >> 16), 0);
 				}
 
 				if (cg != 255) {
-					out[kGIndex] = MAX(out[kGIndex] - ((in[kGIndex] * cg  * (out[kGIndex]) * in[kAIndex]) >> 24), 0);
+					out[kGIndex] = MAX<int>(out[kGIndex] - (int)(((uint32)in[kGIndex] * cg * out[kGIndex] * in[kAIndex]) >> 24), 0);
 				} else {
 					out[kGIndex] = MAX(out[kGIndex] - (in[kGIndex] * (out[kGIndex]) * in[kAIndex] >> 16), 0);
 				}
 
 				if (cr != 255) {
-					out[kRIndex] = MAX(out[kRIndex] - ((in[kRIndex] * cr * (out[kRIndex]) * in[kAIndex]) >> 24), 0);
+					out[kRIndex] = MAX<int>(out[kRIndex] - (int)(((uint32)in[kRIndex] * cr * out[kRIndex] * in[kAIndex]) >> 24), 0);
 				} else {
 					out[kRIndex] = MAX(out[kRIndex] - (in[kRIndex] * (out[kRIndex]) * in[kAIndex] >> 16), 0);
 				}
@@ -437,12 +436,12 @@ Common::Rect TransparentSurface::blit(Graphics::Surface &target, int posX, int p
 			doBlitBinaryFast(ino, outo, img->w, img->h, target.pitch, inStep, inoStep);
 		} else {
 			if (blendMode == BLEND_ADDITIVE) {
-				doBlitAdditiveBlend(ino, outo, img->w, img->h, target.pitch, inStep, inoStep, color);
+				getAdditiveBlendProc()(ino, outo, img->w, img->h, target.pitch, inStep, inoStep, color);
 			} else if (blendMode == BLEND_SUBTRACTIVE) {
-				doBlitSubtractiveBlend(ino, outo, img->w, img->h, target.pitch, inStep, inoStep, color);
+				getSubtractiveBlendProc()(ino, outo, img->w, img->h, target.pitch, inStep, inoStep, color);
 			} else {
 				assert(blendMode == BLEND_NORMAL);
-				doBlitAlphaBlend(ino, outo, img->w, img->h, target.pitch, inStep, inoStep, color);
+				getAlphaBlendProc()(ino, outo, img->w, img->h, target.pitch, inStep, inoStep, color);
 			}
 		}
 
@@ -570,12 +569,12 @@ Common::Rect TransparentSurface::blitClip(Graphics::Surface &target, Common::Rec
 			doBlitBinaryFast(ino, outo, img->w, img->h, target.pitch, inStep, inoStep);
 		} else {
 			if (blendMode == BLEND_ADDITIVE) {
-				doBlitAdditiveBlend(ino, outo, img->w, img->h, target.pitch, inStep, inoStep, color);
+				getAdditiveBlendProc()(ino, outo, img->w, img->h, target.pitch, inStep, inoStep, color);
 			} else if (blendMode == BLEND_SUBTRACTIVE) {
-				doBlitSubtractiveBlend(ino, outo, img->w, img->h, target.pitch, inStep, inoStep, color);
+				getSubtractiveBlendProc()(ino, outo, img->w, img->h, target.pitch, inStep, inoStep, color);
 			} else {
 				assert(blendMode == BLEND_NORMAL);
-				doBlitAlphaBlend(ino, outo, img->w, img->h, target.pitch, inStep, inoStep, color);
+				getAlphaBlendProc()(ino, outo, img->w, img->h, target.pitch, inStep, inoStep, color);
 			}
 		}
 
@@ -676,303 +675,334 @@ systems.
 
 struct tColorRGBA { byte r; byte g; byte b; byte a; };
 
-template <TFilteringMode filteringMode>
-TransparentSurface *TransparentSurface::rotoscaleT(const TransformStruct &transform) const {
-
-	assert(transform._angle != 0); // This would not be ideal; rotoscale() should never be called in conditional branches where angle = 0 anyway.
-
-	Common::Point newHotspot;
-	Common::Rect srcRect(0, 0, (int16)w, (int16)h);
-	Common::Rect rect = TransformTools::newRect(Common::Rect(srcRect), transform, &newHotspot);
-	Common::Rect dstRect(0, 0, (int16)(rect.right - rect.left), (int16)(rect.bottom - rect.top));
-
-	TransparentSurface *target = new TransparentSurface();
-	assert(format.bytesPerPixel == 4);
+namespace {
 
-	int srcW = w;
-	int srcH = h;
-	int dstW = dstRect.width();
-	int dstH = dstRect.height();
-
-	target->create((uint16)dstW, (uint16)dstH, this->format);
+/**
+ * Rows smaller than this number of pixels are not worth splitting across
+ * the worker threads.
+ */
+const int kMinBandPixels = 16384;
+
+inline void interpolateBilinear(tColorRGBA *dp, const tColorRGBA &c00, const tColorRGBA &c01, const tColorRGBA &c10, const tColorRGBA &c11, int ex, int ey) {
+	int t1, t2;
+	t1 = ((((c01.r - c00.r) * ex) >> 16) + c00.r) & 0xff;
+	t2 = ((((c11.r - c10.r) * ex) >> 16) + c10.r) & 0xff;
+	dp->r = (((t2 - t1) * ey) >> 16) + t1;
+	t1 = ((((c01.g - c00.g) * ex) >> 16) + c00.g) & 0xff;
+	t2 = ((((c11.g - c10.g) * ex) >> 16) + c10.g) & 0xff;
+	dp->g = (((t2 - t1) * ey) >> 16) + t1;
+	t1 = ((((c01.b - c00.b) * ex) >> 16) + c00.b) & 0xff;
+	t2 = ((((c11.b - c10.b) * ex) >> 16) + c10.b) & 0xff;
+	dp->b = (((t2 - t1) * ey) >> 16) + t1;
+	t1 = ((((c01.a - c00.a) * ex) >> 16) + c00.a) & 0xff;
+	t2 = ((((c11.a - c10.a) * ex) >> 16) + c10.a) & 0xff;
+	dp->a = (((t2 - t1) * ey) >> 16) + t1;
+}
 
-	if (transform._zoom.x == 0 || transform._zoom.y == 0) {
-		return target;
+template <TFilteringMode filteringMode>
+class RotoscaleJob : public Common::BandedJob {
+public:
+	RotoscaleJob(const Surface &src, Surface &dst, const TransformStruct &transform, const Common::Point &newHotspot) : _src(src), _dst(dst) {
+		uint32 invAngle = 360 - (transform._angle % 360);
+		float invCos = cos(invAngle * M_PI / 180.0);
+		float invSin = sin(invAngle * M_PI / 180.0);
+
+		_icosx = (int)(invCos * (65536.0f * kDefaultZoomX / transform._zoom.x));
+		_isinx = (int)(invSin * (65536.0f * kDefaultZoomX / transform._zoom.x));
+		_icosy = (int)(invCos * (65536.0f * kDefaultZoomY / transform._zoom.y));
+		_isiny = (int)(invSin * (65536.0f * kDefaultZoomY / transform._zoom.y));
+
+		_xd = transform._hotspot.x << 16;
+		_yd = transform._hotspot.y << 16;
+		_cx = newHotspot.x;
+		_cy = newHotspot.y;
 	}
 
-	uint32 invAngle = 360 - (transform._angle % 360);
-	float invCos = cos(invAngle * M_PI / 180.0);
-	float invSin = sin(invAngle * M_PI / 180.0);
-
-	int icosx = (int)(invCos * (65536.0f * kDefaultZoomX / transform._zoom.x));
-	int isinx = (int)(invSin * (65536.0f * kDefaultZoomX / transform._zoom.x));
-	int icosy = (int)(invCos * (65536.0f * kDefaultZoomY / transform._zoom.y));
-	int isiny = (int)(invSin * (65536.0f * kDefaultZoomY / transform._zoom.y));
-
-
-	bool flipx = false, flipy = false; // TODO: See mirroring comment in RenderTicket ctor
-
-	int xd = (srcRect.left + transform._hotspot.x) << 16;
-	int yd = (srcRect.top + transform._hotspot.y) << 16;
-	int cx = newHotspot.x;
-	int cy = newHotspot.y;
-
-	int ax = -icosx * cx;
-	int ay = -isiny * cx;
-	int sw = srcW - 1;
-	int sh = srcH - 1;
-
-	tColorRGBA *pc = (tColorRGBA*)target->getBasePtr(0, 0);
+	void runBand(int begin, int end) {
+		bool flipx = false, flipy = false; // TODO: See mirroring comment in RenderTicket ctor
 
-	for (int y = 0; y < dstH; y++) {
-		int t = cy - y;
-		int sdx = ax + (isinx * t) + xd;
-		int sdy = ay - (icosy * t) + yd;
-		for (int x = 0; x < dstW; x++) {
-			int dx = (sdx >> 16);
-			int dy = (sdy >> 16);
-			if (flipx) {
-				dx = sw - dx;
-			}
-			if (flipy) {
-				dy = sh - dy;
-			}
+		const int srcW = _src.w;
+		const int srcH = _src.h;
+		const int dstW = _dst.w;
+		const int ax = -_icosx * _cx;
+		const int ay = -_isiny * _cx;
+		const int sw = srcW - 1;
+		const int sh = srcH - 1;
+		const tColorRGBA transparent = { 0, 0, 0, 0 };
+
+		for (int y = begin; y < end; y++) {
+			tColorRGBA *pc = (tColorRGBA *)_dst.getBasePtr(0, y);
+			int t = _cy - y;
+			int sdx = ax + (_isinx * t) + _xd;
+			int sdy = ay - (_icosy * t) + _yd;
+			for (int x = 0; x < dstW; x++) {
+				int dx = (sdx >> 16);
+				int dy = (sdy >> 16);
+				if (flipx) {
+					dx = sw - dx;
+				}
+				if (flipy) {
+					dy = sh - dy;
+				}
 
-			if (filteringMode == FILTER_BILINEAR) {
-				if ((dx > -1) && (dy > -1) && (dx < sw) && (dy < sh)) {
-					const tColorRGBA *sp = (const tColorRGBA *)getBasePtr(dx, dy);
-					tColorRGBA c00, c01, c10, c11, cswap;
-					c00 = *sp;
-					sp += 1;
-					c01 = *sp;
-					sp += (this->pitch / 4);
-					c11 = *sp;
-					sp -= 1;
-					c10 = *sp;
-					if (flipx) {
-						cswap = c00; c00=c01; c01=cswap;
-						cswap = c10; c10=c11; c11=cswap;
+				// Pixels outside of the source are cleared, since the
+				// target may be reused.
+				*pc = transparent;
+				if (filteringMode == FILTER_BILINEAR) {
+					if ((dx > -1) && (dy > -1) && (dx < sw) && (dy < sh)) {
+						const tColorRGBA *sp = (const tColorRGBA *)_src.getBasePtr(dx, dy);
+						tColorRGBA c00, c01, c10, c11, cswap;
+						c00 = *sp;
+						sp += 1;
+						c01 = *sp;
+						sp += (_src.pitch / 4);
+						c11 = *sp;
+						sp -= 1;
+						c10 = *sp;
+						if (flipx) {
+							cswap = c00; c00=c01; c01=cswap;
+							cswap = c10; c10=c11; c11=cswap;
+						}
+						if (flipy) {
+							cswap = c00; c00=c10; c10=cswap;
+							cswap = c01; c01=c11; c11=cswap;
+						}
+						interpolateBilinear(pc, c00, c01, c10, c11, sdx & 0xffff, sdy & 0xffff);
 					}
-					if (flipy) {
-						cswap = c00; c00=c10; c10=cswap;
-						cswap = c01; c01=c11; c11=cswap;
+				} else {
+					if ((dx >= 0) && (dy >= 0) && (dx < srcW) && (dy < srcH)) {
+						*pc = *(const tColorRGBA *)_src.getBasePtr(dx, dy);
 					}
-					/*
-					* Interpolate colors
-					*/
-					int ex = (sdx & 0xffff);
-					int ey = (sdy & 0xffff);
-					int t1, t2;
-					t1 = ((((c01.r - c00.r) * ex) >> 16) + c00.r) & 0xff;
-					t2 = ((((c11.r - c10.r) * ex) >> 16) + c10.r) & 0xff;
-					pc->r = (((t2 - t1) * ey) >> 16) + t1;
-					t1 = ((((c01.g - c00.g) * ex) >> 16) + c00.g) & 0xff;
-					t2 = ((((c11.g - c10.g) * ex) >> 16) + c10.g) & 0xff;
-					pc->g = (((t2 - t1) * ey) >> 16) + t1;
-					t1 = ((((c01.b - c00.b) * ex) >> 16) + c00.b) & 0xff;
-					t2 = ((((c11.b - c10.b) * ex) >> 16) + c10.b) & 0xff;
-					pc->b = (((t2 - t1) * ey) >> 16) + t1;
-					t1 = ((((c01.a - c00.a) * ex) >> 16) + c00.a) & 0xff;
-					t2 = ((((c11.a - c10.a) * ex) >> 16) + c10.a) & 0xff;
-					pc->a = (((t2 - t1) * ey) >> 16) + t1;
-				}
-			} else {
-				if ((dx >= 0) && (dy >= 0) && (dx < srcW) && (dy < srcH)) {
-					const tColorRGBA *sp = (const tColorRGBA *)getBasePtr(dx, dy);
-					*pc = *sp;
 				}
+				sdx += _icosx;
+				sdy += _isiny;
+				pc++;
 			}
-			sdx += icosx;
-			sdy += isiny;
-			pc++;
 		}
 	}
-	return target;
-}
-
-template <TFilteringMode filteringMode>
-TransparentSurface *TransparentSurface::scaleT(uint16 newWidth, uint16 newHeight) const {
-
-	Common::Rect srcRect(0, 0, (int16)w, (int16)h);
-	Common::Rect dstRect(0, 0, (int16)newWidth, (int16)newHeight);
-
-	TransparentSurface *target = new TransparentSurface();
-
-	assert(format.bytesPerPixel == 4);
 
-	int srcW = srcRect.width();
-	int srcH = srcRect.height();
-	int dstW = dstRect.width();
-	int dstH = dstRect.height();
+private:
+	const Surface &_src;
+	Surface &_dst;
+	int _icosx, _isinx, _icosy, _isiny;
+	int _xd, _yd;
+	int _cx, _cy;
+};
 
-	target->create((uint16)dstW, (uint16)dstH, this->format);
-
-	if (filteringMode == FILTER_BILINEAR) {
-
-		bool flipx = false, flipy = false; // TODO: See mirroring comment in RenderTicket ctor
-
-
-		int *sax = new int[dstW + 1];
-		int *say = new int[dstH + 1];
-		assert(sax && say);
-
-		/*
-		* Precalculate row increments
-		*/
-		int spixelw = (srcW - 1);
-		int spixelh = (srcH - 1);
-		int sx = (int) (65536.0f * (float) spixelw / (float) (dstW - 1));
-		int sy = (int) (65536.0f * (float) spixelh / (float) (dstH - 1));
-
-		/* Maximum scaled source size */
-		int ssx = (srcW << 16) - 1;
-		int ssy = (srcH << 16) - 1;
-
-		/* Precalculate horizontal row increments */
-		int csx = 0;
-		int *csax = sax;
-		for (int x = 0; x <= dstW; x++) {
-			*csax = csx;
-			csax++;
-			csx += sx;
-
-			/* Guard from overflows */
-			if (csx > ssx) {
-				csx = ssx;
+template <TFilteringMode filteringMode>
+class ScaleJob : public Common::BandedJob {
+public:
+	ScaleJob(const Surface &src, Surface &dst) : _src(src), _dst(dst) {
+		const int srcW = src.w;
+		const int srcH = src.h;
+		const int dstW = dst.w;
+		const int dstH = dst.h;
+
+		_sax = new int[dstW + 1];
+		_say = new int[dstH + 1];
+
+		if (filteringMode == FILTER_BILINEAR) {
+			/*
+			* Precalculate row increments
+			*/
+			int sx = dstW > 1 ? (int) (65536.0f * (float) (srcW - 1) / (float) (dstW - 1)) : 0;
+			int sy = dstH > 1 ? (int) (65536.0f * (float) (srcH - 1) / (float) (dstH - 1)) : 0;
+
+			/* Maximum scaled source size */
+			int ssx = (srcW << 16) - 1;
+			int ssy = (srcH << 16) - 1;
+
+			/* Precalculate horizontal and vertical row increments */
+			int csx = 0;
+			for (int x = 0; x <= dstW; x++) {
+				_sax[x] = csx;
+				csx = MIN(csx + sx, ssx);
+			}
+			int csy = 0;
+			for (int y = 0; y <= dstH; y++) {
+				_say[y] = csy;
+				csy = MIN(csy + sy, ssy);
 			}
+		} else {
+			// The first source pixel of every target pixel. With area
+			// filtering, target pixel x covers the source pixels
+			// [_sax[x], _sax[x + 1]] in part or in full.
+			for (int x = 0; x <= dstW; x++)
+				_sax[x] = (x * srcW) / dstW;
+			for (int y = 0; y <= dstH; y++)
+				_say[y] = (y * srcH) / dstH;
 		}
+	}
+
+	~ScaleJob() {
+		delete[] _sax;
+		delete[] _say;
+	}
 
-		/* Precalculate vertical row increments */
-		int csy = 0;
-		int *csay = say;
-		for (int y = 0; y <= dstH; y++) {
-			*csay = csy;
-			csay++;
-			csy += sy;
-
-			/* Guard from overflows */
-			if (csy > ssy) {
-				csy = ssy;
+	void runBand(int begin, int end) {
+		if (filteringMode == FILTER_BILINEAR)
+			runBandBilinear(begin, end);
+		else if (filteringMode == FILTER_AREA)
+			runBandArea(begin, end);
+		else
+			runBandNearest(begin, end);
+	}
+
+private:
+	const Surface &_src;
+	Surface &_dst;
+	int *_sax;
+	int *_say;
+
+	void runBandNearest(int begin, int end) {
+		for (int y = begin; y < end; y++) {
+			uint32 *destP = (uint32 *)_dst.getBasePtr(0, y);
+			const uint32 *srcP = (const uint32 *)_src.getBasePtr(0, _say[y]);
+			for (int x = 0; x < _dst.w; x++) {
+				*destP++ = srcP[_sax[x]];
 			}
 		}
+	}
 
-		const tColorRGBA *sp = (const tColorRGBA *) getBasePtr(0, 0);
-		tColorRGBA *dp = (tColorRGBA *) target->getBasePtr(0, 0);
-		int spixelgap = srcW;
+	void runBandBilinear(int begin, int end) {
+		const int spixelw = (_src.w - 1);
+		const int spixelh = (_src.h - 1);
+		const int spixelgap = _src.pitch / 4;
 
-		if (flipx) {
-			sp += spixelw;
-		}
-		if (flipy) {
-			sp += spixelgap * spixelh;
-		}
+		for (int y = begin; y < end; y++) {
+			tColorRGBA *dp = (tColorRGBA *)_dst.getBasePtr(0, y);
+			const int cy = (_say[y] >> 16);
+			const int ey = (_say[y] & 0xffff);
+			const tColorRGBA *sp = (const tColorRGBA *)_src.getBasePtr(0, cy);
 
-		csay = say;
-		for (int y = 0; y < dstH; y++) {
-			const tColorRGBA *csp = sp;
-			csax = sax;
-			for (int x = 0; x < dstW; x++) {
+			for (int x = 0; x < _dst.w; x++) {
 				/*
 				* Setup color source pointers
 				*/
-				int ex = (*csax & 0xffff);
-				int ey = (*csay & 0xffff);
-				int cx = (*csax >> 16);
-				int cy = (*csay >> 16);
+				const int cx = (_sax[x] >> 16);
+				const int ex = (_sax[x] & 0xffff);
 
 				const tColorRGBA *c00, *c01, *c10, *c11;
-				c00 = sp;
-				c01 = sp;
-				c10 = sp;
+				c00 = sp + cx;
+				c01 = c00;
+				c10 = c00;
 				if (cy < spixelh) {
-					if (flipy) {
-						c10 -= spixelgap;
-					} else {
-						c10 += spixelgap;
-					}
+					c10 += spixelgap;
 				}
 				c11 = c10;
 				if (cx < spixelw) {
-					if (flipx) {
-						c01--;
-						c11--;
-					} else {
-						c01++;
-						c11++;
-					}
+					c01++;
+					c11++;
 				}
 
-				/*
-				* Draw and interpolate colors
-				*/
-				int t1, t2;
-				t1 = ((((c01->r - c00->r) * ex) >> 16) + c00->r) & 0xff;
-				t2 = ((((c11->r - c10->r) * ex) >> 16) + c10->r) & 0xff;
-				dp->r = (((t2 - t1) * ey) >> 16) + t1;
-				t1 = ((((c01->g - c00->g) * ex) >> 16) + c00->g) & 0xff;
-				t2 = ((((c11->g - c10->g) * ex) >> 16) + c10->g) & 0xff;
-				dp->g = (((t2 - t1) * ey) >> 16) + t1;
-				t1 = ((((c01->b - c00->b) * ex) >> 16) + c00->b) & 0xff;
-				t2 = ((((c11->b - c10->b) * ex) >> 16) + c10->b) & 0xff;
-				dp->b = (((t2 - t1) * ey) >> 16) + t1;
-				t1 = ((((c01->a - c00->a) * ex) >> 16) + c00->a) & 0xff;
-				t2 = ((((c11->a - c10->a) * ex) >> 16) + c10->a) & 0xff;
-				dp->a = (((t2 - t1) * ey) >> 16) + t1;
+				interpolateBilinear(dp, *c00, *c01, *c10, *c11, ex, ey);
+				dp++;
+			}
+		}
+	}
 
-				/*
-				* Advance source pointer x
-				*/
-				int *salastx = csax;
-				csax++;
-				int sstepx = (*csax >> 16) - (*salastx >> 16);
-				if (flipx) {
-					sp -= sstepx;
-				} else {
-					sp += sstepx;
+	/**
+	 * Return how much of target pixel d, scaled to srcSize units, is covered
+	 * by source pixel s, scaled to dstSize units.
+	 */
+	static uint32 coverage(uint32 s, uint32 d, uint32 srcSize, uint32 dstSize) {
+		return MIN((s + 1) * dstSize, (d + 1) * srcSize) - MAX(s * dstSize, d * srcSize);
+	}
+
+	void runBandArea(int begin, int end) {
+		const uint32 srcW = _src.w;
+		const uint32 srcH = _src.h;
+		const uint32 dstW = _dst.w;
+		const uint32 dstH = _dst.h;
+		// The coverages of a target pixel add up to this
+		const uint64 total = (uint64)srcW * srcH;
+
+		for (int y = begin; y < end; y++) {
+			tColorRGBA *dp = (tColorRGBA *)_dst.getBasePtr(0, y);
+			const int lastY = MIN<int>(_say[y + 1], srcH - 1);
+
+			for (uint32 x = 0; x < dstW; x++) {
+				const int lastX = MIN<int>(_sax[x + 1], srcW - 1);
+				uint64 r = 0, g = 0, b = 0, a = 0;
+
+				for (int sy = _say[y]; sy <= lastY; sy++) {
+					const uint32 wy = coverage(sy, y, srcH, dstH);
+					if (!wy)
+						continue;
+
+					const tColorRGBA *sp = (const tColorRGBA *)_src.getBasePtr(0, sy);
+					uint32 rowR = 0, rowG = 0, rowB = 0, rowA = 0;
+					for (int sx = _sax[x]; sx <= lastX; sx++) {
+						const uint32 wx = coverage(sx, x, srcW, dstW);
+						rowR += sp[sx].r * wx;
+						rowG += sp[sx].g * wx;
+						rowB += sp[sx].b * wx;
+						rowA += sp[sx].a * wx;
+					}
+					r += (uint64)rowR * wy;
+					g += (uint64)rowG * wy;
+					b += (uint64)rowB * wy;
+					a += (uint64)rowA * wy;
 				}
 
-				/*
-				* Advance destination pointer x
-				*/
+				dp->r = (r + total / 2) / total;
+				dp->g = (g + total / 2) / total;
+				dp->b = (b + total / 2) / total;
+				dp->a = (a + total / 2) / total;
 				dp++;
 			}
-			/*
-			* Advance source pointer y
-			*/
-			int *salasty = csay;
-			csay++;
-			int sstepy = (*csay >> 16) - (*salasty >> 16);
-			sstepy *= spixelgap;
-			if (flipy) {
-				sp = csp - sstepy;
-			} else {
-				sp = csp + sstepy;
-			}
 		}
+	}
+};
 
-		delete[] sax;
-		delete[] say;
-
-	} else {
+} // End of anonymous namespace
 
-		int *scaleCacheX = new int[dstW];
-		for (int x = 0; x < dstW; x++) {
-			scaleCacheX[x] = (x * srcW) / dstW;
-		}
+template <TFilteringMode filteringMode>
+void TransparentSurface::rotoscaleInto(Graphics::Surface &target, const TransformStruct &transform) const {
+	assert(transform._angle != 0); // This would not be ideal; rotoscale() should never be called in conditional branches where angle = 0 anyway.
+	assert(format.bytesPerPixel == 4 && target.format == format);
 
-		for (int y = 0; y < dstH; y++) {
-			uint32 *destP = (uint32 *)target->getBasePtr(0, y);
-			const uint32 *srcP = (const uint32 *)getBasePtr(0, (y * srcH) / dstH);
-			for (int x = 0; x < dstW; x++) {
-				*destP++ = srcP[scaleCacheX[x]];
-			}
-		}
-		delete[] scaleCacheX;
+	Common::Point newHotspot;
+	Common::Rect rect = TransformTools::newRect(Common::Rect(0, 0, (int16)w, (int16)h), transform, &newHotspot);
+	assert(target.w == rect.width() && target.h == rect.height());
 
+	if (transform._zoom.x == 0 || transform._zoom.y == 0) {
+		for (int y = 0; y < target.h; y++)
+			memset(target.getBasePtr(0, y), 0, target.w * 4);
+		return;
 	}
 
+	RotoscaleJob<filteringMode> job(*this, target, transform, newHotspot);
+	Common::runBanded(job, target.h, MAX(kMinBandPixels / MAX<int>(target.w, 1), 1));
+}
+
+template <TFilteringMode filteringMode>
+TransparentSurface *TransparentSurface::rotoscaleT(const TransformStruct &transform) const {
+	Common::Rect rect = TransformTools::newRect(Common::Rect(0, 0, (int16)w, (int16)h), transform, nullptr);
+
+	TransparentSurface *target = new TransparentSurface();
+	target->create((uint16)rect.width(), (uint16)rect.height(), this->format);
+	rotoscaleInto<filteringMode>(*target, transform);
 	return target;
+}
+
+template <TFilteringMode filteringMode>
+void TransparentSurface::scaleInto(Graphics::Surface &target) const {
+	assert(format.bytesPerPixel == 4 && target.format == format);
+
+	if (!target.w || !target.h || !w || !h)
+		return;
 
+	ScaleJob<filteringMode> job(*this, target);
+	Common::runBanded(job, target.h, MAX(kMinBandPixels / target.w, 1));
+}
+
+template <TFilteringMode filteringMode>
+TransparentSurface *TransparentSurface::scaleT(uint16 newWidth, uint16 newHeight) const {
+	TransparentSurface *target = new TransparentSurface();
+	target->create(newWidth, newHeight, this->format);
+	scaleInto<filteringMode>(*target);
+	return target;
 }
 
 TransparentSurface *TransparentSurface::convertTo(const PixelFormat &dstFormat, const byte *palette) const {
@@ -1058,6 +1088,12 @@ template TransparentSurface *TransparentSurface::rotoscaleT<FILTER_NEAREST>(cons
 template TransparentSurface *TransparentSurface::rotoscaleT<FILTER_BILINEAR>(const TransformStruct &transform) const;
 template TransparentSurface *TransparentSurface::scaleT<FILTER_NEAREST>(uint16 newWidth, uint16 newHeight) const;
 template TransparentSurface *TransparentSurface::scaleT<FILTER_BILINEAR>(uint16 newWidth, uint16 newHeight) const;
+template TransparentSurface *TransparentSurface::scaleT<FILTER_AREA>(uint16 newWidth, uint16 newHeight) const;
+template void TransparentSurface::rotoscaleInto<FILTER_NEAREST>(Graphics::Surface &target, const TransformStruct &transform) const;
+template void TransparentSurface::rotoscaleInto<FILTER_BILINEAR>(Graphics::Surface &target, const TransformStruct &transform) const;
+template void TransparentSurface::scaleInto<FILTER_NEAREST>(Graphics::Surface &target) const;
+template void TransparentSurface::scaleInto<FILTER_BILINEAR>(Graphics::Surface &target) const;
+template void TransparentSurface::scaleInto<FILTER_AREA>(Graphics::Surface &target) const;
 
 TransparentSurface *TransparentSurface::rotoscale(const TransformStruct &transform) const {
 	return rotoscaleT<FILTER_BILINEAR>(transform);
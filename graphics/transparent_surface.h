@@ -70,7 +70,10 @@ enum AlphaType {
 
 enum TFilteringMode {
 	FILTER_NEAREST = 0,
-	FILTER_BILINEAR = 1
+	FILTER_BILINEAR = 1,
+	/// Average of all covered source pixels, for downscaling. Only
+	/// supported by scaling, not by rotoscaling.
+	FILTER_AREA = 2
 };
 
 /**
@@ -162,6 +165,34 @@ struct TransparentSurface : public Graphics::Surface {
 
 	TransparentSurface *rotoscale(const TransformStruct &transform) const;
 
+	/**
+	 * @brief Scale this surface into an existing surface, so that the same
+	 * target can be reused from frame to frame.
+	 *
+	 * Large targets are rendered in bands of rows on the worker threads of
+	 * Common::WorkerPool::getShared().
+	 *
+	 * @param target the resulting surface. Its size is the scaled size and
+	 * its format must be the format of this surface.
+	 */
+	template <TFilteringMode filteringMode>
+	void scaleInto(Graphics::Surface &target) const;
+
+	/**
+	 * @brief Rotoscale this surface into an existing surface, so that the
+	 * same target can be reused from frame to frame.
+	 *
+	 * Large targets are rendered in bands of rows on the worker threads of
+	 * Common::WorkerPool::getShared().
+	 *
+	 * @param target the resulting surface. Its size must be the size of the
+	 * rect returned by TransformTools::newRect() for the transform, and its
+	 * format must be the format of this surface.
+	 * @param transform a TransformStruct wrapping the required info. @see TransformStruct
+	 */
+	template <TFilteringMode filteringMode>
+	void rotoscaleInto(Graphics::Surface &target, const TransformStruct &transform) const;
+
 	TransparentSurface *convertTo(const PixelFormat &dstFormat, const byte *palette = 0) const;
 
 	float getRatio() {
@@ -0,0 +1,627 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "graphics/transparent_surface_kernels.h"
+#include "common/cpudetect.h"
+
+#ifdef SCUMMVM_SIMD_X86
+#include <emmintrin.h>
+#include <immintrin.h>
+#endif
+
+#ifdef SCUMMVM_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+namespace Graphics {
+
+// The vectorized kernels work on whole pixels loaded as 32 bit words, with
+// the alpha value in the lowest byte (see kAIndex in transparent_surface.cpp),
+// so they are only built for little endian hosts. Every formula of the C
+// kernels is evaluated on 16 bit lanes:
+//
+// - (x * y * z) >> 16 is computed as mulhi(x * y, z), as x * y fits into
+//   16 bits for 8 bit values.
+// - The C kernels use (x * a) >> 8 for unmodulated color channels and
+//   (x * c * a) >> 16 for modulated ones; both are handled by the second
+//   form, using 256 as c for unmodulated channels.
+// - (x * c * y * a) >> 24 is computed as mulhi(x * c, y * a) >> 8.
+//
+// Horizontally flipped blits read their source backwards, which is handled
+// by reversing the order of the loaded pixels. Rows which are not a multiple
+// of the vector width are finished by the C kernels.
+
+#if (defined(SCUMMVM_SIMD_X86) || defined(SCUMMVM_SIMD_NEON)) && defined(SCUMM_LITTLE_ENDIAN)
+
+/**
+ * Return the factor a color channel of the additive and subtractive kernels
+ * is multiplied with, as described above.
+ */
+static inline uint16 channelFactor(uint32 color, int shift) {
+	const uint16 c = (color >> shift) & 0xFF;
+	return (c == 255) ? 256 : c;
+}
+
+#endif
+
+#if defined(SCUMMVM_SIMD_X86) && defined(SCUMM_LITTLE_ENDIAN)
+
+__attribute__((target("sse2")))
+static inline __m128i loadPixelsSSE2(const byte *in, bool flipped) {
+	if (!flipped)
+		return _mm_loadu_si128((const __m128i *)in);
+
+	// The following source pixels precede the first one in memory
+	return _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)(in - 12)), _MM_SHUFFLE(0, 1, 2, 3));
+}
+
+/**
+ * Broadcast the alpha value of every pixel to all four lanes of the pixel.
+ */
+__attribute__((target("sse2")))
+static inline __m128i alphaSSE2(__m128i pixels) {
+	return _mm_shufflehi_epi16(_mm_shufflelo_epi16(pixels, _MM_SHUFFLE(0, 0, 0, 0)), _MM_SHUFFLE(0, 0, 0, 0));
+}
+
+__attribute__((target("sse2")))
+static void alphaBlendSSE2(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color) {
+	if (inStep != 4 && inStep != -4) {
+		doBlitAlphaBlend(ino, outo, width, height, pitch, inStep, inoStep, color);
+		return;
+	}
+
+	const bool flipped = inStep < 0;
+	const bool modulated = color != 0xFFFFFFFF;
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i alphaMask = _mm_set1_epi32(0xFF);
+	const __m128i max = _mm_set1_epi16(255);
+	const __m128i ca = _mm_set1_epi16((color >> 24) & 0xFF);
+	const __m128i factors = _mm_set_epi16((color >> 16) & 0xFF, (color >> 8) & 0xFF, color & 0xFF, 0,
+	                                      (color >> 16) & 0xFF, (color >> 8) & 0xFF, color & 0xFF, 0);
+
+	for (uint32 i = 0; i < height; i++) {
+		byte *in = ino;
+		byte *out = outo;
+		uint32 x = width;
+
+		for (; x >= 4; x -= 4) {
+			const __m128i src = loadPixelsSSE2(in, flipped);
+			const __m128i dst = _mm_loadu_si128((const __m128i *)out);
+			const __m128i s0 = _mm_unpacklo_epi8(src, zero);
+			const __m128i s1 = _mm_unpackhi_epi8(src, zero);
+			const __m128i d0 = _mm_unpacklo_epi8(dst, zero);
+			const __m128i d1 = _mm_unpackhi_epi8(dst, zero);
+			__m128i r0, r1, result;
+
+			if (modulated) {
+				const __m128i a0 = _mm_srli_epi16(_mm_mullo_epi16(alphaSSE2(s0), ca), 8);
+				const __m128i a1 = _mm_srli_epi16(_mm_mullo_epi16(alphaSSE2(s1), ca), 8);
+				r0 = _mm_srli_epi16(_mm_mullo_epi16(d0, _mm_sub_epi16(max, a0)), 8);
+				r1 = _mm_srli_epi16(_mm_mullo_epi16(d1, _mm_sub_epi16(max, a1)), 8);
+				r0 = _mm_add_epi16(r0, _mm_mulhi_epu16(_mm_mullo_epi16(s0, factors), a0));
+				r1 = _mm_add_epi16(r1, _mm_mulhi_epu16(_mm_mullo_epi16(s1, factors), a1));
+				result = _mm_or_si128(_mm_packus_epi16(r0, r1), alphaMask);
+			} else {
+				const __m128i a0 = alphaSSE2(s0);
+				const __m128i a1 = alphaSSE2(s1);
+				r0 = _mm_add_epi16(_mm_mullo_epi16(s0, a0), _mm_mullo_epi16(d0, _mm_sub_epi16(max, a0)));
+				r1 = _mm_add_epi16(_mm_mullo_epi16(s1, a1), _mm_mullo_epi16(d1, _mm_sub_epi16(max, a1)));
+				result = _mm_or_si128(_mm_packus_epi16(_mm_srli_epi16(r0, 8), _mm_srli_epi16(r1, 8)), alphaMask);
+
+				// Fully transparent pixels leave the target untouched
+				const __m128i transparent = _mm_cmpeq_epi32(_mm_and_si128(src, alphaMask), zero);
+				result = _mm_or_si128(_mm_and_si128(transparent, dst), _mm_andnot_si128(transparent, result));
+			}
+
+			_mm_storeu_si128((__m128i *)out, result);
+			in += inStep * 4;
+			out += 16;
+		}
+
+		if (x)
+			doBlitAlphaBlend(in, out, x, 1, pitch, inStep, inoStep, color);
+
+		outo += pitch;
+		ino += inoStep;
+	}
+}
+
+__attribute__((target("sse2")))
+static void additiveBlendSSE2(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color) {
+	if (inStep != 4 && inStep != -4) {
+		doBlitAdditiveBlend(ino, outo, width, height, pitch, inStep, inoStep, color);
+		return;
+	}
+
+	const bool flipped = inStep < 0;
+	const bool modulated = color != 0xFFFFFFFF;
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i ca = _mm_set1_epi16((color >> 24) & 0xFF);
+	const __m128i factors = _mm_set_epi16(channelFactor(color, 16), channelFactor(color, 8), channelFactor(color, 0), 0,
+	                                      channelFactor(color, 16), channelFactor(color, 8), channelFactor(color, 0), 0);
+
+	for (uint32 i = 0; i < height; i++) {
+		byte *in = ino;
+		byte *out = outo;
+		uint32 x = width;
+
+		for (; x >= 4; x -= 4) {
+			const __m128i src = loadPixelsSSE2(in, flipped);
+			const __m128i dst = _mm_loadu_si128((const __m128i *)out);
+			const __m128i s0 = _mm_unpacklo_epi8(src, zero);
+			const __m128i s1 = _mm_unpackhi_epi8(src, zero);
+			__m128i a0 = alphaSSE2(s0);
+			__m128i a1 = alphaSSE2(s1);
+
+			if (modulated) {
+				a0 = _mm_srli_epi16(_mm_mullo_epi16(a0, ca), 8);
+				a1 = _mm_srli_epi16(_mm_mullo_epi16(a1, ca), 8);
+			}
+
+			const __m128i t0 = _mm_mulhi_epu16(_mm_mullo_epi16(s0, factors), a0);
+			const __m128i t1 = _mm_mulhi_epu16(_mm_mullo_epi16(s1, factors), a1);
+			_mm_storeu_si128((__m128i *)out, _mm_adds_epu8(dst, _mm_packus_epi16(t0, t1)));
+			in += inStep * 4;
+			out += 16;
+		}
+
+		if (x)
+			doBlitAdditiveBlend(in, out, x, 1, pitch, inStep, inoStep, color);
+
+		outo += pitch;
+		ino += inoStep;
+	}
+}
+
+__attribute__((target("sse2")))
+static void subtractiveBlendSSE2(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color) {
+	if (inStep != 4 && inStep != -4) {
+		doBlitSubtractiveBlend(ino, outo, width, height, pitch, inStep, inoStep, color);
+		return;
+	}
+
+	const bool flipped = inStep < 0;
+	const __m128i zero = _mm_setzero_si128();
+	// Modulated blits make the target opaque
+	const __m128i alphaMask = _mm_set1_epi32(color != 0xFFFFFFFF ? 0xFF : 0);
+	const __m128i factors = _mm_set_epi16(channelFactor(color, 16), channelFactor(color, 8), channelFactor(color, 0), 0,
+	                                      channelFactor(color, 16), channelFactor(color, 8), channelFactor(color, 0), 0);
+
+	for (uint32 i = 0; i < height; i++) {
+		byte *in = ino;
+		byte *out = outo;
+		uint32 x = width;
+
+		for (; x >= 4; x -= 4) {
+			const __m128i src = loadPixelsSSE2(in, flipped);
+			const __m128i dst = _mm_loadu_si128((const __m128i *)out);
+			const __m128i s0 = _mm_unpacklo_epi8(src, zero);
+			const __m128i s1 = _mm_unpackhi_epi8(src, zero);
+			const __m128i d0 = _mm_unpacklo_epi8(dst, zero);
+			const __m128i d1 = _mm_unpackhi_epi8(dst, zero);
+
+			const __m128i t0 = _mm_srli_epi16(_mm_mulhi_epu16(_mm_mullo_epi16(s0, factors), _mm_mullo_epi16(d0, alphaSSE2(s0))), 8);
+			const __m128i t1 = _mm_srli_epi16(_mm_mulhi_epu16(_mm_mullo_epi16(s1, factors), _mm_mullo_epi16(d1, alphaSSE2(s1))), 8);
+			_mm_storeu_si128((__m128i *)out, _mm_or_si128(_mm_subs_epu8(dst, _mm_packus_epi16(t0, t1)), alphaMask));
+			in += inStep * 4;
+			out += 16;
+		}
+
+		if (x)
+			doBlitSubtractiveBlend(in, out, x, 1, pitch, inStep, inoStep, color);
+
+		outo += pitch;
+		ino += inoStep;
+	}
+}
+
+__attribute__((target("avx2")))
+static inline __m256i loadPixelsAVX2(const byte *in, bool flipped) {
+	if (!flipped)
+		return _mm256_loadu_si256((const __m256i *)in);
+
+	// The following source pixels precede the first one in memory
+	return _mm256_permutevar8x32_epi32(_mm256_loadu_si256((const __m256i *)(in - 28)), _mm256_set_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+}
+
+__attribute__((target("avx2")))
+static inline __m256i alphaAVX2(__m256i pixels) {
+	return _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(pixels, _MM_SHUFFLE(0, 0, 0, 0)), _MM_SHUFFLE(0, 0, 0, 0));
+}
+
+// unpack and pack both operate on 128 bit lanes, so the pixel order is
+// preserved by the AVX2 kernels below.
+
+__attribute__((target("avx2")))
+static void alphaBlendAVX2(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color) {
+	if (inStep != 4 && inStep != -4) {
+		doBlitAlphaBlend(ino, outo, width, height, pitch, inStep, inoStep, color);
+		return;
+	}
+
+	const bool flipped = inStep < 0;
+	const bool modulated = color != 0xFFFFFFFF;
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i alphaMask = _mm256_set1_epi32(0xFF);
+	const __m256i max = _mm256_set1_epi16(255);
+	const __m256i ca = _mm256_set1_epi16((color >> 24) & 0xFF);
+	const __m256i factors = _mm256_broadcastsi128_si256(_mm_set_epi16((color >> 16) & 0xFF, (color >> 8) & 0xFF, color & 0xFF, 0,
+	                                                                  (color >> 16) & 0xFF, (color >> 8) & 0xFF, color & 0xFF, 0));
+
+	for (uint32 i = 0; i < height; i++) {
+		byte *in = ino;
+		byte *out = outo;
+		uint32 x = width;
+
+		for (; x >= 8; x -= 8) {
+			const __m256i src = loadPixelsAVX2(in, flipped);
+			const __m256i dst = _mm256_loadu_si256((const __m256i *)out);
+			const __m256i s0 = _mm256_unpacklo_epi8(src, zero);
+			const __m256i s1 = _mm256_unpackhi_epi8(src, zero);
+			const __m256i d0 = _mm256_unpacklo_epi8(dst, zero);
+			const __m256i d1 = _mm256_unpackhi_epi8(dst, zero);
+			__m256i r0, r1, result;
+
+			if (modulated) {
+				const __m256i a0 = _mm256_srli_epi16(_mm256_mullo_epi16(alphaAVX2(s0), ca), 8);
+				const __m256i a1 = _mm256_srli_epi16(_mm256_mullo_epi16(alphaAVX2(s1), ca), 8);
+				r0 = _mm256_srli_epi16(_mm256_mullo_epi16(d0, _mm256_sub_epi16(max, a0)), 8);
+				r1 = _mm256_srli_epi16(_mm256_mullo_epi16(d1, _mm256_sub_epi16(max, a1)), 8);
+				r0 = _mm256_add_epi16(r0, _mm256_mulhi_epu16(_mm256_mullo_epi16(s0, factors), a0));
+				r1 = _mm256_add_epi16(r1, _mm256_mulhi_epu16(_mm256_mullo_epi16(s1, factors), a1));
+				result = _mm256_or_si256(_mm256_packus_epi16(r0, r1), alphaMask);
+			} else {
+				const __m256i a0 = alphaAVX2(s0);
+				const __m256i a1 = alphaAVX2(s1);
+				r0 = _mm256_add_epi16(_mm256_mullo_epi16(s0, a0), _mm256_mullo_epi16(d0, _mm256_sub_epi16(max, a0)));
+				r1 = _mm256_add_epi16(_mm256_mullo_epi16(s1, a1), _mm256_mullo_epi16(d1, _mm256_sub_epi16(max, a1)));
+				result = _mm256_or_si256(_mm256_packus_epi16(_mm256_srli_epi16(r0, 8), _mm256_srli_epi16(r1, 8)), alphaMask);
+
+				const __m256i transparent = _mm256_cmpeq_epi32(_mm256_and_si256(src, alphaMask), zero);
+				result = _mm256_blendv_epi8(result, dst, transparent);
+			}
+
+			_mm256_storeu_si256((__m256i *)out, result);
+			in += inStep * 8;
+			out += 32;
+		}
+
+		if (x)
+			alphaBlendSSE2(in, out, x, 1, pitch, inStep, inoStep, color);
+
+		outo += pitch;
+		ino += inoStep;
+	}
+}
+
+__attribute__((target("avx2")))
+static void additiveBlendAVX2(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color) {
+	if (inStep != 4 && inStep != -4) {
+		doBlitAdditiveBlend(ino, outo, width, height, pitch, inStep, inoStep, color);
+		return;
+	}
+
+	const bool flipped = inStep < 0;
+	const bool modulated = color != 0xFFFFFFFF;
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i ca = _mm256_set1_epi16((color >> 24) & 0xFF);
+	const __m256i factors = _mm256_broadcastsi128_si256(_mm_set_epi16(channelFactor(color, 16), channelFactor(color, 8), channelFactor(color, 0), 0,
+	                                                                  channelFactor(color, 16), channelFactor(color, 8), channelFactor(color, 0), 0));
+
+	for (uint32 i = 0; i < height; i++) {
+		byte *in = ino;
+		byte *out = outo;
+		uint32 x = width;
+
+		for (; x >= 8; x -= 8) {
+			const __m256i src = loadPixelsAVX2(in, flipped);
+			const __m256i dst = _mm256_loadu_si256((const __m256i *)out);
+			const __m256i s0 = _mm256_unpacklo_epi8(src, zero);
+			const __m256i s1 = _mm256_unpackhi_epi8(src, zero);
+			__m256i a0 = alphaAVX2(s0);
+			__m256i a1 = alphaAVX2(s1);
+
+			if (modulated) {
+				a0 = _mm256_srli_epi16(_mm256_mullo_epi16(a0, ca), 8);
+				a1 = _mm256_srli_epi16(_mm256_mullo_epi16(a1, ca), 8);
+			}
+
+			const __m256i t0 = _mm256_mulhi_epu16(_mm256_mullo_epi16(s0, factors), a0);
+			const __m256i t1 = _mm256_mulhi_epu16(_mm256_mullo_epi16(s1, factors), a1);
+			_mm256_storeu_si256((__m256i *)out, _mm256_adds_epu8(dst, _mm256_packus_epi16(t0, t1)));
+			in += inStep * 8;
+			out += 32;
+		}
+
+		if (x)
+			additiveBlendSSE2(in, out, x, 1, pitch, inStep, inoStep, color);
+
+		outo += pitch;
+		ino += inoStep;
+	}
+}
+
+__attribute__((target("avx2")))
+static void subtractiveBlendAVX2(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color) {
+	if (inStep != 4 && inStep != -4) {
+		doBlitSubtractiveBlend(ino, outo, width, height, pitch, inStep, inoStep, color);
+		return;
+	}
+
+	const bool flipped = inStep < 0;
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i alphaMask = _mm256_set1_epi32(color != 0xFFFFFFFF ? 0xFF : 0);
+	const __m256i factors = _mm256_broadcastsi128_si256(_mm_set_epi16(channelFactor(color, 16), channelFactor(color, 8), channelFactor(color, 0), 0,
+	                                                                  channelFactor(color, 16), channelFactor(color, 8), channelFactor(color, 0), 0));
+
+	for (uint32 i = 0; i < height; i++) {
+		byte *in = ino;
+		byte *out = outo;
+		uint32 x = width;
+
+		for (; x >= 8; x -= 8) {
+			const __m256i src = loadPixelsAVX2(in, flipped);
+			const __m256i dst = _mm256_loadu_si256((const __m256i *)out);
+			const __m256i s0 = _mm256_unpacklo_epi8(src, zero);
+			const __m256i s1 = _mm256_unpackhi_epi8(src, zero);
+			const __m256i d0 = _mm256_unpacklo_epi8(dst, zero);
+			const __m256i d1 = _mm256_unpackhi_epi8(dst, zero);
+
+			const __m256i t0 = _mm256_srli_epi16(_mm256_mulhi_epu16(_mm256_mullo_epi16(s0, factors), _mm256_mullo_epi16(d0, alphaAVX2(s0))), 8);
+			const __m256i t1 = _mm256_srli_epi16(_mm256_mulhi_epu16(_mm256_mullo_epi16(s1, factors), _mm256_mullo_epi16(d1, alphaAVX2(s1))), 8);
+			_mm256_storeu_si256((__m256i *)out, _mm256_or_si256(_mm256_subs_epu8(dst, _mm256_packus_epi16(t0, t1)), alphaMask));
+			in += inStep * 8;
+			out += 32;
+		}
+
+		if (x)
+			subtractiveBlendSSE2(in, out, x, 1, pitch, inStep, inoStep, color);
+
+		outo += pitch;
+		ino += inoStep;
+	}
+}
+
+#endif // SCUMMVM_SIMD_X86
+
+#if defined(SCUMMVM_SIMD_NEON) && defined(SCUMM_LITTLE_ENDIAN)
+
+static inline uint8x16_t loadPixelsNEON(const byte *in, bool flipped) {
+	if (!flipped)
+		return vld1q_u8(in);
+
+	// The following source pixels precede the first one in memory
+	const uint32x4_t pixels = vrev64q_u32(vld1q_u32((const uint32_t *)(in - 12)));
+	return vreinterpretq_u8_u32(vextq_u32(pixels, pixels, 2));
+}
+
+/**
+ * Broadcast the alpha value of every pixel to all four bytes of the pixel.
+ */
+static inline uint8x16_t alphaNEON(uint8x16_t pixels) {
+	return vreinterpretq_u8_u32(vmulq_n_u32(vandq_u32(vreinterpretq_u32_u8(pixels), vdupq_n_u32(0xFF)), 0x01010101));
+}
+
+static inline uint16x8_t mulhiNEON(uint16x8_t a, uint16x8_t b) {
+	return vcombine_u16(vshrn_n_u32(vmull_u16(vget_low_u16(a), vget_low_u16(b)), 16),
+	                    vshrn_n_u32(vmull_u16(vget_high_u16(a), vget_high_u16(b)), 16));
+}
+
+static void alphaBlendNEON(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color) {
+	if (inStep != 4 && inStep != -4) {
+		doBlitAlphaBlend(ino, outo, width, height, pitch, inStep, inoStep, color);
+		return;
+	}
+
+	const bool flipped = inStep < 0;
+	const bool modulated = color != 0xFFFFFFFF;
+	const uint8x16_t alphaMask = vreinterpretq_u8_u32(vdupq_n_u32(0xFF));
+	const uint16x8_t max = vdupq_n_u16(255);
+	const uint16x8_t ca = vdupq_n_u16((color >> 24) & 0xFF);
+	const uint16_t factorArray[8] = {
+		0, (uint16_t)(color & 0xFF), (uint16_t)((color >> 8) & 0xFF), (uint16_t)((color >> 16) & 0xFF),
+		0, (uint16_t)(color & 0xFF), (uint16_t)((color >> 8) & 0xFF), (uint16_t)((color >> 16) & 0xFF)
+	};
+	const uint16x8_t factors = vld1q_u16(factorArray);
+
+	for (uint32 i = 0; i < height; i++) {
+		byte *in = ino;
+		byte *out = outo;
+		uint32 x = width;
+
+		for (; x >= 4; x -= 4) {
+			const uint8x16_t src = loadPixelsNEON(in, flipped);
+			const uint8x16_t dst = vld1q_u8(out);
+			const uint8x16_t alpha = alphaNEON(src);
+			const uint16x8_t s0 = vmovl_u8(vget_low_u8(src));
+			const uint16x8_t s1 = vmovl_u8(vget_high_u8(src));
+			const uint16x8_t d0 = vmovl_u8(vget_low_u8(dst));
+			const uint16x8_t d1 = vmovl_u8(vget_high_u8(dst));
+			uint16x8_t a0 = vmovl_u8(vget_low_u8(alpha));
+			uint16x8_t a1 = vmovl_u8(vget_high_u8(alpha));
+			uint8x16_t result;
+
+			if (modulated) {
+				a0 = vshrq_n_u16(vmulq_u16(a0, ca), 8);
+				a1 = vshrq_n_u16(vmulq_u16(a1, ca), 8);
+				uint16x8_t r0 = vshrq_n_u16(vmulq_u16(d0, vsubq_u16(max, a0)), 8);
+				uint16x8_t r1 = vshrq_n_u16(vmulq_u16(d1, vsubq_u16(max, a1)), 8);
+				r0 = vaddq_u16(r0, mulhiNEON(vmulq_u16(s0, factors), a0));
+				r1 = vaddq_u16(r1, mulhiNEON(vmulq_u16(s1, factors), a1));
+				result = vorrq_u8(vcombine_u8(vqmovn_u16(r0), vqmovn_u16(r1)), alphaMask);
+			} else {
+				const uint16x8_t r0 = vmlaq_u16(vmulq_u16(s0, a0), d0, vsubq_u16(max, a0));
+				const uint16x8_t r1 = vmlaq_u16(vmulq_u16(s1, a1), d1, vsubq_u16(max, a1));
+				result = vorrq_u8(vcombine_u8(vshrn_n_u16(r0, 8), vshrn_n_u16(r1, 8)), alphaMask);
+
+				// Fully transparent pixels leave the target untouched
+				const uint8x16_t transparent = vceqq_u8(alpha, vdupq_n_u8(0));
+				result = vbslq_u8(transparent, dst, result);
+			}
+
+			vst1q_u8(out, result);
+			in += inStep * 4;
+			out += 16;
+		}
+
+		if (x)
+			doBlitAlphaBlend(in, out, x, 1, pitch, inStep, inoStep, color);
+
+		outo += pitch;
+		ino += inoStep;
+	}
+}
+
+static void additiveBlendNEON(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color) {
+	if (inStep != 4 && inStep != -4) {
+		doBlitAdditiveBlend(ino, outo, width, height, pitch, inStep, inoStep, color);
+		return;
+	}
+
+	const bool flipped = inStep < 0;
+	const bool modulated = color != 0xFFFFFFFF;
+	const uint16x8_t ca = vdupq_n_u16((color >> 24) & 0xFF);
+	const uint16_t factorArray[8] = {
+		0, channelFactor(color, 0), channelFactor(color, 8), channelFactor(color, 16),
+		0, channelFactor(color, 0), channelFactor(color, 8), channelFactor(color, 16)
+	};
+	const uint16x8_t factors = vld1q_u16(factorArray);
+
+	for (uint32 i = 0; i < height; i++) {
+		byte *in = ino;
+		byte *out = outo;
+		uint32 x = width;
+
+		for (; x >= 4; x -= 4) {
+			const uint8x16_t src = loadPixelsNEON(in, flipped);
+			const uint8x16_t dst = vld1q_u8(out);
+			const uint8x16_t alpha = alphaNEON(src);
+			uint16x8_t a0 = vmovl_u8(vget_low_u8(alpha));
+			uint16x8_t a1 = vmovl_u8(vget_high_u8(alpha));
+
+			if (modulated) {
+				a0 = vshrq_n_u16(vmulq_u16(a0, ca), 8);
+				a1 = vshrq_n_u16(vmulq_u16(a1, ca), 8);
+			}
+
+			const uint16x8_t t0 = mulhiNEON(vmulq_u16(vmovl_u8(vget_low_u8(src)), factors), a0);
+			const uint16x8_t t1 = mulhiNEON(vmulq_u16(vmovl_u8(vget_high_u8(src)), factors), a1);
+			vst1q_u8(out, vqaddq_u8(dst, vcombine_u8(vqmovn_u16(t0), vqmovn_u16(t1))));
+			in += inStep * 4;
+			out += 16;
+		}
+
+		if (x)
+			doBlitAdditiveBlend(in, out, x, 1, pitch, inStep, inoStep, color);
+
+		outo += pitch;
+		ino += inoStep;
+	}
+}
+
+static void subtractiveBlendNEON(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color) {
+	if (inStep != 4 && inStep != -4) {
+		doBlitSubtractiveBlend(ino, outo, width, height, pitch, inStep, inoStep, color);
+		return;
+	}
+
+	const bool flipped = inStep < 0;
+	// Modulated blits make the target opaque
+	const uint8x16_t alphaMask = vreinterpretq_u8_u32(vdupq_n_u32(color != 0xFFFFFFFF ? 0xFF : 0));
+	const uint16_t factorArray[8] = {
+		0, channelFactor(color, 0), channelFactor(color, 8), channelFactor(color, 16),
+		0, channelFactor(color, 0), channelFactor(color, 8), channelFactor(color, 16)
+	};
+	const uint16x8_t factors = vld1q_u16(factorArray);
+
+	for (uint32 i = 0; i < height; i++) {
+		byte *in = ino;
+		byte *out = outo;
+		uint32 x = width;
+
+		for (; x >= 4; x -= 4) {
+			const uint8x16_t src = loadPixelsNEON(in, flipped);
+			const uint8x16_t dst = vld1q_u8(out);
+			const uint8x16_t alpha = alphaNEON(src);
+			const uint16x8_t da0 = vmull_u8(vget_low_u8(dst), vget_low_u8(alpha));
+			const uint16x8_t da1 = vmull_u8(vget_high_u8(dst), vget_high_u8(alpha));
+
+			const uint16x8_t t0 = vshrq_n_u16(mulhiNEON(vmulq_u16(vmovl_u8(vget_low_u8(src)), factors), da0), 8);
+			const uint16x8_t t1 = vshrq_n_u16(mulhiNEON(vmulq_u16(vmovl_u8(vget_high_u8(src)), factors), da1), 8);
+			vst1q_u8(out, vorrq_u8(vqsubq_u8(dst, vcombine_u8(vqmovn_u16(t0), vqmovn_u16(t1))), alphaMask));
+			in += inStep * 4;
+			out += 16;
+		}
+
+		if (x)
+			doBlitSubtractiveBlend(in, out, x, 1, pitch, inStep, inoStep, color);
+
+		outo += pitch;
+		ino += inoStep;
+	}
+}
+
+#endif // SCUMMVM_SIMD_NEON
+
+BlendBlitProc getAlphaBlendProc() {
+#if defined(SCUMMVM_SIMD_X86) && defined(SCUMM_LITTLE_ENDIAN)
+	if (Common::hasCPUFeature(Common::kCPUFeatureAVX2))
+		return alphaBlendAVX2;
+	if (Common::hasCPUFeature(Common::kCPUFeatureSSE2))
+		return alphaBlendSSE2;
+#endif
+#if defined(SCUMMVM_SIMD_NEON) && defined(SCUMM_LITTLE_ENDIAN)
+	if (Common::hasCPUFeature(Common::kCPUFeatureNEON))
+		return alphaBlendNEON;
+#endif
+	return doBlitAlphaBlend;
+}
+
+BlendBlitProc getAdditiveBlendProc() {
+#if defined(SCUMMVM_SIMD_X86) && defined(SCUMM_LITTLE_ENDIAN)
+	if (Common::hasCPUFeature(Common::kCPUFeatureAVX2))
+		return additiveBlendAVX2;
+	if (Common::hasCPUFeature(Common::kCPUFeatureSSE2))
+		return additiveBlendSSE2;
+#endif
+#if defined(SCUMMVM_SIMD_NEON) && defined(SCUMM_LITTLE_ENDIAN)
+	if (Common::hasCPUFeature(Common::kCPUFeatureNEON))
+		return additiveBlendNEON;
+#endif
+	return doBlitAdditiveBlend;
+}
+
+BlendBlitProc getSubtractiveBlendProc() {
+#if defined(SCUMMVM_SIMD_X86) && defined(SCUMM_LITTLE_ENDIAN)
+	if (Common::hasCPUFeature(Common::kCPUFeatureAVX2))
+		return subtractiveBlendAVX2;
+	if (Common::hasCPUFeature(Common::kCPUFeatureSSE2))
+		return subtractiveBlendSSE2;
+#endif
+#if defined(SCUMMVM_SIMD_NEON) && defined(SCUMM_LITTLE_ENDIAN)
+	if (Common::hasCPUFeature(Common::kCPUFeatureNEON))
+		return subtractiveBlendNEON;
+#endif
+	return doBlitSubtractiveBlend;
+}
+
+} // End of namespace Graphics
@@ -0,0 +1,81 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef GRAPHICS_TRANSPARENTSURFACE_KERNELS_H
+#define GRAPHICS_TRANSPARENTSURFACE_KERNELS_H
+
+#include "common/scummsys.h"
+
+namespace Graphics {
+
+/**
+ * A blending kernel composites a width x height block of 32bpp pixels from
+ * ino onto outo, the way TransparentSurface::blit() does.
+ *
+ * @param ino		the first source pixel to draw
+ * @param outo		the first target pixel
+ * @param width		width of the block
+ * @param height	height of the block
+ * @param pitch		pitch of the target surface
+ * @param inStep	distance in bytes between two source pixels of a row,
+ *					negative when flipping horizontally
+ * @param inoStep	distance in bytes between two source rows, negative
+ *					when flipping vertically
+ * @param color		color modulation in 0xAARRGGBB format, 0xFFFFFFFF for
+ *					no modulation
+ *
+ * All kernels produce results which are bit identical to the plain C++
+ * implementations doBlitAlphaBlend, doBlitAdditiveBlend and
+ * doBlitSubtractiveBlend.
+ */
+typedef void (*BlendBlitProc)(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color);
+
+/** Reference implementation of alpha blending. */
+void doBlitAlphaBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color);
+
+/** Reference implementation of additive blending. */
+void doBlitAdditiveBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color);
+
+/** Reference implementation of subtractive blending. */
+void doBlitSubtractiveBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color);
+
+/**
+ * Return the fastest alpha blending kernel supported by the host CPU.
+ * The choice is based on Common::getCPUFeatures().
+ */
+BlendBlitProc getAlphaBlendProc();
+
+/**
+ * Return the fastest additive blending kernel supported by the host CPU.
+ * The choice is based on Common::getCPUFeatures().
+ */
+BlendBlitProc getAdditiveBlendProc();
+
+/**
+ * Return the fastest subtractive blending kernel supported by the host CPU.
+ * The choice is based on Common::getCPUFeatures().
+ */
+BlendBlitProc getSubtractiveBlendProc();
+
+} // End of namespace Graphics
+
+#endif
@@ -83,8 +83,12 @@
 // BASIS, AND BROWN UNIVERSITY HAS NO OBLIGATION TO PROVIDE MAINTENANCE,
 // SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 
+#include "common/atomic.h"
+#include "common/util.h"
+#include "common/workerpool.h"
 #include "graphics/surface.h"
 #include "graphics/yuv_to_rgb.h"
+#include "graphics/yuv_to_rgb_kernels.h"
 
 namespace Common {
 DECLARE_SINGLETON(Graphics::YUVToRGBManager);
@@ -158,7 +162,9 @@ YUVToRGBLookup::YUVToRGBLookup(Graphics::PixelFormat format, YUVToRGBManager::Lu
 }
 
 YUVToRGBManager::YUVToRGBManager() {
-	_lookup = 0;
+	for (int i = 0; i < kMaxLookups; i++)
+		_lookups[i] = 0;
+	_lookupCount = 0;
 
 	int16 *Cr_r_tab = &_colorTab[0 * 256];
 	int16 *Cr_g_tab = &_colorTab[1 * 256];
@@ -180,16 +186,36 @@ YUVToRGBManager::YUVToRGBManager() {
 }
 
 YUVToRGBManager::~YUVToRGBManager() {
-	delete _lookup;
+	for (int i = 0; i < kMaxLookups; i++)
+		delete _lookups[i];
 }
 
 const YUVToRGBLookup *YUVToRGBManager::getLookup(Graphics::PixelFormat format, YUVToRGBManager::LuminanceScale scale) {
-	if (_lookup && _lookup->getFormat() == format && _lookup->getScale() == scale)
-		return _lookup;
+	const uint32 count = MIN<uint32>(Common::atomicLoad(_lookupCount), kMaxLookups);
 
-	delete _lookup;
-	_lookup = new YUVToRGBLookup(format, scale);
-	return _lookup;
+	for (uint32 i = 0; i < count; i++) {
+		// A slot may have been claimed by another thread, but not be
+		// filled in yet
+		const YUVToRGBLookup *lookup = _lookups[i];
+		Common::memoryBarrier();
+
+		if (lookup && lookup->getFormat() == format && lookup->getScale() == scale)
+			return lookup;
+	}
+
+	// Two threads may create the same tables at once. Both are kept, which
+	// does no harm.
+	YUVToRGBLookup *lookup = new YUVToRGBLookup(format, scale);
+	const uint32 index = Common::atomicAdd(_lookupCount, 1) - 1;
+
+	// Should the slots run out, the tables are leaked, as they must not be
+	// freed while in use
+	if (index < kMaxLookups) {
+		Common::memoryBarrier();
+		_lookups[index] = lookup;
+	}
+
+	return lookup;
 }
 
 #define PUT_PIXEL(s, d) \
@@ -233,13 +259,7 @@ void YUVToRGBManager::convert444(Graphics::Surface *dst, YUVToRGBManager::Lumina
 	assert(dst->format.bytesPerPixel == 2 || dst->format.bytesPerPixel == 4);
 	assert(ySrc && uSrc && vSrc);
 
-	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
-
-	// Use a templated function to avoid an if check on every pixel
-	if (dst->format.bytesPerPixel == 2)
-		convertYUV444ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
-	else
-		convertYUV444ToRGB<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+	convert(kLayout444, dst, scale, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
 }
 
 template<typename PixelInt>
@@ -289,13 +309,7 @@ void YUVToRGBManager::convert420(Graphics::Surface *dst, YUVToRGBManager::Lumina
 	assert((yWidth & 1) == 0);
 	assert((yHeight & 1) == 0);
 
-	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
-
-	// Use a templated function to avoid an if check on every pixel
-	if (dst->format.bytesPerPixel == 2)
-		convertYUV420ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
-	else
-		convertYUV420ToRGB<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+	convert(kLayout420, dst, scale, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
 }
 
 #define READ_QUAD(ptr, prefix) \
@@ -374,13 +388,150 @@ void YUVToRGBManager::convert410(Graphics::Surface *dst, YUVToRGBManager::Lumina
 	assert((yWidth & 3) == 0);
 	assert((yHeight & 3) == 0);
 
+	convert(kLayout410, dst, scale, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+}
+
+namespace {
+
+/**
+ * Converts a band of rows of an image. Bands are made of whole chroma rows,
+ * i.e. of 1, 2 or 4 luminance rows for YUV444, YUV420 and YUV410.
+ */
+class YUVToRGBJob : public Common::BandedJob {
+public:
+	YUVToRGBJob(YUVToRGBManager::Layout layout, Graphics::Surface *dst, YUVToRGBManager::LuminanceScale scale, const YUVToRGBLookup *lookup, const int16 *colorTab,
+	            const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yPitch, int uvPitch) :
+		_layout(layout), _dst(dst), _lookup(lookup), _colorTab(colorTab),
+		_ySrc(ySrc), _uSrc(uSrc), _vSrc(vSrc), _yWidth(yWidth), _yPitch(yPitch), _uvPitch(uvPitch),
+		_rowProc(getYUVToRGBRowProc()) {
+		const PixelFormat &format = dst->format;
+		_packing.bytesPerPixel = format.bytesPerPixel;
+		_packing.itu = (scale == YUVToRGBManager::kScaleITU);
+		_packing.alpha = format.ARGBToColor(255, 0, 0, 0);
+		_packing.rLoss = format.rLoss;
+		_packing.gLoss = format.gLoss;
+		_packing.bLoss = format.bLoss;
+		_packing.rShift = format.rShift;
+		_packing.gShift = format.gShift;
+		_packing.bShift = format.bShift;
+	}
+
+	int getRowsPerBand() const {
+		return (_layout == YUVToRGBManager::kLayout444) ? 1 : (_layout == YUVToRGBManager::kLayout420) ? 2 : 4;
+	}
+
+	void runBand(int begin, int end) {
+		const int rows = getRowsPerBand();
+		byte *dstPtr = (byte *)_dst->getBasePtr(0, begin * rows);
+		const byte *ySrc = _ySrc + begin * rows * _yPitch;
+		const byte *uSrc = _uSrc + begin * _uvPitch;
+		const byte *vSrc = _vSrc + begin * _uvPitch;
+		const int yHeight = (end - begin) * rows;
+
+		if (_rowProc)
+			convertRows(dstPtr, ySrc, uSrc, vSrc, yHeight);
+		else if (_dst->format.bytesPerPixel == 2)
+			convertRowsLookup<uint16>(dstPtr, ySrc, uSrc, vSrc, yHeight);
+		else
+			convertRowsLookup<uint32>(dstPtr, ySrc, uSrc, vSrc, yHeight);
+	}
+
+private:
+	YUVToRGBManager::Layout _layout;
+	Graphics::Surface *_dst;
+	const YUVToRGBLookup *_lookup;
+	const int16 *_colorTab;
+	const byte *_ySrc, *_uSrc, *_vSrc;
+	int _yWidth, _yPitch, _uvPitch;
+	YUVToRGBRowProc _rowProc;
+	YUVToRGBPacking _packing;
+
+	// Use templated functions to avoid an if check on every pixel
+	template<typename PixelInt>
+	void convertRowsLookup(byte *dstPtr, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yHeight) {
+		int16 *colorTab = const_cast<int16 *>(_colorTab);
+
+		switch (_layout) {
+		case YUVToRGBManager::kLayout444:
+			convertYUV444ToRGB<PixelInt>(dstPtr, _dst->pitch, _lookup, colorTab, ySrc, uSrc, vSrc, _yWidth, yHeight, _yPitch, _uvPitch);
+			break;
+		case YUVToRGBManager::kLayout420:
+			convertYUV420ToRGB<PixelInt>(dstPtr, _dst->pitch, _lookup, colorTab, ySrc, uSrc, vSrc, _yWidth, yHeight, _yPitch, _uvPitch);
+			break;
+		case YUVToRGBManager::kLayout410:
+			convertYUV410ToRGB<PixelInt>(dstPtr, _dst->pitch, _lookup, colorTab, ySrc, uSrc, vSrc, _yWidth, yHeight, _yPitch, _uvPitch);
+			break;
+		}
+	}
+
+	void convertRows(byte *dstPtr, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yHeight) {
+		switch (_layout) {
+		case YUVToRGBManager::kLayout444:
+			for (int h = 0; h < yHeight; h++) {
+				_rowProc(dstPtr, ySrc, uSrc, vSrc, _yWidth, 0, _packing);
+				dstPtr += _dst->pitch;
+				ySrc += _yPitch;
+				uSrc += _uvPitch;
+				vSrc += _uvPitch;
+			}
+			break;
+
+		case YUVToRGBManager::kLayout420:
+			for (int h = 0; h < yHeight; h += 2) {
+				_rowProc(dstPtr, ySrc, uSrc, vSrc, _yWidth, 1, _packing);
+				_rowProc(dstPtr + _dst->pitch, ySrc + _yPitch, uSrc, vSrc, _yWidth, 1, _packing);
+				dstPtr += _dst->pitch * 2;
+				ySrc += _yPitch * 2;
+				uSrc += _uvPitch;
+				vSrc += _uvPitch;
+			}
+			break;
+
+		case YUVToRGBManager::kLayout410: {
+			byte *chroma = new byte[_yWidth * 2];
+			byte *uRow = chroma;
+			byte *vRow = chroma + _yWidth;
+
+			for (int h = 0; h < yHeight; h++) {
+				// Bilinear interpolation of the chroma values, exactly as
+				// in convertYUV410ToRGB()
+				const int yDiff = h & 3;
+				const int rowIndex = (h >> 2) * _uvPitch;
+
+				for (int x = 0; x < _yWidth / 4; x++) {
+					const int index = rowIndex + x;
+					const byte uA = uSrc[index], uB = uSrc[index + 1], uC = uSrc[index + _uvPitch], uD = uSrc[index + _uvPitch + 1];
+					const byte vA = vSrc[index], vB = vSrc[index + 1], vC = vSrc[index + _uvPitch], vD = vSrc[index + _uvPitch + 1];
+
+					for (int xDiff = 0; xDiff < 4; xDiff++) {
+						uRow[x * 4 + xDiff] = (uA * (4 - xDiff) * (4 - yDiff) + uB * xDiff * (4 - yDiff) + uC * yDiff * (4 - xDiff) + uD * xDiff * yDiff) >> 4;
+						vRow[x * 4 + xDiff] = (vA * (4 - xDiff) * (4 - yDiff) + vB * xDiff * (4 - yDiff) + vC * yDiff * (4 - xDiff) + vD * xDiff * yDiff) >> 4;
+					}
+				}
+
+				_rowProc(dstPtr, ySrc, uRow, vRow, _yWidth & ~3, 0, _packing);
+				dstPtr += _dst->pitch;
+				ySrc += _yPitch;
+			}
+
+			delete[] chroma;
+			break;
+		}
+		}
+	}
+};
+
+} // End of anonymous namespace
+
+void YUVToRGBManager::convert(Layout layout, Graphics::Surface *dst, LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
+	YUVToRGBJob job(layout, dst, scale, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yPitch, uvPitch);
 
-	// Use a templated function to avoid an if check on every pixel
-	if (dst->format.bytesPerPixel == 2)
-		convertYUV410ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
-	else
-		convertYUV410ToRGB<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+	// Rows smaller than this number of pixels are not worth splitting
+	// across the worker threads
+	const int rowsPerBand = job.getRowsPerBand();
+	const int minBandPixels = 16384;
+	Common::runBanded(job, yHeight / rowsPerBand, MAX(minBandPixels / MAX(yWidth * rowsPerBand, 1), 1));
 }
 
 } // End of namespace Graphics
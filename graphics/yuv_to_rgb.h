@@ -105,6 +105,13 @@ public:
 	 */
 	void convert410(Graphics::Surface *dst, LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch);
 
+	/** The chroma subsampling of an image */
+	enum Layout {
+		kLayout444,
+		kLayout420,
+		kLayout410
+	};
+
 private:
 	friend class Common::Singleton<SingletonBaseType>;
 	YUVToRGBManager();
@@ -112,7 +119,27 @@ private:
 
 	const YUVToRGBLookup *getLookup(Graphics::PixelFormat format, LuminanceScale scale);
 
-	YUVToRGBLookup *_lookup;
+	/**
+	 * Convert an image in bands of rows, spread over the worker threads.
+	 * Uses the vectorized row kernels if the CPU supports them, and the
+	 * lookup tables otherwise.
+	 */
+	void convert(Layout layout, Graphics::Surface *dst, LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch);
+
+	enum {
+		/** The number of format and scale combinations converted to at most */
+		kMaxLookups = 16
+	};
+
+	/**
+	 * The lookup tables of all formats and scales converted to so far.
+	 * Conversions may run on several threads, so the tables are kept until
+	 * the manager is destroyed. Slots are claimed through _lookupCount and
+	 * filled without a lock.
+	 */
+	YUVToRGBLookup *volatile _lookups[kMaxLookups];
+	volatile uint32 _lookupCount;
+
 	int16 _colorTab[4 * 256]; // 2048 bytes
 };
 
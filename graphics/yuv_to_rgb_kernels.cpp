@@ -0,0 +1,381 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "graphics/yuv_to_rgb_kernels.h"
+#include "common/cpudetect.h"
+#include "common/util.h"
+
+#ifdef SCUMMVM_SIMD_X86
+#include <emmintrin.h>
+#include <immintrin.h>
+#endif
+
+#ifdef SCUMMVM_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+namespace Graphics {
+
+// The tables of YUVToRGBManager hold (int16)(k * c) for chroma values
+// c = u - 128 or v - 128 and the coefficients
+//
+//   Cr_r:  0.419 / 0.299
+//   Cr_g: -0.299 / 0.419
+//   Cb_g: -0.114 / 0.331
+//   Cb_b:  0.587 / 0.331
+//
+// The kernels compute the same truncated products with integers, as
+// sign(k * c) * (|c| * i + ((|c| * f) >> 16)), where i is the integer part
+// of |k| and f its fraction in 16 bit fixed point. The fractions have been
+// checked to give the exact table values for all chroma values.
+enum {
+	kCrRFraction = 26303,
+	kCrGFraction = 46767,
+	kCbGFraction = 22572,
+	kCbBFraction = 50687
+};
+
+// ITU luminance values are scaled with (value - 16) * 255 / 219. For the
+// possible products the division equals a multiplication with the
+// following factor, keeping the high 16 bits, and a shift.
+enum {
+	kITUFactor = 19153,
+	kITUShift = 6
+};
+
+static inline int chromaTerm(int chroma, int integer, int fraction, bool negative) {
+	const int c = chroma - 128;
+	const int a = ABS(c);
+	const int product = a * integer + ((a * fraction) >> 16);
+	return ((c < 0) != negative) ? -product : product;
+}
+
+static inline uint channelValue(int value, bool itu) {
+	if (!itu)
+		return CLIP(value, 0, 255);
+
+	return (CLIP(value, 16, 235) - 16) * 255 / 219;
+}
+
+void convertYUVToRGBRow(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, int width, int chromaShift, const YUVToRGBPacking &packing) {
+	for (int x = 0; x < width; x++) {
+		const int u = uSrc[x >> chromaShift];
+		const int v = vSrc[x >> chromaShift];
+		const int y = ySrc[x];
+		const int r = y + chromaTerm(v, 1, kCrRFraction, false);
+		const int g = y + chromaTerm(v, 0, kCrGFraction, true) + chromaTerm(u, 0, kCbGFraction, true);
+		const int b = y + chromaTerm(u, 1, kCbBFraction, false);
+
+		const uint32 pixel = packing.alpha |
+			((channelValue(r, packing.itu) >> packing.rLoss) << packing.rShift) |
+			((channelValue(g, packing.itu) >> packing.gLoss) << packing.gShift) |
+			((channelValue(b, packing.itu) >> packing.bLoss) << packing.bShift);
+
+		if (packing.bytesPerPixel == 2)
+			((uint16 *)dst)[x] = pixel;
+		else
+			((uint32 *)dst)[x] = pixel;
+	}
+}
+
+/**
+ * Finish a row with the reference kernel, from pixel x on. For YUV420, x
+ * is always even.
+ */
+static inline void convertRowTail(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, int x, int width, int chromaShift, const YUVToRGBPacking &packing) {
+	if (x < width) {
+		const int c = x >> chromaShift;
+		convertYUVToRGBRow(dst + x * packing.bytesPerPixel, ySrc + x, uSrc + c, vSrc + c, width - x, chromaShift, packing);
+	}
+}
+
+// The vectorized kernels store whole pixels, so they are only built for
+// little endian hosts. All channels are computed on 16 bit lanes, and the
+// shifts of the pixel format are applied with shift counts held in
+// registers, so any format with up to 8 bits per channel is supported.
+
+#if defined(SCUMMVM_SIMD_X86) && defined(SCUMM_LITTLE_ENDIAN)
+
+/**
+ * Load the chroma values of 8 pixels.
+ */
+__attribute__((target("sse2")))
+static inline __m128i loadChromaSSE2(const byte *src, int x, int chromaShift) {
+	if (!chromaShift)
+		return _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(src + x)), _mm_setzero_si128());
+
+	const __m128i c = _mm_cvtsi32_si128(*(const int32 *)(src + (x >> 1)));
+	return _mm_unpacklo_epi8(_mm_unpacklo_epi8(c, c), _mm_setzero_si128());
+}
+
+__attribute__((target("sse2")))
+static inline __m128i chromaTermSSE2(__m128i chroma, int integer, int fraction, bool negative) {
+	const __m128i c = _mm_sub_epi16(chroma, _mm_set1_epi16(128));
+	const __m128i sign = _mm_srai_epi16(c, 15);
+	const __m128i a = _mm_sub_epi16(_mm_xor_si128(c, sign), sign);
+	__m128i product = _mm_mulhi_epu16(a, _mm_set1_epi16((int16)fraction));
+	if (integer)
+		product = _mm_add_epi16(product, a);
+
+	const __m128i resultSign = negative ? _mm_xor_si128(sign, _mm_set1_epi16(-1)) : sign;
+	return _mm_sub_epi16(_mm_xor_si128(product, resultSign), resultSign);
+}
+
+__attribute__((target("sse2")))
+static inline __m128i channelSSE2(__m128i value, bool itu) {
+	if (!itu)
+		return _mm_min_epi16(_mm_max_epi16(value, _mm_setzero_si128()), _mm_set1_epi16(255));
+
+	__m128i scaled = _mm_min_epi16(_mm_max_epi16(value, _mm_set1_epi16(16)), _mm_set1_epi16(235));
+	scaled = _mm_mullo_epi16(_mm_sub_epi16(scaled, _mm_set1_epi16(16)), _mm_set1_epi16(255));
+	return _mm_srli_epi16(_mm_mulhi_epu16(scaled, _mm_set1_epi16(kITUFactor)), kITUShift);
+}
+
+__attribute__((target("sse2")))
+static void convertRowSSE2(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, int width, int chromaShift, const YUVToRGBPacking &packing) {
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i rLoss = _mm_cvtsi32_si128(packing.rLoss);
+	const __m128i gLoss = _mm_cvtsi32_si128(packing.gLoss);
+	const __m128i bLoss = _mm_cvtsi32_si128(packing.bLoss);
+	const __m128i rShift = _mm_cvtsi32_si128(packing.rShift);
+	const __m128i gShift = _mm_cvtsi32_si128(packing.gShift);
+	const __m128i bShift = _mm_cvtsi32_si128(packing.bShift);
+	const __m128i alpha16 = _mm_set1_epi16((int16)packing.alpha);
+	const __m128i alpha32 = _mm_set1_epi32(packing.alpha);
+
+	int x = 0;
+	for (; x + 8 <= width; x += 8) {
+		const __m128i y = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(ySrc + x)), zero);
+		const __m128i u = loadChromaSSE2(uSrc, x, chromaShift);
+		const __m128i v = loadChromaSSE2(vSrc, x, chromaShift);
+
+		const __m128i rValue = _mm_add_epi16(y, chromaTermSSE2(v, 1, kCrRFraction, false));
+		const __m128i gValue = _mm_add_epi16(_mm_add_epi16(y, chromaTermSSE2(v, 0, kCrGFraction, true)), chromaTermSSE2(u, 0, kCbGFraction, true));
+		const __m128i bValue = _mm_add_epi16(y, chromaTermSSE2(u, 1, kCbBFraction, false));
+
+		const __m128i r = _mm_srl_epi16(channelSSE2(rValue, packing.itu), rLoss);
+		const __m128i g = _mm_srl_epi16(channelSSE2(gValue, packing.itu), gLoss);
+		const __m128i b = _mm_srl_epi16(channelSSE2(bValue, packing.itu), bLoss);
+
+		if (packing.bytesPerPixel == 2) {
+			const __m128i pixels = _mm_or_si128(_mm_or_si128(alpha16, _mm_sll_epi16(r, rShift)),
+			                                    _mm_or_si128(_mm_sll_epi16(g, gShift), _mm_sll_epi16(b, bShift)));
+			_mm_storeu_si128((__m128i *)(dst + x * 2), pixels);
+		} else {
+			const __m128i lo = _mm_or_si128(_mm_or_si128(alpha32, _mm_sll_epi32(_mm_unpacklo_epi16(r, zero), rShift)),
+			                                _mm_or_si128(_mm_sll_epi32(_mm_unpacklo_epi16(g, zero), gShift), _mm_sll_epi32(_mm_unpacklo_epi16(b, zero), bShift)));
+			const __m128i hi = _mm_or_si128(_mm_or_si128(alpha32, _mm_sll_epi32(_mm_unpackhi_epi16(r, zero), rShift)),
+			                                _mm_or_si128(_mm_sll_epi32(_mm_unpackhi_epi16(g, zero), gShift), _mm_sll_epi32(_mm_unpackhi_epi16(b, zero), bShift)));
+			_mm_storeu_si128((__m128i *)(dst + x * 4), lo);
+			_mm_storeu_si128((__m128i *)(dst + x * 4 + 16), hi);
+		}
+	}
+
+	convertRowTail(dst, ySrc, uSrc, vSrc, x, width, chromaShift, packing);
+}
+
+/**
+ * Load the chroma values of 16 pixels.
+ */
+__attribute__((target("avx2")))
+static inline __m256i loadChromaAVX2(const byte *src, int x, int chromaShift) {
+	if (!chromaShift)
+		return _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(src + x)));
+
+	const __m128i c = _mm_loadl_epi64((const __m128i *)(src + (x >> 1)));
+	return _mm256_cvtepu8_epi16(_mm_unpacklo_epi8(c, c));
+}
+
+__attribute__((target("avx2")))
+static inline __m256i chromaTermAVX2(__m256i chroma, int integer, int fraction, bool negative) {
+	const __m256i c = _mm256_sub_epi16(chroma, _mm256_set1_epi16(128));
+	const __m256i a = _mm256_abs_epi16(c);
+	__m256i product = _mm256_mulhi_epu16(a, _mm256_set1_epi16((int16)fraction));
+	if (integer)
+		product = _mm256_add_epi16(product, a);
+
+	// The sign of c is applied to the product, which is 0 for c == 0
+	return _mm256_sign_epi16(product, negative ? _mm256_sub_epi16(_mm256_setzero_si256(), c) : c);
+}
+
+__attribute__((target("avx2")))
+static inline __m256i channelAVX2(__m256i value, bool itu) {
+	if (!itu)
+		return _mm256_min_epi16(_mm256_max_epi16(value, _mm256_setzero_si256()), _mm256_set1_epi16(255));
+
+	__m256i scaled = _mm256_min_epi16(_mm256_max_epi16(value, _mm256_set1_epi16(16)), _mm256_set1_epi16(235));
+	scaled = _mm256_mullo_epi16(_mm256_sub_epi16(scaled, _mm256_set1_epi16(16)), _mm256_set1_epi16(255));
+	return _mm256_srli_epi16(_mm256_mulhi_epu16(scaled, _mm256_set1_epi16(kITUFactor)), kITUShift);
+}
+
+__attribute__((target("avx2")))
+static inline __m256i packPixels32AVX2(__m128i r, __m128i g, __m128i b, __m256i alpha, __m128i rShift, __m128i gShift, __m128i bShift) {
+	return _mm256_or_si256(_mm256_or_si256(alpha, _mm256_sll_epi32(_mm256_cvtepu16_epi32(r), rShift)),
+	                       _mm256_or_si256(_mm256_sll_epi32(_mm256_cvtepu16_epi32(g), gShift), _mm256_sll_epi32(_mm256_cvtepu16_epi32(b), bShift)));
+}
+
+__attribute__((target("avx2")))
+static void convertRowAVX2(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, int width, int chromaShift, const YUVToRGBPacking &packing) {
+	const __m128i rLoss = _mm_cvtsi32_si128(packing.rLoss);
+	const __m128i gLoss = _mm_cvtsi32_si128(packing.gLoss);
+	const __m128i bLoss = _mm_cvtsi32_si128(packing.bLoss);
+	const __m128i rShift = _mm_cvtsi32_si128(packing.rShift);
+	const __m128i gShift = _mm_cvtsi32_si128(packing.gShift);
+	const __m128i bShift = _mm_cvtsi32_si128(packing.bShift);
+	const __m256i alpha16 = _mm256_set1_epi16((int16)packing.alpha);
+	const __m256i alpha32 = _mm256_set1_epi32(packing.alpha);
+
+	int x = 0;
+	for (; x + 16 <= width; x += 16) {
+		const __m256i y = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(ySrc + x)));
+		const __m256i u = loadChromaAVX2(uSrc, x, chromaShift);
+		const __m256i v = loadChromaAVX2(vSrc, x, chromaShift);
+
+		const __m256i rValue = _mm256_add_epi16(y, chromaTermAVX2(v, 1, kCrRFraction, false));
+		const __m256i gValue = _mm256_add_epi16(_mm256_add_epi16(y, chromaTermAVX2(v, 0, kCrGFraction, true)), chromaTermAVX2(u, 0, kCbGFraction, true));
+		const __m256i bValue = _mm256_add_epi16(y, chromaTermAVX2(u, 1, kCbBFraction, false));
+
+		const __m256i r = _mm256_srl_epi16(channelAVX2(rValue, packing.itu), rLoss);
+		const __m256i g = _mm256_srl_epi16(channelAVX2(gValue, packing.itu), gLoss);
+		const __m256i b = _mm256_srl_epi16(channelAVX2(bValue, packing.itu), bLoss);
+
+		if (packing.bytesPerPixel == 2) {
+			const __m256i pixels = _mm256_or_si256(_mm256_or_si256(alpha16, _mm256_sll_epi16(r, rShift)),
+			                                       _mm256_or_si256(_mm256_sll_epi16(g, gShift), _mm256_sll_epi16(b, bShift)));
+			_mm256_storeu_si256((__m256i *)(dst + x * 2), pixels);
+		} else {
+			const __m256i lo = packPixels32AVX2(_mm256_castsi256_si128(r), _mm256_castsi256_si128(g), _mm256_castsi256_si128(b), alpha32, rShift, gShift, bShift);
+			const __m256i hi = packPixels32AVX2(_mm256_extracti128_si256(r, 1), _mm256_extracti128_si256(g, 1), _mm256_extracti128_si256(b, 1), alpha32, rShift, gShift, bShift);
+			_mm256_storeu_si256((__m256i *)(dst + x * 4), lo);
+			_mm256_storeu_si256((__m256i *)(dst + x * 4 + 32), hi);
+		}
+	}
+
+	if (x < width) {
+		const int c = x >> chromaShift;
+		convertRowSSE2(dst + x * packing.bytesPerPixel, ySrc + x, uSrc + c, vSrc + c, width - x, chromaShift, packing);
+	}
+}
+
+#endif // SCUMMVM_SIMD_X86
+
+#if defined(SCUMMVM_SIMD_NEON) && defined(SCUMM_LITTLE_ENDIAN)
+
+/**
+ * Load the chroma values of 8 pixels.
+ */
+static inline int16x8_t loadChromaNEON(const byte *src, int x, int chromaShift) {
+	if (!chromaShift)
+		return vreinterpretq_s16_u16(vmovl_u8(vld1_u8(src + x)));
+
+	uint32 quad;
+	memcpy(&quad, src + (x >> 1), 4);
+	const uint8x8_t c = vreinterpret_u8_u32(vdup_n_u32(quad));
+	return vreinterpretq_s16_u16(vmovl_u8(vzip_u8(c, c).val[0]));
+}
+
+static inline int16x8_t chromaTermNEON(int16x8_t chroma, int integer, int fraction, bool negative) {
+	const int16x8_t c = vsubq_s16(chroma, vdupq_n_s16(128));
+	const uint16x8_t a = vreinterpretq_u16_s16(vabsq_s16(c));
+	const uint16x4_t lo = vshrn_n_u32(vmull_n_u16(vget_low_u16(a), fraction), 16);
+	const uint16x4_t hi = vshrn_n_u32(vmull_n_u16(vget_high_u16(a), fraction), 16);
+	int16x8_t product = vreinterpretq_s16_u16(vcombine_u16(lo, hi));
+	if (integer)
+		product = vaddq_s16(product, vreinterpretq_s16_u16(a));
+
+	const uint16x8_t negate = negative ? vcgtq_s16(c, vdupq_n_s16(0)) : vcltq_s16(c, vdupq_n_s16(0));
+	return vbslq_s16(negate, vnegq_s16(product), product);
+}
+
+static inline uint16x8_t channelNEON(int16x8_t value, bool itu) {
+	if (!itu)
+		return vreinterpretq_u16_s16(vminq_s16(vmaxq_s16(value, vdupq_n_s16(0)), vdupq_n_s16(255)));
+
+	const uint16x8_t scaled = vmulq_n_u16(vreinterpretq_u16_s16(vsubq_s16(vminq_s16(vmaxq_s16(value, vdupq_n_s16(16)), vdupq_n_s16(235)), vdupq_n_s16(16))), 255);
+	const uint16x4_t lo = vshrn_n_u32(vmull_n_u16(vget_low_u16(scaled), kITUFactor), 16);
+	const uint16x4_t hi = vshrn_n_u32(vmull_n_u16(vget_high_u16(scaled), kITUFactor), 16);
+	return vshrq_n_u16(vcombine_u16(lo, hi), kITUShift);
+}
+
+static inline uint32x4_t packPixels32NEON(uint16x4_t r, uint16x4_t g, uint16x4_t b, uint32x4_t alpha, int32x4_t rShift, int32x4_t gShift, int32x4_t bShift) {
+	return vorrq_u32(vorrq_u32(alpha, vshlq_u32(vmovl_u16(r), rShift)),
+	                 vorrq_u32(vshlq_u32(vmovl_u16(g), gShift), vshlq_u32(vmovl_u16(b), bShift)));
+}
+
+static void convertRowNEON(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, int width, int chromaShift, const YUVToRGBPacking &packing) {
+	// NEON shifts right by shifting left with a negative count
+	const int16x8_t rLoss = vdupq_n_s16(-packing.rLoss);
+	const int16x8_t gLoss = vdupq_n_s16(-packing.gLoss);
+	const int16x8_t bLoss = vdupq_n_s16(-packing.bLoss);
+	const int16x8_t rShift16 = vdupq_n_s16(packing.rShift);
+	const int16x8_t gShift16 = vdupq_n_s16(packing.gShift);
+	const int16x8_t bShift16 = vdupq_n_s16(packing.bShift);
+	const int32x4_t rShift32 = vdupq_n_s32(packing.rShift);
+	const int32x4_t gShift32 = vdupq_n_s32(packing.gShift);
+	const int32x4_t bShift32 = vdupq_n_s32(packing.bShift);
+	const uint16x8_t alpha16 = vdupq_n_u16((uint16)packing.alpha);
+	const uint32x4_t alpha32 = vdupq_n_u32(packing.alpha);
+
+	int x = 0;
+	for (; x + 8 <= width; x += 8) {
+		const int16x8_t y = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(ySrc + x)));
+		const int16x8_t u = loadChromaNEON(uSrc, x, chromaShift);
+		const int16x8_t v = loadChromaNEON(vSrc, x, chromaShift);
+
+		const int16x8_t rValue = vaddq_s16(y, chromaTermNEON(v, 1, kCrRFraction, false));
+		const int16x8_t gValue = vaddq_s16(vaddq_s16(y, chromaTermNEON(v, 0, kCrGFraction, true)), chromaTermNEON(u, 0, kCbGFraction, true));
+		const int16x8_t bValue = vaddq_s16(y, chromaTermNEON(u, 1, kCbBFraction, false));
+
+		const uint16x8_t r = vshlq_u16(channelNEON(rValue, packing.itu), rLoss);
+		const uint16x8_t g = vshlq_u16(channelNEON(gValue, packing.itu), gLoss);
+		const uint16x8_t b = vshlq_u16(channelNEON(bValue, packing.itu), bLoss);
+
+		if (packing.bytesPerPixel == 2) {
+			const uint16x8_t pixels = vorrq_u16(vorrq_u16(alpha16, vshlq_u16(r, rShift16)),
+			                                    vorrq_u16(vshlq_u16(g, gShift16), vshlq_u16(b, bShift16)));
+			vst1q_u16((uint16_t *)(dst + x * 2), pixels);
+		} else {
+			vst1q_u32((uint32_t *)(dst + x * 4), packPixels32NEON(vget_low_u16(r), vget_low_u16(g), vget_low_u16(b), alpha32, rShift32, gShift32, bShift32));
+			vst1q_u32((uint32_t *)(dst + x * 4 + 16), packPixels32NEON(vget_high_u16(r), vget_high_u16(g), vget_high_u16(b), alpha32, rShift32, gShift32, bShift32));
+		}
+	}
+
+	convertRowTail(dst, ySrc, uSrc, vSrc, x, width, chromaShift, packing);
+}
+
+#endif // SCUMMVM_SIMD_NEON
+
+YUVToRGBRowProc getYUVToRGBRowProc() {
+#if defined(SCUMMVM_SIMD_X86) && defined(SCUMM_LITTLE_ENDIAN)
+	if (Common::hasCPUFeature(Common::kCPUFeatureAVX2))
+		return convertRowAVX2;
+	if (Common::hasCPUFeature(Common::kCPUFeatureSSE2))
+		return convertRowSSE2;
+#endif
+#if defined(SCUMMVM_SIMD_NEON) && defined(SCUMM_LITTLE_ENDIAN)
+	if (Common::hasCPUFeature(Common::kCPUFeatureNEON))
+		return convertRowNEON;
+#endif
+	return nullptr;
+}
+
+} // End of namespace Graphics
@@ -0,0 +1,72 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef GRAPHICS_YUV_TO_RGB_KERNELS_H
+#define GRAPHICS_YUV_TO_RGB_KERNELS_H
+
+#include "common/scummsys.h"
+
+namespace Graphics {
+
+/**
+ * How the color channels are stored in a pixel of the target surface. This
+ * is the subset of PixelFormat the row kernels need, with the alpha bits of
+ * an opaque pixel precomputed.
+ */
+struct YUVToRGBPacking {
+	int bytesPerPixel;
+	/** Whether the luminance values range from 16 to 235 (ITU-R BT.601) */
+	bool itu;
+	uint32 alpha;
+	byte rLoss, gLoss, bLoss;
+	byte rShift, gShift, bShift;
+};
+
+/**
+ * A row kernel converts one row of YUV pixels to RGB pixels, with the same
+ * results as the lookup tables of YUVToRGBManager.
+ *
+ * @param dst			the first target pixel
+ * @param ySrc			the luminance values
+ * @param uSrc			the u values
+ * @param vSrc			the v values
+ * @param width			the number of pixels
+ * @param chromaShift	0 if every pixel has its own chroma values, 1 if two
+ *						neighbouring pixels share them (YUV420)
+ * @param packing		the target pixel format
+ */
+typedef void (*YUVToRGBRowProc)(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, int width, int chromaShift, const YUVToRGBPacking &packing);
+
+/** Reference implementation of a row kernel. */
+void convertYUVToRGBRow(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, int width, int chromaShift, const YUVToRGBPacking &packing);
+
+/**
+ * Return the fastest vectorized row kernel supported by the host CPU, or
+ * nullptr if there is none. The lookup tables beat the reference row
+ * kernel, so it is not returned. The choice is based on
+ * Common::getCPUFeatures().
+ */
+YUVToRGBRowProc getYUVToRGBRowProc();
+
+} // End of namespace Graphics
+
+#endif
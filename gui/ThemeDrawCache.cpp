@@ -0,0 +1,205 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "gui/ThemeDrawCache.h"
+
+namespace GUI {
+
+bool ThemeDrawCache::Key::operator==(const Key &other) const {
+	return drawData == other.drawData &&
+		width == other.width &&
+		height == other.height &&
+		dynamicData == other.dynamicData &&
+		rendererState == other.rendererState &&
+		clipped == other.clipped;
+}
+
+bool ThemeDrawCache::EntryKey::operator==(const EntryKey &other) const {
+	return key == other.key && backgroundHash == other.backgroundHash;
+}
+
+uint ThemeDrawCache::EntryKeyHash::operator()(const EntryKey &key) const {
+	uint hash = (uint)(size_t)key.key.drawData;
+	hash = hash * 31 + ((key.key.width << 16) ^ key.key.height);
+	hash = hash * 31 + key.key.dynamicData;
+	hash = hash * 31 + key.key.rendererState.hash();
+	hash = hash * 31 + key.key.clipped;
+	hash = hash * 31 + key.backgroundHash;
+	return hash;
+}
+
+ThemeDrawCache::ThemeDrawCache(uint32 maxBytes) : _pendingValid(false), _pendingHash(0), _maxBytes(maxBytes), _bytes(0), _hits(0), _misses(0) {
+}
+
+ThemeDrawCache::~ThemeDrawCache() {
+	clear();
+}
+
+bool ThemeDrawCache::draw(const Key &key, Graphics::Surface *surface, const Common::Rect &area) {
+	++_misses;
+	_pendingValid = false;
+
+	if (!isCacheable(surface, area))
+		return false;
+
+	EntryKey entryKey;
+	entryKey.key = key;
+	entryKey.backgroundHash = hashArea(surface, area);
+
+	EntryMap::iterator i = _entries.find(entryKey);
+	if (i != _entries.end() && areaEquals(surface, area, i->_value->background)) {
+		Entry *entry = i->_value;
+		surface->copyRectToSurface(entry->rendering, area.left, area.top, Common::Rect(entry->rendering.w, entry->rendering.h));
+
+		if (entry->lruPosition != _lru.begin()) {
+			_lru.erase(entry->lruPosition);
+			_lru.push_front(entry);
+			entry->lruPosition = _lru.begin();
+		}
+
+		--_misses;
+		++_hits;
+		return true;
+	}
+
+	copyFromArea(_pendingBackground, surface, area);
+	_pendingHash = entryKey.backgroundHash;
+	_pendingValid = true;
+	return false;
+}
+
+void ThemeDrawCache::store(const Key &key, const Graphics::Surface *surface, const Common::Rect &area) {
+	if (!_pendingValid || _pendingBackground.w != area.width() || _pendingBackground.h != area.height())
+		return;
+	_pendingValid = false;
+
+	EntryKey entryKey;
+	entryKey.key = key;
+	entryKey.backgroundHash = _pendingHash;
+
+	// A rendering with the same key was drawn on a different background
+	// which happens to have the same hash. Keep the most recent one.
+	EntryMap::iterator i = _entries.find(entryKey);
+	if (i != _entries.end())
+		removeEntry(i->_value);
+
+	const uint32 size = 2 * _pendingBackground.pitch * _pendingBackground.h;
+	shrink(_maxBytes > size ? _maxBytes - size : 0);
+
+	Entry *entry = new Entry();
+	entry->key = entryKey;
+	entry->background = _pendingBackground;
+	_pendingBackground = Graphics::Surface();
+	copyFromArea(entry->rendering, surface, area);
+
+	_lru.push_front(entry);
+	entry->lruPosition = _lru.begin();
+	_entries[entryKey] = entry;
+	_bytes += size;
+}
+
+void ThemeDrawCache::clear() {
+	while (!_lru.empty())
+		removeEntry(_lru.front());
+	_pendingBackground.free();
+	_pendingValid = false;
+}
+
+void ThemeDrawCache::setMaxBytes(uint32 maxBytes) {
+	_maxBytes = maxBytes;
+	shrink(maxBytes);
+}
+
+void ThemeDrawCache::resetStats() {
+	_hits = 0;
+	_misses = 0;
+}
+
+uint32 ThemeDrawCache::hashArea(const Graphics::Surface *surface, const Common::Rect &area) {
+	const uint32 rowBytes = area.width() * surface->format.bytesPerPixel;
+	uint32 hash = 2166136261u;
+
+	for (int y = area.top; y < area.bottom; ++y) {
+		const byte *src = (const byte *)surface->getBasePtr(area.left, y);
+
+		if (surface->format.bytesPerPixel == 2) {
+			const uint16 *pixels = (const uint16 *)src;
+			for (uint32 x = 0; x < rowBytes / 2; ++x)
+				hash = (hash ^ pixels[x]) * 16777619;
+		} else if (surface->format.bytesPerPixel == 4) {
+			const uint32 *pixels = (const uint32 *)src;
+			for (uint32 x = 0; x < rowBytes / 4; ++x)
+				hash = (hash ^ pixels[x]) * 16777619;
+		} else {
+			for (uint32 x = 0; x < rowBytes; ++x)
+				hash = (hash ^ src[x]) * 16777619;
+		}
+	}
+
+	return hash;
+}
+
+bool ThemeDrawCache::areaEquals(const Graphics::Surface *surface, const Common::Rect &area, const Graphics::Surface &pixels) {
+	const uint32 rowBytes = area.width() * surface->format.bytesPerPixel;
+
+	for (int y = 0; y < pixels.h; ++y) {
+		if (memcmp(surface->getBasePtr(area.left, area.top + y), pixels.getBasePtr(0, y), rowBytes) != 0)
+			return false;
+	}
+
+	return true;
+}
+
+void ThemeDrawCache::copyFromArea(Graphics::Surface &dst, const Graphics::Surface *surface, const Common::Rect &area) {
+	if (dst.w != area.width() || dst.h != area.height() || dst.format != surface->format) {
+		dst.free();
+		dst.create(area.width(), area.height(), surface->format);
+	}
+
+	dst.copyRectToSurface(surface->getBasePtr(area.left, area.top), surface->pitch, 0, 0, area.width(), area.height());
+}
+
+bool ThemeDrawCache::isCacheable(const Graphics::Surface *surface, const Common::Rect &area) const {
+	if (area.isEmpty() || area.left < 0 || area.top < 0 || area.right > surface->w || area.bottom > surface->h)
+		return false;
+
+	// Very large areas like dialog backgrounds would push everything else
+	// out of the cache
+	const uint32 size = 2 * area.width() * area.height() * surface->format.bytesPerPixel;
+	return size <= _maxBytes / 4;
+}
+
+void ThemeDrawCache::removeEntry(Entry *entry) {
+	_bytes -= 2 * entry->background.pitch * entry->background.h;
+	_entries.erase(entry->key);
+	_lru.erase(entry->lruPosition);
+	entry->background.free();
+	entry->rendering.free();
+	delete entry;
+}
+
+void ThemeDrawCache::shrink(uint32 maxBytes) {
+	while (_bytes > maxBytes && !_lru.empty())
+		removeEntry(_lru.back());
+}
+
+} // End of namespace GUI
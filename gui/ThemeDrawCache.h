@@ -0,0 +1,164 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef GUI_THEME_DRAW_CACHE_H
+#define GUI_THEME_DRAW_CACHE_H
+
+#include "common/hashmap.h"
+#include "common/list.h"
+#include "common/noncopyable.h"
+#include "common/rect.h"
+
+#include "graphics/surface.h"
+#include "graphics/VectorRendererState.h"
+
+namespace GUI {
+
+/**
+ * A bounded cache of rasterized DrawData items.
+ *
+ * The draw steps of a DrawData item blend with the pixels below them
+ * (anti-aliased edges, shadows, rounded corners), so a rendering is stored
+ * together with the background it was drawn on. It is only reused when the
+ * area to draw on holds exactly the same pixels, in which case the result
+ * of the draw steps is copied with a plain blit instead of rasterizing them
+ * again.
+ *
+ * The least recently used renderings are dropped once the cached pixels
+ * exceed the memory budget. The owner must clear() the cache whenever the
+ * draw steps or the pixel format change.
+ */
+class ThemeDrawCache : Common::NonCopyable {
+public:
+	/**
+	 * Identifies what was drawn, independently of where it was drawn.
+	 */
+	struct Key {
+		/** The draw steps, only valid until the theme is unloaded */
+		const void *drawData;
+		/** Size of the area the steps were drawn into */
+		int16 width;
+		int16 height;
+		/** Dynamic data passed to the steps */
+		uint32 dynamicData;
+		/** State the steps inherit from the renderer */
+		Graphics::VectorRendererState rendererState;
+		/** Whether the steps were drawn with the clipping variants */
+		bool clipped;
+
+		bool operator==(const Key &other) const;
+	};
+
+	/**
+	 * Create a cache holding at most maxBytes bytes of pixels.
+	 */
+	explicit ThemeDrawCache(uint32 maxBytes = 4 * 1024 * 1024);
+	~ThemeDrawCache();
+
+	/**
+	 * Draw a cached rendering into the given area of the surface.
+	 *
+	 * The area must cover all pixels touched by the draw steps. On a cache
+	 * miss the current contents of the area are remembered, so that the
+	 * caller can draw the steps and call store() with the same arguments.
+	 *
+	 * @return true if the area was drawn, false on a cache miss
+	 */
+	bool draw(const Key &key, Graphics::Surface *surface, const Common::Rect &area);
+
+	/**
+	 * Cache the contents of the area after the draw steps were drawn. Must
+	 * follow a call to draw() with the same arguments which returned false.
+	 */
+	void store(const Key &key, const Graphics::Surface *surface, const Common::Rect &area);
+
+	/**
+	 * Drop all renderings.
+	 */
+	void clear();
+
+	/**
+	 * Change the memory budget, dropping renderings if needed.
+	 */
+	void setMaxBytes(uint32 maxBytes);
+	uint32 getMaxBytes() const { return _maxBytes; }
+
+	/** Return the number of bytes of pixels currently cached. */
+	uint32 getBytes() const { return _bytes; }
+
+	/** Return the number of draws served from the cache. */
+	uint32 getHits() const { return _hits; }
+	/** Return the number of draws which had to rasterize the draw steps. */
+	uint32 getMisses() const { return _misses; }
+	void resetStats();
+
+private:
+	/** Key of the map, which also identifies the background */
+	struct EntryKey {
+		Key key;
+		uint32 backgroundHash;
+
+		bool operator==(const EntryKey &other) const;
+	};
+
+	struct EntryKeyHash {
+		uint operator()(const EntryKey &key) const;
+	};
+
+	struct Entry;
+	typedef Common::List<Entry *> LRUList;
+	typedef Common::HashMap<EntryKey, Entry *, EntryKeyHash> EntryMap;
+
+	struct Entry {
+		EntryKey key;
+		Graphics::Surface background;
+		Graphics::Surface rendering;
+		LRUList::iterator lruPosition;
+	};
+
+	static uint32 hashArea(const Graphics::Surface *surface, const Common::Rect &area);
+	static bool areaEquals(const Graphics::Surface *surface, const Common::Rect &area, const Graphics::Surface &pixels);
+	static void copyFromArea(Graphics::Surface &dst, const Graphics::Surface *surface, const Common::Rect &area);
+
+	bool isCacheable(const Graphics::Surface *surface, const Common::Rect &area) const;
+	void removeEntry(Entry *entry);
+	void shrink(uint32 maxBytes);
+
+	EntryMap _entries;
+	/** Most recently used entries first */
+	LRUList _lru;
+
+	/** Background of the area passed to the last draw() which missed */
+	Graphics::Surface _pendingBackground;
+	bool _pendingValid;
+	uint32 _pendingHash;
+
+	uint32 _maxBytes;
+	uint32 _bytes;
+
+	uint32 _hits;
+	uint32 _misses;
+};
+
+} // End of namespace GUI
+
+#endif
@@ -267,6 +267,47 @@ static const DrawDataInfo kDrawDataDefaults[] = {
 /**********************************************************
  * ThemeItem functions for drawing queues.
  *********************************************************/
+
+/**
+ * Draws the steps of a DrawData item, or copies a previous rendering of the
+ * same item from the draw cache. extendedRect must cover all the pixels the
+ * steps may touch, and clip is null when drawing without clipping.
+ */
+static void drawCachedSteps(ThemeEngine *engine, const WidgetDrawData *data, const Common::Rect &area, const Common::Rect &extendedRect, const Common::Rect *clip, uint32 dynamicData) {
+	Graphics::VectorRenderer *renderer = engine->renderer();
+	ThemeDrawCache &cache = engine->drawCache();
+
+	// A rendering only depends on the position of the clipping rect when
+	// it actually clips something
+	const bool useCache = !clip || clip->contains(extendedRect);
+
+	ThemeDrawCache::Key key;
+	key.drawData = data;
+	key.width = area.width();
+	key.height = area.height();
+	key.dynamicData = dynamicData;
+	key.rendererState = renderer->getState();
+	key.clipped = clip != nullptr;
+
+	Common::List<Graphics::DrawStep>::const_iterator step;
+	if (useCache && cache.draw(key, renderer->getSurface(), extendedRect)) {
+		// Later items may inherit colors from these steps
+		for (step = data->_steps.begin(); step != data->_steps.end(); ++step)
+			renderer->applyStepState(*step, dynamicData);
+		return;
+	}
+
+	for (step = data->_steps.begin(); step != data->_steps.end(); ++step) {
+		if (clip)
+			renderer->drawStepClip(area, *clip, *step, dynamicData);
+		else
+			renderer->drawStep(area, *step, dynamicData);
+	}
+
+	if (useCache)
+		cache.store(key, renderer->getSurface(), extendedRect);
+}
+
 void ThemeItemDrawData::drawSelf(bool draw, bool restore) {
 
 	Common::Rect extendedRect = _area;
@@ -275,11 +316,8 @@ void ThemeItemDrawData::drawSelf(bool draw, bool restore) {
 	if (restore)
 		_engine->restoreBackground(extendedRect);
 
-	if (draw) {
-		Common::List<Graphics::DrawStep>::const_iterator step;
-		for (step = _data->_steps.begin(); step != _data->_steps.end(); ++step)
-			_engine->renderer()->drawStep(_area, *step, _dynamicData);
-	}
+	if (draw)
+		drawCachedSteps(_engine, _data, _area, extendedRect, nullptr, _dynamicData);
 
 	_engine->addDirtyRect(extendedRect);
 }
@@ -292,12 +330,8 @@ void ThemeItemDrawDataClip::drawSelf(bool draw, bool restore) {
 	if (restore)
 		_engine->restoreBackground(extendedRect);
 
-	if (draw) {
-		Common::List<Graphics::DrawStep>::const_iterator step;
-		for (step = _data->_steps.begin(); step != _data->_steps.end(); ++step) {
-			_engine->renderer()->drawStepClip(_area, _clip, *step, _dynamicData);
-		}
-	}
+	if (draw)
+		drawCachedSteps(_engine, _data, _area, extendedRect, &_clip, _dynamicData);
 
 	extendedRect.clip(_clip);
 
@@ -638,6 +672,9 @@ void ThemeEngine::setGraphicsMode(GraphicsMode mode) {
 	_vectorRenderer = Graphics::createRenderer(mode);
 	_vectorRenderer->setSurface(&_screen);
 
+	// The cached renderings may have a different size or pixel format
+	_drawCache.clear();
+
 	// Since we reinitialized our screen surfaces we know nothing has been
 	// drawn so far. Sometimes we still end up with dirty screen bits in the
 	// list. Clearing it avoids invalid overlay writes when the backend
@@ -897,6 +934,9 @@ void ThemeEngine::loadTheme(const Common::String &themeId) {
 }
 
 void ThemeEngine::unloadTheme() {
+	// The cached renderings refer to the draw steps of the theme
+	_drawCache.clear();
+
 	if (!_themeOk)
 		return;
 
@@ -1868,6 +1908,9 @@ void ThemeEngine::updateScreen(bool render) {
 	}
 
 	if (render) {
+		debug(7, "ThemeEngine: draw cache hits %u, misses %u, %u bytes", _drawCache.getHits(), _drawCache.getMisses(), _drawCache.getBytes());
+		_drawCache.resetStats();
+
 #ifdef LAYOUT_DEBUG_DIALOG
 		_vectorRenderer->fillSurface();
 		_themeEval->debugDraw(&_screen, _font);
@@ -36,6 +36,8 @@
 #include "graphics/font.h"
 #include "graphics/pixelformat.h"
 
+#include "gui/ThemeDrawCache.h"
+
 
 #define SCUMMVM_THEME_VERSION_STR "SCUMMVM_STX0.8.23"
 
@@ -543,6 +545,7 @@ public:
 
 	inline ThemeEval *getEvaluator() { return _themeEval; }
 	inline Graphics::VectorRenderer *renderer() { return _vectorRenderer; }
+	inline ThemeDrawCache &drawCache() { return _drawCache; }
 
 	inline bool supportsImages() const { return true; }
 	inline bool ownCursor() const { return _useCursor; }
@@ -683,6 +686,9 @@ protected:
 	/** Vector Renderer object, does the actual drawing on screen */
 	Graphics::VectorRenderer *_vectorRenderer;
 
+	/** Renderings of DrawData items, reused when redrawing the same widgets */
+	ThemeDrawCache _drawCache;
+
 	/** XML Parser, does the Theme parsing instead of the default parser */
 	GUI::ThemeParser *_parser;
 
@@ -0,0 +1,53 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef GUI_LAUNCHER_ENTRY_H
+#define GUI_LAUNCHER_ENTRY_H
+
+#include "common/str.h"
+
+namespace GUI {
+
+/** A game target as listed by the launcher. */
+struct LauncherEntry {
+	Common::String key;
+	Common::String description;
+
+	LauncherEntry(const Common::String &k, const Common::String &d) : key(k), description(d) {}
+};
+
+/**
+ * Orders launcher entries by description, ignoring case, and entries with
+ * the same description by target name.
+ */
+struct LauncherEntryComparator {
+	bool operator()(const LauncherEntry &x, const LauncherEntry &y) const {
+		const int cmp = scumm_stricmp(x.description.c_str(), y.description.c_str());
+		if (cmp != 0)
+			return cmp < 0;
+		return x.key < y.key;
+	}
+};
+
+} // End of namespace GUI
+
+#endif
@@ -22,6 +22,7 @@
 
 #include "base/version.h"
 
+#include "common/algorithm.h"
 #include "common/config-manager.h"
 #include "common/events.h"
 #include "common/fs.h"
@@ -30,11 +31,14 @@
 #include "common/system.h"
 #include "common/translation.h"
 
+#include "engines/detectioncache.h"
+
 #include "gui/about.h"
 #include "gui/browser.h"
 #include "gui/chooser.h"
 #include "gui/editgamedialog.h"
 #include "gui/launcher.h"
+#include "gui/launcher-entry.h"
 #include "gui/massadd.h"
 #include "gui/message.h"
 #include "gui/gui-manager.h"
@@ -245,11 +249,11 @@ void LauncherDialog::close() {
 }
 
 void LauncherDialog::updateListing() {
-	StringArray l;
+	Common::Array<LauncherEntry> entries;
 
 	// Retrieve a list of all games defined in the config file
-	_domains.clear();
 	const ConfigManager::DomainMap &domains = ConfMan.getGameDomains();
+	entries.reserve(domains.size());
 	ConfigManager::DomainMap::const_iterator iter;
 	for (iter = domains.begin(); iter != domains.end(); ++iter) {
 #ifdef __DS__
@@ -275,19 +279,26 @@ void LauncherDialog::updateListing() {
 			description = Common::String::format("Unknown (target %s, gameid %s)", iter->_key.c_str(), gameid.c_str());
 		}
 
-		if (!gameid.empty() && !description.empty()) {
-			// Insert the game into the launcher list
-			int pos = 0, size = l.size();
+		if (!gameid.empty() && !description.empty())
+			entries.push_back(LauncherEntry(iter->_key, description));
+	}
+
+	// Sort the games by description, sorting them one by one into the list
+	// is too slow with thousands of targets
+	Common::sort(entries.begin(), entries.end(), LauncherEntryComparator());
 
-			while (pos < size && (scumm_stricmp(description.c_str(), l[pos].c_str()) > 0))
-				pos++;
-			l.insert_at(pos, description);
-			_domains.insert_at(pos, iter->_key);
-		}
+	StringArray l;
+	l.reserve(entries.size());
+	_domains.clear();
+	_domains.reserve(entries.size());
+	for (uint i = 0; i < entries.size(); ++i) {
+		l.push_back(entries[i].description);
+		_domains.push_back(entries[i].key);
 	}
 
+	// Allow searching for the target as well as for the description
 	const int oldSel = _list->getSelected();
-	_list->setList(l);
+	_list->setList(l, nullptr, &_domains);
 	if (oldSel < (int)l.size())
 		_list->setSelected(oldSel);	// Restore the old selection
 	else if (oldSel != -1)
@@ -573,6 +584,7 @@ bool LauncherDialog::doGameDetection(const Common::String &path) {
 	// ...so let's determine a list of candidates, games that
 	// could be contained in the specified directory.
 	GameList candidates(EngineMan.detectGames(files));
+	DetectionCacheMan.flush();
 
 	int idx;
 	if (candidates.empty()) {
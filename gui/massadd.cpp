@@ -20,6 +20,7 @@
  *
  */
 
+#include "engines/detectioncache.h"
 #include "engines/metaengine.h"
 #include "common/algorithm.h"
 #include "common/config-manager.h"
@@ -253,6 +254,9 @@ void MassAddDialog::handleTickle() {
 	Common::String buf;
 
 	if (_scanStack.empty()) {
+		// Remember the checksums computed during the scan
+		DetectionCacheMan.flush();
+
 		// Enable the OK button
 		_okButton->setEnabled(true);
 
@@ -20,6 +20,7 @@ MODULE_OBJS := \
 	saveload.o \
 	saveload-dialog.o \
 	themebrowser.o \
+	ThemeDrawCache.o \
 	ThemeEngine.o \
 	ThemeEval.o \
 	ThemeLayout.o \
@@ -31,6 +32,7 @@ MODULE_OBJS := \
 	widget.o \
 	widgets/editable.o \
 	widgets/edittext.o \
+	widgets/list-filter.o \
 	widgets/list.o \
 	widgets/popup.o \
 	widgets/scrollbar.o \
@@ -0,0 +1,88 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "gui/widgets/list-filter.h"
+
+#include "common/tokenizer.h"
+
+namespace GUI {
+
+ListFilterIndex::ListFilterIndex() {
+}
+
+void ListFilterIndex::clear() {
+	_texts.clear();
+	_filter.clear();
+	_matches.clear();
+}
+
+void ListFilterIndex::push_back(const Common::String &text) {
+	Common::String lower = text;
+	lower.toLowercase();
+	_texts.push_back(lower);
+
+	// Keep the matches up to date without searching everything again
+	if (matches(_texts.size() - 1, _filter))
+		_matches.push_back(_texts.size() - 1);
+}
+
+void ListFilterIndex::setFilter(const Common::String &filter) {
+	if (filter == _filter)
+		return;
+
+	// A filter which extends the previous one can only match a subset of
+	// the previous matches: every word of the previous filter is contained
+	// in a word of the new one.
+	const bool refine = !_filter.empty() && filter.hasPrefix(_filter);
+	_filter = filter;
+
+	if (refine) {
+		uint count = 0;
+		for (uint i = 0; i < _matches.size(); ++i) {
+			if (matches(_matches[i], _filter))
+				_matches[count++] = _matches[i];
+		}
+		_matches.resize(count);
+	} else {
+		rebuildMatches();
+	}
+}
+
+void ListFilterIndex::rebuildMatches() {
+	_matches.clear();
+	for (uint i = 0; i < _texts.size(); ++i) {
+		if (matches(i, _filter))
+			_matches.push_back(i);
+	}
+}
+
+bool ListFilterIndex::matches(uint entry, const Common::String &filter) const {
+	Common::StringTokenizer tok(filter);
+	while (!tok.empty()) {
+		if (!_texts[entry].contains(tok.nextToken()))
+			return false;
+	}
+
+	return true;
+}
+
+} // End of namespace GUI
@@ -0,0 +1,77 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef GUI_WIDGETS_LIST_FILTER_H
+#define GUI_WIDGETS_LIST_FILTER_H
+
+#include "common/array.h"
+#include "common/str.h"
+
+namespace GUI {
+
+/**
+ * Search index for filtering the entries of a list.
+ *
+ * An entry matches a filter if its text contains all words of the filter
+ * as substrings, ignoring case. The text of each entry is lowercased once
+ * when it is added, instead of on every change of the filter. When a filter
+ * extends the previous one, as it does while the user types, only the
+ * entries which matched the previous filter are searched again.
+ */
+class ListFilterIndex {
+public:
+	ListFilterIndex();
+
+	/** Remove all entries. */
+	void clear();
+
+	/** Add an entry at the end of the index. */
+	void push_back(const Common::String &text);
+
+	uint size() const { return _texts.size(); }
+
+	/**
+	 * Restrict the matches to the entries matching the given filter.
+	 *
+	 * @param filter Words to search for, already lowercased
+	 */
+	void setFilter(const Common::String &filter);
+
+	/** Return the indices of the entries matching the filter, in order. */
+	const Common::Array<int> &getMatches() const { return _matches; }
+
+	/** Return whether the entry matches the given filter. */
+	bool matches(uint entry, const Common::String &filter) const;
+
+private:
+	void rebuildMatches();
+
+	/** Lowercased text of each entry */
+	Common::Array<Common::String> _texts;
+
+	Common::String _filter;
+	Common::Array<int> _matches;
+};
+
+} // End of namespace GUI
+
+#endif
@@ -22,7 +22,6 @@
 
 #include "common/system.h"
 #include "common/frac.h"
-#include "common/tokenizer.h"
 
 #include "gui/widgets/list.h"
 #include "gui/widgets/scrollbar.h"
@@ -121,9 +120,16 @@ void ListWidget::setSelected(int item) {
 	if (_listIndex.size()) {
 		int filteredItem = -1;
 
-		for (uint i = 0; i < _listIndex.size(); ++i) {
-			if (_listIndex[i] == item) {
-				filteredItem = i;
+		// _listIndex is sorted
+		int first = 0, last = _listIndex.size() - 1;
+		while (first <= last) {
+			const int middle = (first + last) / 2;
+			if (_listIndex[middle] < item) {
+				first = middle + 1;
+			} else if (_listIndex[middle] > item) {
+				last = middle - 1;
+			} else {
+				filteredItem = middle;
 				break;
 			}
 		}
@@ -159,7 +165,7 @@ ThemeEngine::FontColor ListWidget::getSelectionColor() const {
 		return _listColors[_listIndex[_selectedItem]];
 }
 
-void ListWidget::setList(const StringArray &list, const ColorList *colors) {
+void ListWidget::setList(const StringArray &list, const ColorList *colors, const StringArray *searchKeys) {
 	if (_editMode && _caretVisible)
 		drawCaret(true);
 
@@ -175,6 +181,16 @@ void ListWidget::setList(const StringArray &list, const ColorList *colors) {
 		assert(_listColors.size() == _dataList.size());
 	}
 
+	_filterIndex.clear();
+	if (searchKeys) {
+		assert(searchKeys->size() == _dataList.size());
+		for (uint i = 0; i < _dataList.size(); ++i)
+			_filterIndex.push_back(_dataList[i] + '\n' + (*searchKeys)[i]);
+	} else {
+		for (uint i = 0; i < _dataList.size(); ++i)
+			_filterIndex.push_back(_dataList[i]);
+	}
+
 	int size = list.size();
 	if (_currentPos >= size)
 		_currentPos = size - 1;
@@ -200,9 +216,15 @@ void ListWidget::append(const String &s, ThemeEngine::FontColor color) {
 	}
 
 	_dataList.push_back(s);
-	_list.push_back(s);
+	_filterIndex.push_back(s);
 
-	setFilter(_filter, false);
+	// Only show the new entry if it matches the active filter
+	if (_filter.empty()) {
+		_list.push_back(s);
+	} else if (!_filterIndex.getMatches().empty() && _filterIndex.getMatches().back() == (int)_dataList.size() - 1) {
+		_list.push_back(s);
+		_listIndex.push_back(_dataList.size() - 1);
+	}
 
 	scrollBarRecalc();
 }
@@ -686,6 +708,7 @@ void ListWidget::setFilter(const String &filter, bool redraw) {
 		return;
 
 	_filter = filt;
+	_filterIndex.setFilter(_filter);
 
 	if (_filter.empty()) {
 		// No filter -> display everything
@@ -694,31 +717,11 @@ void ListWidget::setFilter(const String &filter, bool redraw) {
 	} else {
 		// Restrict the list to everything which contains all words in _filter
 		// as substrings, ignoring case.
+		_listIndex = _filterIndex.getMatches();
 
-		Common::StringTokenizer tok(_filter);
-		String tmp;
-		int n = 0;
-
-		_list.clear();
-		_listIndex.clear();
-
-		for (StringArray::iterator i = _dataList.begin(); i != _dataList.end(); ++i, ++n) {
-			tmp = *i;
-			tmp.toLowercase();
-			bool matches = true;
-			tok.reset();
-			while (!tok.empty()) {
-				if (!tmp.contains(tok.nextToken())) {
-					matches = false;
-					break;
-				}
-			}
-
-			if (matches) {
-				_list.push_back(*i);
-				_listIndex.push_back(n);
-			}
-		}
+		_list.resize(_listIndex.size());
+		for (uint i = 0; i < _listIndex.size(); ++i)
+			_list[i] = _dataList[_listIndex[i]];
 	}
 
 	_currentPos = 0;
@@ -24,6 +24,7 @@
 #define GUI_WIDGETS_LIST_H
 
 #include "gui/widgets/editable.h"
+#include "gui/widgets/list-filter.h"
 #include "common/str.h"
 
 #include "gui/ThemeEngine.h"
@@ -57,6 +58,7 @@ protected:
 	StringArray		_dataList;
 	ColorList		_listColors;
 	Common::Array<int>		_listIndex;
+	ListFilterIndex	_filterIndex;
 	bool			_editable;
 	bool			_editMode;
 	NumberingMode	_numberingMode;
@@ -92,7 +94,15 @@ public:
 	virtual bool containsWidget(Widget *) const;
 	virtual Widget *findWidget(int x, int y);
 
-	void setList(const StringArray &list, const ColorList *colors = 0);
+	/**
+	 * Set the entries of the list.
+	 *
+	 * @param list       Text of the entries
+	 * @param colors     Optional color of each entry
+	 * @param searchKeys Optional additional text per entry, which the filter
+	 *                   matches on but which isn't displayed
+	 */
+	void setList(const StringArray &list, const ColorList *colors = 0, const StringArray *searchKeys = 0);
 	const StringArray &getList()	const			{ return _dataList; }
 
 	void append(const String &s, ThemeEngine::FontColor color = ThemeEngine::kFontColorNormal);
@@ -0,0 +1,222 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/rate.h"
+#include "audio/rate_kernels.h"
+#include "audio/decoders/raw.h"
+#include "audio/mixer.h"
+
+#include "common/cpudetect.h"
+#include "common/stream.h"
+
+class RateTestSuite : public CxxTest::TestSuite
+{
+private:
+	uint32 _seed;
+
+	int16 nextSample() {
+		_seed = _seed * 1103515245 + 12345;
+		return (int16)(_seed >> 16);
+	}
+
+	void fillRandom(int16 *buf, int len) {
+		for (int i = 0; i < len; ++i)
+			buf[i] = nextSample();
+	}
+
+	void kernelTestTemplate(bool stereo, Audio::st_volume_t volL, Audio::st_volume_t volR) {
+		// Use odd lengths to cover the scalar tails of the vector kernels
+		const int frames = 1021;
+		const int inLen = stereo ? frames * 2 : frames;
+
+		int16 *in = new int16[inLen];
+		int16 *outOrig = new int16[frames * 2];
+		int16 *outRef = new int16[frames * 2];
+		int16 *outOpt = new int16[frames * 2];
+
+		fillRandom(in, inLen);
+		fillRandom(outOrig, frames * 2);
+
+		memcpy(outRef, outOrig, frames * 2 * sizeof(int16));
+		(stereo ? Audio::mixStereoC : Audio::mixMonoC)(outRef, in, frames, volL, volR);
+
+		// Check every kernel the host can run, not only the fastest one
+		static const uint32 featureMasks[] = {
+			Common::kCPUFeatureSSE2 | Common::kCPUFeatureNEON,
+			0xFFFFFFFF
+		};
+
+		for (int i = 0; i < ARRAYSIZE(featureMasks); ++i) {
+			Common::setCPUFeatureMask(featureMasks[i]);
+			Audio::MixProc opt = stereo ? Audio::getStereoMixProc() : Audio::getMonoMixProc();
+			Common::setCPUFeatureMask(0xFFFFFFFF);
+
+			memcpy(outOpt, outOrig, frames * 2 * sizeof(int16));
+			opt(outOpt, in, frames, volL, volR);
+
+			TS_ASSERT_EQUALS(memcmp(outRef, outOpt, frames * 2 * sizeof(int16)), 0);
+		}
+
+		delete[] in;
+		delete[] outOrig;
+		delete[] outRef;
+		delete[] outOpt;
+	}
+
+	void flowConverter(int16 *out, int outFrames, const int16 *data, int dataLen, int inRate, int outRate, bool stereo, bool reverseStereo, Audio::RateConverterType type) {
+		// The raw stream takes ownership of its data, so hand it a copy
+		byte *copy = (byte *)malloc(dataLen * sizeof(int16));
+		memcpy(copy, data, dataLen * sizeof(int16));
+
+		Audio::AudioStream *stream = Audio::makeRawStream(copy, dataLen * sizeof(int16), inRate,
+		                                                  Audio::FLAG_16BITS | Audio::FLAG_LITTLE_ENDIAN | (stereo ? Audio::FLAG_STEREO : 0));
+		Audio::RateConverter *converter = Audio::makeRateConverter(inRate, outRate, stereo, reverseStereo, type);
+
+		memset(out, 0, outFrames * 2 * sizeof(int16));
+		// Flow in small, uneven chunks the way the mixer callback does
+		int16 *ptr = out;
+		while (ptr < out + outFrames * 2) {
+			const int chunk = MIN<int>(333, (out + outFrames * 2 - ptr) / 2);
+			const int res = converter->flow(*stream, ptr, chunk, 200, 97);
+			if (res <= 0)
+				break;
+			ptr += res * 2;
+		}
+
+		delete converter;
+		delete stream;
+	}
+
+	void converterTestTemplate(int inRate, int outRate, bool stereo, bool reverseStereo, Audio::RateConverterType type = Audio::kRateConverterDefault) {
+		const int dataLen = 4000 * (stereo ? 2 : 1);
+		const int outFrames = 4000 * 2 * outRate / inRate;
+
+		int16 *data = new int16[dataLen];
+		int16 *outRef = new int16[outFrames * 2];
+		int16 *outOpt = new int16[outFrames * 2];
+		fillRandom(data, dataLen);
+
+		Common::setCPUFeatureMask(0);
+		flowConverter(outRef, outFrames, data, dataLen, inRate, outRate, stereo, reverseStereo, type);
+		Common::setCPUFeatureMask(0xFFFFFFFF);
+		flowConverter(outOpt, outFrames, data, dataLen, inRate, outRate, stereo, reverseStereo, type);
+
+		TS_ASSERT_EQUALS(memcmp(outRef, outOpt, outFrames * 2 * sizeof(int16)), 0);
+
+		delete[] data;
+		delete[] outRef;
+		delete[] outOpt;
+	}
+
+public:
+	void setUp() {
+		_seed = 0x5C0FF;
+	}
+
+	void test_mix_stereo_kernel() {
+		kernelTestTemplate(true, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume);
+		kernelTestTemplate(true, 0, 255);
+		kernelTestTemplate(true, 1, 128);
+		kernelTestTemplate(true, 77, 3);
+	}
+
+	void test_mix_mono_kernel() {
+		kernelTestTemplate(false, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume);
+		kernelTestTemplate(false, 255, 0);
+		kernelTestTemplate(false, 128, 1);
+		kernelTestTemplate(false, 3, 77);
+	}
+
+	void test_mix_kernel_saturation() {
+		const int frames = 64;
+		int16 in[frames * 2];
+		int16 outRef[frames * 2], outOpt[frames * 2];
+
+		for (int i = 0; i < frames * 2; ++i) {
+			in[i] = (i & 1) ? -32768 : 32767;
+			outRef[i] = outOpt[i] = (i & 2) ? -32000 : 32000;
+		}
+
+		Audio::mixStereoC(outRef, in, frames, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume);
+		Audio::getStereoMixProc()(outOpt, in, frames, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume);
+
+		TS_ASSERT_EQUALS(memcmp(outRef, outOpt, sizeof(outRef)), 0);
+	}
+
+	void test_copy_converter() {
+		converterTestTemplate(22050, 22050, false, false);
+		converterTestTemplate(22050, 22050, true, false);
+		converterTestTemplate(22050, 22050, true, true);
+	}
+
+	void test_simple_converter() {
+		converterTestTemplate(44100, 22050, false, false);
+		converterTestTemplate(44100, 22050, true, false);
+		converterTestTemplate(44100, 22050, true, true);
+	}
+
+	void test_linear_converter() {
+		converterTestTemplate(11025, 44100, false, false);
+		converterTestTemplate(22050, 48000, true, false);
+		converterTestTemplate(22050, 48000, true, true);
+	}
+
+	void test_fir_kernel() {
+		int16 samples[Audio::SINC_TAPS * 4];
+		int16 coefs[Audio::SINC_TAPS];
+
+		fillRandom(samples, ARRAYSIZE(samples));
+		// Keep the coefficients in the range supported by the kernels
+		for (int i = 0; i < Audio::SINC_TAPS; ++i)
+			coefs[i] = nextSample() / (Audio::SINC_TAPS * 2);
+
+		Audio::FirProc opt = Audio::getFirProc();
+		for (int offset = 0; offset < Audio::SINC_TAPS * 3; ++offset)
+			TS_ASSERT_EQUALS(Audio::firC(samples + offset, coefs), opt(samples + offset, coefs));
+	}
+
+	void test_sinc_converter() {
+		converterTestTemplate(11025, 44100, false, false, Audio::kRateConverterSinc);
+		converterTestTemplate(22050, 48000, true, false, Audio::kRateConverterSinc);
+		converterTestTemplate(22050, 44100, true, true, Audio::kRateConverterSinc);
+		converterTestTemplate(44100, 22050, true, false, Audio::kRateConverterSinc);
+		converterTestTemplate(48000, 11025, false, false, Audio::kRateConverterSinc);
+	}
+
+	void test_sinc_converter_dc() {
+		// The filter is normalized to unity gain, so a constant signal must
+		// pass through unchanged once the filter has filled up.
+		const int dataLen = 2000;
+		const int outFrames = 2000 * 48000 / 22050;
+
+		int16 *data = new int16[dataLen];
+		int16 *out = new int16[outFrames * 2];
+		for (int i = 0; i < dataLen; ++i)
+			data[i] = 12345;
+
+		byte *copy = (byte *)malloc(dataLen * sizeof(int16));
+		memcpy(copy, data, dataLen * sizeof(int16));
+		Audio::AudioStream *stream = Audio::makeRawStream(copy, dataLen * sizeof(int16), 22050, Audio::FLAG_16BITS | Audio::FLAG_LITTLE_ENDIAN);
+		Audio::RateConverter *converter = Audio::makeRateConverter(22050, 48000, false, false, Audio::kRateConverterSinc);
+
+		memset(out, 0, outFrames * 2 * sizeof(int16));
+		const int res = converter->flow(*stream, out, outFrames, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume);
+		TS_ASSERT(res > outFrames / 2);
+
+		for (int i = 100; i < res / 2; ++i) {
+			TS_ASSERT_EQUALS(out[i * 2], 12345);
+			TS_ASSERT_EQUALS(out[i * 2 + 1], 12345);
+		}
+
+		delete converter;
+		delete stream;
+		delete[] data;
+		delete[] out;
+	}
+
+	void test_parse_rate_converter_type() {
+		TS_ASSERT_EQUALS(Audio::parseRateConverterType("sinc"), Audio::kRateConverterSinc);
+		TS_ASSERT_EQUALS(Audio::parseRateConverterType("SINC"), Audio::kRateConverterSinc);
+		TS_ASSERT_EQUALS(Audio::parseRateConverterType("default"), Audio::kRateConverterDefault);
+		TS_ASSERT_EQUALS(Audio::parseRateConverterType(""), Audio::kRateConverterDefault);
+	}
+};
@@ -0,0 +1,105 @@
+#include <cxxtest/TestSuite.h>
+
+#include "backends/fs/posix/posix-mmap-stream.h"
+#include "backends/fs/stdiostream.h"
+
+class PosixMmapStreamTestSuite : public CxxTest::TestSuite {
+#if defined(POSIX) && defined(HAVE_MMAP)
+	static const char *path() { return "test/posix-mmap-stream.tmp"; }
+
+	public:
+	void setUp() {
+		StdioStream *file = StdioStream::makeFromPath(path(), true);
+		TS_ASSERT(file);
+		if (!file)
+			return;
+		for (int i = 0; i < 100; ++i)
+			file->writeByte(i);
+		delete file;
+	}
+
+	void tearDown() {
+		remove(path());
+	}
+
+	void test_size() {
+		PosixMmapStream *stream = PosixMmapStream::makeFromPath(path());
+		TS_ASSERT(stream);
+		TS_ASSERT_EQUALS(stream->size(), 100);
+		TS_ASSERT_EQUALS(stream->pos(), 0);
+		TS_ASSERT(stream->getMemory());
+		delete stream;
+
+		TS_ASSERT(!PosixMmapStream::makeFromPath("test/posix-mmap-stream.missing"));
+	}
+
+	void test_seek() {
+		PosixMmapStream *stream = PosixMmapStream::makeFromPath(path());
+
+		TS_ASSERT(stream->seek(10));
+		TS_ASSERT_EQUALS(stream->readByte(), 10);
+		TS_ASSERT(stream->seek(5, SEEK_CUR));
+		TS_ASSERT_EQUALS(stream->readByte(), 16);
+		TS_ASSERT(stream->seek(-1, SEEK_END));
+		TS_ASSERT_EQUALS(stream->readByte(), 99);
+
+		// Seeks before the start of the file fail and keep the position
+		stream->seek(50);
+		TS_ASSERT(!stream->seek(-1));
+		TS_ASSERT(!stream->seek(-51, SEEK_CUR));
+		TS_ASSERT(!stream->seek(-101, SEEK_END));
+		TS_ASSERT_EQUALS(stream->pos(), 50);
+
+		TS_ASSERT(stream->seek(0, SEEK_END));
+		TS_ASSERT_EQUALS(stream->pos(), 100);
+		delete stream;
+	}
+
+	void test_seek_past_end() {
+		// Like StdioStream, seeking past the end succeeds and the following
+		// read sets the end of stream flag
+		PosixMmapStream *stream = PosixMmapStream::makeFromPath(path());
+		byte buffer[8];
+
+		TS_ASSERT(stream->seek(120));
+		TS_ASSERT_EQUALS(stream->pos(), 120);
+		TS_ASSERT(!stream->eos());
+		TS_ASSERT_EQUALS(stream->read(buffer, 8), 0u);
+		TS_ASSERT(stream->eos());
+
+		TS_ASSERT(stream->seek(10, SEEK_CUR));
+		TS_ASSERT_EQUALS(stream->pos(), 130);
+		TS_ASSERT(stream->seek(5, SEEK_END));
+		TS_ASSERT_EQUALS(stream->pos(), 105);
+		TS_ASSERT_EQUALS(stream->read(buffer, 1), 0u);
+		TS_ASSERT(stream->eos());
+
+		// Seeking back into the file works as before
+		TS_ASSERT(stream->seek(-10, SEEK_CUR));
+		TS_ASSERT_EQUALS(stream->pos(), 95);
+		TS_ASSERT(!stream->eos());
+		TS_ASSERT_EQUALS(stream->readByte(), 95);
+		delete stream;
+	}
+
+	void test_read_at_eos() {
+		PosixMmapStream *stream = PosixMmapStream::makeFromPath(path());
+		byte buffer[8];
+
+		stream->seek(96);
+		TS_ASSERT_EQUALS(stream->read(buffer, 8), 4u);
+		TS_ASSERT_EQUALS(buffer[0], 96);
+		TS_ASSERT_EQUALS(buffer[3], 99);
+		TS_ASSERT(stream->eos());
+
+		TS_ASSERT_EQUALS(stream->read(buffer, 1), 0u);
+		TS_ASSERT(stream->eos());
+
+		// A successful seek clears the end of stream flag
+		TS_ASSERT(stream->seek(0));
+		TS_ASSERT(!stream->eos());
+		TS_ASSERT_EQUALS(stream->readByte(), 0);
+		delete stream;
+	}
+#endif
+};
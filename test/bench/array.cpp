@@ -0,0 +1,67 @@
+#include "test/bench/bench.h"
+
+#include "common/array.h"
+#include "common/str.h"
+
+namespace Bench {
+
+void runArrayBenchmarks() {
+	const uint count = 1000000;
+	const int rounds = 20;
+	uint32 checksum = 0;
+
+	Timer timer;
+	for (int round = 0; round < rounds; ++round) {
+		Common::Array<uint32> array;
+		for (uint i = 0; i < count; ++i)
+			array.push_back(i);
+		checksum += array.size();
+	}
+	report("common/array", "push_back uint32", timer.elapsed() * 1e9 / (count * rounds), "ns/op");
+
+	timer.restart();
+	for (int round = 0; round < rounds; ++round) {
+		Common::Array<uint32> array;
+		array.reserve(count);
+		for (uint i = 0; i < count; ++i)
+			array.push_back(i);
+		checksum += array.size();
+	}
+	report("common/array", "push_back uint32 reserved", timer.elapsed() * 1e9 / (count * rounds), "ns/op");
+
+	// Growing an array of objects copies every element on reallocation
+	const Common::String value("a string which does not fit into the builtin storage");
+	timer.restart();
+	for (int round = 0; round < rounds; ++round) {
+		Common::Array<Common::String> array;
+		for (uint i = 0; i < count / 10; ++i)
+			array.push_back(value);
+		checksum += array.size();
+	}
+	report("common/array", "push_back String", timer.elapsed() * 1e9 / (count / 10 * rounds), "ns/op");
+
+	resetRandom(1);
+	Common::Array<uint32> array;
+	for (uint i = 0; i < count; ++i)
+		array.push_back(nextRandom());
+
+	// Walking and copying are cheap, so do more of it
+	const int passes = rounds * 10;
+	timer.restart();
+	for (int round = 0; round < passes; ++round) {
+		for (Common::Array<uint32>::const_iterator i = array.begin(); i != array.end(); ++i)
+			checksum += *i;
+	}
+	report("common/array", "iterate uint32", timer.elapsed() * 1e9 / (count * passes), "ns/op");
+
+	timer.restart();
+	for (int round = 0; round < passes; ++round) {
+		Common::Array<uint32> copy(array);
+		checksum += copy[round];
+	}
+	report("common/array", "copy uint32", timer.elapsed() * 1e9 / (count * passes), "ns/op");
+
+	consume(checksum);
+}
+
+} // End of namespace Bench
@@ -0,0 +1,136 @@
+#define FORBIDDEN_SYMBOL_EXCEPTION_printf
+#define FORBIDDEN_SYMBOL_EXCEPTION_stdout
+
+#include "test/bench/bench.h"
+
+#include "common/algorithm.h"
+#include "common/array.h"
+#include "common/str.h"
+
+#include <stdio.h>
+
+namespace Bench {
+
+struct Suite {
+	const char *name;
+	void (*run)();
+};
+
+static const Suite s_suites[] = {
+	{ "audio/rate", runRateBenchmarks },
+	{ "common/array", runArrayBenchmarks },
+	{ "common/dcl", runDCLBenchmarks },
+	{ "common/hashmap", runHashMapBenchmarks },
+	{ "common/huffman", runHuffmanBenchmarks },
+	{ "common/str", runStringBenchmarks },
+	{ "common/stream", runStreamBenchmarks },
+	{ "common/zlib", runZlibBenchmarks },
+	{ "graphics/blit", runBlitBenchmarks },
+	{ "graphics/scale", runScaleBenchmarks },
+	{ "graphics/scaler", runScalerBenchmarks },
+	{ "graphics/yuv", runYUVBenchmarks },
+	{ "gui/launcher", runLauncherBenchmarks }
+};
+
+struct Result {
+	Common::String suite;
+	Common::String name;
+	Common::String unit;
+	Common::Array<double> values;
+};
+
+static Common::Array<Result> s_results;
+static uint32 s_seed = 1;
+static volatile uint32 s_consumed = 0;
+
+void report(const char *suite, const char *name, double value, const char *unit) {
+	for (uint i = 0; i < s_results.size(); ++i) {
+		if (s_results[i].suite == suite && s_results[i].name == name) {
+			s_results[i].values.push_back(value);
+			return;
+		}
+	}
+
+	Result result;
+	result.suite = suite;
+	result.name = name;
+	result.unit = unit;
+	result.values.push_back(value);
+	s_results.push_back(result);
+}
+
+uint32 nextRandom() {
+	s_seed = s_seed * 1103515245 + 12345;
+	return s_seed >> 8;
+}
+
+void resetRandom(uint32 seed) {
+	s_seed = seed;
+}
+
+void consume(uint32 value) {
+	s_consumed += value;
+}
+
+static double median(Common::Array<double> values) {
+	Common::sort(values.begin(), values.end());
+	const uint middle = values.size() / 2;
+	if (values.size() % 2)
+		return values[middle];
+	return (values[middle - 1] + values[middle]) / 2;
+}
+
+static void printResults(bool csv) {
+	for (uint i = 0; i < s_results.size(); ++i) {
+		const Result &result = s_results[i];
+		if (csv)
+			printf("\"%s\",\"%s\",%.3f,\"%s\"\n", result.suite.c_str(), result.name.c_str(), median(result.values), result.unit.c_str());
+		else
+			printf("%-24s %-40s %14.3f %s\n", result.suite.c_str(), result.name.c_str(), median(result.values), result.unit.c_str());
+	}
+	fflush(stdout);
+	s_results.clear();
+}
+
+} // End of namespace Bench
+
+int main(int argc, char *argv[]) {
+	bool csv = false;
+	const char *filter = "";
+	int repeat = 1;
+
+	for (int i = 1; i < argc; ++i) {
+		if (!strcmp(argv[i], "--csv")) {
+			csv = true;
+		} else if (!strncmp(argv[i], "--filter=", 9)) {
+			filter = argv[i] + 9;
+		} else if (!strncmp(argv[i], "--repeat=", 9)) {
+			repeat = MAX(atoi(argv[i] + 9), 1);
+		} else if (!strcmp(argv[i], "--list")) {
+			for (int j = 0; j < ARRAYSIZE(Bench::s_suites); ++j)
+				printf("%s\n", Bench::s_suites[j].name);
+			return 0;
+		} else {
+			printf("Usage: %s [--csv] [--filter=TEXT] [--repeat=N] [--list]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	if (csv)
+		printf("suite,name,value,unit\n");
+
+	for (int i = 0; i < ARRAYSIZE(Bench::s_suites); ++i) {
+		if (!strstr(Bench::s_suites[i].name, filter))
+			continue;
+
+		for (int run = 0; run < repeat; ++run) {
+			Bench::Timer timer;
+			Bench::s_suites[i].run();
+			Bench::report(Bench::s_suites[i].name, "suite wall time", timer.elapsed() * 1e3, "ms");
+			Bench::report(Bench::s_suites[i].name, "suite processor time", timer.cpuElapsed() * 1e3, "ms");
+		}
+		Bench::printResults(csv);
+	}
+
+	return 0;
+}
@@ -0,0 +1,103 @@
+#ifndef TEST_BENCH_BENCH_H
+#define TEST_BENCH_BENCH_H
+
+// The benchmarks measure time through the C library
+#define FORBIDDEN_SYMBOL_EXCEPTION_time_h
+
+#include "common/scummsys.h"
+#include "common/util.h"
+
+#include <time.h>
+
+/*
+ * A minimal benchmark harness. Benchmarks measure the wall clock time spent
+ * in a workload and report the result through Bench::report(). The runner
+ * also reports the wall clock and processor time of every suite, so that
+ * time spent waiting, e.g. for worker threads, shows up.
+ *
+ * The runner accepts the following options (pass them through BENCH_FLAGS
+ * when using the 'bench' make target):
+ *   --csv         print the results as comma separated values
+ *   --filter=TEXT only run the suites whose name contains TEXT
+ *   --repeat=N    run every suite N times and report the median values
+ *   --list        list the available suites
+ *
+ * Workloads are generated from fixed seeds, so the results of two builds
+ * can be compared with devtools/bench-compare.py.
+ */
+namespace Bench {
+
+/**
+ * Measures time, in seconds. elapsed() returns the wall clock time from a
+ * monotonic clock, cpuElapsed() the processor time of the process.
+ */
+class Timer {
+	double _start;
+	clock_t _cpuStart;
+
+	static double now() {
+#ifdef CLOCK_MONOTONIC
+		timespec ts;
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		return ts.tv_sec + ts.tv_nsec * 1e-9;
+#else
+		return (double)clock() / CLOCKS_PER_SEC;
+#endif
+	}
+
+public:
+	Timer() { restart(); }
+
+	void restart() {
+		_start = now();
+		_cpuStart = clock();
+	}
+
+	double elapsed() const { return now() - _start; }
+	double cpuElapsed() const { return (double)(clock() - _cpuStart) / CLOCKS_PER_SEC; }
+};
+
+/**
+ * Report a single measurement of a benchmark.
+ *
+ * @param suite	name of the group the benchmark belongs to, e.g. "audio/rate"
+ * @param name	name of the benchmark
+ * @param value	measured value
+ * @param unit	unit of the value
+ */
+void report(const char *suite, const char *name, double value, const char *unit);
+
+/**
+ * Return a deterministic pseudo random number, so that all runs of a
+ * benchmark operate on the same data.
+ */
+uint32 nextRandom();
+
+/**
+ * Reset the sequence returned by nextRandom().
+ */
+void resetRandom(uint32 seed);
+
+/**
+ * Consume a value computed by a benchmark, so that the compiler cannot
+ * optimize the computation away.
+ */
+void consume(uint32 value);
+
+void runRateBenchmarks();
+void runHashMapBenchmarks();
+void runStringBenchmarks();
+void runArrayBenchmarks();
+void runStreamBenchmarks();
+void runZlibBenchmarks();
+void runDCLBenchmarks();
+void runHuffmanBenchmarks();
+void runLauncherBenchmarks();
+void runBlitBenchmarks();
+void runScaleBenchmarks();
+void runScalerBenchmarks();
+void runYUVBenchmarks();
+
+} // End of namespace Bench
+
+#endif
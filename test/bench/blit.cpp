@@ -0,0 +1,124 @@
+#include "test/bench/bench.h"
+
+#include "common/cpudetect.h"
+#include "common/str.h"
+
+#include "graphics/transform_tools.h"
+#include "graphics/transparent_surface.h"
+
+namespace Bench {
+
+static void benchBlit(const char *modeName, Graphics::TSpriteBlendMode blendMode, uint color, const char *pathName, uint32 featureMask) {
+	// A full screen of sprites at 1080p
+	const int frames = 100;
+	const Graphics::PixelFormat format = Graphics::TransparentSurface::getSupportedPixelFormat();
+
+	resetRandom(1);
+	Graphics::TransparentSurface sprite;
+	sprite.create(256, 256, format);
+	uint32 *pixels = (uint32 *)sprite.getPixels();
+	for (int i = 0; i < sprite.w * sprite.h; ++i)
+		pixels[i] = nextRandom() ^ (nextRandom() << 8);
+
+	Graphics::Surface screen;
+	screen.create(1920, 1080, format);
+
+	Common::setCPUFeatureMask(featureMask);
+	Timer timer;
+	for (int frame = 0; frame < frames; ++frame) {
+		for (int y = 0; y < screen.h; y += sprite.h)
+			for (int x = 0; x < screen.w; x += sprite.w)
+				sprite.blit(screen, x, y, Graphics::FLIP_NONE, nullptr, color, -1, -1, blendMode);
+	}
+	const double elapsed = timer.elapsed();
+	Common::setCPUFeatureMask(0xFFFFFFFF);
+
+	consume(*(uint32 *)screen.getPixels());
+	screen.free();
+	sprite.free();
+
+	const Common::String name = Common::String::format("%s %s", modeName, pathName);
+	report("graphics/blit", name.c_str(), frames / elapsed, "frames/s");
+}
+
+static void benchBlitPaths(const char *modeName, Graphics::TSpriteBlendMode blendMode, uint color) {
+	benchBlit(modeName, blendMode, color, "scalar", 0);
+	benchBlit(modeName, blendMode, color, "simd", 0xFFFFFFFF);
+}
+
+void runBlitBenchmarks() {
+	benchBlitPaths("alpha", Graphics::BLEND_NORMAL, 0xFFFFFFFF);
+	benchBlitPaths("alpha modulated", Graphics::BLEND_NORMAL, 0x80FF8040);
+	benchBlitPaths("additive", Graphics::BLEND_ADDITIVE, 0xFFFFFFFF);
+	benchBlitPaths("subtractive", Graphics::BLEND_SUBTRACTIVE, 0xFFFFFFFF);
+}
+
+template <Graphics::TFilteringMode filteringMode>
+static void benchScale(const char *filterName, int srcW, int srcH, int dstW, int dstH) {
+	const int frames = 50;
+	const Graphics::PixelFormat format = Graphics::TransparentSurface::getSupportedPixelFormat();
+
+	resetRandom(1);
+	Graphics::TransparentSurface sprite;
+	sprite.create(srcW, srcH, format);
+	uint32 *pixels = (uint32 *)sprite.getPixels();
+	for (int i = 0; i < sprite.w * sprite.h; ++i)
+		pixels[i] = nextRandom() ^ (nextRandom() << 8);
+
+	Graphics::Surface target;
+	target.create(dstW, dstH, format);
+
+	Timer timer;
+	for (int frame = 0; frame < frames; ++frame)
+		sprite.scaleInto<filteringMode>(target);
+	const double elapsed = timer.elapsed();
+
+	consume(*(uint32 *)target.getPixels());
+	target.free();
+	sprite.free();
+
+	const Common::String name = Common::String::format("%s %dx%d->%dx%d", filterName, srcW, srcH, dstW, dstH);
+	report("graphics/scale", name.c_str(), frames / elapsed, "frames/s");
+}
+
+template <Graphics::TFilteringMode filteringMode>
+static void benchRotoscale(const char *filterName, int angle, int zoom) {
+	const int frames = 50;
+	const Graphics::PixelFormat format = Graphics::TransparentSurface::getSupportedPixelFormat();
+
+	resetRandom(1);
+	Graphics::TransparentSurface sprite;
+	sprite.create(640, 480, format);
+	uint32 *pixels = (uint32 *)sprite.getPixels();
+	for (int i = 0; i < sprite.w * sprite.h; ++i)
+		pixels[i] = nextRandom() ^ (nextRandom() << 8);
+
+	const Graphics::TransformStruct transform(zoom, zoom, angle, 320, 240);
+	const Common::Rect rect = Graphics::TransformTools::newRect(Common::Rect(sprite.w, sprite.h), transform, nullptr);
+	Graphics::Surface target;
+	target.create(rect.width(), rect.height(), format);
+
+	Timer timer;
+	for (int frame = 0; frame < frames; ++frame)
+		sprite.rotoscaleInto<filteringMode>(target, transform);
+	const double elapsed = timer.elapsed();
+
+	consume(*(uint32 *)target.getPixels());
+	target.free();
+	sprite.free();
+
+	const Common::String name = Common::String::format("%s 640x480 %d deg %d%%", filterName, angle, zoom);
+	report("graphics/scale", name.c_str(), frames / elapsed, "frames/s");
+}
+
+void runScaleBenchmarks() {
+	benchScale<Graphics::FILTER_NEAREST>("nearest", 640, 480, 1920, 1440);
+	benchScale<Graphics::FILTER_BILINEAR>("bilinear", 640, 480, 1920, 1440);
+	benchScale<Graphics::FILTER_NEAREST>("nearest", 1920, 1440, 640, 480);
+	benchScale<Graphics::FILTER_BILINEAR>("bilinear", 1920, 1440, 640, 480);
+	benchScale<Graphics::FILTER_AREA>("area", 1920, 1440, 640, 480);
+	benchRotoscale<Graphics::FILTER_NEAREST>("nearest", 30, 200);
+	benchRotoscale<Graphics::FILTER_BILINEAR>("bilinear", 30, 200);
+}
+
+} // End of namespace Bench
@@ -0,0 +1,213 @@
+#include "test/bench/bench.h"
+
+#include "common/array.h"
+#include "common/bitstream.h"
+#include "common/dcl.h"
+#include "common/huffman.h"
+#include "common/memstream.h"
+#include "common/zlib.h"
+
+namespace Bench {
+
+static const uint32 kUnpackedSize = 4 * 1024 * 1024;
+
+/**
+ * Fill data with pseudo random text, which compresses about as well as
+ * the scripts and text resources of a game.
+ */
+static void generateText(byte *data, uint32 size) {
+	static const char *const words[] = {
+		"the ", "door ", "is ", "locked", ". ", "You ", "can't ", "open ", "it ",
+		"with ", "your ", "bare ", "hands", "! ", "Take ", "key ", "look ", "at ",
+		"room", "\n"
+	};
+
+	resetRandom(1);
+	uint32 pos = 0;
+	while (pos < size) {
+		const char *word = words[nextRandom() % ARRAYSIZE(words)];
+		while (*word && pos < size)
+			data[pos++] = *word++;
+	}
+}
+
+#ifdef USE_ZLIB
+void runZlibBenchmarks() {
+	byte *data = new byte[kUnpackedSize];
+	generateText(data, kUnpackedSize);
+
+	// The compressor takes ownership of the stream it writes to
+	Common::MemoryWriteStreamDynamic *packedStream = new Common::MemoryWriteStreamDynamic(DisposeAfterUse::NO);
+	Common::WriteStream *compressor = Common::wrapCompressedWriteStream(packedStream);
+	Timer timer;
+	compressor->write(data, kUnpackedSize);
+	compressor->finalize();
+	report("common/zlib", "gzip compress", kUnpackedSize / timer.elapsed() / (1024 * 1024), "MB/s");
+	byte *packed = packedStream->getData();
+	const uint32 packedSize = packedStream->size();
+	delete compressor;
+
+	byte *unpacked = new byte[kUnpackedSize];
+	const int rounds = 4;
+	timer.restart();
+	for (int round = 0; round < rounds; ++round) {
+		Common::SeekableReadStream *stream = Common::wrapCompressedReadStream(new Common::MemoryReadStream(packed, packedSize));
+		stream->read(unpacked, kUnpackedSize);
+		delete stream;
+	}
+	report("common/zlib", "gzip decompress", kUnpackedSize * rounds / timer.elapsed() / (1024 * 1024), "MB/s");
+
+	consume(memcmp(data, unpacked, kUnpackedSize));
+	free(packed);
+	delete[] unpacked;
+	delete[] data;
+}
+#else
+void runZlibBenchmarks() {
+}
+#endif
+
+/**
+ * Writes bits in the order the DCL decompressor reads them, least
+ * significant bit first.
+ */
+class DCLBitWriter {
+	Common::Array<byte> &_data;
+	uint32 _bits;
+	int _count;
+public:
+	DCLBitWriter(Common::Array<byte> &data) : _data(data), _bits(0), _count(0) {}
+
+	void writeBits(uint32 value, int n) {
+		for (int i = 0; i < n; ++i) {
+			_bits |= ((value >> i) & 1) << _count;
+			if (++_count == 8) {
+				_data.push_back(_bits);
+				_bits = 0;
+				_count = 0;
+			}
+		}
+	}
+
+	// Huffman codes are written in the order the tree is walked
+	void writeCode(const char *code) {
+		for (; *code; ++code)
+			writeBits(*code == '1', 1);
+	}
+
+	void flush() {
+		// The decompressor reads ahead by up to four bytes
+		writeBits(0, 32 + 8 - _count);
+	}
+};
+
+/**
+ * Compress data in DCL binary mode with a 4 KB dictionary. Only matches of
+ * 3 to 5 bytes within the last 64 bytes are looked for, which is enough to
+ * exercise both the literal and the copy paths of the decompressor.
+ */
+static void packDCL(const byte *data, uint32 size, Common::Array<byte> &packed) {
+	// Length codes for match lengths 3, 4 and 5
+	static const char *const lengthCodes[] = { "11", "100", "011" };
+	// Distance code for the upper bits of offsets 1 to 64
+	static const char *const distanceCode = "11";
+
+	DCLBitWriter writer(packed);
+	writer.writeBits(0, 8);		// binary mode
+	writer.writeBits(6, 8);		// 4 KB dictionary
+
+	uint32 pos = 0;
+	while (pos < size) {
+		int bestLength = 0, bestOffset = 0;
+		for (int offset = 1; offset <= 64 && offset <= (int)pos; ++offset) {
+			int length = 0;
+			while (length < 5 && pos + length < size && data[pos + length] == data[pos + length - offset])
+				++length;
+			if (length > bestLength) {
+				bestLength = length;
+				bestOffset = offset;
+			}
+		}
+
+		if (bestLength >= 3) {
+			writer.writeBits(1, 1);
+			writer.writeCode(lengthCodes[bestLength - 3]);
+			writer.writeCode(distanceCode);
+			writer.writeBits(bestOffset - 1, 6);
+			pos += bestLength;
+		} else {
+			writer.writeBits(0, 1);
+			writer.writeBits(data[pos], 8);
+			++pos;
+		}
+	}
+
+	writer.flush();
+}
+
+void runDCLBenchmarks() {
+	byte *data = new byte[kUnpackedSize];
+	generateText(data, kUnpackedSize);
+
+	Common::Array<byte> packed;
+	packDCL(data, kUnpackedSize, packed);
+
+	byte *unpacked = new byte[kUnpackedSize];
+	const int rounds = 4;
+	bool success = true;
+	Timer timer;
+	for (int round = 0; round < rounds; ++round) {
+		Common::MemoryReadStream stream(packed.begin(), packed.size());
+		success &= Common::decompressDCL(&stream, unpacked, packed.size(), kUnpackedSize);
+	}
+	const double elapsed = timer.elapsed();
+
+	if (success && !memcmp(data, unpacked, kUnpackedSize))
+		report("common/dcl", "decompress", kUnpackedSize * rounds / elapsed / (1024 * 1024), "MB/s");
+	else
+		report("common/dcl", "decompress failed", 0, "");
+
+	delete[] unpacked;
+	delete[] data;
+}
+
+void runHuffmanBenchmarks() {
+	// A complete canonical code of 28 symbols, 4 of 3 bits, 8 of 5 bits and
+	// 16 of 6 bits. Random input bits then decode to a skewed distribution
+	// of symbols, like real data would.
+	const uint32 codeCount = 28;
+	uint32 codes[codeCount];
+	uint8 lengths[codeCount];
+	uint32 code = 0;
+	uint8 length = 3;
+	for (uint32 i = 0; i < codeCount; ++i) {
+		const uint8 symbolLength = (i < 4) ? 3 : (i < 12) ? 5 : 6;
+		code <<= symbolLength - length;
+		length = symbolLength;
+		codes[i] = code++;
+		lengths[i] = length;
+	}
+
+	Common::Huffman huffman(6, codeCount, codes, lengths);
+
+	const uint32 size = 1024 * 1024;
+	byte *data = new byte[size];
+	resetRandom(1);
+	for (uint32 i = 0; i < size; ++i)
+		data[i] = (byte)nextRandom();
+
+	uint32 checksum = 0, symbols = 0;
+	Timer timer;
+	Common::MemoryReadStream stream(data, size);
+	Common::BitStream8MSB bits(stream);
+	while (bits.pos() + 6 <= bits.size()) {
+		checksum += huffman.getSymbol(bits);
+		++symbols;
+	}
+	report("common/huffman", "decode", symbols / timer.elapsed() / 1e6, "Msymbols/s");
+
+	consume(checksum);
+	delete[] data;
+}
+
+} // End of namespace Bench
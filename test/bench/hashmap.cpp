@@ -0,0 +1,80 @@
+#include "test/bench/bench.h"
+
+#include "common/array.h"
+#include "common/flat-hashmap.h"
+#include "common/hash-str.h"
+#include "common/hashmap.h"
+#include "common/str.h"
+
+namespace Bench {
+
+template<class Map, class Key>
+static void benchMap(const char *suite, const char *mapName, const Common::Array<Key> &keys, const Common::Array<Key> &missing) {
+	// Look the keys up in a different order than they were inserted in
+	Common::Array<Key> lookups(keys);
+	resetRandom(2);
+	for (uint i = lookups.size() - 1; i > 0; --i)
+		SWAP(lookups[i], lookups[nextRandom() % (i + 1)]);
+
+	const int rounds = 10;
+	const double ops = (double)keys.size() * rounds;
+	double insertTime = 0, hitTime = 0, missTime = 0, iterateTime = 0;
+	uint32 checksum = 0;
+
+	for (int round = 0; round < rounds; ++round) {
+		Map map;
+
+		Timer timer;
+		for (uint i = 0; i < keys.size(); ++i)
+			map[keys[i]] = i;
+		insertTime += timer.elapsed();
+
+		timer.restart();
+		for (uint i = 0; i < lookups.size(); ++i)
+			checksum += map.getVal(lookups[i], 0);
+		hitTime += timer.elapsed();
+
+		timer.restart();
+		for (uint i = 0; i < missing.size(); ++i)
+			checksum += map.contains(missing[i]);
+		missTime += timer.elapsed();
+
+		timer.restart();
+		for (typename Map::const_iterator i = map.begin(); i != map.end(); ++i)
+			checksum += i->_value;
+		iterateTime += timer.elapsed();
+	}
+
+	report(suite, Common::String::format("%s insert", mapName).c_str(), insertTime * 1e9 / ops, "ns/op");
+	report(suite, Common::String::format("%s lookup hit", mapName).c_str(), hitTime * 1e9 / ops, "ns/op");
+	report(suite, Common::String::format("%s lookup miss", mapName).c_str(), missTime * 1e9 / ops, "ns/op");
+	report(suite, Common::String::format("%s iterate", mapName).c_str(), iterateTime * 1e9 / ops, "ns/op");
+	consume(checksum);
+}
+
+void runHashMapBenchmarks() {
+	const uint count = 100000;
+
+	resetRandom(1);
+	Common::Array<int> intKeys, intMissing;
+	for (uint i = 0; i < count; ++i) {
+		// Collisions between the two sets are unlikely enough to not matter
+		intKeys.push_back((int)nextRandom());
+		intMissing.push_back((int)nextRandom());
+	}
+
+	benchMap<Common::HashMap<int, uint>, int>("common/hashmap int", "HashMap", intKeys, intMissing);
+	benchMap<Common::FlatHashMap<int, uint>, int>("common/hashmap int", "FlatHashMap", intKeys, intMissing);
+
+	resetRandom(1);
+	Common::Array<Common::String> stringKeys, stringMissing;
+	for (uint i = 0; i < count; ++i) {
+		stringKeys.push_back(Common::String::format("selector_%u", nextRandom()));
+		stringMissing.push_back(Common::String::format("missing_%u", nextRandom()));
+	}
+
+	benchMap<Common::HashMap<Common::String, uint>, Common::String>("common/hashmap string", "HashMap", stringKeys, stringMissing);
+	benchMap<Common::FlatHashMap<Common::String, uint>, Common::String>("common/hashmap string", "FlatHashMap", stringKeys, stringMissing);
+}
+
+} // End of namespace Bench
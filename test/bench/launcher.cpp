@@ -0,0 +1,215 @@
+#include "test/bench/bench.h"
+
+#include "common/algorithm.h"
+#include "common/array.h"
+#include "common/config-manager.h"
+#include "common/str.h"
+#include "common/system.h"
+
+#include "gui/launcher-entry.h"
+#include "gui/widgets/list-filter.h"
+
+#ifdef POSIX
+#include "backends/fs/posix/posix-fs-factory.h"
+#include "backends/fs/stdiostream.h"
+#endif
+
+namespace Bench {
+
+static const int kTargetCount = 5000;
+
+#ifdef POSIX
+
+/**
+ * Just enough of a backend for the config manager, which opens its file
+ * through the filesystem factory.
+ */
+class LauncherBenchSystem : public OSystem {
+public:
+	LauncherBenchSystem() { _fsFactory = new POSIXFilesystemFactory(); }
+
+	const GraphicsMode *getSupportedGraphicsModes() const { return 0; }
+	int getDefaultGraphicsMode() const { return 0; }
+	bool setGraphicsMode(int mode) { return false; }
+	int getGraphicsMode() const { return 0; }
+#ifdef USE_RGB_COLOR
+	Graphics::PixelFormat getScreenFormat() const { return Graphics::PixelFormat::createFormatCLUT8(); }
+	Common::List<Graphics::PixelFormat> getSupportedFormats() const { return Common::List<Graphics::PixelFormat>(); }
+#endif
+	void initSize(uint width, uint height, const Graphics::PixelFormat *format = NULL) {}
+	int16 getHeight() { return 0; }
+	int16 getWidth() { return 0; }
+	PaletteManager *getPaletteManager() { return 0; }
+	void copyRectToScreen(const void *buf, int pitch, int x, int y, int w, int h) {}
+	Graphics::Surface *lockScreen() { return 0; }
+	void unlockScreen() {}
+	void fillScreen(uint32 col) {}
+	void updateScreen() {}
+	void setShakePos(int shakeOffset) {}
+	void showOverlay() {}
+	void hideOverlay() {}
+	Graphics::PixelFormat getOverlayFormat() const { return Graphics::PixelFormat::createFormatCLUT8(); }
+	void clearOverlay() {}
+	void grabOverlay(void *buf, int pitch) {}
+	void copyRectToOverlay(const void *buf, int pitch, int x, int y, int w, int h) {}
+	int16 getOverlayHeight() { return 0; }
+	int16 getOverlayWidth() { return 0; }
+	bool showMouse(bool visible) { return false; }
+	void warpMouse(int x, int y) {}
+	void setMouseCursor(const void *buf, uint w, uint h, int hotspotX, int hotspotY, uint32 keycolor, bool dontScale = false, const Graphics::PixelFormat *format = NULL) {}
+	uint32 getMillis(bool skipRecord = false) { return 0; }
+	void delayMillis(uint msecs) {}
+	void getTimeAndDate(TimeDate &t) const {}
+	MutexRef createMutex() { return 0; }
+	void lockMutex(MutexRef mutex) {}
+	void unlockMutex(MutexRef mutex) {}
+	void deleteMutex(MutexRef mutex) {}
+	Audio::Mixer *getMixer() { return 0; }
+	void quit() {}
+	void displayMessageOnOSD(const char *msg) {}
+	void displayActivityIconOnOSD(const Graphics::Surface *icon) {}
+	void logMessage(LogMessageType::Type type, const char *message) {}
+};
+
+#endif
+
+static Common::String randomDescription() {
+	static const char *const words[] = {
+		"Monkey", "Island", "Quest", "Secret", "Tentacle", "Day", "King's",
+		"Space", "Legend", "Curse", "Revenge", "Sam", "Max", "Broken", "Sword",
+		"Simon", "Sorcerer", "Dig", "Loom", "Beneath", "Steel", "Sky"
+	};
+
+	Common::String description;
+	const int wordCount = 2 + nextRandom() % 4;
+	for (int i = 0; i < wordCount; ++i) {
+		if (i)
+			description += ' ';
+		description += words[nextRandom() % ARRAYSIZE(words)];
+	}
+	return description + Common::String::format(" (CD/DOS/%c%c)", 'A' + nextRandom() % 26, 'A' + nextRandom() % 26);
+}
+
+/**
+ * Create the given number of game targets, which look like those added by
+ * the mass add dialog, in no particular order.
+ */
+static Common::Array<GUI::LauncherEntry> createEntries(int targets) {
+	resetRandom(1);
+
+	Common::Array<GUI::LauncherEntry> entries;
+	entries.reserve(targets);
+	for (int i = 0; i < targets; ++i)
+		entries.push_back(GUI::LauncherEntry(Common::String::format("target%d", i), randomDescription()));
+	return entries;
+}
+
+#ifdef POSIX
+
+static const char *configPath() { return "test/bench/launcher.ini"; }
+
+/**
+ * Write a scummvm.ini with the given game targets, as the launcher finds it
+ * at startup.
+ */
+static bool writeConfig(const Common::Array<GUI::LauncherEntry> &entries) {
+	StdioStream *file = StdioStream::makeFromPath(configPath(), true);
+	if (!file)
+		return false;
+
+	file->writeString("[scummvm]\nversioninfo=2.0.0\ngfx_mode=2x\nlastselectedgame=target0\n\n");
+	for (uint i = 0; i < entries.size(); ++i) {
+		file->writeString("[" + entries[i].key + "]\n");
+		file->writeString("description=" + entries[i].description + "\n");
+		file->writeString(Common::String::format("gameid=game%d\n", nextRandom() % 300));
+		file->writeString("path=/games/collection/" + entries[i].key + "\n");
+		file->writeString("language=en\nplatform=pc\nguioptions=sndNoSpeech gameOption1\n\n");
+	}
+
+	const bool success = !file->err();
+	delete file;
+	return success;
+}
+
+/**
+ * Load the targets from the config file and build the sorted game list,
+ * as the launcher does at startup.
+ */
+static bool loadEntries(Common::Array<GUI::LauncherEntry> &entries, const Common::String &suffix) {
+	if (!writeConfig(createEntries(kTargetCount)))
+		return false;
+
+	OSystem *oldSystem = g_system;
+	LauncherBenchSystem *system = new LauncherBenchSystem();
+	g_system = system;
+
+	Timer timer;
+	ConfMan.loadConfigFile(configPath());
+	report("gui/launcher", ("load config" + suffix).c_str(), timer.elapsed() * 1e3, "ms");
+
+	// Building the sorted game list, as LauncherDialog::updateListing() does
+	timer.restart();
+	const Common::ConfigManager::DomainMap &domains = ConfMan.getGameDomains();
+	entries.reserve(domains.size());
+	for (Common::ConfigManager::DomainMap::const_iterator i = domains.begin(); i != domains.end(); ++i)
+		entries.push_back(GUI::LauncherEntry(i->_key, i->_value.getVal("description")));
+	Common::sort(entries.begin(), entries.end(), GUI::LauncherEntryComparator());
+	report("gui/launcher", ("build list" + suffix).c_str(), timer.elapsed() * 1e3, "ms");
+
+	g_system = oldSystem;
+	delete system;
+	remove(configPath());
+	return entries.size() == (uint)kTargetCount;
+}
+
+#else
+
+static bool loadEntries(Common::Array<GUI::LauncherEntry> &entries, const Common::String &suffix) {
+	return false;
+}
+
+#endif
+
+void runLauncherBenchmarks() {
+	const Common::String suffix = Common::String::format(" %d targets", kTargetCount);
+
+	// Loading the targets at startup, or sorting generated ones where the
+	// config file cannot be written
+	Common::Array<GUI::LauncherEntry> entries;
+	if (!loadEntries(entries, suffix)) {
+		entries = createEntries(kTargetCount);
+		Timer timer;
+		Common::sort(entries.begin(), entries.end(), GUI::LauncherEntryComparator());
+		report("gui/launcher", ("sort list" + suffix).c_str(), timer.elapsed() * 1e3, "ms");
+	}
+
+	// Building the search index, as ListWidget::setList() does
+	Timer timer;
+	GUI::ListFilterIndex index;
+	for (uint i = 0; i < entries.size(); ++i)
+		index.push_back(entries[i].description + '\n' + entries[i].key);
+	report("gui/launcher", ("build index" + suffix).c_str(), timer.elapsed() * 1e3, "ms");
+
+	// Typing a search, one key at a time
+	const Common::String search = "monkey island cd";
+	const int rounds = 20;
+	timer.restart();
+	for (int round = 0; round < rounds; ++round) {
+		for (uint length = 1; length <= search.size(); ++length)
+			index.setFilter(Common::String(search.c_str(), length));
+		consume(index.getMatches().size());
+		index.setFilter("");
+	}
+	report("gui/launcher", ("type filter" + suffix).c_str(), timer.elapsed() * 1e3 / (rounds * search.size()), "ms/key");
+
+	// Searching without a previous filter to refine
+	timer.restart();
+	for (int round = 0; round < rounds; ++round) {
+		index.setFilter(search);
+		consume(index.getMatches().size());
+		index.setFilter("");
+	}
+	report("gui/launcher", ("full filter" + suffix).c_str(), timer.elapsed() * 1e3 / rounds, "ms");
+}
+
+} // End of namespace Bench
@@ -0,0 +1,80 @@
+#include "test/bench/bench.h"
+
+#include "audio/audiostream.h"
+#include "audio/mixer.h"
+#include "audio/rate.h"
+
+#include "common/str.h"
+
+namespace Bench {
+
+/**
+ * An endless stream of pseudo random samples, so that the benchmark only
+ * measures the converter itself.
+ */
+class NoiseStream : public Audio::AudioStream {
+	bool _stereo;
+	int _rate;
+	int16 _noise[4096];
+	int _pos;
+public:
+	NoiseStream(bool stereo, int rate) : _stereo(stereo), _rate(rate), _pos(0) {
+		for (int i = 0; i < ARRAYSIZE(_noise); ++i)
+			_noise[i] = (int16)(nextRandom() >> 8);
+	}
+
+	int readBuffer(int16 *buffer, const int numSamples) {
+		for (int i = 0; i < numSamples; ++i) {
+			buffer[i] = _noise[_pos];
+			_pos = (_pos + 1) % ARRAYSIZE(_noise);
+		}
+		return numSamples;
+	}
+
+	bool isStereo() const { return _stereo; }
+	int getRate() const { return _rate; }
+	bool endOfData() const { return false; }
+};
+
+static void benchConverter(const char *typeName, Audio::RateConverterType type, int inRate, int outRate, bool stereo) {
+	// Several seconds of output, flowed in chunks of a typical mixer callback size
+	const int chunkFrames = 1024;
+	const int seconds = 20;
+
+	resetRandom(1);
+	NoiseStream stream(stereo, inRate);
+	Audio::RateConverter *converter = Audio::makeRateConverter(inRate, outRate, stereo, false, type);
+	int16 *buffer = new int16[chunkFrames * 2];
+
+	Timer timer;
+	for (int frames = 0; frames < outRate * seconds; frames += chunkFrames) {
+		memset(buffer, 0, chunkFrames * 2 * sizeof(int16));
+		converter->flow(stream, buffer, chunkFrames, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume);
+	}
+	const double elapsed = timer.elapsed();
+
+	delete[] buffer;
+	delete converter;
+
+	// Fraction of a single core needed to convert one channel in real time
+	const Common::String name = Common::String::format("%s %d->%d %s", typeName, inRate, outRate, stereo ? "stereo" : "mono");
+	report("audio/rate", name.c_str(), elapsed / seconds * 100.0, "% cpu/channel");
+}
+
+void runRateBenchmarks() {
+	static const int rates[][2] = {
+		{ 11025, 44100 },
+		{ 22050, 44100 },
+		{ 22050, 48000 },
+		{ 44100, 22050 }
+	};
+
+	for (int i = 0; i < ARRAYSIZE(rates); ++i) {
+		for (int stereo = 0; stereo < 2; ++stereo) {
+			benchConverter("default", Audio::kRateConverterDefault, rates[i][0], rates[i][1], stereo != 0);
+			benchConverter("sinc", Audio::kRateConverterSinc, rates[i][0], rates[i][1], stereo != 0);
+		}
+	}
+}
+
+} // End of namespace Bench
@@ -0,0 +1,68 @@
+#include "test/bench/bench.h"
+
+#include "common/cpudetect.h"
+#include "common/str.h"
+
+#include "graphics/scaler.h"
+
+namespace Bench {
+
+#ifdef USE_SCALERS
+
+static void benchScaler(const char *scalerName, ScalerProc *scaler, int factor, const char *pathName, uint32 featureMask) {
+	// 320x200 game screen with a one pixel border the scalers may read
+	const int width = 320;
+	const int height = 200;
+	const int pitch = width + 2;
+	const int frames = 100;
+
+	resetRandom(1);
+	uint16 *src = new uint16[pitch * (height + 2)];
+	for (int i = 0; i < pitch * (height + 2); ++i) {
+		// Runs of equal pixels, like in most game graphics
+		src[i] = (nextRandom() & 3) ? src[MAX(i - 1, 0)] : nextRandom();
+	}
+
+	const uint32 dstPitch = width * factor * sizeof(uint16);
+	byte *dst = new byte[dstPitch * height * factor];
+
+	Common::setCPUFeatureMask(featureMask);
+	Timer timer;
+	for (int frame = 0; frame < frames; ++frame)
+		scaler((const byte *)(src + pitch + 1), pitch * sizeof(uint16), dst, dstPitch, width, height);
+	const double elapsed = timer.elapsed();
+	Common::setCPUFeatureMask(0xFFFFFFFF);
+
+	consume(*(const uint16 *)dst);
+	delete[] src;
+	delete[] dst;
+
+	const Common::String name = Common::String::format("%s %s", scalerName, pathName);
+	report("graphics/scaler", name.c_str(), (double)width * height * frames / elapsed / 1000000.0, "Mpixels/s");
+}
+
+static void benchScaler(const char *scalerName, ScalerProc *scaler, int factor) {
+	benchScaler(scalerName, scaler, factor, "scalar", 0);
+	benchScaler(scalerName, scaler, factor, "simd", 0xFFFFFFFF);
+}
+
+#endif
+
+void runScalerBenchmarks() {
+#ifdef USE_SCALERS
+	InitScalers(565);
+
+	// Plain pixel doubling as the upper bound for the filtering scalers
+	benchScaler("normal2x", Normal2x, 2, "scalar", 0);
+	benchScaler("advmame2x", AdvMame2x, 2);
+	benchScaler("advmame3x", AdvMame3x, 3);
+#ifdef USE_HQ_SCALERS
+	benchScaler("hq2x", HQ2x, 2);
+	benchScaler("hq3x", HQ3x, 3);
+#endif
+
+	DestroyScalers();
+#endif
+}
+
+} // End of namespace Bench
@@ -0,0 +1,75 @@
+#include "test/bench/bench.h"
+
+#include "common/bufferedstream.h"
+#include "common/memstream.h"
+
+namespace Bench {
+
+static const uint32 kStreamSize = 16 * 1024 * 1024;
+
+static void benchReadByte(const char *name, Common::SeekableReadStream *stream) {
+	uint32 checksum = 0;
+
+	Timer timer;
+	for (uint32 i = 0; i < kStreamSize; ++i)
+		checksum += stream->readByte();
+	report("common/stream", name, kStreamSize / timer.elapsed() / (1024 * 1024), "MB/s");
+
+	consume(checksum);
+}
+
+static void benchReadUint32(const char *name, Common::SeekableReadStream *stream) {
+	uint32 checksum = 0;
+
+	Timer timer;
+	for (uint32 i = 0; i < kStreamSize / 4; ++i)
+		checksum += stream->readUint32LE();
+	report("common/stream", name, kStreamSize / timer.elapsed() / (1024 * 1024), "MB/s");
+
+	consume(checksum);
+}
+
+static void benchReadBlocks(const char *name, Common::SeekableReadStream *stream, uint32 blockSize, int passes) {
+	byte *block = new byte[blockSize];
+	uint32 checksum = 0;
+
+	Timer timer;
+	for (int pass = 0; pass < passes; ++pass) {
+		stream->seek(0);
+		for (uint32 i = 0; i < kStreamSize / blockSize; ++i) {
+			stream->read(block, blockSize);
+			checksum += block[i % blockSize];
+		}
+	}
+	report("common/stream", name, (double)kStreamSize * passes / timer.elapsed() / (1024 * 1024), "MB/s");
+
+	delete[] block;
+	consume(checksum);
+}
+
+void runStreamBenchmarks() {
+	resetRandom(1);
+	byte *data = new byte[kStreamSize];
+	for (uint32 i = 0; i < kStreamSize; ++i)
+		data[i] = (byte)nextRandom();
+
+	Common::MemoryReadStream memoryStream(data, kStreamSize);
+	benchReadByte("MemoryReadStream readByte", &memoryStream);
+	memoryStream.seek(0);
+	benchReadUint32("MemoryReadStream readUint32LE", &memoryStream);
+	benchReadBlocks("MemoryReadStream read 16 bytes", &memoryStream, 16, 4);
+	benchReadBlocks("MemoryReadStream read 4 KB", &memoryStream, 4096, 32);
+
+	Common::SeekableReadStream *bufferedStream = Common::wrapBufferedSeekableReadStream(&memoryStream, 4096, DisposeAfterUse::NO);
+	memoryStream.seek(0);
+	benchReadByte("BufferedReadStream readByte", bufferedStream);
+	bufferedStream->seek(0);
+	benchReadUint32("BufferedReadStream readUint32LE", bufferedStream);
+	benchReadBlocks("BufferedReadStream read 16 bytes", bufferedStream, 16, 4);
+	benchReadBlocks("BufferedReadStream read 4 KB", bufferedStream, 4096, 32);
+	delete bufferedStream;
+
+	delete[] data;
+}
+
+} // End of namespace Bench
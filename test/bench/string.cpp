@@ -0,0 +1,78 @@
+#include "test/bench/bench.h"
+
+#include "common/array.h"
+#include "common/str.h"
+
+namespace Bench {
+
+void runStringBenchmarks() {
+	const uint count = 5000000;
+
+	resetRandom(1);
+	Common::Array<Common::String> shortStrings, longStrings;
+	for (uint i = 0; i < 1000; ++i) {
+		// Short strings fit into the builtin storage, long ones live on the heap
+		shortStrings.push_back(Common::String::format("obj%u", nextRandom() % 10000));
+		longStrings.push_back(Common::String::format("a string which does not fit into the builtin storage %u", nextRandom()));
+	}
+
+	uint32 checksum = 0;
+
+	Timer timer;
+	for (uint i = 0; i < count; ++i) {
+		Common::String copy(shortStrings[i % shortStrings.size()]);
+		checksum += copy.size();
+	}
+	report("common/str", "copy short", timer.elapsed() * 1e9 / count, "ns/op");
+
+	timer.restart();
+	for (uint i = 0; i < count; ++i) {
+		Common::String copy(longStrings[i % longStrings.size()]);
+		checksum += copy.size();
+	}
+	report("common/str", "copy long (shared)", timer.elapsed() * 1e9 / count, "ns/op");
+
+	timer.restart();
+	for (uint i = 0; i < count; ++i) {
+		Common::String copy(longStrings[i % longStrings.size()].c_str());
+		checksum += copy.size();
+	}
+	report("common/str", "construct long", timer.elapsed() * 1e9 / count, "ns/op");
+
+	timer.restart();
+	for (uint i = 0; i < count / 1000; ++i) {
+		Common::String str;
+		for (uint j = 0; j < 1000; ++j)
+			str += (char)('a' + j % 26);
+		checksum += str.size();
+	}
+	report("common/str", "append char", timer.elapsed() * 1e9 / count, "ns/op");
+
+	timer.restart();
+	for (uint i = 0; i < count / 100; ++i) {
+		Common::String str;
+		for (uint j = 0; j < 100; ++j)
+			str += shortStrings[j];
+		checksum += str.size();
+	}
+	report("common/str", "append string", timer.elapsed() * 1e9 / count, "ns/op");
+
+	timer.restart();
+	for (uint i = 0; i < count / 10; ++i) {
+		const Common::String &a = longStrings[i % longStrings.size()];
+		const Common::String &b = longStrings[(i + 1) % longStrings.size()];
+		checksum += a.equalsIgnoreCase(b) + (a < b);
+	}
+	report("common/str", "compare", timer.elapsed() * 1e9 / (count / 10), "ns/op");
+
+	timer.restart();
+	for (uint i = 0; i < count / 10; ++i) {
+		const Common::String str = Common::String::format("%s.%03d", shortStrings[i % shortStrings.size()].c_str(), i % 1000);
+		checksum += str.size();
+	}
+	report("common/str", "format", timer.elapsed() * 1e9 / (count / 10), "ns/op");
+
+	consume(checksum);
+}
+
+} // End of namespace Bench
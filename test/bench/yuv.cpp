@@ -0,0 +1,74 @@
+#include "test/bench/bench.h"
+
+#include "common/cpudetect.h"
+#include "common/str.h"
+
+#include "graphics/yuv_to_rgb.h"
+
+namespace Bench {
+
+static void benchConvert(const char *layoutName, Graphics::YUVToRGBManager::Layout layout, const char *formatName, const Graphics::PixelFormat &format, const char *pathName, uint32 featureMask) {
+	// One second of 1080p video at 30 frames per second
+	const int width = 1920;
+	const int height = 1080;
+	const int frames = 30;
+
+	resetRandom(1);
+	byte *y = new byte[width * height];
+	byte *u = new byte[(width + 1) * (height + 1)];
+	byte *v = new byte[(width + 1) * (height + 1)];
+	for (int i = 0; i < width * height; ++i)
+		y[i] = nextRandom();
+	for (int i = 0; i < (width + 1) * (height + 1); ++i) {
+		u[i] = nextRandom();
+		v[i] = nextRandom();
+	}
+
+	Graphics::Surface surface;
+	surface.create(width, height, format);
+
+	Common::setCPUFeatureMask(featureMask);
+	Timer timer;
+	for (int frame = 0; frame < frames; ++frame) {
+		switch (layout) {
+		case Graphics::YUVToRGBManager::kLayout444:
+			YUVToRGBMan.convert444(&surface, Graphics::YUVToRGBManager::kScaleITU, y, u, v, width, height, width, width + 1);
+			break;
+		case Graphics::YUVToRGBManager::kLayout420:
+			YUVToRGBMan.convert420(&surface, Graphics::YUVToRGBManager::kScaleITU, y, u, v, width, height, width, width + 1);
+			break;
+		case Graphics::YUVToRGBManager::kLayout410:
+			YUVToRGBMan.convert410(&surface, Graphics::YUVToRGBManager::kScaleITU, y, u, v, width, height, width, width + 1);
+			break;
+		}
+	}
+	const double elapsed = timer.elapsed();
+	Common::setCPUFeatureMask(0xFFFFFFFF);
+
+	consume(*(const uint16 *)surface.getPixels());
+	surface.free();
+	delete[] y;
+	delete[] u;
+	delete[] v;
+
+	const Common::String name = Common::String::format("%s %s %s", layoutName, formatName, pathName);
+	report("graphics/yuv", name.c_str(), frames / elapsed, "frames/s");
+}
+
+static void benchLayout(const char *layoutName, Graphics::YUVToRGBManager::Layout layout) {
+	const Graphics::PixelFormat rgb565(2, 5, 6, 5, 0, 11, 5, 0, 0);
+	const Graphics::PixelFormat argb8888(4, 8, 8, 8, 8, 16, 8, 0, 24);
+
+	benchConvert(layoutName, layout, "16bpp", rgb565, "lookup", 0);
+	benchConvert(layoutName, layout, "16bpp", rgb565, "simd", 0xFFFFFFFF);
+	benchConvert(layoutName, layout, "32bpp", argb8888, "lookup", 0);
+	benchConvert(layoutName, layout, "32bpp", argb8888, "simd", 0xFFFFFFFF);
+}
+
+void runYUVBenchmarks() {
+	benchLayout("yuv420", Graphics::YUVToRGBManager::kLayout420);
+	benchLayout("yuv444", Graphics::YUVToRGBManager::kLayout444);
+	benchLayout("yuv410", Graphics::YUVToRGBManager::kLayout410);
+}
+
+} // End of namespace Bench
@@ -0,0 +1,152 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/archive.h"
+#include "common/memstream.h"
+
+/**
+ * Archive whose members are one byte streams containing the id of the
+ * archive, so that tests can tell which archive served a lookup.
+ */
+class TestArchive : public Common::Archive {
+public:
+	TestArchive(byte id) : _id(id) {}
+
+	void addMember(const Common::String &name) { _names.push_back(name); }
+
+	// Accept a name without listing it, like paths into sub directories.
+	void addHidden(const Common::String &name) { _hidden.push_back(name); }
+
+	virtual bool hasFile(const Common::String &name) const {
+		return contains(_names, name) || contains(_hidden, name);
+	}
+
+	virtual int listMembers(Common::ArchiveMemberList &list) const {
+		for (Common::List<Common::String>::const_iterator i = _names.begin(); i != _names.end(); ++i)
+			list.push_back(Common::ArchiveMemberPtr(new Common::GenericArchiveMember(*i, this)));
+		return _names.size();
+	}
+
+	virtual const Common::ArchiveMemberPtr getMember(const Common::String &name) const {
+		return Common::ArchiveMemberPtr(new Common::GenericArchiveMember(name, this));
+	}
+
+	virtual Common::SeekableReadStream *createReadStreamForMember(const Common::String &name) const {
+		if (!hasFile(name))
+			return 0;
+		return new Common::MemoryReadStream(&_id, 1);
+	}
+
+private:
+	static bool contains(const Common::List<Common::String> &list, const Common::String &name) {
+		for (Common::List<Common::String>::const_iterator i = list.begin(); i != list.end(); ++i) {
+			if (i->equalsIgnoreCase(name))
+				return true;
+		}
+		return false;
+	}
+
+	byte _id;
+	Common::List<Common::String> _names;
+	Common::List<Common::String> _hidden;
+};
+
+class SearchSetTestSuite : public CxxTest::TestSuite {
+	static int openedFrom(const Common::SearchSet &set, const char *name) {
+		Common::SeekableReadStream *stream = set.createReadStreamForMember(name);
+		if (!stream)
+			return -1;
+		int id = stream->readByte();
+		delete stream;
+		return id;
+	}
+
+	static void fill(Common::SearchSet &set) {
+		TestArchive *low = new TestArchive(1);
+		low->addMember("shared.dat");
+		low->addMember("low.dat");
+		TestArchive *high = new TestArchive(2);
+		high->addMember("SHARED.DAT");
+		high->addHidden("sub/high.dat");
+		set.add("low", low, 0);
+		set.add("high", high, 10);
+	}
+
+	public:
+	void test_index_matches_search() {
+		Common::SearchSet plain, indexed;
+		fill(plain);
+		fill(indexed);
+		indexed.enableIndex(true);
+
+		const char *names[] = { "shared.dat", "Shared.Dat", "low.dat", "sub/high.dat", "missing.dat" };
+		for (int i = 0; i < ARRAYSIZE(names); ++i) {
+			TS_ASSERT_EQUALS(indexed.hasFile(names[i]), plain.hasFile(names[i]));
+			TS_ASSERT_EQUALS(openedFrom(indexed, names[i]), openedFrom(plain, names[i]));
+		}
+
+		TS_ASSERT_EQUALS(openedFrom(indexed, "shared.dat"), 2);
+		TS_ASSERT_EQUALS(openedFrom(indexed, "sub/high.dat"), 2);
+		TS_ASSERT_EQUALS(openedFrom(indexed, "missing.dat"), -1);
+	}
+
+	void test_index_stats() {
+		Common::SearchSet set;
+		fill(set);
+
+		TS_ASSERT(set.hasFile("low.dat"));
+		TS_ASSERT_EQUALS(set.getIndexHits(), 0u);
+		TS_ASSERT_EQUALS(set.getIndexMisses(), 0u);
+
+		set.enableIndex(true);
+		TS_ASSERT(set.hasFile("low.dat"));
+		TS_ASSERT(set.hasFile("LOW.DAT"));
+		TS_ASSERT(set.hasFile("sub/high.dat"));
+		TS_ASSERT(!set.hasFile("missing.dat"));
+		TS_ASSERT_EQUALS(set.getIndexHits(), 2u);
+		TS_ASSERT_EQUALS(set.getIndexMisses(), 2u);
+
+		set.resetIndexStats();
+		TS_ASSERT_EQUALS(set.getIndexHits(), 0u);
+		TS_ASSERT_EQUALS(set.getIndexMisses(), 0u);
+	}
+
+	void test_index_invalidation() {
+		Common::SearchSet set;
+		fill(set);
+		set.enableIndex(true);
+		TS_ASSERT_EQUALS(openedFrom(set, "shared.dat"), 2);
+
+		set.setPriority("low", 20);
+		TS_ASSERT_EQUALS(openedFrom(set, "shared.dat"), 1);
+
+		set.remove("low");
+		TS_ASSERT_EQUALS(openedFrom(set, "shared.dat"), 2);
+		TS_ASSERT(!set.hasFile("low.dat"));
+
+		TestArchive *top = new TestArchive(3);
+		top->addMember("shared.dat");
+		set.add("top", top, 30);
+		TS_ASSERT_EQUALS(openedFrom(set, "shared.dat"), 3);
+
+		set.clear();
+		TS_ASSERT(!set.hasFile("shared.dat"));
+	}
+
+	void test_index_unlisted_archive() {
+		Common::SearchSet set;
+		fill(set);
+
+		// An archive which does not list its members still wins over a
+		// lower priority archive listing the same name.
+		TestArchive *unlisted = new TestArchive(3);
+		unlisted->addHidden("low.dat");
+		set.add("unlisted", unlisted, 5);
+		set.enableIndex(true);
+
+		TS_ASSERT_EQUALS(openedFrom(set, "low.dat"), 3);
+		TS_ASSERT_EQUALS(openedFrom(set, "shared.dat"), 2);
+
+		set.setPriority("unlisted", -5);
+		TS_ASSERT_EQUALS(openedFrom(set, "low.dat"), 1);
+	}
+};
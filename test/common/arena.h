@@ -0,0 +1,207 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/arena.h"
+#include "common/list.h"
+#include "common/memorypool.h"
+#include "common/str.h"
+
+class ArenaTestSuite : public CxxTest::TestSuite
+{
+	public:
+	void test_stats() {
+		Common::Arena arena;
+		TS_ASSERT_EQUALS(arena.getLiveObjects(), 0u);
+		TS_ASSERT_EQUALS(arena.getLiveBytes(), 0u);
+
+		void *a = arena.allocate(10);
+		void *b = arena.allocate(100);
+		void *c = arena.allocate(10000);
+		TS_ASSERT(a && b && c);
+		TS_ASSERT_DIFFERS(a, b);
+		memset(a, 1, 10);
+		memset(b, 2, 100);
+		memset(c, 3, 10000);
+
+		TS_ASSERT_EQUALS(arena.getLiveObjects(), 3u);
+		TS_ASSERT_EQUALS(arena.getLiveBytes(), 10110u);
+		TS_ASSERT_EQUALS(arena.getFrameAllocations(), 3u);
+
+		arena.deallocate(c, 10000);
+		arena.deallocate(a, 10);
+		TS_ASSERT_EQUALS(arena.getLiveObjects(), 1u);
+		TS_ASSERT_EQUALS(arena.getLiveBytes(), 100u);
+		TS_ASSERT_EQUALS(arena.getPeakBytes(), 10110u);
+
+		arena.beginFrame();
+		TS_ASSERT_EQUALS(arena.getFrameAllocations(), 0u);
+		a = arena.allocate(16);
+		TS_ASSERT_EQUALS(arena.getFrameAllocations(), 1u);
+		TS_ASSERT_EQUALS(arena.getTotalAllocations(), 4u);
+
+		arena.deallocate(a, 16);
+		arena.deallocate(b, 100);
+		TS_ASSERT_EQUALS(arena.getLiveObjects(), 0u);
+	}
+
+	void test_reuse() {
+		Common::Arena arena;
+		void *a = arena.allocate(32);
+		arena.deallocate(a, 32);
+		// Blocks of the same size class are recycled
+		TS_ASSERT_EQUALS(arena.allocate(20), a);
+	}
+
+	void test_reset() {
+		Common::Arena arena;
+		// Fill the first four pages of the pool (8 + 16 + 32 + 64 chunks)
+		void *first[120];
+		for (int i = 0; i < 120; ++i)
+			first[i] = arena.allocate(24);
+		arena.allocate(5000);
+		TS_ASSERT_EQUALS(arena.getLiveObjects(), 121u);
+
+		arena.reset();
+		TS_ASSERT_EQUALS(arena.getLiveObjects(), 0u);
+		TS_ASSERT_EQUALS(arena.getLiveBytes(), 0u);
+		TS_ASSERT_EQUALS(arena.getPeakBytes(), 24u * 120 + 5000);
+
+		// The pages are kept, so the same memory is handed out again
+		for (int i = 0; i < 120; ++i) {
+			void *p = arena.allocate(24);
+			bool found = false;
+			for (int j = 0; j < 120; ++j)
+				found |= (first[j] == p);
+			TS_ASSERT(found);
+		}
+	}
+
+	void test_scope() {
+		Common::Arena arena;
+		TS_ASSERT(Common::Arena::getCurrent() == 0);
+		{
+			Common::ArenaScope scope(&arena);
+			TS_ASSERT_EQUALS(Common::Arena::getCurrent(), &arena);
+			{
+				Common::ArenaScope inner(0);
+				TS_ASSERT(Common::Arena::getCurrent() == 0);
+			}
+			TS_ASSERT_EQUALS(Common::Arena::getCurrent(), &arena);
+
+			void *p = Common::arenaAlloc(40);
+			TS_ASSERT_EQUALS(arena.getLiveObjects(), 1u);
+			Common::arenaFree(p, 40);
+			TS_ASSERT_EQUALS(arena.getLiveObjects(), 0u);
+		}
+		TS_ASSERT(Common::Arena::getCurrent() == 0);
+
+		// Heap blocks may be released while an arena is current
+		void *p = Common::arenaAlloc(40);
+		{
+			Common::ArenaScope scope(&arena);
+			Common::arenaFree(p, 40);
+		}
+		TS_ASSERT_EQUALS(arena.getLiveObjects(), 0u);
+	}
+
+	void test_containers() {
+		Common::Arena arena;
+		Common::List<Common::String> list;
+		{
+			Common::ArenaScope scope(&arena);
+			for (int i = 0; i < 50; ++i)
+				list.push_back(Common::String::format("a string long enough to live on the heap, number %d", i));
+#ifdef USE_ARENA_ALLOCATOR
+			TS_ASSERT_EQUALS(arena.getLiveObjects(), 100u);
+#else
+			TS_ASSERT_EQUALS(arena.getLiveObjects(), 0u);
+#endif
+		}
+
+		// Containers filled in a scope stay usable after it ends
+		int i = 0;
+		for (Common::List<Common::String>::const_iterator it = list.begin(); it != list.end(); ++it, ++i)
+			TS_ASSERT_EQUALS(*it, Common::String::format("a string long enough to live on the heap, number %d", i));
+		list.clear();
+		TS_ASSERT_EQUALS(arena.getLiveObjects(), 0u);
+	}
+
+	// The String and List hooks only exist in builds configured with
+	// --enable-arena-allocator
+	void test_string() {
+#ifdef USE_ARENA_ALLOCATOR
+		Common::Arena arena;
+		// Strings created outside of a scope keep using the heap
+		Common::String outside("a string long enough to live on the heap");
+		{
+			Common::ArenaScope scope(&arena);
+			Common::String builtin("short");
+			TS_ASSERT_EQUALS(arena.getLiveObjects(), 0u);
+
+			Common::String inside("another string long enough to live on the heap");
+			TS_ASSERT_EQUALS(arena.getLiveObjects(), 1u);
+			const size_t peak = arena.getPeakBytes();
+			TS_ASSERT_LESS_THAN(0u, peak);
+
+			// Growing allocates the new storage before freeing the old one
+			inside += ", grown past the capacity of its first allocation";
+			TS_ASSERT_EQUALS(arena.getLiveObjects(), 1u);
+			TS_ASSERT_LESS_THAN(peak, arena.getPeakBytes());
+
+			outside += ", and grown past the capacity of its heap storage";
+			TS_ASSERT_EQUALS(arena.getLiveObjects(), 2u);
+		}
+		TS_ASSERT_EQUALS(arena.getLiveObjects(), 1u);
+
+		// The storage is returned to its arena after the scope ended
+		outside.clear();
+		TS_ASSERT_EQUALS(arena.getLiveObjects(), 0u);
+		TS_ASSERT_EQUALS(arena.getLiveBytes(), 0u);
+#endif
+	}
+
+	void test_list() {
+#ifdef USE_ARENA_ALLOCATOR
+		Common::Arena arena;
+		Common::List<int> list;
+		list.push_back(-1);
+		{
+			Common::ArenaScope scope(&arena);
+			for (int i = 0; i < 10; ++i)
+				list.push_back(i);
+			TS_ASSERT_EQUALS(arena.getLiveObjects(), 10u);
+			TS_ASSERT_EQUALS(arena.getFrameAllocations(), 10u);
+			const size_t peak = arena.getPeakBytes();
+			TS_ASSERT_LESS_THAN(10 * sizeof(int), peak);
+
+			list.pop_front();
+			list.pop_back();
+			TS_ASSERT_EQUALS(arena.getLiveObjects(), 9u);
+			TS_ASSERT_EQUALS(arena.getPeakBytes(), peak);
+		}
+		TS_ASSERT_EQUALS(list.size(), 9u);
+		TS_ASSERT_EQUALS(list.front(), 0);
+		TS_ASSERT_EQUALS(list.back(), 8);
+
+		list.clear();
+		TS_ASSERT_EQUALS(arena.getLiveObjects(), 0u);
+		TS_ASSERT_EQUALS(arena.getLiveBytes(), 0u);
+#endif
+	}
+
+	void test_memorypool_free_all() {
+		// Use up the internal storage and the first allocated page
+		Common::FixedSizeMemoryPool<16, 4> pool;
+		void *chunks[12];
+		for (int i = 0; i < 12; ++i)
+			chunks[i] = pool.allocChunk();
+
+		pool.freeAllChunks();
+		for (int i = 0; i < 12; ++i) {
+			void *p = pool.allocChunk();
+			bool found = false;
+			for (int j = 0; j < 12; ++j)
+				found |= (chunks[j] == p);
+			TS_ASSERT(found);
+		}
+	}
+};
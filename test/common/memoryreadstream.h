@@ -104,4 +104,12 @@ class MemoryReadStreamTestSuite : public CxxTest::TestSuite {
 		ms.seek(0, SEEK_SET);
 		TS_ASSERT(!ms.eos());
 	}
+
+	void test_get_memory() {
+		byte contents[] = { 1, 2, 3 };
+		Common::MemoryReadStream ms(contents, sizeof(contents));
+
+		ms.readByte();
+		TS_ASSERT_EQUALS(ms.getMemory(), contents);
+	}
 };
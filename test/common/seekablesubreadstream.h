@@ -70,4 +70,19 @@ class SeekableSubReadStreamTestSuite : public CxxTest::TestSuite {
 		b = ssrs.readByte();
 		TS_ASSERT_EQUALS(b, 1);
 	}
+
+	void test_get_memory() {
+		byte contents[10] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+		Common::MemoryReadStream ms(contents, 10);
+
+		Common::SeekableSubReadStream ssrs(&ms, 2, 8);
+		TS_ASSERT_EQUALS(ssrs.getMemory(), contents + 2);
+
+		// A substream reaching past its parent has no valid memory range
+		Common::SeekableSubReadStream pastEnd(&ms, 2, 12);
+		TS_ASSERT(!pastEnd.getMemory());
+
+		Common::SeekableSubReadStream nested(&ssrs, 1, 3);
+		TS_ASSERT_EQUALS(nested.getMemory(), contents + 3);
+	}
 };
@@ -0,0 +1,132 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/workerpool.h"
+
+class CounterJob : public Common::WorkerJob {
+public:
+	CounterJob() : _count(0) {}
+
+	void run() {
+		++_count;
+	}
+
+	int _count;
+};
+
+class OrderJob : public Common::WorkerJob {
+public:
+	OrderJob() : _id(0), _order(nullptr), _count(nullptr) {}
+
+	void run() {
+		_order[(*_count)++] = _id;
+	}
+
+	int _id;
+	int *_order;
+	int *_count;
+};
+
+class MarkBandsJob : public Common::BandedJob {
+public:
+	MarkBandsJob(int count) : _marks(new int[count]) {
+		memset(_marks, 0, count * sizeof(int));
+	}
+
+	~MarkBandsJob() {
+		delete[] _marks;
+	}
+
+	void runBand(int begin, int end) {
+		for (int i = begin; i < end; ++i)
+			++_marks[i];
+	}
+
+	int *_marks;
+};
+
+class WorkerPoolTestSuite : public CxxTest::TestSuite
+{
+	public:
+	void test_inline_pool() {
+		Common::WorkerPool pool(0);
+		TS_ASSERT_EQUALS(pool.getThreadCount(), 0u);
+
+		CounterJob job;
+		TS_ASSERT(pool.isDone(&job));
+		pool.submit(&job);
+		TS_ASSERT_EQUALS(job._count, 1);
+		TS_ASSERT(pool.isDone(&job));
+	}
+
+	void test_submit_wait() {
+		Common::WorkerPool pool(3);
+
+		CounterJob jobs[64];
+		for (int round = 0; round < 4; ++round) {
+			for (int i = 0; i < ARRAYSIZE(jobs); ++i)
+				pool.submit(&jobs[i]);
+
+			// Waiting on a job which is still queued runs it right away
+			pool.wait(&jobs[ARRAYSIZE(jobs) - 1]);
+			TS_ASSERT(pool.isDone(&jobs[ARRAYSIZE(jobs) - 1]));
+
+			pool.waitAll();
+			for (int i = 0; i < ARRAYSIZE(jobs); ++i) {
+				TS_ASSERT(pool.isDone(&jobs[i]));
+				TS_ASSERT_EQUALS(jobs[i]._count, round + 1);
+			}
+		}
+	}
+
+	void test_sequential() {
+		Common::WorkerPool pool(1, true);
+
+		OrderJob jobs[32];
+		int order[ARRAYSIZE(jobs)];
+		int count = 0;
+		for (int i = 0; i < ARRAYSIZE(jobs); ++i) {
+			jobs[i]._id = i;
+			jobs[i]._order = order;
+			jobs[i]._count = &count;
+			pool.submit(&jobs[i]);
+		}
+
+		// Waiting on the last job must not run it ahead of the others
+		pool.wait(&jobs[ARRAYSIZE(jobs) - 1]);
+		TS_ASSERT_EQUALS(count, ARRAYSIZE(jobs));
+		for (int i = 0; i < ARRAYSIZE(jobs); ++i)
+			TS_ASSERT_EQUALS(order[i], i);
+	}
+
+	void test_destructor_runs_pending_jobs() {
+		CounterJob jobs[16];
+		{
+			Common::WorkerPool pool(2);
+			for (int i = 0; i < ARRAYSIZE(jobs); ++i)
+				pool.submit(&jobs[i]);
+		}
+
+		for (int i = 0; i < ARRAYSIZE(jobs); ++i)
+			TS_ASSERT_EQUALS(jobs[i]._count, 1);
+	}
+
+	void test_banded() {
+		static const int counts[] = { 0, 1, 7, 100, 1001 };
+		Common::WorkerPool pool(3);
+
+		for (int i = 0; i < ARRAYSIZE(counts); ++i) {
+			for (int minBandSize = 1; minBandSize < 200; minBandSize *= 3) {
+				// Every item is processed exactly once
+				MarkBandsJob job(counts[i]);
+				Common::runBanded(job, counts[i], minBandSize, &pool);
+				for (int j = 0; j < counts[i]; ++j)
+					TS_ASSERT_EQUALS(job._marks[j], 1);
+
+				MarkBandsJob sharedJob(counts[i]);
+				Common::runBanded(sharedJob, counts[i], minBandSize);
+				for (int j = 0; j < counts[i]; ++j)
+					TS_ASSERT_EQUALS(sharedJob._marks[j], 1);
+			}
+		}
+	}
+};
@@ -0,0 +1,78 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/memstream.h"
+#include "engines/detectioncache.h"
+
+class DetectionCacheTestSuite : public CxxTest::TestSuite {
+	public:
+	void setUp() {
+		DetectionCacheMan.clear();
+	}
+
+	void test_hit() {
+		DetectionCache &cache = DetectionCacheMan;
+		cache.store("/games/monkey/000.lfl", 5000, 1234, 42, "0123456789abcdef0123456789abcdef");
+
+		Common::String md5;
+		TS_ASSERT(cache.lookup("/games/monkey/000.lfl", 5000, 1234, 42, md5));
+		TS_ASSERT_EQUALS(md5, "0123456789abcdef0123456789abcdef");
+		TS_ASSERT_EQUALS(cache.getHits(), 1u);
+		TS_ASSERT_EQUALS(cache.getMisses(), 0u);
+	}
+
+	void test_miss() {
+		DetectionCache &cache = DetectionCacheMan;
+		cache.store("/games/monkey/000.lfl", 5000, 1234, 42, "0123456789abcdef0123456789abcdef");
+
+		Common::String md5;
+		// Unknown file
+		TS_ASSERT(!cache.lookup("/games/monkey/001.lfl", 5000, 1234, 42, md5));
+		// Same file, but hashed over a different number of bytes
+		TS_ASSERT(!cache.lookup("/games/monkey/000.lfl", 0, 1234, 42, md5));
+		TS_ASSERT_EQUALS(cache.getHits(), 0u);
+		TS_ASSERT_EQUALS(cache.getMisses(), 2u);
+	}
+
+	void test_stale() {
+		DetectionCache &cache = DetectionCacheMan;
+		cache.store("/games/monkey/000.lfl", 5000, 1234, 42, "0123456789abcdef0123456789abcdef");
+
+		Common::String md5;
+		// The file changed size
+		TS_ASSERT(!cache.lookup("/games/monkey/000.lfl", 5000, 1235, 42, md5));
+		// The file was modified
+		TS_ASSERT(!cache.lookup("/games/monkey/000.lfl", 5000, 1234, 43, md5));
+
+		// Storing the new checksum replaces the stale entry
+		cache.store("/games/monkey/000.lfl", 5000, 1234, 43, "fedcba9876543210fedcba9876543210");
+		TS_ASSERT(!cache.lookup("/games/monkey/000.lfl", 5000, 1234, 42, md5));
+		TS_ASSERT(cache.lookup("/games/monkey/000.lfl", 5000, 1234, 43, md5));
+		TS_ASSERT_EQUALS(md5, "fedcba9876543210fedcba9876543210");
+	}
+
+	void test_save_load() {
+		DetectionCache &cache = DetectionCacheMan;
+		cache.store("/games/monkey/000.lfl", 5000, 1234, 42, "0123456789abcdef0123456789abcdef");
+		cache.store("/games/loom/000.lfl", 0, 99, 7, "fedcba9876543210fedcba9876543210");
+
+		Common::MemoryWriteStreamDynamic out(DisposeAfterUse::YES);
+		TS_ASSERT_EQUALS(cache.saveToStream(out), 2u);
+
+		cache.clear();
+		Common::MemoryReadStream in(out.getData(), out.size());
+		TS_ASSERT(cache.loadFromStream(in));
+
+		Common::String md5;
+		TS_ASSERT(cache.lookup("/games/monkey/000.lfl", 5000, 1234, 42, md5));
+		TS_ASSERT_EQUALS(md5, "0123456789abcdef0123456789abcdef");
+		TS_ASSERT(cache.lookup("/games/loom/000.lfl", 0, 99, 7, md5));
+		TS_ASSERT_EQUALS(md5, "fedcba9876543210fedcba9876543210");
+		TS_ASSERT(!cache.lookup("/games/loom/000.lfl", 0, 99, 8, md5));
+	}
+
+	void test_load_invalid() {
+		const byte data[12] = { 'N', 'O', 'P', 'E', 1, 0, 0, 0, 0, 0, 0, 0 };
+		Common::MemoryReadStream in(data, sizeof(data));
+		TS_ASSERT(!DetectionCacheMan.loadFromStream(in));
+	}
+};
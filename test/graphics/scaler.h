@@ -0,0 +1,102 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/cpudetect.h"
+#include "graphics/scaler.h"
+
+class ScalerTestSuite : public CxxTest::TestSuite
+{
+private:
+	enum {
+		// Odd sizes, so that the vectorized scalers leave pixels for the
+		// C implementations
+		kWidth = 53,
+		kHeight = 17,
+		kPitch = kWidth + 2
+	};
+
+	uint32 _seed;
+	// The source has a border of one pixel the scalers may read
+	uint16 _src[kPitch * (kHeight + 2)];
+
+	uint32 nextRandom() {
+		_seed = _seed * 1103515245 + 12345;
+		return _seed >> 8;
+	}
+
+	void fillSource() {
+		// Mostly a few colors, so that many neighbours are equal or similar
+		static const uint16 colors[] = { 0x0000, 0xFFFF, 0xF800, 0xF820, 0x07E0, 0x001F };
+
+		_seed = 1;
+		for (int i = 0; i < ARRAYSIZE(_src); ++i) {
+			const uint32 r = nextRandom();
+			_src[i] = (r & 7) ? colors[(r >> 3) % ARRAYSIZE(colors)] : (r >> 8);
+		}
+	}
+
+	void scalerTestTemplate(ScalerProc *scaler, int factor) {
+		fillSource();
+		InitScalers(565);
+
+		const byte *src = (const byte *)(_src + kPitch + 1);
+		const uint32 srcPitch = kPitch * sizeof(uint16);
+		const int dstWidth = kWidth * factor;
+		const int dstHeight = kHeight * factor;
+		const uint32 dstPitch = dstWidth * sizeof(uint16);
+
+		// The C implementations are the reference for the vectorized ones
+		uint16 *reference = new uint16[dstWidth * dstHeight];
+		uint16 *optimized = new uint16[dstWidth * dstHeight];
+		Common::setCPUFeatureMask(0);
+		scaler(src, srcPitch, (byte *)reference, dstPitch, kWidth, kHeight);
+
+		static const uint32 featureMasks[] = {
+			Common::kCPUFeatureSSE2,
+			0xFFFFFFFF
+		};
+
+		for (int i = 0; i < ARRAYSIZE(featureMasks); ++i) {
+			Common::setCPUFeatureMask(featureMasks[i]);
+			memset(optimized, 0, dstWidth * dstHeight * sizeof(uint16));
+			scaler(src, srcPitch, (byte *)optimized, dstPitch, kWidth, kHeight);
+
+			for (int y = 0; y < dstHeight; ++y)
+				TS_ASSERT_EQUALS(memcmp(reference + y * dstWidth, optimized + y * dstWidth, dstPitch), 0);
+		}
+		Common::setCPUFeatureMask(0xFFFFFFFF);
+
+		delete[] reference;
+		delete[] optimized;
+		DestroyScalers();
+	}
+
+public:
+#ifdef USE_SCALERS
+	void test_advmame2x() {
+		scalerTestTemplate(AdvMame2x, 2);
+	}
+
+	void test_advmame3x() {
+		scalerTestTemplate(AdvMame3x, 3);
+	}
+
+#ifdef USE_HQ_SCALERS
+	void test_hq2x() {
+		scalerTestTemplate(HQ2x, 2);
+	}
+
+	void test_hq3x() {
+		scalerTestTemplate(HQ3x, 3);
+	}
+#endif
+
+	void test_reentrant() {
+		TS_ASSERT(isScalerReentrant(Normal2x));
+		TS_ASSERT(isScalerReentrant(AdvMame2x));
+#if defined(USE_HQ_SCALERS) && defined(USE_NASM)
+		TS_ASSERT(!isScalerReentrant(HQ2x));
+		TS_ASSERT(!isScalerReentrant(HQ3x));
+#endif
+	}
+#endif
+};
@@ -0,0 +1,71 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/cpudetect.h"
+#include "graphics/skip_copy_kernels.h"
+
+class SkipCopyKernelsTestSuite : public CxxTest::TestSuite
+{
+private:
+	enum {
+		kMaxWidth = 100,
+		kSkipColor = 0xFF
+	};
+
+	uint32 _seed;
+
+	uint32 nextRandom() {
+		_seed = _seed * 1103515245 + 12345;
+		return _seed >> 8;
+	}
+
+	void fillRows(byte *target, byte *source) {
+		for (int i = 0; i < kMaxWidth; ++i) {
+			target[i] = nextRandom();
+			// Every third source pixel is transparent on average
+			source[i] = (nextRandom() % 3) ? (byte)(nextRandom() % kSkipColor) : (byte)kSkipColor;
+		}
+	}
+
+public:
+	void test_widths() {
+		static const uint32 featureMasks[] = {
+			Common::kCPUFeatureSSE2 | Common::kCPUFeatureNEON,
+			0xFFFFFFFF
+		};
+
+		byte source[kMaxWidth], target[kMaxWidth], reference[kMaxWidth], optimized[kMaxWidth];
+
+		Common::setCPUFeatureMask(0);
+		TS_ASSERT_EQUALS(Graphics::getSkipCopyProc(), &Graphics::skipCopyRow);
+
+		_seed = 1;
+		for (int width = 0; width < kMaxWidth; ++width) {
+			fillRows(target, source);
+
+			// Start one pixel in as well, so unaligned rows are covered
+			for (int offset = 0; offset < 2; ++offset) {
+				memcpy(reference, target, kMaxWidth);
+				Graphics::skipCopyRow(reference + offset, source + offset, width, kSkipColor);
+
+				for (int i = 0; i < ARRAYSIZE(featureMasks); ++i) {
+					Common::setCPUFeatureMask(featureMasks[i]);
+					memcpy(optimized, target, kMaxWidth);
+					Graphics::getSkipCopyProc()(optimized + offset, source + offset, width, kSkipColor);
+					TS_ASSERT_EQUALS(memcmp(reference, optimized, kMaxWidth), 0);
+				}
+				Common::setCPUFeatureMask(0xFFFFFFFF);
+			}
+		}
+	}
+
+	void test_all_transparent() {
+		byte source[kMaxWidth], target[kMaxWidth];
+		memset(source, kSkipColor, kMaxWidth);
+		for (int i = 0; i < kMaxWidth; ++i)
+			target[i] = i;
+
+		Graphics::getSkipCopyProc()(target, source, kMaxWidth, kSkipColor);
+		for (int i = 0; i < kMaxWidth; ++i)
+			TS_ASSERT_EQUALS(target[i], i);
+	}
+};
@@ -0,0 +1,131 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/transform_cache.h"
+
+class TransformCacheTestSuite : public CxxTest::TestSuite
+{
+private:
+	void createSprite(Graphics::TransparentSurface &sprite, uint16 width, uint16 height, uint32 seed) {
+		sprite.create(width, height, Graphics::TransparentSurface::getSupportedPixelFormat());
+		uint32 *pixels = (uint32 *)sprite.getPixels();
+		for (int i = 0; i < width * height; ++i) {
+			seed = seed * 1103515245 + 12345;
+			pixels[i] = seed;
+		}
+	}
+
+	bool equals(const Graphics::Surface &a, const Graphics::Surface &b) {
+		if (a.w != b.w || a.h != b.h)
+			return false;
+		for (int y = 0; y < a.h; ++y)
+			if (memcmp(a.getBasePtr(0, y), b.getBasePtr(0, y), a.w * 4))
+				return false;
+		return true;
+	}
+
+public:
+	void test_hits_and_misses() {
+		Graphics::TransparentSurface sprite;
+		createSprite(sprite, 40, 30, 1);
+		Graphics::TransformCache cache;
+		const Graphics::TransformStruct transform(150, 100, 30, 10, 5);
+
+		const Graphics::TransparentSurface *first = cache.rotoscale(sprite, 0, transform);
+		TS_ASSERT_EQUALS(cache.getMisses(), 1u);
+		TS_ASSERT_EQUALS(cache.getHits(), 0u);
+
+		Graphics::TransparentSurface *expected = sprite.rotoscaleT<Graphics::FILTER_BILINEAR>(transform);
+		TS_ASSERT(equals(*first, *expected));
+		expected->free();
+		delete expected;
+
+		TS_ASSERT_EQUALS(cache.rotoscale(sprite, 0, transform), first);
+		TS_ASSERT_EQUALS(cache.getHits(), 1u);
+
+		// Anything which changes the result is a different entry
+		const Graphics::TransformStruct otherHotspot(150, 100, 30, 11, 5);
+		TS_ASSERT_DIFFERS(cache.rotoscale(sprite, 0, otherHotspot), first);
+		cache.rotoscale(sprite, 0, transform, Graphics::FILTER_NEAREST);
+		cache.rotoscale(sprite, 1, transform);
+		cache.scale(sprite, 0, 80, 60);
+		cache.scale(sprite, 0, 80, 60, Graphics::FILTER_AREA);
+		TS_ASSERT_EQUALS(cache.getMisses(), 6u);
+		TS_ASSERT_EQUALS(cache.getEntryCount(), 6u);
+
+		const Graphics::TransparentSurface *scaled = cache.scale(sprite, 0, 80, 60);
+		TS_ASSERT_EQUALS(scaled->w, 80);
+		TS_ASSERT_EQUALS(scaled->h, 60);
+		TS_ASSERT_EQUALS(cache.getHits(), 2u);
+
+		// Rotoscaling has no area filter, it gives the bilinear result
+		TS_ASSERT_EQUALS(cache.rotoscale(sprite, 0, transform, Graphics::FILTER_AREA), first);
+		TS_ASSERT_EQUALS(cache.getHits(), 3u);
+		TS_ASSERT_EQUALS(cache.getEntryCount(), 6u);
+
+		cache.resetStats();
+		TS_ASSERT_EQUALS(cache.getHits(), 0u);
+		TS_ASSERT_EQUALS(cache.getMisses(), 0u);
+
+		cache.clear();
+		TS_ASSERT_EQUALS(cache.getEntryCount(), 0u);
+		TS_ASSERT_EQUALS(cache.getBytes(), 0u);
+		sprite.free();
+	}
+
+	void test_memory_ceiling() {
+		Graphics::TransparentSurface sprite;
+		createSprite(sprite, 16, 16, 2);
+
+		// Room for three 32x32 results
+		Graphics::TransformCache cache(3 * 32 * 32 * 4);
+
+		cache.scale(sprite, 0, 32, 32);
+		cache.scale(sprite, 1, 32, 32);
+		cache.scale(sprite, 2, 32, 32);
+		TS_ASSERT_EQUALS(cache.getBytes(), 3u * 32 * 32 * 4);
+		TS_ASSERT_EQUALS(cache.getEvictions(), 0u);
+
+		// Use the oldest one, so that the second one is evicted instead
+		cache.scale(sprite, 0, 32, 32);
+		cache.scale(sprite, 3, 32, 32);
+		TS_ASSERT_EQUALS(cache.getEvictions(), 1u);
+		TS_ASSERT_EQUALS(cache.getEntryCount(), 3u);
+		TS_ASSERT(cache.getBytes() <= cache.getMaxBytes());
+
+		const uint32 misses = cache.getMisses();
+		cache.scale(sprite, 0, 32, 32);
+		cache.scale(sprite, 2, 32, 32);
+		TS_ASSERT_EQUALS(cache.getMisses(), misses);
+		cache.scale(sprite, 1, 32, 32);
+		TS_ASSERT_EQUALS(cache.getMisses(), misses + 1);
+
+		// A result larger than the ceiling is still returned
+		const Graphics::TransparentSurface *large = cache.scale(sprite, 0, 128, 128);
+		TS_ASSERT(large);
+		TS_ASSERT_EQUALS(cache.getEntryCount(), 1u);
+
+		cache.setMaxBytes(0);
+		TS_ASSERT_EQUALS(cache.getEntryCount(), 0u);
+		sprite.free();
+	}
+
+	void test_invalidate() {
+		Graphics::TransparentSurface sprite1, sprite2;
+		createSprite(sprite1, 16, 16, 3);
+		createSprite(sprite2, 16, 16, 4);
+		Graphics::TransformCache cache;
+
+		cache.scale(sprite1, 0, 20, 20);
+		cache.scale(sprite1, 0, 24, 24);
+		cache.scale(sprite2, 0, 20, 20);
+		cache.invalidate(sprite1);
+		TS_ASSERT_EQUALS(cache.getEntryCount(), 1u);
+		TS_ASSERT_EQUALS(cache.getBytes(), 20u * 20 * 4);
+
+		cache.scale(sprite2, 0, 20, 20);
+		TS_ASSERT_EQUALS(cache.getHits(), 1u);
+
+		sprite1.free();
+		sprite2.free();
+	}
+};
@@ -0,0 +1,245 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/cpudetect.h"
+#include "graphics/transparent_surface.h"
+#include "graphics/transparent_surface_kernels.h"
+#include "graphics/transform_tools.h"
+
+class TransparentSurfaceTestSuite : public CxxTest::TestSuite
+{
+private:
+	uint32 _seed;
+
+	uint32 nextRandom() {
+		_seed = _seed * 1103515245 + 12345;
+		return _seed >> 8;
+	}
+
+	void fillRandom(Graphics::Surface &surface) {
+		for (int y = 0; y < surface.h; ++y) {
+			uint32 *pixels = (uint32 *)surface.getBasePtr(0, y);
+			for (int x = 0; x < surface.w; ++x) {
+				pixels[x] = nextRandom() ^ (nextRandom() << 8);
+
+				// Make sure the special cases of the alpha value are covered
+				switch (nextRandom() % 4) {
+				case 0:
+					pixels[x] &= ~0xFF;
+					break;
+				case 1:
+					pixels[x] |= 0xFF;
+					break;
+				default:
+					break;
+				}
+			}
+		}
+	}
+
+	void blitTestTemplate(int flipping, uint color, Graphics::TSpriteBlendMode blendMode) {
+		// Use odd sizes to cover the scalar tails of the vector kernels
+		const Graphics::PixelFormat format = Graphics::TransparentSurface::getSupportedPixelFormat();
+		Graphics::TransparentSurface sprite;
+		sprite.create(37, 11, format);
+		Graphics::Surface background, reference, optimized;
+		background.create(53, 17, format);
+
+		_seed = 1;
+		fillRandom(sprite);
+		fillRandom(background);
+
+		// The scalar kernels are the golden reference for the vector ones
+		Common::setCPUFeatureMask(0);
+		reference.copyFrom(background);
+		sprite.blit(reference, 5, 3, flipping, nullptr, color, -1, -1, blendMode);
+
+		// Check every kernel the host can run, not only the fastest one
+		static const uint32 featureMasks[] = {
+			Common::kCPUFeatureSSE2 | Common::kCPUFeatureNEON,
+			0xFFFFFFFF
+		};
+
+		for (int i = 0; i < ARRAYSIZE(featureMasks); ++i) {
+			Common::setCPUFeatureMask(featureMasks[i]);
+			optimized.copyFrom(background);
+			sprite.blit(optimized, 5, 3, flipping, nullptr, color, -1, -1, blendMode);
+
+			for (int y = 0; y < background.h; ++y)
+				TS_ASSERT_EQUALS(memcmp(reference.getBasePtr(0, y), optimized.getBasePtr(0, y), background.w * 4), 0);
+			optimized.free();
+		}
+		Common::setCPUFeatureMask(0xFFFFFFFF);
+
+		reference.free();
+		background.free();
+		sprite.free();
+	}
+
+	void blendModeTestTemplate(Graphics::TSpriteBlendMode blendMode) {
+		static const uint colors[] = { 0xFFFFFFFF, 0xFFFF00FF, 0x80FF40C0, 0x20102030, 0xFF00FFFF };
+		static const int flippings[] = { Graphics::FLIP_NONE, Graphics::FLIP_H, Graphics::FLIP_V, Graphics::FLIP_HV };
+
+		for (int i = 0; i < ARRAYSIZE(colors); ++i)
+			for (int j = 0; j < ARRAYSIZE(flippings); ++j)
+				blitTestTemplate(flippings[j], colors[i], blendMode);
+	}
+
+
+	template <Graphics::TFilteringMode filteringMode>
+	void scaleIntoTestTemplate(uint16 width, uint16 height) {
+		const Graphics::PixelFormat format = Graphics::TransparentSurface::getSupportedPixelFormat();
+		Graphics::TransparentSurface sprite;
+		sprite.create(97, 61, format);
+		_seed = 1;
+		fillRandom(sprite);
+
+		// Rendering into a reused surface gives the same result as
+		// rendering into a fresh one.
+		Graphics::TransparentSurface *fresh = sprite.scaleT<filteringMode>(width, height);
+		Graphics::Surface reused;
+		reused.create(width, height, format);
+		fillRandom(reused);
+		sprite.scaleInto<filteringMode>(reused);
+
+		for (int y = 0; y < height; ++y)
+			TS_ASSERT_EQUALS(memcmp(fresh->getBasePtr(0, y), reused.getBasePtr(0, y), width * 4), 0);
+
+		reused.free();
+		fresh->free();
+		delete fresh;
+		sprite.free();
+	}
+
+	template <Graphics::TFilteringMode filteringMode>
+	void rotoscaleIntoTestTemplate(const Graphics::TransformStruct &transform) {
+		const Graphics::PixelFormat format = Graphics::TransparentSurface::getSupportedPixelFormat();
+		Graphics::TransparentSurface sprite;
+		sprite.create(97, 61, format);
+		_seed = 1;
+		fillRandom(sprite);
+
+		Graphics::TransparentSurface *fresh = sprite.rotoscaleT<filteringMode>(transform);
+		Graphics::Surface reused;
+		reused.create(fresh->w, fresh->h, format);
+		fillRandom(reused);
+		sprite.rotoscaleInto<filteringMode>(reused, transform);
+
+		for (int y = 0; y < fresh->h; ++y)
+			TS_ASSERT_EQUALS(memcmp(fresh->getBasePtr(0, y), reused.getBasePtr(0, y), fresh->w * 4), 0);
+
+		reused.free();
+		fresh->free();
+		delete fresh;
+		sprite.free();
+	}
+
+public:
+	void test_alpha_blend() {
+		blendModeTestTemplate(Graphics::BLEND_NORMAL);
+	}
+
+	void test_additive_blend() {
+		blendModeTestTemplate(Graphics::BLEND_ADDITIVE);
+	}
+
+	void test_subtractive_blend() {
+		blendModeTestTemplate(Graphics::BLEND_SUBTRACTIVE);
+	}
+
+	void test_alpha_blend_values() {
+		// An opaque pixel replaces the target, a transparent one keeps it,
+		// whichever kernel is used.
+		const Graphics::PixelFormat format = Graphics::TransparentSurface::getSupportedPixelFormat();
+		Graphics::TransparentSurface sprite;
+		sprite.create(16, 1, format);
+		Graphics::Surface target;
+		target.create(16, 1, format);
+
+		uint32 *src = (uint32 *)sprite.getPixels();
+		uint32 *dst = (uint32 *)target.getPixels();
+		for (int x = 0; x < 16; ++x) {
+			src[x] = (x & 1) ? format.ARGBToColor(0, 10, 20, 30) : format.ARGBToColor(255, 200, 100, 50);
+			dst[x] = format.ARGBToColor(255, 1, 2, 3);
+		}
+
+		sprite.blit(target);
+
+		for (int x = 0; x < 16; ++x) {
+			uint8 a, r, g, b;
+			format.colorToARGB(dst[x], a, r, g, b);
+			TS_ASSERT_EQUALS(a, 255);
+			if (x & 1) {
+				TS_ASSERT_EQUALS(r, 1);
+				TS_ASSERT_EQUALS(g, 2);
+				TS_ASSERT_EQUALS(b, 3);
+			} else {
+				// (255 * c + 0 * 1) >> 8
+				TS_ASSERT_EQUALS(r, 199);
+				TS_ASSERT_EQUALS(g, 99);
+				TS_ASSERT_EQUALS(b, 49);
+			}
+		}
+
+		target.free();
+		sprite.free();
+	}
+
+	void test_scale_into() {
+		scaleIntoTestTemplate<Graphics::FILTER_NEAREST>(200, 150);
+		scaleIntoTestTemplate<Graphics::FILTER_NEAREST>(31, 17);
+		scaleIntoTestTemplate<Graphics::FILTER_BILINEAR>(200, 150);
+		scaleIntoTestTemplate<Graphics::FILTER_BILINEAR>(31, 17);
+		scaleIntoTestTemplate<Graphics::FILTER_AREA>(200, 150);
+		scaleIntoTestTemplate<Graphics::FILTER_AREA>(31, 17);
+	}
+
+	void test_rotoscale_into() {
+		rotoscaleIntoTestTemplate<Graphics::FILTER_NEAREST>(Graphics::TransformStruct(100, 100, 30, 20, 10));
+		rotoscaleIntoTestTemplate<Graphics::FILTER_NEAREST>(Graphics::TransformStruct(250, 150, 200, 0, 0));
+		rotoscaleIntoTestTemplate<Graphics::FILTER_BILINEAR>(Graphics::TransformStruct(100, 100, 30, 20, 10));
+		rotoscaleIntoTestTemplate<Graphics::FILTER_BILINEAR>(Graphics::TransformStruct(250, 150, 200, 0, 0));
+		rotoscaleIntoTestTemplate<Graphics::FILTER_BILINEAR>(Graphics::TransformStruct(0, 100, 45, 0, 0));
+	}
+
+	void test_scale_area() {
+		const Graphics::PixelFormat format = Graphics::TransparentSurface::getSupportedPixelFormat();
+		Graphics::TransparentSurface sprite;
+		sprite.create(3, 2, format);
+		uint32 *pixels = (uint32 *)sprite.getPixels();
+		pixels[0] = format.ARGBToColor(255, 0, 0, 0);
+		pixels[1] = format.ARGBToColor(255, 90, 30, 0);
+		pixels[2] = format.ARGBToColor(0, 0, 60, 0);
+		pixels[3] = format.ARGBToColor(255, 30, 0, 90);
+		pixels[4] = format.ARGBToColor(255, 0, 0, 0);
+		pixels[5] = format.ARGBToColor(0, 30, 90, 90);
+
+		// A single pixel gets the average of all source pixels
+		Graphics::TransparentSurface *scaled = sprite.scaleT<Graphics::FILTER_AREA>(1, 1);
+		uint8 a, r, g, b;
+		format.colorToARGB(*(const uint32 *)scaled->getPixels(), a, r, g, b);
+		TS_ASSERT_EQUALS(a, 170);
+		TS_ASSERT_EQUALS(r, 25);
+		TS_ASSERT_EQUALS(g, 30);
+		TS_ASSERT_EQUALS(b, 30);
+		scaled->free();
+		delete scaled;
+
+		// The middle column is split between the two target pixels
+		scaled = sprite.scaleT<Graphics::FILTER_AREA>(2, 1);
+		const uint32 *result = (const uint32 *)scaled->getPixels();
+		format.colorToARGB(result[0], a, r, g, b);
+		TS_ASSERT_EQUALS(a, 255);
+		TS_ASSERT_EQUALS(r, 25);
+		TS_ASSERT_EQUALS(g, 5);
+		TS_ASSERT_EQUALS(b, 30);
+		format.colorToARGB(result[1], a, r, g, b);
+		TS_ASSERT_EQUALS(a, 85);
+		TS_ASSERT_EQUALS(r, 25);
+		TS_ASSERT_EQUALS(g, 55);
+		TS_ASSERT_EQUALS(b, 30);
+		scaled->free();
+		delete scaled;
+
+		sprite.free();
+	}
+};
@@ -0,0 +1,218 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/cpudetect.h"
+#include "common/workerpool.h"
+#include "graphics/yuv_to_rgb.h"
+
+/**
+ * Converts an image over and over, counting the results which differ from
+ * the expected one.
+ */
+class YUVToRGBRepeatJob : public Common::WorkerJob {
+public:
+	YUVToRGBRepeatJob(const byte *y, const byte *u, const byte *v, int width, int height, const Graphics::Surface &expected, int count) :
+		_y(y), _u(u), _v(v), _width(width), _height(height), _expected(expected), _count(count), _mismatches(0) {
+		_surface.create(width, height, expected.format);
+	}
+
+	~YUVToRGBRepeatJob() {
+		_surface.free();
+	}
+
+	void run() {
+		for (int i = 0; i < _count; ++i) {
+			YUVToRGBMan.convert420(&_surface, Graphics::YUVToRGBManager::kScaleITU, _y, _u, _v, _width, _height, _width, _width + 1);
+			if (memcmp(_surface.getPixels(), _expected.getPixels(), _height * _surface.pitch))
+				_mismatches++;
+		}
+	}
+
+	int getMismatches() const { return _mismatches; }
+
+private:
+	const byte *_y, *_u, *_v;
+	int _width, _height;
+	const Graphics::Surface &_expected;
+	Graphics::Surface _surface;
+	int _count;
+	int _mismatches;
+};
+
+class YUVToRGBTestSuite : public CxxTest::TestSuite
+{
+private:
+	enum {
+		kWidth = 52,
+		kHeight = 36
+	};
+
+	uint32 _seed;
+	byte _y[kWidth * kHeight];
+	// Large enough for YUV444, plus the extra row and column of YUV410
+	byte _u[(kWidth + 1) * (kHeight + 1)];
+	byte _v[(kWidth + 1) * (kHeight + 1)];
+
+	uint32 nextRandom() {
+		_seed = _seed * 1103515245 + 12345;
+		return _seed >> 8;
+	}
+
+	void fillPlanes() {
+		_seed = 1;
+		for (int i = 0; i < ARRAYSIZE(_y); ++i)
+			_y[i] = nextRandom();
+		for (int i = 0; i < ARRAYSIZE(_u); ++i) {
+			_u[i] = nextRandom();
+			_v[i] = nextRandom();
+		}
+
+		// Make sure the clipping of all channels is covered
+		_y[0] = 0;
+		_y[1] = 255;
+		_u[0] = _v[0] = 0;
+		_u[1] = _v[1] = 255;
+	}
+
+	void convert(Graphics::Surface &dst, Graphics::YUVToRGBManager::Layout layout, Graphics::YUVToRGBManager::LuminanceScale scale) {
+		switch (layout) {
+		case Graphics::YUVToRGBManager::kLayout444:
+			YUVToRGBMan.convert444(&dst, scale, _y, _u, _v, kWidth, kHeight, kWidth, kWidth + 1);
+			break;
+		case Graphics::YUVToRGBManager::kLayout420:
+			YUVToRGBMan.convert420(&dst, scale, _y, _u, _v, kWidth, kHeight, kWidth, kWidth + 1);
+			break;
+		case Graphics::YUVToRGBManager::kLayout410:
+			YUVToRGBMan.convert410(&dst, scale, _y, _u, _v, kWidth, kHeight, kWidth, kWidth + 1);
+			break;
+		}
+	}
+
+	void conversionTestTemplate(const Graphics::PixelFormat &format, Graphics::YUVToRGBManager::Layout layout, Graphics::YUVToRGBManager::LuminanceScale scale) {
+		fillPlanes();
+
+		// The lookup tables are the reference for the vectorized kernels
+		Graphics::Surface reference, optimized;
+		reference.create(kWidth, kHeight, format);
+		Common::setCPUFeatureMask(0);
+		convert(reference, layout, scale);
+
+		static const uint32 featureMasks[] = {
+			Common::kCPUFeatureSSE2 | Common::kCPUFeatureNEON,
+			0xFFFFFFFF
+		};
+
+		for (int i = 0; i < ARRAYSIZE(featureMasks); ++i) {
+			Common::setCPUFeatureMask(featureMasks[i]);
+			optimized.create(kWidth, kHeight, format);
+			convert(optimized, layout, scale);
+
+			for (int y = 0; y < kHeight; ++y)
+				TS_ASSERT_EQUALS(memcmp(reference.getBasePtr(0, y), optimized.getBasePtr(0, y), kWidth * format.bytesPerPixel), 0);
+			optimized.free();
+		}
+		Common::setCPUFeatureMask(0xFFFFFFFF);
+
+		reference.free();
+	}
+
+	void formatTestTemplate(const Graphics::PixelFormat &format) {
+		static const Graphics::YUVToRGBManager::Layout layouts[] = {
+			Graphics::YUVToRGBManager::kLayout444,
+			Graphics::YUVToRGBManager::kLayout420,
+			Graphics::YUVToRGBManager::kLayout410
+		};
+
+		for (int i = 0; i < ARRAYSIZE(layouts); ++i) {
+			conversionTestTemplate(format, layouts[i], Graphics::YUVToRGBManager::kScaleFull);
+			conversionTestTemplate(format, layouts[i], Graphics::YUVToRGBManager::kScaleITU);
+		}
+	}
+
+public:
+	void test_rgb565() {
+		formatTestTemplate(Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0));
+	}
+
+	void test_argb1555() {
+		formatTestTemplate(Graphics::PixelFormat(2, 5, 5, 5, 1, 10, 5, 0, 15));
+	}
+
+	void test_argb8888() {
+		formatTestTemplate(Graphics::PixelFormat(4, 8, 8, 8, 8, 16, 8, 0, 24));
+	}
+
+	void test_rgba8888() {
+		formatTestTemplate(Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0));
+	}
+
+	void test_xrgb8888() {
+		formatTestTemplate(Graphics::PixelFormat(4, 8, 8, 8, 0, 16, 8, 0, 0));
+	}
+
+	void test_concurrent_formats() {
+		// The lookup tables of one format must stay valid while another
+		// thread converts to other formats
+		fillPlanes();
+		Common::setCPUFeatureMask(0);
+
+		const Graphics::PixelFormat format(2, 5, 6, 5, 0, 11, 5, 0, 0);
+		Graphics::Surface expected;
+		expected.create(kWidth, kHeight, format);
+		convert(expected, Graphics::YUVToRGBManager::kLayout420, Graphics::YUVToRGBManager::kScaleITU);
+
+		const Graphics::PixelFormat otherFormats[] = {
+			Graphics::PixelFormat(2, 5, 5, 5, 1, 10, 5, 0, 15),
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 16, 8, 0, 24),
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0)
+		};
+
+		Common::WorkerPool::getShared();
+		Common::WorkerPool pool(1);
+		YUVToRGBRepeatJob job(_y, _u, _v, kWidth, kHeight, expected, 200);
+		pool.submit(&job);
+
+		Graphics::Surface other;
+		for (int i = 0; !pool.isDone(&job) || i < 20; ++i) {
+			other.create(kWidth, kHeight, otherFormats[i % ARRAYSIZE(otherFormats)]);
+			convert(other, Graphics::YUVToRGBManager::kLayout420, (i & 1) ? Graphics::YUVToRGBManager::kScaleFull : Graphics::YUVToRGBManager::kScaleITU);
+			other.free();
+		}
+
+		pool.wait(&job);
+		TS_ASSERT_EQUALS(job.getMismatches(), 0);
+
+		Common::setCPUFeatureMask(0xFFFFFFFF);
+		expected.free();
+	}
+
+	void test_all_chroma_values() {
+		// Every pair of chroma values once, so the integer arithmetic of the
+		// kernels is checked against every entry of the chroma tables
+		const Graphics::PixelFormat format(4, 8, 8, 8, 8, 16, 8, 0, 24);
+		byte *y = new byte[256 * 256];
+		byte *u = new byte[256 * 256];
+		byte *v = new byte[256 * 256];
+		for (int i = 0; i < 256 * 256; ++i) {
+			y[i] = (i * 7) >> 8;
+			u[i] = i & 0xFF;
+			v[i] = i >> 8;
+		}
+
+		Graphics::Surface reference, optimized;
+		reference.create(256, 256, format);
+		optimized.create(256, 256, format);
+		for (int scale = Graphics::YUVToRGBManager::kScaleFull; scale <= Graphics::YUVToRGBManager::kScaleITU; ++scale) {
+			Common::setCPUFeatureMask(0);
+			YUVToRGBMan.convert444(&reference, (Graphics::YUVToRGBManager::LuminanceScale)scale, y, u, v, 256, 256, 256, 256);
+			Common::setCPUFeatureMask(0xFFFFFFFF);
+			YUVToRGBMan.convert444(&optimized, (Graphics::YUVToRGBManager::LuminanceScale)scale, y, u, v, 256, 256, 256, 256);
+			TS_ASSERT_EQUALS(memcmp(reference.getPixels(), optimized.getPixels(), 256 * 256 * 4), 0);
+		}
+
+		reference.free();
+		optimized.free();
+		delete[] y;
+		delete[] u;
+		delete[] v;
+	}
+};
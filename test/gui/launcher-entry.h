@@ -0,0 +1,36 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/algorithm.h"
+#include "common/array.h"
+#include "gui/launcher-entry.h"
+
+class LauncherEntryTestSuite : public CxxTest::TestSuite {
+	public:
+	void test_order() {
+		GUI::LauncherEntryComparator less;
+		const GUI::LauncherEntry a("b", "Day of the Tentacle");
+		const GUI::LauncherEntry b("a", "day of the tentacle");
+		const GUI::LauncherEntry c("a", "Zak McKracken");
+
+		// Descriptions are compared ignoring case, targets break ties
+		TS_ASSERT(less(b, a));
+		TS_ASSERT(!less(a, b));
+		TS_ASSERT(less(a, c));
+		TS_ASSERT(!less(c, a));
+		TS_ASSERT(!less(a, a));
+	}
+
+	void test_sort() {
+		Common::Array<GUI::LauncherEntry> entries;
+		entries.push_back(GUI::LauncherEntry("monkey-2", "The Secret of Monkey Island"));
+		entries.push_back(GUI::LauncherEntry("tentacle", "Day of the Tentacle"));
+		entries.push_back(GUI::LauncherEntry("monkey-1", "The secret of Monkey Island"));
+		entries.push_back(GUI::LauncherEntry("atlantis", "Indiana Jones and the Fate of Atlantis"));
+
+		Common::sort(entries.begin(), entries.end(), GUI::LauncherEntryComparator());
+		TS_ASSERT_EQUALS(entries[0].key, "tentacle");
+		TS_ASSERT_EQUALS(entries[1].key, "atlantis");
+		TS_ASSERT_EQUALS(entries[2].key, "monkey-1");
+		TS_ASSERT_EQUALS(entries[3].key, "monkey-2");
+	}
+};
@@ -0,0 +1,100 @@
+#include <cxxtest/TestSuite.h>
+
+#include "gui/widgets/list-filter.h"
+
+class ListFilterIndexTestSuite : public CxxTest::TestSuite {
+	static void fill(GUI::ListFilterIndex &index) {
+		index.push_back("Monkey Island 2: LeChuck's Revenge\nmonkey2");
+		index.push_back("The Secret of Monkey Island\nmonkey");
+		index.push_back("Day of the Tentacle\ntentacle");
+		index.push_back("Indiana Jones and the Fate of Atlantis\natlantis");
+	}
+
+	static Common::String matches(const GUI::ListFilterIndex &index) {
+		Common::String result;
+		for (uint i = 0; i < index.getMatches().size(); ++i)
+			result += Common::String::format("%d", index.getMatches()[i]);
+		return result;
+	}
+
+	public:
+	void test_empty_filter() {
+		GUI::ListFilterIndex index;
+		fill(index);
+		TS_ASSERT_EQUALS(index.size(), 4u);
+		TS_ASSERT_EQUALS(matches(index), "0123");
+	}
+
+	void test_words() {
+		GUI::ListFilterIndex index;
+		fill(index);
+
+		// Every word must be contained, in any order, ignoring case
+		index.setFilter("island monkey");
+		TS_ASSERT_EQUALS(matches(index), "01");
+		index.setFilter("the of");
+		TS_ASSERT_EQUALS(matches(index), "123");
+
+		// The search keys are matched as well
+		index.setFilter("tentacle");
+		TS_ASSERT_EQUALS(matches(index), "2");
+	}
+
+	void test_refine() {
+		GUI::ListFilterIndex index;
+		fill(index);
+
+		// Typing one key at a time refines the previous matches
+		const char *const steps[] = { "e", "en", "ent", "entx", "entxy" };
+		const char *const expected[] = { "0123", "02", "2", "", "" };
+		for (int i = 0; i < ARRAYSIZE(steps); ++i) {
+			index.setFilter(steps[i]);
+			TS_ASSERT_EQUALS(matches(index), expected[i]);
+		}
+	}
+
+	void test_refine_words() {
+		GUI::ListFilterIndex index;
+		fill(index);
+
+		const char *const steps[] = { "m", "monkey", "monkey ", "monkey 2" };
+		const char *const expected[] = { "01", "01", "01", "0" };
+		for (int i = 0; i < ARRAYSIZE(steps); ++i) {
+			index.setFilter(steps[i]);
+			TS_ASSERT_EQUALS(matches(index), expected[i]);
+		}
+	}
+
+	void test_widen() {
+		GUI::ListFilterIndex index;
+		fill(index);
+
+		index.setFilter("monkey 2");
+		TS_ASSERT_EQUALS(matches(index), "0");
+
+		// Removing characters or changing the filter searches all entries
+		index.setFilter("monkey");
+		TS_ASSERT_EQUALS(matches(index), "01");
+		index.setFilter("atlantis");
+		TS_ASSERT_EQUALS(matches(index), "3");
+		index.setFilter("");
+		TS_ASSERT_EQUALS(matches(index), "0123");
+	}
+
+	void test_push_back() {
+		GUI::ListFilterIndex index;
+		fill(index);
+		index.setFilter("monkey");
+
+		// Appended entries are matched against the current filter
+		index.push_back("Monkey Island 3\nmonkey3");
+		index.push_back("Sam & Max Hit the Road\nsamnmax");
+		TS_ASSERT_EQUALS(matches(index), "014");
+		TS_ASSERT(index.matches(5, "sam max"));
+		TS_ASSERT(!index.matches(5, "monkey"));
+
+		index.clear();
+		TS_ASSERT_EQUALS(index.size(), 0u);
+		TS_ASSERT(index.getMatches().empty());
+	}
+};
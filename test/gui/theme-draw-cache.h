@@ -0,0 +1,173 @@
+#include <cxxtest/TestSuite.h>
+
+#include "gui/ThemeDrawCache.h"
+
+class ThemeDrawCacheTestSuite : public CxxTest::TestSuite
+{
+private:
+	enum {
+		kItemSize = 8,
+		// Room for four renderings with their backgrounds
+		kMaxBytes = 4 * 2 * kItemSize * kItemSize * 2
+	};
+
+	Graphics::Surface _surface;
+	int _drawData[6];
+
+	GUI::ThemeDrawCache::Key makeKey(int item) {
+		GUI::ThemeDrawCache::Key key;
+		key.drawData = &_drawData[item];
+		key.width = kItemSize;
+		key.height = kItemSize;
+		key.dynamicData = 0;
+		key.rendererState.fgColor = 0xF800;
+		key.rendererState.bgColor = 0x001F;
+		key.clipped = false;
+		return key;
+	}
+
+	Common::Rect area() const {
+		return Common::Rect(4, 4, 4 + kItemSize, 4 + kItemSize);
+	}
+
+	/** Fill the area with a background which depends on the seed. */
+	void fillBackground(uint16 seed) {
+		for (int y = 0; y < _surface.h; ++y) {
+			for (int x = 0; x < _surface.w; ++x)
+				*(uint16 *)_surface.getBasePtr(x, y) = seed + x + y * _surface.w;
+		}
+	}
+
+	/** Stand-in for the draw steps, which blend with the background. */
+	void drawSteps(uint16 color) {
+		const Common::Rect r = area();
+		for (int y = r.top; y < r.bottom; ++y) {
+			for (int x = r.left; x < r.right; ++x) {
+				uint16 *pixel = (uint16 *)_surface.getBasePtr(x, y);
+				*pixel = (*pixel >> 1) + color;
+			}
+		}
+	}
+
+	/** Draw an item through the cache, returns true on a hit. */
+	bool drawItem(GUI::ThemeDrawCache &cache, const GUI::ThemeDrawCache::Key &key, uint16 color) {
+		if (cache.draw(key, &_surface, area()))
+			return true;
+
+		drawSteps(color);
+		cache.store(key, &_surface, area());
+		return false;
+	}
+
+	bool areaEquals(const Graphics::Surface &other) {
+		for (int y = 0; y < _surface.h; ++y) {
+			if (memcmp(_surface.getBasePtr(0, y), other.getBasePtr(0, y), _surface.pitch))
+				return false;
+		}
+		return true;
+	}
+
+public:
+	void setUp() {
+		_surface.create(16, 16, Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0));
+	}
+
+	void tearDown() {
+		_surface.free();
+	}
+
+	void test_hit() {
+		GUI::ThemeDrawCache cache(kMaxBytes);
+		const GUI::ThemeDrawCache::Key key = makeKey(0);
+
+		fillBackground(1);
+		TS_ASSERT(!drawItem(cache, key, 0x100));
+		TS_ASSERT_EQUALS(cache.getMisses(), 1u);
+
+		Graphics::Surface expected;
+		expected.copyFrom(_surface);
+
+		// The same item on the same background is copied from the cache
+		fillBackground(1);
+		TS_ASSERT(drawItem(cache, key, 0x100));
+		TS_ASSERT_EQUALS(cache.getHits(), 1u);
+		TS_ASSERT(areaEquals(expected));
+		expected.free();
+
+		// Not on a different background
+		fillBackground(2);
+		TS_ASSERT(!drawItem(cache, key, 0x100));
+	}
+
+	void test_state_change() {
+		GUI::ThemeDrawCache cache(kMaxBytes);
+		GUI::ThemeDrawCache::Key key = makeKey(0);
+
+		fillBackground(1);
+		drawItem(cache, key, 0x100);
+
+		// Every part of the renderer state is compared, not just a hash
+		GUI::ThemeDrawCache::Key other = key;
+		other.rendererState.gradientEnd = 1;
+		fillBackground(1);
+		TS_ASSERT(!drawItem(cache, other, 0x200));
+
+		other = key;
+		other.rendererState.disableShadows = true;
+		fillBackground(1);
+		TS_ASSERT(!drawItem(cache, other, 0x300));
+
+		other = key;
+		other.dynamicData = 1;
+		fillBackground(1);
+		TS_ASSERT(!drawItem(cache, other, 0x400));
+
+		// The original rendering is still there
+		fillBackground(1);
+		TS_ASSERT(drawItem(cache, key, 0x100));
+	}
+
+	void test_eviction() {
+		GUI::ThemeDrawCache cache(kMaxBytes);
+
+		for (int i = 0; i < 5; ++i) {
+			fillBackground(1);
+			drawItem(cache, makeKey(i), 0x100 * i);
+			TS_ASSERT_LESS_THAN_EQUALS(cache.getBytes(), (uint32)kMaxBytes);
+		}
+
+		// The least recently used rendering was dropped for the fifth one
+		fillBackground(1);
+		TS_ASSERT(drawItem(cache, makeKey(4), 0x400));
+		fillBackground(1);
+		TS_ASSERT(drawItem(cache, makeKey(1), 0x100));
+		fillBackground(1);
+		TS_ASSERT(!drawItem(cache, makeKey(0), 0));
+
+		// Shrinking the budget drops renderings right away
+		cache.setMaxBytes(kMaxBytes / 4);
+		TS_ASSERT_LESS_THAN_EQUALS(cache.getBytes(), (uint32)kMaxBytes / 4);
+	}
+
+	void test_theme_reload() {
+		GUI::ThemeDrawCache cache(kMaxBytes);
+
+		fillBackground(1);
+		drawItem(cache, makeKey(0), 0x100);
+		fillBackground(1);
+		drawItem(cache, makeKey(1), 0x200);
+		TS_ASSERT(cache.getBytes() > 0);
+
+		// ThemeEngine clears the cache when it unloads the theme, the draw
+		// steps of the new theme may live at the same addresses
+		cache.clear();
+		TS_ASSERT_EQUALS(cache.getBytes(), 0u);
+
+		fillBackground(1);
+		TS_ASSERT(!drawItem(cache, makeKey(0), 0x300));
+		fillBackground(1);
+		TS_ASSERT(!drawItem(cache, makeKey(1), 0x400));
+		fillBackground(1);
+		TS_ASSERT(drawItem(cache, makeKey(0), 0x300));
+	}
+};
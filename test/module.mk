@@ -5,8 +5,8 @@
 #
 ######################################################################
 
-TESTS        := $(srcdir)/test/common/*.h $(srcdir)/test/audio/*.h
-TEST_LIBS    := audio/libaudio.a common/libcommon.a
+TESTS        := $(srcdir)/test/common/*.h $(srcdir)/test/audio/*.h $(srcdir)/test/graphics/*.h $(srcdir)/test/engines/*.h $(srcdir)/test/backends/*.h $(srcdir)/test/gui/*.h $(srcdir)/test/video/*.h
+TEST_LIBS    := engines/libengines.a backends/libbackends.a gui/libgui.a video/libvideo.a audio/libaudio.a graphics/libgraphics.a common/libcommon.a
 
 ifeq ($(ENABLE_WINTERMUTE), STATIC_PLUGIN)
 	TESTS += $(srcdir)/test/engines/wintermute/*.h
@@ -49,8 +49,20 @@ test/runner.cpp: $(TESTS)
 	@mkdir -p test
 	$(srcdir)/test/cxxtest/cxxtestgen.py $(TEST_FLAGS) -o $@ $+
 
+#
+# Benchmarks, use the 'bench' target to run them. Options for the runner,
+# e.g. --csv or --filter=common/str, can be passed in BENCH_FLAGS.
+#
+BENCH_SRCS   := $(wildcard $(srcdir)/test/bench/*.cpp)
+
+bench: test/bench/runner
+	./test/bench/runner $(BENCH_FLAGS)
+test/bench/runner: $(BENCH_SRCS) $(TEST_LIBS)
+	@mkdir -p test/bench
+	$(QUIET_CXX)$(CXX) $(TEST_CXXFLAGS) $(CPPFLAGS) $(TEST_CFLAGS) -o $@ $+ $(TEST_LDFLAGS)
+
 clean: clean-test
 clean-test:
-	-$(RM) test/runner.cpp test/runner
+	-$(RM) test/runner.cpp test/runner test/bench/runner
 
-.PHONY: test clean-test
+.PHONY: test bench clean-test
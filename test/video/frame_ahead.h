@@ -0,0 +1,244 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/atomic.h"
+#include "common/system.h"
+#include "graphics/surface.h"
+#include "video/video_decoder.h"
+
+/**
+ * Just enough of a backend for VideoDecoder, which asks for the screen
+ * format and the time.
+ */
+class FrameAheadTestSystem : public OSystem {
+public:
+	const GraphicsMode *getSupportedGraphicsModes() const { return 0; }
+	int getDefaultGraphicsMode() const { return 0; }
+	bool setGraphicsMode(int mode) { return false; }
+	int getGraphicsMode() const { return 0; }
+#ifdef USE_RGB_COLOR
+	Graphics::PixelFormat getScreenFormat() const { return Graphics::PixelFormat::createFormatCLUT8(); }
+	Common::List<Graphics::PixelFormat> getSupportedFormats() const { return Common::List<Graphics::PixelFormat>(); }
+#endif
+	void initSize(uint width, uint height, const Graphics::PixelFormat *format = NULL) {}
+	int16 getHeight() { return 0; }
+	int16 getWidth() { return 0; }
+	PaletteManager *getPaletteManager() { return 0; }
+	void copyRectToScreen(const void *buf, int pitch, int x, int y, int w, int h) {}
+	Graphics::Surface *lockScreen() { return 0; }
+	void unlockScreen() {}
+	void fillScreen(uint32 col) {}
+	void updateScreen() {}
+	void setShakePos(int shakeOffset) {}
+	void showOverlay() {}
+	void hideOverlay() {}
+	Graphics::PixelFormat getOverlayFormat() const { return Graphics::PixelFormat::createFormatCLUT8(); }
+	void clearOverlay() {}
+	void grabOverlay(void *buf, int pitch) {}
+	void copyRectToOverlay(const void *buf, int pitch, int x, int y, int w, int h) {}
+	int16 getOverlayHeight() { return 0; }
+	int16 getOverlayWidth() { return 0; }
+	bool showMouse(bool visible) { return false; }
+	void warpMouse(int x, int y) {}
+	void setMouseCursor(const void *buf, uint w, uint h, int hotspotX, int hotspotY, uint32 keycolor, bool dontScale = false, const Graphics::PixelFormat *format = NULL) {}
+	uint32 getMillis(bool skipRecord = false) { return 0; }
+	void delayMillis(uint msecs) {}
+	void getTimeAndDate(TimeDate &t) const {}
+	MutexRef createMutex() { return 0; }
+	void lockMutex(MutexRef mutex) {}
+	void unlockMutex(MutexRef mutex) {}
+	void deleteMutex(MutexRef mutex) {}
+	Audio::Mixer *getMixer() { return 0; }
+	void quit() {}
+	void displayMessageOnOSD(const char *msg) {}
+	void displayActivityIconOnOSD(const Graphics::Surface *icon) {}
+	void logMessage(LogMessageType::Type type, const char *message) {}
+};
+
+/**
+ * A video of solid frames whose pixels hold the frame number. Frames from
+ * a given one on are only decoded once the test releases them.
+ */
+class FrameAheadTestDecoder : public Video::VideoDecoder {
+public:
+	enum {
+		kFrameCount = 20
+	};
+
+	FrameAheadTestDecoder() : _holdFrom(kFrameCount), _released(1) {}
+	~FrameAheadTestDecoder() { close(); }
+
+	bool loadStream(Common::SeekableReadStream *stream) {
+		close();
+		addTrack(new TestVideoTrack(this));
+		return true;
+	}
+
+	/** Hold back the frames from the given one on until release() is called. */
+	void holdFrom(int frame) {
+		_holdFrom = frame;
+		Common::atomicStore(_released, 0);
+	}
+
+	void release() {
+		Common::atomicStore(_released, 1);
+	}
+
+protected:
+	bool supportsFrameAhead() const { return true; }
+
+private:
+	class TestVideoTrack : public FixedRateVideoTrack {
+	public:
+		TestVideoTrack(FrameAheadTestDecoder *decoder) : _decoder(decoder), _curFrame(-1) {
+			_surface.create(8, 4, Graphics::PixelFormat::createFormatCLUT8());
+		}
+		~TestVideoTrack() { _surface.free(); }
+
+		uint16 getWidth() const { return _surface.w; }
+		uint16 getHeight() const { return _surface.h; }
+		Graphics::PixelFormat getPixelFormat() const { return _surface.format; }
+		int getCurFrame() const { return _curFrame; }
+		int getFrameCount() const { return kFrameCount; }
+		bool isSeekable() const { return true; }
+
+		bool seek(const Audio::Timestamp &time) {
+			_curFrame = getFrameAtTime(time) - 1;
+			return true;
+		}
+
+		const Graphics::Surface *decodeNextFrame() {
+			_curFrame++;
+			if (_curFrame >= _decoder->_holdFrom) {
+				while (!Common::atomicLoad(_decoder->_released))
+					;
+			}
+
+			memset(_surface.getPixels(), _curFrame, _surface.w * _surface.h);
+			return &_surface;
+		}
+
+	protected:
+		Common::Rational getFrameRate() const { return 10; }
+
+	private:
+		FrameAheadTestDecoder *_decoder;
+		Graphics::Surface _surface;
+		int _curFrame;
+	};
+
+	int _holdFrom;
+	volatile uint32 _released;
+};
+
+class FrameAheadTestSuite : public CxxTest::TestSuite
+{
+private:
+	OSystem *_oldSystem;
+	FrameAheadTestSystem *_system;
+
+	/** Decode the next frame and check that it is the expected one. */
+	void checkNextFrame(Video::VideoDecoder &decoder, int frame) {
+		const Graphics::Surface *surface = decoder.decodeNextFrame();
+		TS_ASSERT(surface);
+		if (!surface)
+			return;
+
+		TS_ASSERT_EQUALS(*(const byte *)surface->getPixels(), frame);
+		TS_ASSERT_EQUALS(*(const byte *)surface->getBasePtr(7, 3), frame);
+		TS_ASSERT_EQUALS(decoder.getCurFrame(), frame);
+	}
+
+public:
+	void setUp() {
+		_oldSystem = g_system;
+		_system = new FrameAheadTestSystem();
+		g_system = _system;
+	}
+
+	void tearDown() {
+		g_system = _oldSystem;
+		delete _system;
+	}
+
+	void test_frame_order() {
+		FrameAheadTestDecoder decoder;
+		decoder.loadStream(0);
+		TS_ASSERT(decoder.setFrameAhead(3));
+		TS_ASSERT_EQUALS(decoder.getFrameAhead(), 3u);
+
+		for (int i = 0; i < FrameAheadTestDecoder::kFrameCount; ++i) {
+			TS_ASSERT(!decoder.endOfVideo());
+			checkNextFrame(decoder, i);
+		}
+
+		TS_ASSERT(decoder.endOfVideo());
+		TS_ASSERT(!decoder.decodeNextFrame());
+		TS_ASSERT_EQUALS(decoder.getFrameAheadStats().framesDecoded, (uint32)FrameAheadTestDecoder::kFrameCount);
+		TS_ASSERT_EQUALS(decoder.getFrameAheadStats().framesDropped, 0u);
+	}
+
+	void test_seek() {
+		FrameAheadTestDecoder decoder;
+		decoder.loadStream(0);
+		decoder.setFrameAhead(4);
+
+		for (int i = 0; i < 3; ++i)
+			checkNextFrame(decoder, i);
+
+		// The frames decoded ahead of the seek are dropped
+		TS_ASSERT(decoder.seekToFrame(10));
+		TS_ASSERT_EQUALS(decoder.getFrameAheadStats().framesDropped, 4u);
+		for (int i = 10; i < 13; ++i)
+			checkNextFrame(decoder, i);
+
+		// Seeking close to the end must not decode past it
+		TS_ASSERT(decoder.seekToFrame(FrameAheadTestDecoder::kFrameCount - 2));
+		checkNextFrame(decoder, FrameAheadTestDecoder::kFrameCount - 2);
+		checkNextFrame(decoder, FrameAheadTestDecoder::kFrameCount - 1);
+		TS_ASSERT(decoder.endOfVideo());
+	}
+
+	void test_rewind() {
+		FrameAheadTestDecoder decoder;
+		decoder.loadStream(0);
+		decoder.setFrameAhead(2);
+
+		for (int i = 0; i < FrameAheadTestDecoder::kFrameCount; ++i)
+			checkNextFrame(decoder, i);
+		TS_ASSERT(decoder.endOfVideo());
+
+		TS_ASSERT(decoder.rewind());
+		TS_ASSERT(!decoder.endOfVideo());
+		for (int i = 0; i < 5; ++i)
+			checkNextFrame(decoder, i);
+
+		TS_ASSERT(decoder.rewind());
+		checkNextFrame(decoder, 0);
+	}
+
+	void test_stop_in_flight() {
+		FrameAheadTestDecoder decoder;
+		decoder.loadStream(0);
+		decoder.holdFrom(1);
+		TS_ASSERT(decoder.setFrameAhead(4));
+
+		// The first frame is decoded right away, the next one is held back
+		TS_ASSERT_EQUALS(decoder.getFrameQueueDepth(), 1u);
+
+		// Stopping waits for the frames still being decoded
+		decoder.release();
+		TS_ASSERT(decoder.setFrameAhead(0));
+		TS_ASSERT_EQUALS(decoder.getFrameAhead(), 0u);
+		TS_ASSERT_EQUALS(decoder.getFrameAheadStats().framesDropped, 4u);
+
+		// Decoding continues on this thread where the background thread stopped
+		checkNextFrame(decoder, 4);
+
+		// Closing with frames in flight is safe as well
+		decoder.holdFrom(6);
+		TS_ASSERT(decoder.setFrameAhead(3));
+		decoder.release();
+		decoder.close();
+		TS_ASSERT_EQUALS(decoder.getFrameAhead(), 0u);
+	}
+};
@@ -28,6 +28,7 @@
 #include "audio/decoders/raw.h"
 
 #include "common/util.h"
+#include "common/debug.h"
 #include "common/textconsole.h"
 #include "common/math.h"
 #include "common/stream.h"
@@ -206,7 +207,9 @@ void BinkDecoder::readNextPacket() {
 	frame.bits = new Common::BitStream32LELSB(new Common::SeekableSubReadStream(_bink,
 			videoPacketStart, videoPacketEnd), DisposeAfterUse::YES);
 
-	videoTrack->decodePacket(frame);
+	// Frames decoded ahead of time are decoded on a background thread,
+	// which must not use g_system nor the debug output
+	videoTrack->decodePacket(frame, !getFrameAhead() && debugLevelSet(5));
 
 	delete frame.bits;
 	frame.bits = 0;
@@ -299,6 +302,12 @@ BinkDecoder::BinkVideoTrack::BinkVideoTrack(uint32 width, uint32 height, const G
 	_oldPlanes[2] = new byte[(width >> 1) * (height >> 1)]; // V, 1/4 resolution
 	_oldPlanes[3] = new byte[ width       *  height      ]; // A
 
+	// Every 8x8 luma/alpha block and 16x16 chroma block may hold one DCT block
+	uint32 lumaBlocks   = ((_surface.w + 7) >> 3) * ((_surface.h + 7) >> 3);
+	uint32 chromaBlocks = ((_surface.w + 15) >> 4) * ((_surface.h + 15) >> 4);
+	_dctBlocks.resize(lumaBlocks * (_hasAlpha ? 2 : 1) + chromaBlocks * 2);
+	_dctBlockCount = 0;
+
 	// Initialize the video with solid black
 	memset(_curPlanes[0],   0,  width       *  height      );
 	memset(_curPlanes[1],   0, (width >> 1) * (height >> 1));
@@ -329,9 +338,13 @@ BinkDecoder::BinkVideoTrack::~BinkVideoTrack() {
 	_surface.free();
 }
 
-void BinkDecoder::BinkVideoTrack::decodePacket(VideoFrame &frame) {
+void BinkDecoder::BinkVideoTrack::decodePacket(VideoFrame &frame, bool timing) {
 	assert(frame.bits);
 
+	const uint32 startTime = timing ? g_system->getMillis() : 0;
+
+	_dctBlockCount = 0;
+
 	if (_hasAlpha) {
 		if (_id == kBIKiID)
 			frame.bits->skip(32);
@@ -351,6 +364,15 @@ void BinkDecoder::BinkVideoTrack::decodePacket(VideoFrame &frame) {
 			break;
 	}
 
+	const uint32 parseTime = timing ? g_system->getMillis() : 0;
+
+	// The bitstream has to be read serially, but the inverse DCTs of the
+	// blocks read are independent of each other and of the pixels written
+	// while reading.
+	Common::runBanded(*this, _dctBlockCount, 64);
+
+	const uint32 idctTime = timing ? g_system->getMillis() : 0;
+
 	// Convert the YUV data we have to our format
 	// We're ignoring alpha for now
 	// The width used here is the surface-width, and not the video-width
@@ -364,6 +386,12 @@ void BinkDecoder::BinkVideoTrack::decodePacket(VideoFrame &frame) {
 		SWAP(_curPlanes[i], _oldPlanes[i]);
 
 	_curFrame++;
+
+	if (timing) {
+		const uint32 endTime = g_system->getMillis();
+		debug(5, "Bink frame %d: parse %d ms, %d DCT blocks %d ms, convert %d ms", _curFrame,
+				parseTime - startTime, _dctBlockCount, idctTime - parseTime, endTime - idctTime);
+	}
 }
 
 void BinkDecoder::BinkVideoTrack::decodePlane(VideoFrame &video, int planeIdx, bool isChroma) {
@@ -821,14 +849,11 @@ void BinkDecoder::BinkVideoTrack::blockResidue(DecodeContext &ctx) {
 }
 
 void BinkDecoder::BinkVideoTrack::blockIntra(DecodeContext &ctx) {
-	int16 block[64];
-	memset(block, 0, 64 * sizeof(int16));
+	int16 *block = queueDCTBlock(ctx, false);
 
 	block[0] = getBundleValue(kSourceIntraDC);
 
 	readDCTCoeffs(*ctx.video, block, true);
-
-	IDCTPut(ctx, block);
 }
 
 void BinkDecoder::BinkVideoTrack::blockFill(DecodeContext &ctx) {
@@ -842,14 +867,11 @@ void BinkDecoder::BinkVideoTrack::blockFill(DecodeContext &ctx) {
 void BinkDecoder::BinkVideoTrack::blockInter(DecodeContext &ctx) {
 	blockMotion(ctx);
 
-	int16 block[64];
-	memset(block, 0, 64 * sizeof(int16));
+	int16 *block = queueDCTBlock(ctx, true);
 
 	block[0] = getBundleValue(kSourceInterDC);
 
 	readDCTCoeffs(*ctx.video, block, false);
-
-	IDCTAdd(ctx, block);
 }
 
 void BinkDecoder::BinkVideoTrack::blockPattern(DecodeContext &ctx) {
@@ -1329,23 +1351,45 @@ void BinkDecoder::BinkVideoTrack::IDCT(int16 *block) {
 	}
 }
 
-void BinkDecoder::BinkVideoTrack::IDCTAdd(DecodeContext &ctx, int16 *block) {
+void BinkDecoder::BinkVideoTrack::IDCTAdd(byte *dest, uint32 pitch, int16 *block) {
 	int i, j;
 
 	IDCT(block);
-	byte *dest = ctx.dest;
-	for (i = 0; i < 8; i++, dest += ctx.pitch, block += 8)
+	for (i = 0; i < 8; i++, dest += pitch, block += 8)
 		for (j = 0; j < 8; j++)
 			 dest[j] += block[j];
 }
 
-void BinkDecoder::BinkVideoTrack::IDCTPut(DecodeContext &ctx, int16 *block) {
+void BinkDecoder::BinkVideoTrack::IDCTPut(byte *dest, uint32 pitch, int16 *block) {
 	int i;
 	int16 temp[64];
 	for (i = 0; i < 8; i++)
 		IDCTCol(&temp[i], &block[i]);
 	for (i = 0; i < 8; i++) {
-		IDCT_ROW( (&ctx.dest[i*ctx.pitch]), (&temp[8*i]) );
+		IDCT_ROW( (&dest[i*pitch]), (&temp[8*i]) );
+	}
+}
+
+int16 *BinkDecoder::BinkVideoTrack::queueDCTBlock(DecodeContext &ctx, bool add) {
+	assert(_dctBlockCount < _dctBlocks.size());
+
+	DCTBlock &block = _dctBlocks[_dctBlockCount++];
+	block.dest  = ctx.dest;
+	block.pitch = ctx.pitch;
+	block.add   = add;
+	memset(block.coeffs, 0, 64 * sizeof(int16));
+
+	return block.coeffs;
+}
+
+void BinkDecoder::BinkVideoTrack::runBand(int begin, int end) {
+	for (int i = begin; i < end; i++) {
+		DCTBlock &block = _dctBlocks[i];
+
+		if (block.add)
+			IDCTAdd(block.dest, block.pitch, block.coeffs);
+		else
+			IDCTPut(block.dest, block.pitch, block.coeffs);
 	}
 }
 
@@ -33,6 +33,7 @@
 
 #include "common/array.h"
 #include "common/rational.h"
+#include "common/workerpool.h"
 
 #include "video/video_decoder.h"
 
@@ -75,6 +76,7 @@ public:
 protected:
 	void readNextPacket();
 	bool supportsAudioTrackSwitching() const { return true; }
+	bool supportsFrameAhead() const { return true; }
 	AudioTrack *getAudioTrack(int index);
 
 private:
@@ -139,7 +141,7 @@ private:
 		~VideoFrame();
 	};
 
-	class BinkVideoTrack : public FixedRateVideoTrack {
+	class BinkVideoTrack : public FixedRateVideoTrack, private Common::BandedJob {
 	public:
 		BinkVideoTrack(uint32 width, uint32 height, const Graphics::PixelFormat &format, uint32 frameCount, const Common::Rational &frameRate, bool swapPlanes, bool hasAlpha, uint32 id);
 		~BinkVideoTrack();
@@ -151,8 +153,13 @@ private:
 		int getFrameCount() const { return _frameCount; }
 		const Graphics::Surface *decodeNextFrame() { return &_surface; }
 
-		/** Decode a video packet. */
-		void decodePacket(VideoFrame &frame);
+		/**
+		 * Decode a video packet.
+		 *
+		 * @param frame		the frame to decode
+		 * @param timing	whether to log how long the decoding steps took
+		 */
+		void decodePacket(VideoFrame &frame, bool timing);
 
 	protected:
 		Common::Rational getFrameRate() const { return _frameRate; }
@@ -211,6 +218,17 @@ private:
 			kBlockRaw           ///< Uncoded 8x8 block.
 		};
 
+		/**
+		 * An 8x8 DCT block whose inverse transform is deferred until all
+		 * planes of the frame have been read.
+		 */
+		struct DCTBlock {
+			byte *dest;        ///< Top left pixel of the block in the current plane.
+			uint32 pitch;      ///< Pitch of the plane.
+			bool add;          ///< Add the result to the motion compensated pixels?
+			int16 coeffs[64];  ///< The DCT coefficients.
+		};
+
 		/** Data structure for decoding and tranlating Huffman'd data. */
 		struct Huffman {
 			int  index;       ///< Index of the Huffman codebook to use.
@@ -257,6 +275,9 @@ private:
 		byte *_curPlanes[4]; ///< The 4 color planes, YUVA, current frame.
 		byte *_oldPlanes[4]; ///< The 4 color planes, YUVA, last frame.
 
+		Common::Array<DCTBlock> _dctBlocks; ///< The DCT blocks of the current frame.
+		uint32 _dctBlockCount;              ///< Number of DCT blocks queued for the current frame.
+
 		/** Initialize the bundles. */
 		void initBundles();
 		/** Deinitialize the bundles. */
@@ -312,10 +333,15 @@ private:
 		void readDCTCoeffs   (VideoFrame &video, int16 *block, bool isIntra);
 		void readResidue     (VideoFrame &video, int16 *block, int masksCount);
 
+		/** Queue a DCT block at the current position, returning its zeroed coefficients. */
+		int16 *queueDCTBlock(DecodeContext &ctx, bool add);
+		/** Transform the queued DCT blocks [begin, end). */
+		void runBand(int begin, int end);
+
 		// Bink video IDCT
 		void IDCT(int16 *block);
-		void IDCTPut(DecodeContext &ctx, int16 *block);
-		void IDCTAdd(DecodeContext &ctx, int16 *block);
+		void IDCTPut(byte *dest, uint32 pitch, int16 *block);
+		void IDCTAdd(byte *dest, uint32 pitch, int16 *block);
 	};
 
 	class BinkAudioTrack : public AudioTrack {
@@ -73,6 +73,7 @@ public:
 
 protected:
 	void readNextPacket();
+	bool supportsFrameAhead() const { return true; }
 
 private:
 	class TheoraVideoTrack : public VideoTrack {
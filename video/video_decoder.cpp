@@ -27,12 +27,40 @@
 
 #include "common/rational.h"
 #include "common/file.h"
+#include "common/rect.h"
 #include "common/system.h"
+#include "common/workerpool.h"
 
 #include "graphics/palette.h"
+#include "graphics/surface.h"
 
 namespace Video {
 
+/**
+ * A frame decoded ahead of time, together with the state of the video
+ * after decoding it.
+ */
+class VideoDecoder::FrameAheadSlot : public Common::WorkerJob {
+public:
+	FrameAheadSlot(VideoDecoder *decoder) : _decoder(decoder), decoded(false), hasSurface(false), dirtyPalette(false), curFrame(-1), nextFrameStartTime(0), endOfTrack(false) {}
+	~FrameAheadSlot() { surface.free(); }
+
+	void run() { _decoder->decodeFrameAhead(*this); }
+
+private:
+	VideoDecoder *_decoder;
+
+public:
+	bool decoded;
+	bool hasSurface;
+	Graphics::Surface surface;
+	bool dirtyPalette;
+	byte palette[256 * 3];
+	int curFrame;
+	uint32 nextFrameStartTime;
+	bool endOfTrack;
+};
+
 VideoDecoder::VideoDecoder() {
 	_startTime = 0;
 	_dirtyPalette = false;
@@ -48,6 +76,14 @@ VideoDecoder::VideoDecoder() {
 	_nextVideoTrack = 0;
 	_mainAudioTrack = 0;
 	_canSetDither = true;
+	_frameAheadPool = 0;
+	_frameAheadCount = 0;
+	_frameAheadFirst = 0;
+	_frameAheadQueued = 0;
+	_frameAheadDecodeEnded = false;
+	_frameAheadCurFrame = -1;
+	_frameAheadNextFrameStartTime = 0;
+	_frameAheadEndOfTrack = false;
 
 	// Find the best format for output
 	_defaultHighColorFormat = g_system->getScreenFormat();
@@ -56,7 +92,14 @@ VideoDecoder::VideoDecoder() {
 		_defaultHighColorFormat = Graphics::PixelFormat(4, 8, 8, 8, 8, 8, 16, 24, 0);
 }
 
+VideoDecoder::~VideoDecoder() {
+	stopFrameAhead();
+}
+
 void VideoDecoder::close() {
+	// Wait for the background thread before anything else touches the tracks
+	stopFrameAhead();
+
 	if (isPlaying())
 		stop();
 
@@ -175,6 +218,47 @@ const Graphics::Surface *VideoDecoder::decodeNextFrame() {
 	_needsUpdate = false;
 	_canSetDither = false;
 
+	if (_frameAheadCount) {
+		if (_frameAheadEndOfTrack)
+			return 0;
+
+		if (!_frameAheadQueued)
+			submitFramesAhead();
+
+		if (!_frameAheadQueued)
+			return 0;
+
+		FrameAheadSlot *slot = _frameAheadSlots[_frameAheadFirst];
+
+		if (!_frameAheadPool->isDone(slot)) {
+			_frameAheadStats.stalls++;
+			_frameAheadPool->wait(slot);
+		}
+
+		// The slot keeps the frame until the next call
+		_frameAheadFirst = (_frameAheadFirst + 1) % _frameAheadSlots.size();
+		_frameAheadQueued--;
+
+		if (!slot->decoded) {
+			_frameAheadEndOfTrack = true;
+			return 0;
+		}
+
+		_frameAheadStats.framesDecoded++;
+		_frameAheadCurFrame = slot->curFrame;
+		_frameAheadNextFrameStartTime = slot->nextFrameStartTime;
+		_frameAheadEndOfTrack = slot->endOfTrack;
+
+		if (slot->dirtyPalette) {
+			memcpy(_frameAheadPalette, slot->palette, sizeof(_frameAheadPalette));
+			_palette = _frameAheadPalette;
+			_dirtyPalette = true;
+		}
+
+		submitFramesAhead();
+		return slot->hasSurface ? &slot->surface : 0;
+	}
+
 	readNextPacket();
 
 	// If we have no next video track at this point, there shouldn't be
@@ -196,6 +280,10 @@ const Graphics::Surface *VideoDecoder::decodeNextFrame() {
 }
 
 bool VideoDecoder::setReverse(bool reverse) {
+	// Frames are only decoded ahead of time in forward direction
+	if (_frameAheadCount)
+		return !reverse;
+
 	// Can only reverse video-only videos
 	if (reverse && hasAudio())
 		return false;
@@ -220,6 +308,9 @@ const byte *VideoDecoder::getPalette() {
 }
 
 int VideoDecoder::getCurFrame() const {
+	if (_frameAheadCount)
+		return _frameAheadCurFrame;
+
 	int32 frame = -1;
 
 	for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++)
@@ -261,13 +352,29 @@ uint32 VideoDecoder::getTime() const {
 }
 
 uint32 VideoDecoder::getTimeToNextFrame() const {
-	if (endOfVideo() || _needsUpdate || !_nextVideoTrack)
+	if (endOfVideo() || _needsUpdate)
 		return 0;
 
+	uint32 nextFrameStartTime;
+	bool isReversed;
+
+	if (_frameAheadCount) {
+		if (_frameAheadEndOfTrack)
+			return 0;
+
+		nextFrameStartTime = _frameAheadNextFrameStartTime;
+		isReversed = false;
+	} else {
+		if (!_nextVideoTrack)
+			return 0;
+
+		nextFrameStartTime = _nextVideoTrack->getNextFrameStartTime();
+		isReversed = _nextVideoTrack->isReversed();
+	}
+
 	uint32 currentTime = getTime();
-	uint32 nextFrameStartTime = _nextVideoTrack->getNextFrameStartTime();
 
-	if (_nextVideoTrack->isReversed()) {
+	if (isReversed) {
 		// For reversed videos, we need to handle the time difference the opposite way.
 		if (nextFrameStartTime >= currentTime)
 			return 0;
@@ -283,9 +390,14 @@ uint32 VideoDecoder::getTimeToNextFrame() const {
 }
 
 bool VideoDecoder::endOfVideo() const {
-	for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++)
-		if (!(*it)->endOfTrack() && (!isPlaying() || (*it)->getTrackType() != Track::kTrackTypeVideo || !_endTimeSet || ((VideoTrack *)*it)->getNextFrameStartTime() < (uint)_endTime.msecs()))
+	for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++) {
+		if ((*it)->getTrackType() == Track::kTrackTypeVideo) {
+			if (hasVideoFramesLeft((const VideoTrack *)*it))
+				return false;
+		} else if (!(*it)->endOfTrack()) {
 			return false;
+		}
+	}
 
 	return true;
 }
@@ -305,6 +417,10 @@ bool VideoDecoder::rewind() {
 	if (!isRewindable())
 		return false;
 
+	// Drop the frames decoded ahead of time, they are of no use anymore
+	if (_frameAheadCount)
+		flushFramesAhead();
+
 	// Stop all tracks so they can be rewound
 	if (isPlaying())
 		stopAudio();
@@ -321,6 +437,12 @@ bool VideoDecoder::rewind() {
 	_startTime = g_system->getMillis();
 	resetPauseStartTime();
 	findNextVideoTrack();
+
+	if (_frameAheadCount) {
+		syncFramesAhead();
+		submitFramesAhead();
+	}
+
 	return true;
 }
 
@@ -339,6 +461,10 @@ bool VideoDecoder::seek(const Audio::Timestamp &time) {
 	if (!isSeekable())
 		return false;
 
+	// Drop the frames decoded ahead of time, they are of no use anymore
+	if (_frameAheadCount)
+		flushFramesAhead();
+
 	// Stop all tracks so they can be seeked
 	if (isPlaying())
 		stopAudio();
@@ -363,6 +489,12 @@ bool VideoDecoder::seek(const Audio::Timestamp &time) {
 
 	resetPauseStartTime();
 	findNextVideoTrack();
+
+	if (_frameAheadCount) {
+		syncFramesAhead();
+		submitFramesAhead();
+	}
+
 	_needsUpdate = true;
 	return true;
 }
@@ -896,12 +1028,29 @@ bool VideoDecoder::hasFramesLeft() const {
 	// This is only used for needsUpdate() atm so that setEndTime() works properly
 	// And unlike endOfVideoTracks(), this takes into account _endTime
 	for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++)
-		if ((*it)->getTrackType() == Track::kTrackTypeVideo && !(*it)->endOfTrack() && (!isPlaying() || !_endTimeSet || ((VideoTrack *)*it)->getNextFrameStartTime() < (uint)_endTime.msecs()))
+		if ((*it)->getTrackType() == Track::kTrackTypeVideo && hasVideoFramesLeft((const VideoTrack *)*it))
 			return true;
 
 	return false;
 }
 
+bool VideoDecoder::hasVideoFramesLeft(const VideoTrack *track) const {
+	// When decoding ahead of time, the track itself is ahead of the frames
+	// handed out so far, and it may be busy on the background thread
+	bool endOfTrack;
+	uint32 nextFrameStartTime;
+
+	if (_frameAheadCount) {
+		endOfTrack = _frameAheadEndOfTrack;
+		nextFrameStartTime = _frameAheadNextFrameStartTime;
+	} else {
+		endOfTrack = track->endOfTrack();
+		nextFrameStartTime = endOfTrack ? 0 : track->getNextFrameStartTime();
+	}
+
+	return !endOfTrack && (!isPlaying() || !_endTimeSet || nextFrameStartTime < (uint)_endTime.msecs());
+}
+
 bool VideoDecoder::hasAudio() const {
 	for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++)
 		if ((*it)->getTrackType() == Track::kTrackTypeAudio)
@@ -910,4 +1059,177 @@ bool VideoDecoder::hasAudio() const {
 	return false;
 }
 
+bool VideoDecoder::setFrameAhead(uint frameCount) {
+	if (frameCount == _frameAheadCount)
+		return true;
+
+	stopFrameAhead();
+
+	if (frameCount == 0)
+		return true;
+
+	if (!supportsFrameAhead())
+		return false;
+
+	// Only a single video track playing forward is supported
+	VideoTrack *track = 0;
+
+	for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++) {
+		if ((*it)->getTrackType() == Track::kTrackTypeVideo) {
+			if (track)
+				return false;
+
+			track = (VideoTrack *)*it;
+		}
+	}
+
+	if (!track || track->isReversed())
+		return false;
+
+	// Decoders may split their work across the shared worker pool, which
+	// must be created on this thread
+	Common::WorkerPool::getShared();
+
+	// The frames must be decoded one after another
+	_frameAheadPool = new Common::WorkerPool(1, true);
+	_frameAheadCount = frameCount;
+	_frameAheadFirst = 0;
+	_frameAheadQueued = 0;
+	_canSetDither = false;
+
+	// One more slot holds the frame returned last by decodeNextFrame()
+	for (uint i = 0; i < frameCount + 1; i++) {
+		FrameAheadSlot *slot = new FrameAheadSlot(this);
+		slot->surface.create(track->getWidth(), track->getHeight(), track->getPixelFormat());
+		_frameAheadSlots.push_back(slot);
+	}
+
+	findNextVideoTrack();
+	syncFramesAhead();
+
+	// Decode the first frame on this thread, so any state shared between
+	// decoders, like the YUV lookup tables, is set up before the background
+	// thread uses it
+	if (!_frameAheadDecodeEnded) {
+		_frameAheadSlots[0]->run();
+		_frameAheadQueued = 1;
+	}
+
+	submitFramesAhead();
+	return true;
+}
+
+uint VideoDecoder::getFrameQueueDepth() const {
+	uint depth = 0;
+
+	for (uint i = 0; i < _frameAheadQueued; i++) {
+		FrameAheadSlot *slot = _frameAheadSlots[(_frameAheadFirst + i) % _frameAheadSlots.size()];
+
+		if (!_frameAheadPool->isDone(slot) || !slot->decoded)
+			break;
+
+		depth++;
+	}
+
+	return depth;
+}
+
+void VideoDecoder::decodeFrameAhead(FrameAheadSlot &slot) {
+	// This runs on the background thread, which owns the tracks while any
+	// slot is queued. It follows the steps of decodeNextFrame().
+	slot.decoded = false;
+	slot.hasSurface = false;
+	slot.dirtyPalette = false;
+
+	if (!_nextVideoTrack)
+		return;
+
+	readNextPacket();
+
+	const Graphics::Surface *frame = _nextVideoTrack->decodeNextFrame();
+
+	if (frame) {
+		if (slot.surface.w != frame->w || slot.surface.h != frame->h || slot.surface.format != frame->format) {
+			slot.surface.free();
+			slot.surface.create(frame->w, frame->h, frame->format);
+		}
+
+		slot.surface.copyRectToSurface(*frame, 0, 0, Common::Rect(frame->w, frame->h));
+		slot.hasSurface = true;
+	}
+
+	if (_nextVideoTrack->hasDirtyPalette()) {
+		memcpy(slot.palette, _nextVideoTrack->getPalette(), sizeof(slot.palette));
+		slot.dirtyPalette = true;
+	}
+
+	slot.decoded = true;
+	slot.curFrame = _nextVideoTrack->getCurFrame();
+	slot.endOfTrack = !findNextVideoTrack();
+	slot.nextFrameStartTime = slot.endOfTrack ? 0 : _nextVideoTrack->getNextFrameStartTime();
+}
+
+void VideoDecoder::submitFramesAhead() {
+	// Stop once a decoded frame turns out to be the last one
+	for (uint i = 0; i < _frameAheadQueued && !_frameAheadDecodeEnded; i++) {
+		FrameAheadSlot *slot = _frameAheadSlots[(_frameAheadFirst + i) % _frameAheadSlots.size()];
+
+		if (!_frameAheadPool->isDone(slot))
+			break;
+
+		if (!slot->decoded || slot->endOfTrack)
+			_frameAheadDecodeEnded = true;
+	}
+
+	while (!_frameAheadDecodeEnded && _frameAheadQueued < _frameAheadCount) {
+		FrameAheadSlot *slot = _frameAheadSlots[(_frameAheadFirst + _frameAheadQueued) % _frameAheadSlots.size()];
+		_frameAheadQueued++;
+		_frameAheadPool->submit(slot);
+	}
+}
+
+void VideoDecoder::flushFramesAhead() {
+	_frameAheadPool->waitAll();
+
+	for (uint i = 0; i < _frameAheadQueued; i++) {
+		if (_frameAheadSlots[(_frameAheadFirst + i) % _frameAheadSlots.size()]->decoded) {
+			_frameAheadStats.framesDecoded++;
+			_frameAheadStats.framesDropped++;
+		}
+	}
+
+	_frameAheadFirst = (_frameAheadFirst + _frameAheadQueued) % _frameAheadSlots.size();
+	_frameAheadQueued = 0;
+}
+
+void VideoDecoder::syncFramesAhead() {
+	// Take over the state of the video track, which must not be busy
+	for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++) {
+		if ((*it)->getTrackType() == Track::kTrackTypeVideo) {
+			VideoTrack *track = (VideoTrack *)*it;
+			_frameAheadCurFrame = track->getCurFrame();
+			_frameAheadEndOfTrack = track->endOfTrack();
+			_frameAheadNextFrameStartTime = _frameAheadEndOfTrack ? 0 : track->getNextFrameStartTime();
+		}
+	}
+
+	_frameAheadDecodeEnded = _frameAheadEndOfTrack;
+}
+
+void VideoDecoder::stopFrameAhead() {
+	if (!_frameAheadCount)
+		return;
+
+	flushFramesAhead();
+
+	for (uint i = 0; i < _frameAheadSlots.size(); i++)
+		delete _frameAheadSlots[i];
+
+	_frameAheadSlots.clear();
+	delete _frameAheadPool;
+	_frameAheadPool = 0;
+	_frameAheadCount = 0;
+	_frameAheadQueued = 0;
+}
+
 } // End of namespace Video
@@ -38,6 +38,7 @@ class SeekableAudioStream;
 
 namespace Common {
 class SeekableReadStream;
+class WorkerPool;
 }
 
 namespace Graphics {
@@ -52,7 +53,7 @@ namespace Video {
 class VideoDecoder {
 public:
 	VideoDecoder();
-	virtual ~VideoDecoder() {}
+	virtual ~VideoDecoder();
 
 	/////////////////////////////////////////
 	// Opening/Closing a Video
@@ -396,6 +397,65 @@ public:
 	 */
 	bool setDitheringPalette(const byte *palette);
 
+	/**
+	 * Statistics of decoding frames ahead of time.
+	 *
+	 * @see setFrameAhead()
+	 */
+	struct FrameAheadStats {
+		FrameAheadStats() : framesDecoded(0), framesDropped(0), stalls(0) {}
+
+		/** The number of frames decoded ahead of time */
+		uint32 framesDecoded;
+
+		/** The number of decoded frames thrown away by seeking, rewinding or closing */
+		uint32 framesDropped;
+
+		/** The number of decodeNextFrame() calls which had to wait for their frame */
+		uint32 stalls;
+	};
+
+	/**
+	 * Decode up to the given number of frames ahead of time on a background
+	 * thread, so expensive frames do not stall the caller of
+	 * decodeNextFrame(). Frame timing, getCurFrame() and endOfVideo() still
+	 * refer to the frames returned by decodeNextFrame().
+	 *
+	 * This is only supported for videos with a single video track by
+	 * decoders which can decode on another thread, and not while playing in
+	 * reverse. The setting remains until close() is called.
+	 *
+	 * This should be called after loadStream() and setDitheringPalette(). It
+	 * decodes the first frame right away on the calling thread. Changing the
+	 * setting later drops the frames decoded ahead so far.
+	 *
+	 * @param frameCount	the number of frames to decode ahead, or 0 to
+	 *						decode each frame when it is requested again
+	 * @return true on success, false otherwise
+	 */
+	bool setFrameAhead(uint frameCount);
+
+	/**
+	 * Get the number of frames decoded ahead of time.
+	 */
+	uint getFrameAhead() const { return _frameAheadCount; }
+
+	/**
+	 * Get the number of frames which are decoded and waiting to be
+	 * returned by decodeNextFrame().
+	 */
+	uint getFrameQueueDepth() const;
+
+	/**
+	 * Get the statistics of decoding frames ahead of time.
+	 */
+	const FrameAheadStats &getFrameAheadStats() const { return _frameAheadStats; }
+
+	/**
+	 * Reset the statistics of decoding frames ahead of time.
+	 */
+	void resetFrameAheadStats() { _frameAheadStats = FrameAheadStats(); }
+
 	/////////////////////////////////////////
 	// Audio Control
 	/////////////////////////////////////////
@@ -894,6 +954,17 @@ protected:
 	 */
 	virtual bool seekIntern(const Audio::Timestamp &time);
 
+	/**
+	 * Can frames of this video be decoded ahead of time?
+	 *
+	 * If this returns true, readNextPacket() and decodeNextFrame() of the
+	 * video track are called on a background thread once setFrameAhead()
+	 * is used. They may then only feed the audio tracks through streams
+	 * which are safe to use from several threads, such as
+	 * Audio::QueuingAudioStream.
+	 */
+	virtual bool supportsFrameAhead() const { return false; }
+
 	/**
 	 * Does this video format support switching between audio tracks?
 	 *
@@ -950,6 +1021,30 @@ private:
 	int8 _audioBalance;
 
 	AudioTrack *_mainAudioTrack;
+
+	// Decoding frames ahead of time
+	class FrameAheadSlot;
+	typedef Common::Array<FrameAheadSlot *> FrameAheadSlotList;
+
+	Common::WorkerPool *_frameAheadPool;
+	FrameAheadSlotList _frameAheadSlots;
+	uint _frameAheadCount;
+	uint _frameAheadFirst, _frameAheadQueued;
+	bool _frameAheadDecodeEnded;
+
+	// The state of the video as seen by the caller of decodeNextFrame()
+	int _frameAheadCurFrame;
+	uint32 _frameAheadNextFrameStartTime;
+	bool _frameAheadEndOfTrack;
+	byte _frameAheadPalette[256 * 3];
+	FrameAheadStats _frameAheadStats;
+
+	void decodeFrameAhead(FrameAheadSlot &slot);
+	bool hasVideoFramesLeft(const VideoTrack *track) const;
+	void submitFramesAhead();
+	void flushFramesAhead();
+	void syncFramesAhead();
+	void stopFrameAhead();
 };
 
 } // End of namespace Video